@@ -221,6 +221,7 @@ XdmfAttribute::setCenter(const shared_ptr<const XdmfAttributeCenter> center)
 void
 XdmfAttribute::setName(const std::string & name)
 {
+  XdmfChildIndex::rename(*this);
   mName = name;
   this->setIsChanged(true);
 }
@@ -245,6 +245,7 @@ XdmfGrid::setGridController(shared_ptr<XdmfGridController> newController)
 void
 XdmfGrid::setName(const std::string & name)
 {
+  XdmfChildIndex::rename(*this);
   mName = name;
   this->setIsChanged(true);
 }
@@ -21,12 +21,20 @@
 /*                                                                           */
 /*****************************************************************************/
 
+#include <algorithm>
 #include <utility>
+#include "XdmfArrayType.hpp"
+#include "XdmfAttribute.hpp"
+#include "XdmfCurvilinearGrid.hpp"
 #include "XdmfError.hpp"
 #include "XdmfGeometry.hpp"
 #include "XdmfTopology.hpp"
 #include "XdmfGridCollection.hpp"
 #include "XdmfGridCollectionType.hpp"
+#include "XdmfRectilinearGrid.hpp"
+#include "XdmfRegularGrid.hpp"
+#include "XdmfTime.hpp"
+#include "XdmfUnstructuredGrid.hpp"
 
 class XdmfGridCollection::XdmfGridCollectionImpl : public XdmfGridImpl
 {
@@ -51,6 +59,27 @@ class XdmfGridCollection::XdmfGridCollectionImpl : public XdmfGridImpl
   }
 };
 
+namespace {
+
+  bool
+  isBeforeStepTime(const double time,
+                   const std::pair<double, unsigned int> & stepTime)
+  {
+    return time < stepTime.first;
+  }
+
+  void
+  copyValues(const shared_ptr<XdmfArray> array,
+             std::vector<double> & values)
+  {
+    values.resize(array->getSize());
+    if (values.size() > 0) {
+      array->getValues(0, &values[0], values.size());
+    }
+  }
+
+}
+
 shared_ptr<XdmfGridCollection>
 XdmfGridCollection::New()
 {
@@ -64,6 +93,8 @@ XdmfGridCollection::XdmfGridCollection() :
   mType(XdmfGridCollectionType::NoCollectionType())
 {
     mImpl = new XdmfGridCollectionImpl();
+    mInterpolatedSteps[0] = 0;
+    mInterpolatedSteps[1] = 0;
 }
 
 XdmfGridCollection::XdmfGridCollection(XdmfGridCollection & refCollection) :
@@ -71,6 +102,8 @@ XdmfGridCollection::XdmfGridCollection(XdmfGridCollection & refCollection) :
   XdmfGrid(refCollection),
   mType(refCollection.mType)
 {
+  mInterpolatedSteps[0] = 0;
+  mInterpolatedSteps[1] = 0;
 }
 
 XdmfGridCollection::~XdmfGridCollection()
@@ -141,6 +174,134 @@ XdmfGridCollection::copyGrid(shared_ptr<XdmfGrid> sourceGrid)
   }
 }
 
+shared_ptr<XdmfAttribute>
+XdmfGridCollection::getInterpolated(const double time,
+                                    const std::string & name)
+{
+  // Steps may have been added, removed, or given new times
+  std::vector<std::pair<double, unsigned int> > stepTimes;
+  this->getStepTimes(stepTimes);
+  if (stepTimes != mUnsortedStepTimes) {
+    mUnsortedStepTimes = stepTimes;
+    mStepTimes = stepTimes;
+    std::sort(mStepTimes.begin(), mStepTimes.end());
+    // Values kept from the previous steps may no longer apply
+    mInterpolatedAttributes[0].reset();
+    mInterpolatedAttributes[1].reset();
+  }
+  if (mStepTimes.size() == 0) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: No steps with a time in "
+                       "XdmfGridCollection::getInterpolated");
+  }
+
+  // Find the steps bracketing the time
+  std::vector<std::pair<double, unsigned int> >::const_iterator upper =
+    std::upper_bound(mStepTimes.begin(),
+                     mStepTimes.end(),
+                     time,
+                     isBeforeStepTime);
+  unsigned int lowerStep = 0;
+  unsigned int upperStep = 0;
+  double weight = 0.0;
+  if (upper == mStepTimes.begin()) {
+    lowerStep = upper->second;
+    upperStep = lowerStep;
+  }
+  else if (upper == mStepTimes.end()) {
+    lowerStep = (upper - 1)->second;
+    upperStep = lowerStep;
+  }
+  else {
+    lowerStep = (upper - 1)->second;
+    upperStep = upper->second;
+    weight = (time - (upper - 1)->first) / (upper->first - (upper - 1)->first);
+    if (weight == 0.0) {
+      upperStep = lowerStep;
+    }
+  }
+
+  if (mInterpolatedName != name) {
+    mInterpolatedName = name;
+    mInterpolatedAttributes[0].reset();
+    mInterpolatedAttributes[1].reset();
+  }
+  // Keep values only while they are read from the same heavy data, values
+  // copied from memory may have been edited since
+  for (unsigned int slot = 0; slot < 2; ++slot) {
+    if (mInterpolatedAttributes[slot]) {
+      std::vector<shared_ptr<XdmfHeavyDataController> > controllers;
+      this->getStepControllers(mInterpolatedSteps[slot], name, controllers);
+      if (controllers.size() == 0 ||
+          controllers != mInterpolatedControllers[slot]) {
+        mInterpolatedAttributes[slot].reset();
+      }
+    }
+  }
+
+  // Read the bracketing steps that are not already kept
+  unsigned int slots[2];
+  for (unsigned int i = 0; i < 2; ++i) {
+    const unsigned int step = i == 0 ? lowerStep : upperStep;
+    unsigned int slot = 0;
+    while (slot < 2 &&
+           !(mInterpolatedAttributes[slot] && mInterpolatedSteps[slot] == step)) {
+      ++slot;
+    }
+    if (slot == 2) {
+      // Replace the values not needed for the other bracketing step
+      if (i == 0) {
+        slot = (mInterpolatedAttributes[0] &&
+                mInterpolatedSteps[0] == upperStep) ? 1 : 0;
+      }
+      else {
+        slot = 1 - slots[0];
+      }
+      mInterpolatedAttributes[slot] =
+        this->readStepAttribute(step, name, mInterpolatedValues[slot]);
+      mInterpolatedSteps[slot] = step;
+      mInterpolatedControllers[slot].clear();
+      this->getStepControllers(step, name, mInterpolatedControllers[slot]);
+    }
+    slots[i] = slot;
+  }
+
+  const std::vector<double> & lowerValues = mInterpolatedValues[slots[0]];
+  const std::vector<double> & upperValues = mInterpolatedValues[slots[1]];
+  if (lowerValues.size() != upperValues.size()) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: Attribute " + name + " differs in size between "
+                       "steps in XdmfGridCollection::getInterpolated");
+  }
+
+  shared_ptr<XdmfAttribute> source = mInterpolatedAttributes[slots[0]];
+  shared_ptr<XdmfAttribute> interpolated = XdmfAttribute::New();
+  interpolated->setName(name);
+  interpolated->setCenter(source->getCenter());
+  interpolated->setType(source->getType());
+  std::vector<unsigned int> dimensions = source->getDimensions();
+  unsigned int dimensionsSize = 1;
+  for (unsigned int i = 0; i < dimensions.size(); ++i) {
+    dimensionsSize *= dimensions[i];
+  }
+  if (dimensionsSize != lowerValues.size()) {
+    dimensions = std::vector<unsigned int>(1, lowerValues.size());
+  }
+  interpolated->initialize(XdmfArrayType::Float64(), dimensions);
+
+  const unsigned int size = lowerValues.size();
+  if (size > 0) {
+    double * interpolatedValues = (double *)interpolated->getValuesInternal();
+    const double * lowerPointer = &lowerValues[0];
+    const double * upperPointer = &upperValues[0];
+    for (unsigned int i = 0; i < size; ++i) {
+      interpolatedValues[i] =
+        lowerPointer[i] + weight * (upperPointer[i] - lowerPointer[i]);
+    }
+  }
+  return interpolated;
+}
+
 std::map<std::string, std::string>
 XdmfGridCollection::getItemProperties() const
 {
@@ -157,6 +318,72 @@ XdmfGridCollection::getItemTag() const
   return ItemTag;
 }
 
+unsigned int
+XdmfGridCollection::getNumberTimeSteps()
+{
+  return this->getNumberUnstructuredGrids() +
+         this->getNumberCurvilinearGrids() +
+         this->getNumberRectilinearGrids() +
+         this->getNumberRegularGrids() +
+         this->getNumberGridCollections();
+}
+
+void
+XdmfGridCollection::getStepControllers(const unsigned int stepId,
+                                       const std::string & name,
+                                       std::vector<shared_ptr<XdmfHeavyDataController> > & controllers)
+{
+  shared_ptr<XdmfAttribute> attribute;
+  if (shared_ptr<XdmfGrid> grid = this->getStepGrid(stepId)) {
+    attribute = grid->getAttribute(name);
+  }
+  // Values in memory are copied, not read from the controllers
+  if (attribute && !attribute->isInitialized()) {
+    for (unsigned int i = 0; i < attribute->getNumberHeavyDataControllers(); ++i) {
+      controllers.push_back(attribute->getHeavyDataController(i));
+    }
+  }
+}
+
+shared_ptr<XdmfGrid>
+XdmfGridCollection::getStepGrid(const unsigned int stepId)
+{
+  // Steps are numbered through each kind of grid in turn
+  unsigned int index = stepId;
+  if (index < this->getNumberUnstructuredGrids()) {
+    return this->getUnstructuredGrid(index);
+  }
+  index -= this->getNumberUnstructuredGrids();
+  if (index < this->getNumberCurvilinearGrids()) {
+    return this->getCurvilinearGrid(index);
+  }
+  index -= this->getNumberCurvilinearGrids();
+  if (index < this->getNumberRectilinearGrids()) {
+    return this->getRectilinearGrid(index);
+  }
+  index -= this->getNumberRectilinearGrids();
+  if (index < this->getNumberRegularGrids()) {
+    return this->getRegularGrid(index);
+  }
+  index -= this->getNumberRegularGrids();
+  if (index < this->getNumberGridCollections()) {
+    return this->getGridCollection(index);
+  }
+  return shared_ptr<XdmfGrid>();
+}
+
+void
+XdmfGridCollection::getStepTimes(std::vector<std::pair<double, unsigned int> > & stepTimes)
+{
+  const unsigned int numberSteps = this->getNumberTimeSteps();
+  for (unsigned int i = 0; i < numberSteps; ++i) {
+    shared_ptr<XdmfGrid> grid = this->getStepGrid(i);
+    if (grid && grid->getTime()) {
+      stepTimes.push_back(std::make_pair(grid->getTime()->getValue(), i));
+    }
+  }
+}
+
 shared_ptr<const XdmfGridCollectionType>
 XdmfGridCollection::getType() const
 {
@@ -272,6 +499,39 @@ XdmfGridCollection::read()
   }
 }
 
+shared_ptr<XdmfAttribute>
+XdmfGridCollection::readStepAttribute(const unsigned int stepId,
+                                      const std::string & name,
+                                      std::vector<double> & values)
+{
+  shared_ptr<XdmfAttribute> attribute;
+  if (shared_ptr<XdmfGrid> grid = this->getStepGrid(stepId)) {
+    attribute = grid->getAttribute(name);
+  }
+  if (!attribute) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: No attribute " + name + " in step of "
+                       "XdmfGridCollection::readStepAttribute");
+  }
+  if (!attribute->isInitialized() &&
+      attribute->getNumberHeavyDataControllers() > 0) {
+    // Read into a separate array, leaving the step as it was
+    shared_ptr<XdmfArray> stepValues = XdmfArray::New();
+    for (unsigned int i = 0; i < attribute->getNumberHeavyDataControllers(); ++i) {
+      stepValues->insert(attribute->getHeavyDataController(i));
+    }
+    stepValues->read();
+    copyValues(stepValues, values);
+  }
+  else {
+    if (!attribute->isInitialized()) {
+      attribute->read();
+    }
+    copyValues(attribute, values);
+  }
+  return attribute;
+}
+
 void
 XdmfGridCollection::release()
 {
@@ -400,6 +660,17 @@ void XdmfGridCollectionSetType(XDMFGRIDCOLLECTION * collection, int type, int *
   XDMF_ERROR_WRAP_END(status)
 }
 
+XDMFATTRIBUTE * XdmfGridCollectionGetInterpolated(XDMFGRIDCOLLECTION * collection, double time, char * name, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  XdmfItem * tempPointer = (XdmfItem *)collection;
+  XdmfGridCollection * tempCollection = dynamic_cast<XdmfGridCollection *>(tempPointer);
+  shared_ptr<XdmfAttribute> interpolated = tempCollection->getInterpolated(time, std::string(name));
+  return (XDMFATTRIBUTE *)((void *)(new XdmfAttribute(*interpolated.get())));
+  XDMF_ERROR_WRAP_END(status)
+  return NULL;
+}
+
 XDMF_DOMAIN_C_CHILD_WRAPPER(XdmfGridCollection, XDMFGRIDCOLLECTION)
 XDMF_GRID_C_CHILD_WRAPPER(XdmfGridCollection, XDMFGRIDCOLLECTION)
 XDMF_ITEM_C_CHILD_WRAPPER(XdmfGridCollection, XDMFGRIDCOLLECTION)
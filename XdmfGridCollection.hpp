@@ -78,6 +78,27 @@ public:
 
   std::string getItemTag() const;
 
+  /**
+   * Gets the values of an attribute at a time between the steps of a
+   * temporal collection, linearly interpolated between the two steps
+   * that bracket it. Times before the first step or after the last
+   * step take the values of that step. Steps without a time are
+   * ignored.
+   *
+   * Only the named attribute of the bracketing steps is read, through
+   * its heavy data controllers when it is not already in memory, and
+   * the values of the last two steps read are kept so that sequential
+   * queries only read a step when crossing into it.
+   *
+   * @param     time    The time to interpolate the attribute at.
+   * @param     name    The name of the attribute to interpolate.
+   * @return            An attribute holding the interpolated values
+   *                    as Float64, with the name, center, type and
+   *                    dimensions of the attribute of the steps.
+   */
+  virtual shared_ptr<XdmfAttribute> getInterpolated(const double time,
+                                                    const std::string & name);
+
   /**
    * Get the XdmfGridCollectionType associated with this grid collection.
    *
@@ -176,8 +197,57 @@ protected:
 
   void copyGrid(shared_ptr<XdmfGrid> sourceGrid);
 
+  /**
+   * Gets the number of steps that getInterpolated considers, the
+   * index of the steps is rebuilt when this changes.
+   *
+   * @return    The number of steps in the collection.
+   */
+  virtual unsigned int getNumberTimeSteps();
+
+  /**
+   * Gets the time of each step that has one.
+   *
+   * @param     stepTimes       Filled with the time and index of the
+   *                            steps, in any order.
+   */
+  virtual void
+  getStepTimes(std::vector<std::pair<double, unsigned int> > & stepTimes);
+
+  /**
+   * Reads the values of an attribute of a step without loading the
+   * rest of the step.
+   *
+   * @param     stepId  The index of the step to read from.
+   * @param     name    The name of the attribute to read.
+   * @param     values  Filled with the values of the attribute.
+   * @return            The attribute of the step that was read.
+   */
+  virtual shared_ptr<XdmfAttribute>
+  readStepAttribute(const unsigned int stepId,
+                    const std::string & name,
+                    std::vector<double> & values);
+
+  /**
+   * Gets the heavy data controllers that readStepAttribute reads the
+   * values of an attribute of a step from. Values read earlier are kept
+   * while these stay the same.
+   *
+   * @param     stepId          The index of the step.
+   * @param     name            The name of the attribute.
+   * @param     controllers     Filled with the controllers, left empty
+   *                            when the values are not read from heavy
+   *                            data and have to be copied again.
+   */
+  virtual void
+  getStepControllers(const unsigned int stepId,
+                     const std::string & name,
+                     std::vector<shared_ptr<XdmfHeavyDataController> > & controllers);
+
 private:
 
+  shared_ptr<XdmfGrid> getStepGrid(const unsigned int stepId);
+
   /**
    * PIMPL
    */
@@ -187,6 +257,16 @@ private:
   void operator=(const XdmfGridCollection &);  // Not implemented.
 
   shared_ptr<const XdmfGridCollectionType> mType;
+  // Times of the steps sorted by time, and in step order to notice edits
+  std::vector<std::pair<double, unsigned int> > mStepTimes;
+  std::vector<std::pair<double, unsigned int> > mUnsortedStepTimes;
+  // Values of the attribute last interpolated for the two steps last read,
+  // kept while they are read from the same heavy data controllers
+  std::string mInterpolatedName;
+  unsigned int mInterpolatedSteps[2];
+  std::vector<double> mInterpolatedValues[2];
+  shared_ptr<XdmfAttribute> mInterpolatedAttributes[2];
+  std::vector<shared_ptr<XdmfHeavyDataController> > mInterpolatedControllers[2];
 };
 
 #endif
@@ -209,6 +289,8 @@ XDMF_EXPORT int XdmfGridCollectionGetType(XDMFGRIDCOLLECTION * collection, int *
 
 XDMF_EXPORT void XdmfGridCollectionSetType(XDMFGRIDCOLLECTION * collection, int type, int * status);
 
+XDMF_EXPORT XDMFATTRIBUTE * XdmfGridCollectionGetInterpolated(XDMFGRIDCOLLECTION * collection, double time, char * name, int * status);
+
 XDMF_DOMAIN_C_CHILD_DECLARE(XdmfGridCollection, XDMFGRIDCOLLECTION, XDMF)
 XDMF_GRID_C_CHILD_DECLARE(XdmfGridCollection, XDMFGRIDCOLLECTION, XDMF)
 XDMF_ITEM_C_CHILD_DECLARE(XdmfGridCollection, XDMFGRIDCOLLECTION, XDMF)
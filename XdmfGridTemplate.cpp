@@ -21,6 +21,7 @@
 /*                                                                           */
 /*****************************************************************************/
 
+#include <algorithm>
 #include <sstream>
 #include <utility>
 #include "XdmfArray.hpp"
@@ -57,7 +58,8 @@ XdmfGridTemplate::New()
 XdmfGridTemplate::XdmfGridTemplate() :
   XdmfTemplate(),
   XdmfGridCollection(),
-  mTimeCollection(XdmfArray::New())
+  mTimeCollection(XdmfArray::New()),
+  mTimeIndexSize(0)
 {
   mTimeCollection->setName("Time Collection");
 }
@@ -65,7 +67,8 @@ XdmfGridTemplate::XdmfGridTemplate() :
 XdmfGridTemplate::XdmfGridTemplate(XdmfGridTemplate & refTemplate) :
   XdmfTemplate(refTemplate),
   XdmfGridCollection(refTemplate),
-  mTimeCollection(refTemplate.mTimeCollection)
+  mTimeCollection(refTemplate.mTimeCollection),
+  mTimeIndexSize(0)
 {
 }
 
@@ -103,6 +106,25 @@ XdmfGridTemplate::getItemTag() const
   return ItemTag;
 }
 
+unsigned int
+XdmfGridTemplate::getNumberTimeSteps()
+{
+  return this->getNumberSteps();
+}
+
+void
+XdmfGridTemplate::getStepTimes(std::vector<std::pair<double, unsigned int> > & stepTimes)
+{
+  if (!mTimeCollection->isInitialized()) {
+    mTimeCollection->read();
+  }
+  const unsigned int numberSteps =
+    std::min(mTimeCollection->getSize(), this->getNumberSteps());
+  for (unsigned int i = 0; i < numberSteps; ++i) {
+    stepTimes.push_back(std::make_pair(mTimeCollection->getValue<double>(i), i));
+  }
+}
+
 shared_ptr<XdmfArray>
 XdmfGridTemplate::getTimes()
 {
@@ -842,6 +864,9 @@ XdmfGridTemplate::populateItem(const std::map<std::string, std::string> & itemPr
             }
           }
         }
+        else if (array->getName().compare("Keyframe Description") == 0) {
+          this->populateKeyframes(array);
+        }
         else if (array->getName().compare("Time Collection") == 0) {
           mTimeCollection = array;
         }
@@ -893,6 +918,74 @@ XdmfGridTemplate::populateItem(const std::map<std::string, std::string> & itemPr
   else {
     mNumSteps = mDataControllers.size() / mTrackedArrays.size();
   }
+  this->resetStepIndex();
+}
+
+void
+XdmfGridTemplate::getStepControllers(const unsigned int stepId,
+                                     const std::string & name,
+                                     std::vector<shared_ptr<XdmfHeavyDataController> > & controllers)
+{
+  shared_ptr<XdmfAttribute> attribute;
+  if (shared_ptr<XdmfGrid> grid = shared_dynamic_cast<XdmfGrid>(mBase)) {
+    attribute = grid->getAttribute(name);
+  }
+  if (!attribute) {
+    return;
+  }
+  for (unsigned int i = 0; i < mTrackedArrays.size(); ++i) {
+    if (mTrackedArrays[i] == attribute.get()) {
+      // Only steps appended to common datasets keep their controllers
+      if (stepId < this->getNumberSteps() &&
+          mHeavyWriter &&
+          (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Append ||
+           mHeavyWriter->getMode() == XdmfHeavyDataWriter::Hyperslab) &&
+          mDataControllers[i].size() > 0) {
+        controllers = this->findStepControllers(stepId, i);
+      }
+      return;
+    }
+  }
+  // Untracked attributes are the same for every step
+  if (!attribute->isInitialized()) {
+    for (unsigned int i = 0; i < attribute->getNumberHeavyDataControllers(); ++i) {
+      controllers.push_back(attribute->getHeavyDataController(i));
+    }
+  }
+}
+
+shared_ptr<XdmfAttribute>
+XdmfGridTemplate::readStepAttribute(const unsigned int stepId,
+                                    const std::string & name,
+                                    std::vector<double> & values)
+{
+  shared_ptr<XdmfAttribute> attribute;
+  if (shared_ptr<XdmfGrid> grid = shared_dynamic_cast<XdmfGrid>(mBase)) {
+    attribute = grid->getAttribute(name);
+  }
+  if (!attribute) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: No attribute " + name + " in base of "
+                       "XdmfGridTemplate::readStepAttribute");
+  }
+  shared_ptr<XdmfArray> stepValues;
+  for (unsigned int i = 0; i < mTrackedArrays.size() && !stepValues; ++i) {
+    if (mTrackedArrays[i] == attribute.get()) {
+      stepValues = this->readStep(stepId, i);
+    }
+  }
+  if (!stepValues) {
+    // Untracked attributes are the same for every step
+    if (!attribute->isInitialized()) {
+      attribute->read();
+    }
+    stepValues = attribute;
+  }
+  values.resize(stepValues->getSize());
+  if (values.size() > 0) {
+    stepValues->getValues(0, &values[0], values.size());
+  }
+  return attribute;
 }
 
 void
@@ -942,13 +1035,37 @@ XdmfGridTemplate::setStep(shared_ptr<XdmfTime> time)
     if (!mTimeCollection->isInitialized()) {
       mTimeCollection->read();
     }
-    unsigned int index = 0;
-    while (index < mTimeCollection->getSize() &&
-           time->getValue() != mTimeCollection->getValue<double>(index))
+    const unsigned int size = mTimeCollection->getSize();
+    if (mTimeIndexSize != size) {
+      mTimeIndex.clear();
+      for (unsigned int i = 0; i < size; ++i) {
+        mTimeIndex.insert(std::make_pair(mTimeCollection->getValue<double>(i), i));
+      }
+      mTimeIndexSize = size;
+    }
+    unsigned int index = size;
+    std::map<double, unsigned int>::const_iterator iter =
+      mTimeIndex.find(time->getValue());
+    if (iter != mTimeIndex.end() &&
+        time->getValue() == mTimeCollection->getValue<double>(iter->second))
+    {
+      index = iter->second;
+    }
+    else
     {
-      ++index;
+      // Times changed without changing their number
+      index = 0;
+      while (index < size &&
+             time->getValue() != mTimeCollection->getValue<double>(index))
+      {
+        ++index;
+      }
+      if (index < size)
+      {
+        mTimeIndexSize = 0;
+      }
     }
-    if (index < mTimeCollection->getSize())
+    if (index < size)
     {
       this->setStep(index);
     }
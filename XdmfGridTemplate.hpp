@@ -194,10 +194,28 @@ protected:
                const std::vector<shared_ptr<XdmfItem> > & childItems,
                const XdmfCoreReader * const reader);
 
+  unsigned int getNumberTimeSteps();
+
+  void getStepTimes(std::vector<std::pair<double, unsigned int> > & stepTimes);
+
+  shared_ptr<XdmfAttribute>
+  readStepAttribute(const unsigned int stepId,
+                    const std::string & name,
+                    std::vector<double> & values);
+
+  void
+  getStepControllers(const unsigned int stepId,
+                     const std::string & name,
+                     std::vector<shared_ptr<XdmfHeavyDataController> > & controllers);
+
   shared_ptr<XdmfArray> mTimeCollection;
 
 private:
 
+  // Step of the first occurrence of each time, built for mTimeIndexSize times
+  std::map<double, unsigned int> mTimeIndex;
+  unsigned int mTimeIndexSize;
+
   XdmfGridTemplate(const XdmfGridTemplate &);  // Not implemented.
   void operator=(const XdmfGridTemplate &);  // Not implemented.
 
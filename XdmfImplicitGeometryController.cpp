@@ -0,0 +1,422 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfImplicitGeometryController.cpp                                  */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <climits>
+#include <limits>
+#include <sstream>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfError.hpp"
+#include "XdmfImplicitGeometryController.hpp"
+
+/**
+ * local functions
+ */
+namespace {
+
+  std::vector<double>
+  readAxis(const shared_ptr<XdmfArray> & axis)
+  {
+    bool releaseAxis = false;
+    if(!axis->isInitialized()) {
+      axis->read();
+      releaseAxis = true;
+    }
+    std::vector<double> toReturn(axis->getSize());
+    if(axis->getSize() > 0) {
+      axis->getValues(0, &toReturn[0], axis->getSize());
+    }
+    if(releaseAxis) {
+      axis->release();
+    }
+    return toReturn;
+  }
+
+  // Dataspace with one dimension per axis, last axis first, followed by
+  // the coordinates of each point. Each dimension fits an unsigned int
+  // however many points the grid has.
+  std::vector<unsigned int>
+  getStructuredDataspace(const std::vector<std::vector<double> > & axesCoordinates)
+  {
+    std::vector<unsigned int> toReturn;
+    for(unsigned int i=axesCoordinates.size(); i>0; --i) {
+      toReturn.push_back(axesCoordinates[i-1].size());
+    }
+    toReturn.push_back(axesCoordinates.size());
+    return toReturn;
+  }
+
+  unsigned long long
+  getNumberCoordinates(const std::vector<std::vector<double> > & axesCoordinates)
+  {
+    if(axesCoordinates.size() == 0) {
+      return 0;
+    }
+    unsigned long long numberCoordinates = axesCoordinates.size();
+    for(unsigned int i=0; i<axesCoordinates.size(); ++i) {
+      numberCoordinates *= axesCoordinates[i].size();
+    }
+    return numberCoordinates;
+  }
+
+  // Dataspace (number of points, number of axes) when the interleaved
+  // coordinates are addressable by an unsigned int, the structured
+  // dataspace otherwise. Both order the values the same way.
+  std::vector<unsigned int>
+  getPointDataspace(const std::vector<std::vector<double> > & axesCoordinates)
+  {
+    const unsigned long long numberCoordinates =
+      getNumberCoordinates(axesCoordinates);
+    if(numberCoordinates > UINT_MAX) {
+      return getStructuredDataspace(axesCoordinates);
+    }
+    std::vector<unsigned int> toReturn;
+    toReturn.push_back(axesCoordinates.size() == 0 ?
+                       0 : (unsigned int)(numberCoordinates / axesCoordinates.size()));
+    toReturn.push_back(axesCoordinates.size());
+    return toReturn;
+  }
+
+  template <typename T>
+  void
+  writeValues(std::ostream & stream,
+              const std::vector<T> & values)
+  {
+    stream << ";";
+    for(unsigned int i=0; i<values.size(); ++i) {
+      if(i > 0) {
+        stream << " ";
+      }
+      stream << values[i];
+    }
+  }
+
+}
+
+shared_ptr<XdmfImplicitGeometryController>
+XdmfImplicitGeometryController::New(const shared_ptr<XdmfRegularGrid> regularGrid)
+{
+  const std::vector<double> origin = readAxis(regularGrid->getOrigin());
+  const std::vector<double> brickSize = readAxis(regularGrid->getBrickSize());
+  const std::vector<double> dimensions =
+    readAxis(regularGrid->getDimensions());
+
+  std::vector<unsigned int> numberPoints(dimensions.size());
+  for(unsigned int i=0; i<dimensions.size(); ++i) {
+    numberPoints[i] = (unsigned int)dimensions[i];
+  }
+  return XdmfImplicitGeometryController::New(origin, brickSize, numberPoints);
+}
+
+shared_ptr<XdmfImplicitGeometryController>
+XdmfImplicitGeometryController::New(const std::vector<double> & origin,
+                                    const std::vector<double> & brickSize,
+                                    const std::vector<unsigned int> & numberPoints)
+{
+  if(numberPoints.size() != brickSize.size() ||
+     numberPoints.size() != origin.size()) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Inconsistent brick, dimension, and origin sizes in "
+                       "XdmfImplicitGeometryController::New");
+  }
+
+  std::vector<std::vector<double> > axesCoordinates(numberPoints.size());
+  for(unsigned int i=0; i<numberPoints.size(); ++i) {
+    axesCoordinates[i].resize(numberPoints[i]);
+    for(unsigned int j=0; j<numberPoints[i]; ++j) {
+      axesCoordinates[i][j] = origin[i] + j * brickSize[i];
+    }
+  }
+
+  const std::vector<unsigned int> dataspace =
+    getPointDataspace(axesCoordinates);
+  shared_ptr<XdmfImplicitGeometryController>
+    p(new XdmfImplicitGeometryController(axesCoordinates,
+                                         std::vector<unsigned int>(dataspace.size(), 0),
+                                         std::vector<unsigned int>(dataspace.size(), 1),
+                                         dataspace,
+                                         dataspace));
+  // Keep the regular description so it can be written compactly
+  p->mOrigin = origin;
+  p->mBrickSize = brickSize;
+  return p;
+}
+
+shared_ptr<XdmfImplicitGeometryController>
+XdmfImplicitGeometryController::New(const shared_ptr<XdmfRectilinearGrid> rectilinearGrid)
+{
+  const std::vector<shared_ptr<XdmfArray> > coordinates =
+    rectilinearGrid->getCoordinates();
+  std::vector<std::vector<double> > axesCoordinates(coordinates.size());
+  for(unsigned int i=0; i<coordinates.size(); ++i) {
+    axesCoordinates[i] = readAxis(coordinates[i]);
+  }
+  return XdmfImplicitGeometryController::New(axesCoordinates);
+}
+
+shared_ptr<XdmfImplicitGeometryController>
+XdmfImplicitGeometryController::New(const std::vector<std::vector<double> > & axesCoordinates)
+{
+  const std::vector<unsigned int> dataspace =
+    getPointDataspace(axesCoordinates);
+  shared_ptr<XdmfImplicitGeometryController>
+    p(new XdmfImplicitGeometryController(axesCoordinates,
+                                         std::vector<unsigned int>(dataspace.size(), 0),
+                                         std::vector<unsigned int>(dataspace.size(), 1),
+                                         dataspace,
+                                         dataspace));
+  return p;
+}
+
+shared_ptr<XdmfImplicitGeometryController>
+XdmfImplicitGeometryController::New(const std::vector<std::vector<double> > & axesCoordinates,
+                                    const std::vector<unsigned int> & starts,
+                                    const std::vector<unsigned int> & strides,
+                                    const std::vector<unsigned int> & dimensions)
+{
+  std::vector<unsigned int> dataspace = getPointDataspace(axesCoordinates);
+  if(starts.size() == 1) {
+    // Flat selection over the interleaved coordinates
+    const unsigned long long numberCoordinates =
+      getNumberCoordinates(axesCoordinates);
+    if(numberCoordinates > UINT_MAX) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Flat selection over more coordinates than an "
+                         "unsigned int addresses in "
+                         "XdmfImplicitGeometryController::New");
+    }
+    dataspace = std::vector<unsigned int>(1, (unsigned int)numberCoordinates);
+  }
+  else if(starts.size() != dataspace.size()) {
+    // Selection of a block along each axis
+    dataspace = getStructuredDataspace(axesCoordinates);
+  }
+  if(starts.size() != dataspace.size() ||
+     strides.size() != dataspace.size() ||
+     dimensions.size() != dataspace.size()) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Selection rank does not match dataspace rank in "
+                       "XdmfImplicitGeometryController::New");
+  }
+  for(unsigned int i=0; i<dataspace.size(); ++i) {
+    if(dimensions[i] > 0 &&
+       starts[i] + (unsigned long long)(dimensions[i] - 1) * strides[i] >=
+       dataspace[i]) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Selection exceeds dataspace in "
+                         "XdmfImplicitGeometryController::New");
+    }
+  }
+  shared_ptr<XdmfImplicitGeometryController>
+    p(new XdmfImplicitGeometryController(axesCoordinates,
+                                         starts,
+                                         strides,
+                                         dimensions,
+                                         dataspace));
+  return p;
+}
+
+XdmfImplicitGeometryController::XdmfImplicitGeometryController(const std::vector<std::vector<double> > & axesCoordinates,
+                                                               const std::vector<unsigned int> & starts,
+                                                               const std::vector<unsigned int> & strides,
+                                                               const std::vector<unsigned int> & dimensions,
+                                                               const std::vector<unsigned int> & dataspaces) :
+  XdmfHeavyDataController("",
+                          XdmfArrayType::Float64(),
+                          starts,
+                          strides,
+                          dimensions,
+                          dataspaces),
+  mAxesCoordinates(axesCoordinates)
+{
+}
+
+XdmfImplicitGeometryController::XdmfImplicitGeometryController(const XdmfImplicitGeometryController & refController) :
+  XdmfHeavyDataController(refController),
+  mAxesCoordinates(refController.mAxesCoordinates),
+  mOrigin(refController.mOrigin),
+  mBrickSize(refController.mBrickSize)
+{
+}
+
+XdmfImplicitGeometryController::~XdmfImplicitGeometryController()
+{
+}
+
+const std::vector<std::vector<double> > &
+XdmfImplicitGeometryController::getAxesCoordinates() const
+{
+  return mAxesCoordinates;
+}
+
+std::string
+XdmfImplicitGeometryController::getDescriptor() const
+{
+  std::stringstream descriptorStream;
+  descriptorStream.precision(std::numeric_limits<double>::digits10 + 2);
+  if(mOrigin.size() > 0) {
+    std::vector<unsigned int> numberPoints(mAxesCoordinates.size());
+    for(unsigned int i=0; i<mAxesCoordinates.size(); ++i) {
+      numberPoints[i] = mAxesCoordinates[i].size();
+    }
+    descriptorStream << "Regular";
+    writeValues(descriptorStream, mOrigin);
+    writeValues(descriptorStream, mBrickSize);
+    writeValues(descriptorStream, numberPoints);
+  }
+  else {
+    descriptorStream << "Rectilinear";
+    for(unsigned int i=0; i<mAxesCoordinates.size(); ++i) {
+      writeValues(descriptorStream, mAxesCoordinates[i]);
+    }
+  }
+  return descriptorStream.str();
+}
+
+std::string
+XdmfImplicitGeometryController::getName() const
+{
+  return "Implicit";
+}
+
+void
+XdmfImplicitGeometryController::getProperties(std::map<std::string, std::string> & collectedProperties) const
+{
+  // Generated values have no file to reference, the descriptor holds
+  // everything needed to generate them again.
+  collectedProperties["Format"] = "Implicit";
+}
+
+void
+XdmfImplicitGeometryController::read(XdmfArray * const array)
+{
+  unsigned long long selectionSize = 1;
+  for(unsigned int i=0; i<mDimensions.size(); ++i) {
+    selectionSize *= mDimensions[i];
+  }
+  if(selectionSize > UINT_MAX) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Selection holds more values than an XdmfArray in "
+                       "XdmfImplicitGeometryController::read, read a "
+                       "block of the points instead");
+  }
+
+  array->initialize(mType, mDimensions);
+
+  const unsigned int numberAxes = mAxesCoordinates.size();
+  const unsigned int size = (unsigned int)selectionSize;
+  if(size == 0 || numberAxes == 0) {
+    return;
+  }
+
+  double * values = static_cast<double *>(array->getValuesInternal());
+
+  bool isContiguous = true;
+  for(unsigned int i=0; i<mDimensions.size(); ++i) {
+    if(mStart[i] != 0 ||
+       mStride[i] != 1 ||
+       mDimensions[i] != mDataspaceDimensions[i]) {
+      isContiguous = false;
+      break;
+    }
+  }
+
+  if(isContiguous) {
+    // Whole dataspace, walk the point indices directly without
+    // decomposing each flat index.
+    std::vector<unsigned int> pointIndex(numberAxes, 0);
+    for(unsigned int i=0; i<size; i+=numberAxes) {
+      for(unsigned int j=0; j<numberAxes; ++j) {
+        values[i + j] = mAxesCoordinates[j][pointIndex[j]];
+      }
+      for(unsigned int j=0; j<numberAxes; ++j) {
+        if(++pointIndex[j] < mAxesCoordinates[j].size()) {
+          break;
+        }
+        pointIndex[j] = 0;
+      }
+    }
+    return;
+  }
+
+  // Arbitrary hyperslab, generate only the selected values.
+  const unsigned int rank = mDimensions.size();
+  std::vector<unsigned int> index(rank, 0);
+  for(unsigned int i=0; i<size; ++i) {
+    unsigned long long flatIndex = 0;
+    for(unsigned int j=0; j<rank; ++j) {
+      flatIndex = flatIndex * mDataspaceDimensions[j] +
+        mStart[j] + (unsigned long long)index[j] * mStride[j];
+    }
+    const unsigned int axis = flatIndex % numberAxes;
+    unsigned long long point = flatIndex / numberAxes;
+    for(unsigned int j=0; j<axis; ++j) {
+      point /= mAxesCoordinates[j].size();
+    }
+    values[i] = mAxesCoordinates[axis][point % mAxesCoordinates[axis].size()];
+
+    for(int j=rank-1; j>=0; --j) {
+      if(++index[j] < mDimensions[j]) {
+        break;
+      }
+      index[j] = 0;
+    }
+  }
+}
+
+// C Wrappers
+
+XDMFIMPLICITGEOMETRYCONTROLLER *
+XdmfImplicitGeometryControllerNewFromRegularGrid(XDMFREGULARGRID * regularGrid,
+                                                 int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  XdmfItem * tempPointer = (XdmfItem *)(regularGrid);
+  XdmfRegularGrid * classedPointer = dynamic_cast<XdmfRegularGrid *>(tempPointer);
+  shared_ptr<XdmfRegularGrid> originGrid =
+    shared_ptr<XdmfRegularGrid>(classedPointer, XdmfNullDeleter());
+  shared_ptr<XdmfImplicitGeometryController> generatedController =
+    XdmfImplicitGeometryController::New(originGrid);
+  return (XDMFIMPLICITGEOMETRYCONTROLLER *)((void *)(new XdmfImplicitGeometryController(*generatedController.get())));
+  XDMF_ERROR_WRAP_END(status)
+  return NULL;
+}
+
+XDMFIMPLICITGEOMETRYCONTROLLER *
+XdmfImplicitGeometryControllerNewFromRectilinearGrid(XDMFRECTILINEARGRID * rectilinearGrid,
+                                                     int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  XdmfItem * tempPointer = (XdmfItem *)(rectilinearGrid);
+  XdmfRectilinearGrid * classedPointer = dynamic_cast<XdmfRectilinearGrid *>(tempPointer);
+  shared_ptr<XdmfRectilinearGrid> originGrid =
+    shared_ptr<XdmfRectilinearGrid>(classedPointer, XdmfNullDeleter());
+  shared_ptr<XdmfImplicitGeometryController> generatedController =
+    XdmfImplicitGeometryController::New(originGrid);
+  return (XDMFIMPLICITGEOMETRYCONTROLLER *)((void *)(new XdmfImplicitGeometryController(*generatedController.get())));
+  XDMF_ERROR_WRAP_END(status)
+  return NULL;
+}
+
+// C Wrappers for parent classes are generated by macros
+XDMF_HEAVYCONTROLLER_C_CHILD_WRAPPER(XdmfImplicitGeometryController, XDMFIMPLICITGEOMETRYCONTROLLER)
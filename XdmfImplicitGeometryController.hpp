@@ -0,0 +1,186 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfImplicitGeometryController.hpp                                  */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef XDMFIMPLICITGEOMETRYCONTROLLER_HPP_
+#define XDMFIMPLICITGEOMETRYCONTROLLER_HPP_
+
+// C Compatible Includes
+#include "Xdmf.hpp"
+#include "XdmfHeavyDataController.hpp"
+#include "XdmfRectilinearGrid.hpp"
+#include "XdmfRegularGrid.hpp"
+
+#ifdef __cplusplus
+
+/**
+ * @brief Generates the point coordinates of a structured grid on demand.
+ *
+ * XdmfImplicitGeometryController couples an XdmfArray with the
+ * coordinates of an XdmfRegularGrid or XdmfRectilinearGrid without
+ * storing them. Only the coordinate values along each axis are kept;
+ * reading the controller computes the interleaved point coordinates
+ * for the selected block. The dataspace has dimensions
+ * (number of points, number of axes) with the first axis varying
+ * fastest, matching the point ordering used when converting a
+ * structured grid to an XdmfUnstructuredGrid. Grids with more
+ * coordinates than an unsigned int addresses use a dataspace with one
+ * dimension per axis instead, last axis first, followed by the number
+ * of axes. Blocks may be selected in either dataspace, though only
+ * blocks an XdmfArray can hold may be read.
+ *
+ * Since nothing is stored on disk, XdmfWriter generates the values
+ * and writes them like any other array. When
+ * XdmfWriter::setWriteImplicit is enabled it instead records the
+ * origin, brick size and number of points of a regular grid (or the
+ * axis coordinates of a rectilinear grid) in place of values
+ * exceeding the light data limit, with Format="Implicit". Heavy data
+ * writers visited directly replace this controller with their own
+ * when the array is written.
+ */
+class XDMF_EXPORT XdmfImplicitGeometryController : public XdmfHeavyDataController {
+
+public:
+
+  virtual ~XdmfImplicitGeometryController();
+
+  /**
+   * Create a new controller generating the points of a regular grid.
+   *
+   * @param     regularGrid     The grid to generate points for.
+   *
+   * @return    New Implicit Geometry Controller.
+   */
+  static shared_ptr<XdmfImplicitGeometryController>
+  New(const shared_ptr<XdmfRegularGrid> regularGrid);
+
+  /**
+   * Create a new controller generating the points of a rectilinear grid.
+   *
+   * @param     rectilinearGrid The grid to generate points for.
+   *
+   * @return    New Implicit Geometry Controller.
+   */
+  static shared_ptr<XdmfImplicitGeometryController>
+  New(const shared_ptr<XdmfRectilinearGrid> rectilinearGrid);
+
+  /**
+   * Create a new controller generating the points defined by the
+   * provided axis coordinates.
+   *
+   * @param     axesCoordinates The coordinate values along each axis.
+   *
+   * @return    New Implicit Geometry Controller.
+   */
+  static shared_ptr<XdmfImplicitGeometryController>
+  New(const std::vector<std::vector<double> > & axesCoordinates);
+
+  /**
+   * Create a new controller generating the points of a regular grid
+   * described by its origin, brick size and number of points.
+   *
+   * @param     origin          The coordinates of the first point.
+   * @param     brickSize       The distance between points along each axis.
+   * @param     numberPoints    The number of points along each axis.
+   *
+   * @return    New Implicit Geometry Controller.
+   */
+  static shared_ptr<XdmfImplicitGeometryController>
+  New(const std::vector<double> & origin,
+      const std::vector<double> & brickSize,
+      const std::vector<unsigned int> & numberPoints);
+
+  /**
+   * Create a new controller generating a block of the points defined
+   * by the provided axis coordinates.
+   *
+   * @param     axesCoordinates The coordinate values along each axis.
+   * @param     starts          Starting index for each dimension
+   * @param     strides         Distance between read values across the dataspace
+   * @param     dimensions      Number of elements to select in each dimension
+   *
+   * @return    New Implicit Geometry Controller.
+   */
+  static shared_ptr<XdmfImplicitGeometryController>
+  New(const std::vector<std::vector<double> > & axesCoordinates,
+      const std::vector<unsigned int> & starts,
+      const std::vector<unsigned int> & strides,
+      const std::vector<unsigned int> & dimensions);
+
+  /**
+   * Gets the coordinate values along each axis used to generate points.
+   *
+   * @return    The coordinate values along each axis.
+   */
+  const std::vector<std::vector<double> > & getAxesCoordinates() const;
+
+  virtual std::string getDescriptor() const;
+
+  virtual std::string getName() const;
+
+  virtual void
+  getProperties(std::map<std::string, std::string> & collectedProperties) const;
+
+  virtual void read(XdmfArray * const array);
+
+  XdmfImplicitGeometryController(const XdmfImplicitGeometryController &);
+
+protected:
+
+  XdmfImplicitGeometryController(const std::vector<std::vector<double> > & axesCoordinates,
+                                 const std::vector<unsigned int> & starts,
+                                 const std::vector<unsigned int> & strides,
+                                 const std::vector<unsigned int> & dimensions,
+                                 const std::vector<unsigned int> & dataspaces);
+
+private:
+
+  void operator=(const XdmfImplicitGeometryController &);  // Not implemented.
+
+  const std::vector<std::vector<double> > mAxesCoordinates;
+  std::vector<double> mOrigin;
+  std::vector<double> mBrickSize;
+
+};
+
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C wrappers go here
+
+struct XDMFIMPLICITGEOMETRYCONTROLLER; // Simply as a typedef to ensure correct typing
+typedef struct XDMFIMPLICITGEOMETRYCONTROLLER XDMFIMPLICITGEOMETRYCONTROLLER;
+
+XDMF_EXPORT XDMFIMPLICITGEOMETRYCONTROLLER * XdmfImplicitGeometryControllerNewFromRegularGrid(XDMFREGULARGRID * regularGrid, int * status);
+
+XDMF_EXPORT XDMFIMPLICITGEOMETRYCONTROLLER * XdmfImplicitGeometryControllerNewFromRectilinearGrid(XDMFRECTILINEARGRID * rectilinearGrid, int * status);
+
+XDMF_HEAVYCONTROLLER_C_CHILD_DECLARE(XdmfImplicitGeometryController, XDMFIMPLICITGEOMETRYCONTROLLER, XDMF)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XDMFIMPLICITGEOMETRYCONTROLLER_HPP_ */
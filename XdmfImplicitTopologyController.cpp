@@ -0,0 +1,368 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfImplicitTopologyController.cpp                                  */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <climits>
+#include <sstream>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfError.hpp"
+#include "XdmfImplicitTopologyController.hpp"
+
+/**
+ * local functions
+ */
+namespace {
+
+  void
+  checkPointDimensions(const std::vector<unsigned int> & pointDimensions)
+  {
+    if(pointDimensions.size() != 2 && pointDimensions.size() != 3) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Cannot generate connectivity for structured grids "
+                         "of dimensions not 2 or 3 in "
+                         "XdmfImplicitTopologyController");
+    }
+  }
+
+  unsigned long long
+  getNumberPoints(const std::vector<unsigned int> & pointDimensions)
+  {
+    unsigned long long numberPoints = 1;
+    for(unsigned int i=0; i<pointDimensions.size(); ++i) {
+      numberPoints *= pointDimensions[i];
+    }
+    return numberPoints;
+  }
+
+  // Dataspace with one dimension per axis of cells, last axis first,
+  // followed by the nodes per element. Each dimension fits an unsigned
+  // int however many elements the grid has.
+  std::vector<unsigned int>
+  getStructuredDataspace(const std::vector<unsigned int> & pointDimensions)
+  {
+    checkPointDimensions(pointDimensions);
+    std::vector<unsigned int> toReturn;
+    for(unsigned int i=pointDimensions.size(); i>0; --i) {
+      toReturn.push_back(pointDimensions[i-1] < 2 ?
+                         0 : pointDimensions[i-1] - 1);
+    }
+    toReturn.push_back(1 << pointDimensions.size());
+    return toReturn;
+  }
+
+  // Dataspace (number of elements, nodes per element) when the
+  // connectivity is addressable by an unsigned int, the structured
+  // dataspace otherwise. Both order the values the same way.
+  std::vector<unsigned int>
+  getElementDataspace(const std::vector<unsigned int> & pointDimensions)
+  {
+    const std::vector<unsigned int> structuredDataspace =
+      getStructuredDataspace(pointDimensions);
+    unsigned long long numberValues = 1;
+    for(unsigned int i=0; i<structuredDataspace.size(); ++i) {
+      numberValues *= structuredDataspace[i];
+    }
+    if(numberValues > UINT_MAX) {
+      return structuredDataspace;
+    }
+    const unsigned int nodesPerElement = structuredDataspace.back();
+    std::vector<unsigned int> toReturn;
+    toReturn.push_back((unsigned int)(numberValues / nodesPerElement));
+    toReturn.push_back(nodesPerElement);
+    return toReturn;
+  }
+
+  template <typename T>
+  void
+  generateConnectivity(T * values,
+                       const unsigned int size,
+                       const std::vector<unsigned int> & pointDimensions,
+                       const std::vector<unsigned long long> & nodeOffsets,
+                       const std::vector<unsigned int> & start,
+                       const std::vector<unsigned int> & stride,
+                       const std::vector<unsigned int> & dimensions,
+                       const std::vector<unsigned int> & dataspaceDimensions)
+  {
+    const unsigned int nodesPerElement = nodeOffsets.size();
+    const unsigned int numberAxes = pointDimensions.size();
+
+    bool isContiguous = true;
+    for(unsigned int i=0; i<dimensions.size(); ++i) {
+      if(start[i] != 0 ||
+         stride[i] != 1 ||
+         dimensions[i] != dataspaceDimensions[i]) {
+        isContiguous = false;
+        break;
+      }
+    }
+
+    if(isContiguous) {
+      // Whole dataspace, step through the cells keeping track of the
+      // first node of each.
+      std::vector<unsigned int> cellIndex(numberAxes, 0);
+      unsigned long long offset = 0;
+      for(unsigned int i=0; i<size; i+=nodesPerElement) {
+        for(unsigned int j=0; j<nodesPerElement; ++j) {
+          values[i + j] = (T)(offset + nodeOffsets[j]);
+        }
+        ++offset;
+        unsigned long long axisStride = 1;
+        for(unsigned int j=0; j<numberAxes; ++j) {
+          if(++cellIndex[j] < pointDimensions[j] - 1) {
+            break;
+          }
+          // Skip the last point along this axis
+          cellIndex[j] = 0;
+          offset += axisStride;
+          axisStride *= pointDimensions[j];
+        }
+      }
+      return;
+    }
+
+    // Arbitrary hyperslab, generate only the selected values.
+    const unsigned int rank = dimensions.size();
+    std::vector<unsigned int> index(rank, 0);
+    for(unsigned int i=0; i<size; ++i) {
+      unsigned long long flatIndex = 0;
+      for(unsigned int j=0; j<rank; ++j) {
+        flatIndex = flatIndex * dataspaceDimensions[j] +
+          start[j] + (unsigned long long)index[j] * stride[j];
+      }
+      const unsigned int node = flatIndex % nodesPerElement;
+      unsigned long long element = flatIndex / nodesPerElement;
+      unsigned long long firstNode = 0;
+      unsigned long long axisStride = 1;
+      for(unsigned int j=0; j<numberAxes; ++j) {
+        firstNode += (element % (pointDimensions[j] - 1)) * axisStride;
+        element /= pointDimensions[j] - 1;
+        axisStride *= pointDimensions[j];
+      }
+      values[i] = (T)(firstNode + nodeOffsets[node]);
+
+      for(int j=rank-1; j>=0; --j) {
+        if(++index[j] < dimensions[j]) {
+          break;
+        }
+        index[j] = 0;
+      }
+    }
+  }
+
+}
+
+shared_ptr<XdmfImplicitTopologyController>
+XdmfImplicitTopologyController::New(const std::vector<unsigned int> & pointDimensions)
+{
+  const std::vector<unsigned int> dataspace =
+    getElementDataspace(pointDimensions);
+  shared_ptr<XdmfImplicitTopologyController>
+    p(new XdmfImplicitTopologyController(pointDimensions,
+                                         std::vector<unsigned int>(dataspace.size(), 0),
+                                         std::vector<unsigned int>(dataspace.size(), 1),
+                                         dataspace,
+                                         dataspace));
+  return p;
+}
+
+shared_ptr<XdmfImplicitTopologyController>
+XdmfImplicitTopologyController::New(const std::vector<unsigned int> & pointDimensions,
+                                    const std::vector<unsigned int> & starts,
+                                    const std::vector<unsigned int> & strides,
+                                    const std::vector<unsigned int> & dimensions)
+{
+  std::vector<unsigned int> dataspace = getElementDataspace(pointDimensions);
+  if(starts.size() == 1) {
+    // Flat selection over the interleaved connectivity
+    if(dataspace.size() != 2) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Flat selection over more connectivity values "
+                         "than an unsigned int addresses in "
+                         "XdmfImplicitTopologyController::New");
+    }
+    dataspace = std::vector<unsigned int>(1, dataspace[0] * dataspace[1]);
+  }
+  else if(starts.size() != dataspace.size()) {
+    // Selection of a block of cells along each axis
+    dataspace = getStructuredDataspace(pointDimensions);
+  }
+  if(starts.size() != dataspace.size() ||
+     strides.size() != dataspace.size() ||
+     dimensions.size() != dataspace.size()) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Selection rank does not match dataspace rank in "
+                       "XdmfImplicitTopologyController::New");
+  }
+  for(unsigned int i=0; i<dataspace.size(); ++i) {
+    if(dimensions[i] > 0 &&
+       starts[i] + (unsigned long long)(dimensions[i] - 1) * strides[i] >=
+       dataspace[i]) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Selection exceeds dataspace in "
+                         "XdmfImplicitTopologyController::New");
+    }
+  }
+  shared_ptr<XdmfImplicitTopologyController>
+    p(new XdmfImplicitTopologyController(pointDimensions,
+                                         starts,
+                                         strides,
+                                         dimensions,
+                                         dataspace));
+  return p;
+}
+
+XdmfImplicitTopologyController::XdmfImplicitTopologyController(const std::vector<unsigned int> & pointDimensions,
+                                                               const std::vector<unsigned int> & starts,
+                                                               const std::vector<unsigned int> & strides,
+                                                               const std::vector<unsigned int> & dimensions,
+                                                               const std::vector<unsigned int> & dataspaces) :
+  XdmfHeavyDataController("",
+                          getNumberPoints(pointDimensions) > UINT_MAX ?
+                          XdmfArrayType::Int64() : XdmfArrayType::UInt32(),
+                          starts,
+                          strides,
+                          dimensions,
+                          dataspaces),
+  mPointDimensions(pointDimensions)
+{
+  // Node ids of an element relative to its first node, in the same
+  // order as XdmfTopologyType::Quadrilateral and Hexahedron.
+  const unsigned long long nx = mPointDimensions[0];
+  mNodeOffsets.push_back(0);
+  mNodeOffsets.push_back(1);
+  mNodeOffsets.push_back(nx + 1);
+  mNodeOffsets.push_back(nx);
+  if(mPointDimensions.size() == 3) {
+    const unsigned long long zOffset = nx * mPointDimensions[1];
+    for(unsigned int i=0; i<4; ++i) {
+      mNodeOffsets.push_back(zOffset + mNodeOffsets[i]);
+    }
+  }
+}
+
+XdmfImplicitTopologyController::XdmfImplicitTopologyController(const XdmfImplicitTopologyController & refController) :
+  XdmfHeavyDataController(refController),
+  mPointDimensions(refController.mPointDimensions),
+  mNodeOffsets(refController.mNodeOffsets)
+{
+}
+
+XdmfImplicitTopologyController::~XdmfImplicitTopologyController()
+{
+}
+
+std::string
+XdmfImplicitTopologyController::getDescriptor() const
+{
+  std::stringstream descriptorStream;
+  descriptorStream << "Structured;";
+  for(unsigned int i=0; i<mPointDimensions.size(); ++i) {
+    if(i > 0) {
+      descriptorStream << " ";
+    }
+    descriptorStream << mPointDimensions[i];
+  }
+  return descriptorStream.str();
+}
+
+std::string
+XdmfImplicitTopologyController::getName() const
+{
+  return "Implicit";
+}
+
+std::vector<unsigned int>
+XdmfImplicitTopologyController::getPointDimensions() const
+{
+  return mPointDimensions;
+}
+
+void
+XdmfImplicitTopologyController::getProperties(std::map<std::string, std::string> & collectedProperties) const
+{
+  // Generated values have no file to reference, the descriptor holds
+  // everything needed to generate them again.
+  collectedProperties["Format"] = "Implicit";
+}
+
+void
+XdmfImplicitTopologyController::read(XdmfArray * const array)
+{
+  unsigned long long selectionSize = 1;
+  for(unsigned int i=0; i<mDimensions.size(); ++i) {
+    selectionSize *= mDimensions[i];
+  }
+  if(selectionSize > UINT_MAX) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Selection holds more values than an XdmfArray in "
+                       "XdmfImplicitTopologyController::read, read a "
+                       "block of the connectivity instead");
+  }
+
+  array->initialize(mType, mDimensions);
+
+  const unsigned int size = (unsigned int)selectionSize;
+  if(size == 0) {
+    return;
+  }
+
+  if(mType == XdmfArrayType::Int64()) {
+    generateConnectivity(static_cast<long *>(array->getValuesInternal()),
+                         size,
+                         mPointDimensions,
+                         mNodeOffsets,
+                         mStart,
+                         mStride,
+                         mDimensions,
+                         mDataspaceDimensions);
+  }
+  else {
+    generateConnectivity(static_cast<unsigned int *>(array->getValuesInternal()),
+                         size,
+                         mPointDimensions,
+                         mNodeOffsets,
+                         mStart,
+                         mStride,
+                         mDimensions,
+                         mDataspaceDimensions);
+  }
+}
+
+// C Wrappers
+
+XDMFIMPLICITTOPOLOGYCONTROLLER *
+XdmfImplicitTopologyControllerNew(unsigned int * pointDimensions,
+                                  unsigned int numDims,
+                                  int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  std::vector<unsigned int> dimVector(pointDimensions, pointDimensions + numDims);
+  shared_ptr<XdmfImplicitTopologyController> generatedController =
+    XdmfImplicitTopologyController::New(dimVector);
+  return (XDMFIMPLICITTOPOLOGYCONTROLLER *)((void *)(new XdmfImplicitTopologyController(*generatedController.get())));
+  XDMF_ERROR_WRAP_END(status)
+  return NULL;
+}
+
+// C Wrappers for parent classes are generated by macros
+XDMF_HEAVYCONTROLLER_C_CHILD_WRAPPER(XdmfImplicitTopologyController, XDMFIMPLICITTOPOLOGYCONTROLLER)
@@ -0,0 +1,145 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfImplicitTopologyController.hpp                                  */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef XDMFIMPLICITTOPOLOGYCONTROLLER_HPP_
+#define XDMFIMPLICITTOPOLOGYCONTROLLER_HPP_
+
+// C Compatible Includes
+#include "Xdmf.hpp"
+#include "XdmfHeavyDataController.hpp"
+
+#ifdef __cplusplus
+
+/**
+ * @brief Generates the connectivity of a structured grid on demand.
+ *
+ * XdmfImplicitTopologyController couples an XdmfArray with the
+ * quadrilateral (2D) or hexahedral (3D) connectivity of a structured
+ * grid of the given point dimensions without storing it. Reading the
+ * controller computes the node ids of the selected block. The
+ * dataspace has dimensions (number of elements, nodes per element)
+ * with the first dimension varying fastest, matching the connectivity
+ * used when converting a structured grid to an XdmfUnstructuredGrid.
+ * Grids with more connectivity values than an unsigned int addresses
+ * use a dataspace with one dimension per axis of cells instead, last
+ * axis first, followed by the nodes per element. Node ids are 64 bit
+ * once the grid has more points than an unsigned int addresses.
+ *
+ * Since nothing is stored on disk, XdmfWriter generates the values
+ * and writes them like any other array. When
+ * XdmfWriter::setWriteImplicit is enabled it instead records the point
+ * dimensions in place of values exceeding the light data limit, with
+ * Format="Implicit". Heavy data writers visited directly replace this
+ * controller with their own when the array is written.
+ */
+class XDMF_EXPORT XdmfImplicitTopologyController : public XdmfHeavyDataController {
+
+public:
+
+  virtual ~XdmfImplicitTopologyController();
+
+  /**
+   * Create a new controller generating the connectivity of a structured
+   * grid.
+   *
+   * @param     pointDimensions The number of points along each axis.
+   *
+   * @return    New Implicit Topology Controller.
+   */
+  static shared_ptr<XdmfImplicitTopologyController>
+  New(const std::vector<unsigned int> & pointDimensions);
+
+  /**
+   * Create a new controller generating a block of the connectivity of a
+   * structured grid.
+   *
+   * @param     pointDimensions The number of points along each axis.
+   * @param     starts          Starting index for each dimension
+   * @param     strides         Distance between read values across the dataspace
+   * @param     dimensions      Number of elements to select in each dimension
+   *
+   * @return    New Implicit Topology Controller.
+   */
+  static shared_ptr<XdmfImplicitTopologyController>
+  New(const std::vector<unsigned int> & pointDimensions,
+      const std::vector<unsigned int> & starts,
+      const std::vector<unsigned int> & strides,
+      const std::vector<unsigned int> & dimensions);
+
+  virtual std::string getDescriptor() const;
+
+  virtual std::string getName() const;
+
+  /**
+   * Gets the number of points along each axis of the structured grid.
+   *
+   * @return    The number of points along each axis.
+   */
+  std::vector<unsigned int> getPointDimensions() const;
+
+  virtual void
+  getProperties(std::map<std::string, std::string> & collectedProperties) const;
+
+  virtual void read(XdmfArray * const array);
+
+  XdmfImplicitTopologyController(const XdmfImplicitTopologyController &);
+
+protected:
+
+  XdmfImplicitTopologyController(const std::vector<unsigned int> & pointDimensions,
+                                 const std::vector<unsigned int> & starts,
+                                 const std::vector<unsigned int> & strides,
+                                 const std::vector<unsigned int> & dimensions,
+                                 const std::vector<unsigned int> & dataspaces);
+
+private:
+
+  void operator=(const XdmfImplicitTopologyController &);  // Not implemented.
+
+  const std::vector<unsigned int> mPointDimensions;
+  std::vector<unsigned long long> mNodeOffsets;
+
+};
+
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C wrappers go here
+
+struct XDMFIMPLICITTOPOLOGYCONTROLLER; // Simply as a typedef to ensure correct typing
+typedef struct XDMFIMPLICITTOPOLOGYCONTROLLER XDMFIMPLICITTOPOLOGYCONTROLLER;
+
+XDMF_EXPORT XDMFIMPLICITTOPOLOGYCONTROLLER * XdmfImplicitTopologyControllerNew(unsigned int * pointDimensions,
+                                                                               unsigned int numDims,
+                                                                               int * status);
+
+XDMF_HEAVYCONTROLLER_C_CHILD_DECLARE(XdmfImplicitTopologyController, XDMFIMPLICITTOPOLOGYCONTROLLER, XDMF)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XDMFIMPLICITTOPOLOGYCONTROLLER_HPP_ */
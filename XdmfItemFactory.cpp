@@ -22,6 +22,7 @@
 /*****************************************************************************/
 
 #include <cctype>
+#include <cstdlib>
 #include <boost/tokenizer.hpp>
 #include "XdmfAttribute.hpp"
 #include "XdmfCurvilinearGrid.hpp"
@@ -33,6 +34,8 @@
 #include "XdmfGraph.hpp"
 #include "XdmfGridCollection.hpp"
 #include "XdmfGridTemplate.hpp"
+#include "XdmfImplicitGeometryController.hpp"
+#include "XdmfImplicitTopologyController.hpp"
 #include "XdmfInformation.hpp"
 #include "XdmfItemFactory.hpp"
 #include "XdmfAggregate.hpp"
@@ -307,6 +310,182 @@ XdmfItemFactory::createItem(const std::string & itemTag,
   return shared_ptr<XdmfItem>();
 }
 
+/**
+ * local functions
+ */
+namespace {
+
+  // Split a string at every occurrence of separator, keeping empty parts
+  std::vector<std::string>
+  splitDescription(const std::string & description,
+                   const char separator)
+  {
+    std::vector<std::string> toReturn;
+    size_t start = 0;
+    size_t split = description.find(separator);
+    while(split != std::string::npos) {
+      toReturn.push_back(description.substr(start, split - start));
+      start = split + 1;
+      split = description.find(separator, start);
+    }
+    toReturn.push_back(description.substr(start));
+    return toReturn;
+  }
+
+  template <typename T>
+  std::vector<T>
+  parseValues(const std::string & values)
+  {
+    std::vector<T> toReturn;
+    boost::char_separator<char> sep(" \t\n");
+    boost::tokenizer<boost::char_separator<char> > tokens(values, sep);
+    for(boost::tokenizer<boost::char_separator<char> >::const_iterator
+          iter = tokens.begin();
+        iter != tokens.end();
+        ++iter) {
+      toReturn.push_back((T)atof((*iter).c_str()));
+    }
+    return toReturn;
+  }
+
+}
+
+std::vector<shared_ptr<XdmfHeavyDataController> >
+XdmfItemFactory::generateHeavyDataControllers(const std::map<std::string, std::string> & itemProperties,
+                                              const std::vector<unsigned int> & passedDimensions,
+                                              shared_ptr<const XdmfArrayType> passedArrayType,
+                                              const std::string & passedFormat) const
+{
+#ifdef XDMF_BUILD_DSM
+  std::vector<shared_ptr<XdmfHeavyDataController> > returnControllers =
+    XdmfDSMItemFactory::generateHeavyDataControllers(itemProperties,
+                                                     passedDimensions,
+                                                     passedArrayType,
+                                                     passedFormat);
+#else
+  std::vector<shared_ptr<XdmfHeavyDataController> > returnControllers =
+    XdmfCoreItemFactory::generateHeavyDataControllers(itemProperties,
+                                                      passedDimensions,
+                                                      passedArrayType,
+                                                      passedFormat);
+#endif
+
+  if (returnControllers.size() > 0)
+  {
+    return returnControllers;
+  }
+
+  std::string formatVal = passedFormat;
+  if (formatVal.size() == 0)
+  {
+    std::map<std::string, std::string>::const_iterator format =
+      itemProperties.find("Format");
+    if(format != itemProperties.end()) {
+      formatVal = format->second;
+    }
+  }
+
+  if(formatVal.compare("Implicit") != 0) {
+    return returnControllers;
+  }
+
+  std::map<std::string, std::string>::const_iterator content =
+    itemProperties.find("Content");
+  if(content == itemProperties.end()) {
+    XdmfError::message(XdmfError::FATAL,
+                       "'Content' not found in generateHeavyControllers in "
+                       "XdmfItemFactory");
+  }
+
+  // Each controller is written as its description followed, when only
+  // part of the values are used, by start:stride:dimensions:dataspace
+  const std::vector<std::string> contentVals =
+    splitDescription(content->second, '|');
+
+  unsigned int arrayOffset = 0;
+  unsigned int contentIndex = 0;
+  while(contentIndex < contentVals.size()) {
+    const std::string descriptor = contentVals[contentIndex];
+    const std::vector<std::string> description =
+      splitDescription(descriptor, ';');
+
+    std::vector<std::vector<unsigned int> > selection;
+    if(contentIndex + 1 < contentVals.size()) {
+      const std::vector<std::string> dataspaceVals =
+        splitDescription(contentVals[contentIndex + 1], ':');
+      if(dataspaceVals.size() != 4) {
+        XdmfError::message(XdmfError::FATAL,
+                           "Invalid dataspace description in "
+                           "generateHeavyControllers in XdmfItemFactory");
+      }
+      for(unsigned int i=0; i<3; ++i) {
+        selection.push_back(parseValues<unsigned int>(dataspaceVals[i]));
+      }
+      contentIndex += 2;
+    }
+    else {
+      contentIndex += 1;
+    }
+
+    shared_ptr<XdmfHeavyDataController> newController;
+    if(description[0].compare("Regular") == 0 && description.size() == 4) {
+      shared_ptr<XdmfImplicitGeometryController> regularController =
+        XdmfImplicitGeometryController::New(parseValues<double>(description[1]),
+                                            parseValues<double>(description[2]),
+                                            parseValues<unsigned int>(description[3]));
+      if(selection.size() == 0) {
+        newController = regularController;
+      }
+      else {
+        newController =
+          XdmfImplicitGeometryController::New(regularController->getAxesCoordinates(),
+                                              selection[0],
+                                              selection[1],
+                                              selection[2]);
+      }
+    }
+    else if(description[0].compare("Rectilinear") == 0) {
+      std::vector<std::vector<double> > axesCoordinates;
+      for(unsigned int i=1; i<description.size(); ++i) {
+        axesCoordinates.push_back(parseValues<double>(description[i]));
+      }
+      if(selection.size() == 0) {
+        newController = XdmfImplicitGeometryController::New(axesCoordinates);
+      }
+      else {
+        newController = XdmfImplicitGeometryController::New(axesCoordinates,
+                                                            selection[0],
+                                                            selection[1],
+                                                            selection[2]);
+      }
+    }
+    else if(description[0].compare("Structured") == 0 &&
+            description.size() == 2) {
+      const std::vector<unsigned int> pointDimensions =
+        parseValues<unsigned int>(description[1]);
+      if(selection.size() == 0) {
+        newController = XdmfImplicitTopologyController::New(pointDimensions);
+      }
+      else {
+        newController = XdmfImplicitTopologyController::New(pointDimensions,
+                                                            selection[0],
+                                                            selection[1],
+                                                            selection[2]);
+      }
+    }
+    else {
+      XdmfError::message(XdmfError::FATAL,
+                         "Unknown implicit description '" + descriptor +
+                         "' in generateHeavyControllers in XdmfItemFactory");
+    }
+    newController->setArrayOffset(arrayOffset);
+    arrayOffset += newController->getSize();
+    returnControllers.push_back(newController);
+  }
+
+  return returnControllers;
+}
+
 bool
 XdmfItemFactory::isArrayTag(char * tag) const
 {
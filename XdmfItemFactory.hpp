@@ -80,6 +80,12 @@ public:
              const std::map<std::string, std::string> & itemProperties,
              const std::vector<shared_ptr<XdmfItem> > & childItems) const;
 
+  virtual std::vector<shared_ptr<XdmfHeavyDataController> >
+  generateHeavyDataControllers(const std::map<std::string, std::string> & itemProperties,
+                               const std::vector<unsigned int> & passedDimensions = std::vector<unsigned int>(),
+                               shared_ptr<const XdmfArrayType> passedArrayType = shared_ptr<const XdmfArrayType>(),
+                               const std::string & passedFormat = std::string()) const;
+
   virtual bool isArrayTag(char * tag) const;
 
   virtual XdmfItem *
@@ -366,6 +366,7 @@ XdmfMap::setMap(std::map<task_id, node_id_map> map)
 void
 XdmfMap::setName(const std::string & name)
 {
+  XdmfChildIndex::rename(*this);
   mName = name;
   this->setIsChanged(true);
 }
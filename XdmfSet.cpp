@@ -122,6 +122,7 @@ XdmfSet::populateItem(const std::map<std::string, std::string> & itemProperties,
 void
 XdmfSet::setName(const std::string & name)
 {
+  XdmfChildIndex::rename(*this);
   mName = name;
   this->setIsChanged(true);
 }
@@ -21,12 +21,16 @@
 /*                                                                           */
 /*****************************************************************************/
 
+#include <algorithm>
 #include <sstream>
 #include <utility>
 #include <climits>
+#include <cstring>
 #include <set>
 #include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
 #include "XdmfHDF5Controller.hpp"
+#include "XdmfHDF5Writer.hpp"
 #include "XdmfBinaryController.hpp"
 #include "XdmfItem.hpp"
 #include "XdmfItemFactory.hpp"
@@ -42,69 +46,54 @@
 
 #include <stdio.h>
 
+std::vector<unsigned int>
+getControllerStarts(const std::vector<shared_ptr<XdmfHeavyDataController> > & datasetControllers)
+{
+  // Offset of each controller within the dataset, followed by the dataset size
+  std::vector<unsigned int> returnVector(1, 0);
+  for (unsigned int i = 0; i < datasetControllers.size(); ++i)
+  {
+    returnVector.push_back(returnVector.back() + datasetControllers[i]->getSize());
+  }
+  return returnVector;
+}
+
 std::vector<shared_ptr<XdmfHeavyDataController> >
-getStepControllers(unsigned int stepId,
-                   std::vector<unsigned int> stepDims,
-                   std::vector<shared_ptr<XdmfHeavyDataController> > datasetControllers)
+getDatasetControllers(unsigned int offset,
+                      unsigned int size,
+                      const std::vector<shared_ptr<XdmfHeavyDataController> > & datasetControllers,
+                      const std::vector<unsigned int> & controllerStarts)
 {
   std::vector<shared_ptr<XdmfHeavyDataController> > returnVector;
   if (datasetControllers.size() > 0)
   {
-    unsigned int sizePerStep = 1;
-    for (unsigned int i = 0; i < stepDims.size(); ++i)
-    {
-      sizePerStep *= stepDims[i];
+    // Find the controller that the section starts in
+    unsigned int controllerIndex =
+      std::upper_bound(controllerStarts.begin() + 1, controllerStarts.end(), offset) -
+      (controllerStarts.begin() + 1);
+    if (controllerIndex >= datasetControllers.size()) {
+      XdmfError::message(XdmfError::FATAL, "Error: Step does not fit in data step provided");
     }
-//    unsigned int offset = (sizePerStep * stepId);
-//    unsigned int offsetStepsRemaining = 0;
-    unsigned int offset = 0;
-    unsigned int offsetStepsRemaining = stepId;
+    offset -= controllerStarts[controllerIndex];
     // grabbing the subset is a little different for each type
     // Right now we assume controllers are of the same type
-    unsigned int controllerIndex = 0;
-    unsigned int sizeRemaining = sizePerStep;
+    unsigned int sizeRemaining = size;
     unsigned int arrayoffset = 0;
     while (sizeRemaining > 0)
     {
-//printf("sizeRemaining = %u\n", sizeRemaining);
-      // We don't reset the controller index between runs of the while loop
-      // On iterations after the first it should only execute the loop once
-      // because offset is set to 0
-      while (controllerIndex < datasetControllers.size())
+      // Skip over empty controllers
+      while (controllerIndex < datasetControllers.size() &&
+             datasetControllers[controllerIndex]->getSize() == 0)
       {
-//printf("offset = %u\n", offset);
-//printf("%u >= %u\n", offset, datasetControllers[controllerIndex]->getSize());
-        //Iterate until we find the controller that the step starts in
-        if (offset >= datasetControllers[controllerIndex]->getSize())
-        {
-          offset -= datasetControllers[controllerIndex]->getSize();
-          ++controllerIndex;
-        }
-        else
-        {
-          if (offsetStepsRemaining == 0)
-          {
-            // offset is within the current controller
-            break;
-          }
-          else
-          {
-            // There are steps left to offset
-//printf("accounting for step %d\n", offsetStepsRemaining);
-            offset += sizePerStep;
-            --offsetStepsRemaining;
-          }
-        }
+        ++controllerIndex;
+      }
+      if (controllerIndex >= datasetControllers.size()) {
+        XdmfError::message(XdmfError::FATAL, "Error: Step does not fit in data step provided");
       }
-//printf("final offset = %u\n", offset);
       std::vector<unsigned int> newDimVector;
       std::vector<unsigned int> newStarts;
-//printf("after creating dim vector but before filling it\n");
-//printf("%d < %d\n", controllerIndex, datasetControllers.size());
-//printf("size left %d\n", sizeRemaining);
       if (offset + sizeRemaining <= datasetControllers[controllerIndex]->getSize())
       {
-//printf("step is entirely in the controller\n");
         // step is entirely within this controller
         newStarts.push_back(offset + datasetControllers[controllerIndex]->getStart()[0]); // TODO multidim version
         newDimVector.push_back(sizeRemaining);
@@ -112,19 +101,15 @@ getStepControllers(unsigned int stepId,
       }
       else
       {
-//printf("step is partially in the controller\n");
         if (controllerIndex + 1 >= datasetControllers.size()) {
           // Error, step doesn't fit in the data set provided
           XdmfError::message(XdmfError::FATAL, "Error: Step does not fit in data step provided");
         }
         // step is partially in this controller
-        newDimVector.push_back(sizeRemaining -
-                               (sizeRemaining - (datasetControllers[controllerIndex]->getSize() - offset)));
+        newDimVector.push_back(datasetControllers[controllerIndex]->getSize() - offset);
         newStarts.push_back(offset+datasetControllers[controllerIndex]->getStart()[0]); // TODO multidim version
         sizeRemaining -= newDimVector[0];
       }
-//printf("size for other controllers %d\n", sizeRemaining);
-//printf("before creating the new controller\n");
       // Using the remaining space in the controller
       // Slightly differen creation method for each controller
       if (datasetControllers[0]->getName().compare("Binary") == 0) {
@@ -155,28 +140,110 @@ getStepControllers(unsigned int stepId,
                                     datasetControllers[controllerIndex])->getDataspaceDimensions());
         returnVector.push_back(createdController);
       }
-//printf("after creating the new controller\n");
       returnVector[returnVector.size()-1]->setArrayOffset(arrayoffset);
       arrayoffset += returnVector[returnVector.size()-1]->getSize();
+      // Starts at the beggining of the next controller
       offset = 0;
       ++controllerIndex;
-      // Starts at the beggining of the next controller
     }
   }
-/*
-printf("size of return vector = %d\n", returnVector.size());
-for (unsigned int i = 0; i < returnVector.size(); ++i)
+  return returnVector;
+}
+
+std::vector<shared_ptr<XdmfHeavyDataController> >
+getStepControllers(unsigned int stepId,
+                   std::vector<unsigned int> stepDims,
+                   std::vector<shared_ptr<XdmfHeavyDataController> > datasetControllers,
+                   const std::vector<unsigned int> & controllerStarts)
 {
-  shared_ptr<XdmfHDF5Controller> currentController = shared_dynamic_cast<XdmfHDF5Controller>(returnVector[i]);
-assert(currentController);
-  printf("file = %s\n", currentController->getFilePath().c_str());
-  printf("dataset = %s\n", currentController->getDataSetPath().c_str());
-  printf("start = %u\n", currentController->getStart()[0]);
-  printf("dimension = %u\n", currentController->getDimensions()[0]);
-  printf("dataspace = %u\n", currentController->getDataspaceDimensions()[0]);
+  unsigned int sizePerStep = 1;
+  for (unsigned int i = 0; i < stepDims.size(); ++i)
+  {
+    sizePerStep *= stepDims[i];
+  }
+  return getDatasetControllers(sizePerStep * stepId,
+                               sizePerStep,
+                               datasetControllers,
+                               controllerStarts);
 }
-*/
-  return returnVector;
+
+std::vector<shared_ptr<XdmfHeavyDataController> >
+getStepControllers(unsigned int stepId,
+                   std::vector<unsigned int> stepDims,
+                   std::vector<shared_ptr<XdmfHeavyDataController> > datasetControllers)
+{
+  return getStepControllers(stepId,
+                            stepDims,
+                            datasetControllers,
+                            getControllerStarts(datasetControllers));
+}
+
+unsigned long long
+hashValues(const XdmfArray & array)
+{
+  // FNV-1a over the bytes of the values
+  const unsigned char * values =
+    static_cast<const unsigned char *>(array.getValuesInternal());
+  const unsigned int numBytes = array.getSize() * array.getArrayType()->getElementSize();
+  unsigned long long hash = 14695981039346656037ULL;
+  for (unsigned int i = 0; i < numBytes; ++i)
+  {
+    hash ^= values[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool
+equalValues(const XdmfArray & array, const XdmfArray & otherArray)
+{
+  if (array.getArrayType() != otherArray.getArrayType() ||
+      array.getSize() != otherArray.getSize()) {
+    return false;
+  }
+  return memcmp(array.getValuesInternal(),
+                otherArray.getValuesInternal(),
+                array.getSize() * array.getArrayType()->getElementSize()) == 0;
+}
+
+void
+xorValues(XdmfArray & array, const XdmfArray & keyframe)
+{
+  // Exclusive or of the bytes, so that encoding and decoding are the same
+  unsigned char * values =
+    static_cast<unsigned char *>(array.getValuesInternal());
+  const unsigned char * keyframeValues =
+    static_cast<const unsigned char *>(keyframe.getValuesInternal());
+  const unsigned int numBytes =
+    std::min(array.getSize(), keyframe.getSize()) * array.getArrayType()->getElementSize();
+  for (unsigned int i = 0; i < numBytes; ++i)
+  {
+    values[i] ^= keyframeValues[i];
+  }
+}
+
+std::string
+getDescriptionString(const shared_ptr<XdmfArray> array)
+{
+  std::string descriptionString;
+  if (array->getArrayType() == XdmfArrayType::Int8())
+  {
+    descriptionString = std::string((char *)array->getValuesInternal());
+  }
+  else if (array->getArrayType() == XdmfArrayType::String())
+  {
+    std::stringstream descriptionstream;
+    for (unsigned int i = 0; i < array->getSize(); ++i)
+    {
+      descriptionstream << array->getValue<std::string>(i);
+      if (i < array->getSize() - 1)
+      {
+        descriptionstream << '|';
+      }
+    }
+    descriptionString = descriptionstream.str();
+  }
+  return descriptionString;
 }
 
 std::vector<shared_ptr<XdmfHeavyDataController> >
@@ -440,7 +507,9 @@ XdmfTemplate::XdmfTemplate() :
   mBase(shared_ptr<XdmfItem>()),
   mCurrentStep(-1),
   mNumSteps(0),
-  mItemFactory(shared_ptr<XdmfItemFactory>())
+  mItemFactory(shared_ptr<XdmfItemFactory>()),
+  mPrefetch(0),
+  mKeyframeInterval(0)
 {
 }
 
@@ -449,7 +518,9 @@ XdmfTemplate::XdmfTemplate(XdmfTemplate & refTemplate) :
   mBase(refTemplate.mBase),
   mCurrentStep(refTemplate.mCurrentStep),
   mNumSteps(refTemplate.mNumSteps),
-  mItemFactory(refTemplate.mItemFactory)
+  mItemFactory(refTemplate.mItemFactory),
+  mPrefetch(refTemplate.mPrefetch),
+  mKeyframeInterval(refTemplate.mKeyframeInterval)
 {
 }
 
@@ -468,121 +539,164 @@ XdmfTemplate::addStep()
     XdmfError::message(XdmfError::FATAL,
                        "Error: XdmfTemplate attempting to add a step when no arrays are tracked");
   }
-  for (unsigned int arrayIndex = 0; arrayIndex < mTrackedArrays.size(); ++arrayIndex) {
-    if (mTrackedArrayTypes.size() < mTrackedArrays.size()){
-      mTrackedArrayTypes.resize(mTrackedArrays.size());
-    }
-    if (mTrackedArrayDims.size() < mTrackedArrays.size()){
-      mTrackedArrayDims.resize(mTrackedArrays.size());
-    }
-    if (!mTrackedArrayTypes[arrayIndex]) {
-      mTrackedArrayTypes[arrayIndex] = mTrackedArrays[arrayIndex]->getArrayType();
-    }
-    if (mTrackedArrayDims[arrayIndex].size() == 0) {
-      mTrackedArrayDims[arrayIndex] = mTrackedArrays[arrayIndex]->getDimensions();
-    }
-    // Write the tracked arrays to heavy data if they aren't already
-    if (mHeavyWriter) {
-      bool revertToAppend = false;
-      if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Append) {
-        // Set to original heavy data controllers for append
-        if (mDataControllers.size() > arrayIndex)
-        {
-          if (mDataControllers[arrayIndex].size() > 0)
-          {
-            while (mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers() > 0) {
-              mTrackedArrays[arrayIndex]->removeHeavyDataController(0);
-            }
-            for (unsigned int i = 0; i < mDataControllers[arrayIndex].size(); ++i)
-            {
-              mTrackedArrays[arrayIndex]->insert(mDataControllers[arrayIndex][i]);
-            }
-          }
-        }
-        else
-        {
-          // Creating new Dataset
-          // Set to default mode so that it doesn't overlap
-          mHeavyWriter->setMode(XdmfHeavyDataWriter::Default);
-          revertToAppend = true;
-        }
+  // The arrays of a step are appended through one opening of the file,
+  // unless the caller already holds it open
+  shared_ptr<XdmfHDF5Writer> hdf5Writer =
+    shared_dynamic_cast<XdmfHDF5Writer>(mHeavyWriter);
+  const bool appendStep = hdf5Writer &&
+    hdf5Writer->getMode() == XdmfHeavyDataWriter::Append &&
+    !hdf5Writer->getFileIsOpen();
+  if (appendStep) {
+    hdf5Writer->openFile();
+  }
+  try {
+    for (unsigned int arrayIndex = 0; arrayIndex < mTrackedArrays.size(); ++arrayIndex) {
+      if (mTrackedArrayTypes.size() < mTrackedArrays.size()){
+        mTrackedArrayTypes.resize(mTrackedArrays.size());
       }
-      else if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Hyperslab) {
-        // Use the controller that references the subset that will be overwritten
-        if (!(arrayIndex < mDataControllers.size()))
-        {
-          // When in overwrite mode the dataset must be preallocated
-          XdmfError::message(XdmfError::FATAL, "Error: Heavy Data dataset must be preallocated "
-                                               "to use Hyperslab mode Templates");
-        }
-        std::vector<shared_ptr<XdmfHeavyDataController> > overwriteControllers =
-          getStepControllers(mCurrentStep, mTrackedArrayDims[arrayIndex], mDataControllers[arrayIndex]);
-        mTrackedArrays[arrayIndex]->setHeavyDataController(overwriteControllers);
+      if (mTrackedArrayDims.size() < mTrackedArrays.size()){
+        mTrackedArrayDims.resize(mTrackedArrays.size());
       }
-      mTrackedArrays[arrayIndex]->accept(mHeavyWriter);
-      if (revertToAppend)
-      {
-        mHeavyWriter->setMode(XdmfHeavyDataWriter::Append);
+      if (!mTrackedArrayTypes[arrayIndex]) {
+        mTrackedArrayTypes[arrayIndex] = mTrackedArrays[arrayIndex]->getArrayType();
       }
-    }
-    datastream.str(std::string());
-    for (unsigned int controllerIndex = 0; controllerIndex < mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers(); ++controllerIndex) {
-      // TODO throw error if controller types don't match
-      // For each heavy data controller
-      std::string writerPath = XdmfSystemUtils::getRealPath(mHeavyWriter->getFilePath());
-      std::string heavyDataPath =
-        mTrackedArrays[arrayIndex]->getHeavyDataController(controllerIndex)->getFilePath();
-      size_t index = heavyDataPath.find_last_of("/\\");
-      if(index != std::string::npos) {
-        // If path is not a folder
-        // put the directory path into this variable
-        const std::string heavyDataDir = heavyDataPath.substr(0, index + 1);
-        // If the directory is in the XML File Path
-        if(writerPath.find(heavyDataDir) == 0) {
-          heavyDataPath =
-            heavyDataPath.substr(heavyDataDir.size(),
-                                 heavyDataPath.size() - heavyDataDir.size());
-          // Pull the file off of the end and place it in the DataPath
+      if (mTrackedArrayDims[arrayIndex].size() == 0) {
+        mTrackedArrayDims[arrayIndex] = mTrackedArrays[arrayIndex]->getDimensions();
+      }
+      // Steps are only encoded when each is written to its own data set
+      const bool encodeStep = mKeyframeInterval > 0 &&
+                              mHeavyWriter &&
+                              mHeavyWriter->getMode() == XdmfHeavyDataWriter::Default &&
+                              mTrackedArrays[arrayIndex]->isInitialized() &&
+                              mTrackedArrays[arrayIndex]->getArrayType() != XdmfArrayType::String();
+      const unsigned int entryIndex = mDataControllers.size();
+      unsigned long long valuesHash = 0;
+      shared_ptr<XdmfArray> originalValues;
+      if (encodeStep) {
+        valuesHash = hashValues(*mTrackedArrays[arrayIndex]);
+        const int unchangedEntry = this->findUnchangedEntry(arrayIndex, valuesHash);
+        if (unchangedEntry >= 0) {
+          // Refer to the heavy data of the earlier step instead of writing
+          mDataControllers.push_back(mDataControllers[unchangedEntry]);
+          mDataTypes.push_back(mDataTypes[unchangedEntry]);
+          mDataDescriptions.push_back(mDataDescriptions[unchangedEntry]);
+          if ((unsigned int)unchangedEntry < mKeyframeTypes.size() &&
+              mKeyframeTypes[unchangedEntry].size() > 0) {
+            mKeyframeTypes.resize(entryIndex + 1);
+            mKeyframeDescriptions.resize(entryIndex + 1);
+            mKeyframeTypes[entryIndex] = mKeyframeTypes[unchangedEntry];
+            mKeyframeDescriptions[entryIndex] = mKeyframeDescriptions[unchangedEntry];
+          }
+          continue;
         }
-        // Otherwise the full path is required
+        originalValues = this->encodeValues(arrayIndex);
       }
-      datastream << heavyDataPath;
-      datastream << mTrackedArrays[arrayIndex]->getHeavyDataController(controllerIndex)->getDescriptor();
-        datastream << "|";
-        for (unsigned int i = 0; i < mTrackedArrays[arrayIndex]->getHeavyDataController(controllerIndex)->getDimensions().size(); ++i) {
-          datastream << mTrackedArrays[arrayIndex]->getHeavyDataController(controllerIndex)->getDimensions()[i];
-          if (i < mTrackedArrays[arrayIndex]->getHeavyDataController(controllerIndex)->getDimensions().size() - 1) {
-            datastream << " ";
+      // Write the tracked arrays to heavy data if they aren't already
+      if (mHeavyWriter) {
+        bool revertToAppend = false;
+        if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Append) {
+          // Set to original heavy data controllers for append
+          if (mDataControllers.size() > arrayIndex)
+          {
+            if (mDataControllers[arrayIndex].size() > 0)
+            {
+              while (mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers() > 0) {
+                mTrackedArrays[arrayIndex]->removeHeavyDataController(0);
+              }
+              for (unsigned int i = 0; i < mDataControllers[arrayIndex].size(); ++i)
+              {
+                mTrackedArrays[arrayIndex]->insert(mDataControllers[arrayIndex][i]);
+              }
+            }
+          }
+          else if (hdf5Writer)
+          {
+            // Creating new Dataset, chunked by step and grown by each append
+            if (mHeavyWriter->getFileSizeLimit() <= 0 &&
+                mTrackedArrays[arrayIndex]->isInitialized() &&
+                mTrackedArrays[arrayIndex]->getSize() > 0) {
+              while (mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers() > 0) {
+                mTrackedArrays[arrayIndex]->removeHeavyDataController(0);
+              }
+              mTrackedArrays[arrayIndex]->insert(
+                hdf5Writer->allocateDataSet(mTrackedArrays[arrayIndex]->getArrayType(),
+                                            0,
+                                            mTrackedArrays[arrayIndex]->getSize()));
+            }
+            else {
+              mHeavyWriter->setMode(XdmfHeavyDataWriter::Default);
+              revertToAppend = true;
+            }
+          }
+          else
+          {
+            // Creating new Dataset
+            // Set to default mode so that it doesn't overlap
+            mHeavyWriter->setMode(XdmfHeavyDataWriter::Default);
+            revertToAppend = true;
           }
         }
-        if (controllerIndex + 1 < mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers()) {
-          datastream << "|";
+        else if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Hyperslab) {
+          // Use the controller that references the subset that will be overwritten
+          if (!(arrayIndex < mDataControllers.size()))
+          {
+            // When in overwrite mode the dataset must be preallocated
+            XdmfError::message(XdmfError::FATAL, "Error: Heavy Data dataset must be preallocated "
+                                                 "to use Hyperslab mode Templates");
+          }
+          std::vector<shared_ptr<XdmfHeavyDataController> > overwriteControllers =
+            getStepControllers(mCurrentStep, mTrackedArrayDims[arrayIndex], mDataControllers[arrayIndex]);
+          mTrackedArrays[arrayIndex]->setHeavyDataController(overwriteControllers);
         }
-    }
-    if (mHeavyWriter) {
-      if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Append) {
-        if (mDataControllers.size() > arrayIndex)
+        mTrackedArrays[arrayIndex]->accept(mHeavyWriter);
+        if (revertToAppend)
         {
-          // If controllers already exist
-          // Store the overarching controllers again
-          mDataControllers[arrayIndex].clear();
-          for (unsigned int i = 0; i < mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers(); ++i)
+          mHeavyWriter->setMode(XdmfHeavyDataWriter::Append);
+        }
+      }
+      datastream.str(std::string());
+      datastream << this->describeHeavyData(*mTrackedArrays[arrayIndex]);
+      if (mHeavyWriter) {
+        if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Append) {
+          if (mDataControllers.size() > arrayIndex)
           {
-            mDataControllers[arrayIndex].push_back(mTrackedArrays[arrayIndex]->getHeavyDataController(i));
+            // If controllers already exist
+            // Store the overarching controllers again
+            mDataControllers[arrayIndex].clear();
+            for (unsigned int i = 0; i < mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers(); ++i)
+            {
+              mDataControllers[arrayIndex].push_back(mTrackedArrays[arrayIndex]->getHeavyDataController(i));
+            }
+            // Clear controllers from the array
+            while (mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers() > 0) {
+              mTrackedArrays[arrayIndex]->removeHeavyDataController(0);
+            }
+            // If append set controller to the correct subsection of the whole
+            std::vector<shared_ptr<XdmfHeavyDataController> > readControllers = getStepControllers(mCurrentStep, mTrackedArrayDims[arrayIndex], mDataControllers[arrayIndex]);
+            mTrackedArrays[arrayIndex]->setHeavyDataController(readControllers);
+            // Replace with updated description
+            mDataDescriptions[arrayIndex] = datastream.str();
           }
-          // Clear controllers from the array
-          while (mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers() > 0) {
-            mTrackedArrays[arrayIndex]->removeHeavyDataController(0);
+          else
+          {
+            // If a new dataset, as normal
+            mDataControllers.push_back(std::vector<shared_ptr<XdmfHeavyDataController> >());
+            for (unsigned int i = 0; i < mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers(); ++i) {
+              mDataControllers[mDataControllers.size()-1].push_back((mTrackedArrays[arrayIndex]->getHeavyDataController(i)));
+            }
+            if (mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers() > 0) {
+              mDataTypes.push_back(mTrackedArrays[arrayIndex]->getHeavyDataController(0)->getName());
+              mDataDescriptions.push_back(datastream.str());
+            }
           }
-          // If append set controller to the correct subsection of the whole
-          std::vector<shared_ptr<XdmfHeavyDataController> > readControllers = getStepControllers(mCurrentStep, mTrackedArrayDims[arrayIndex], mDataControllers[arrayIndex]);
-          mTrackedArrays[arrayIndex]->setHeavyDataController(readControllers);
-          // Replace with updated description
-          mDataDescriptions[arrayIndex] = datastream.str();
         }
-        else
-        {
-          // If a new dataset, as normal
+        else if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Hyperslab) {
+          // Hyperslab is already storing the base controller
+          // So nothing is done here, the controller should already be pointing to the correct location
+          // TODO, to what the file index was before the add, as opposed to 0
+          mHeavyWriter->setFileIndex(0);
+        }
+        else {
           mDataControllers.push_back(std::vector<shared_ptr<XdmfHeavyDataController> >());
           for (unsigned int i = 0; i < mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers(); ++i) {
             mDataControllers[mDataControllers.size()-1].push_back((mTrackedArrays[arrayIndex]->getHeavyDataController(i)));
@@ -593,30 +707,27 @@ XdmfTemplate::addStep()
           }
         }
       }
-      else if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Hyperslab) {
-        // Hyperslab is already storing the base controller
-        // So nothing is done here, the controller should already be pointing to the correct location
-        // TODO, to what the file index was before the add, as opposed to 0
-        mHeavyWriter->setFileIndex(0);
-      }
       else {
         mDataControllers.push_back(std::vector<shared_ptr<XdmfHeavyDataController> >());
-        for (unsigned int i = 0; i < mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers(); ++i) {
-          mDataControllers[mDataControllers.size()-1].push_back((mTrackedArrays[arrayIndex]->getHeavyDataController(i)));
-        }
-        if (mTrackedArrays[arrayIndex]->getNumberHeavyDataControllers() > 0) {
-          mDataTypes.push_back(mTrackedArrays[arrayIndex]->getHeavyDataController(0)->getName());
-          mDataDescriptions.push_back(datastream.str());
-        }
+        mDataTypes.push_back("XML");
+        mDataDescriptions.push_back(mTrackedArrays[arrayIndex]->getValuesString());
+      }
+      if (encodeStep) {
+        this->recordStep(arrayIndex, entryIndex, valuesHash, originalValues);
       }
     }
-    else {
-      mDataControllers.push_back(std::vector<shared_ptr<XdmfHeavyDataController> >());
-      mDataTypes.push_back("XML");
-      mDataDescriptions.push_back(mTrackedArrays[arrayIndex]->getValuesString());
+  }
+  catch (...) {
+    if (appendStep) {
+      hdf5Writer->closeFile();
     }
+    throw;
+  }
+  if (appendStep) {
+    hdf5Writer->closeFile();
   }
   ++mNumSteps;
+  this->resetStepIndex();
   this->setIsChanged(true);
   return mCurrentStep;
 }
@@ -633,6 +744,119 @@ XdmfTemplate::clearStep()
   mCurrentStep = -1;
 }
 
+std::string
+XdmfTemplate::describeHeavyData(const XdmfArray & array)
+{
+  std::stringstream datastream;
+  for (unsigned int controllerIndex = 0; controllerIndex < array.getNumberHeavyDataControllers(); ++controllerIndex) {
+    // TODO throw error if controller types don't match
+    // For each heavy data controller
+    std::string writerPath = XdmfSystemUtils::getRealPath(mHeavyWriter->getFilePath());
+    std::string heavyDataPath =
+      array.getHeavyDataController(controllerIndex)->getFilePath();
+    size_t index = heavyDataPath.find_last_of("/\\");
+    if(index != std::string::npos) {
+      // If path is not a folder
+      // put the directory path into this variable
+      const std::string heavyDataDir = heavyDataPath.substr(0, index + 1);
+      // If the directory is in the XML File Path
+      if(writerPath.find(heavyDataDir) == 0) {
+        heavyDataPath =
+          heavyDataPath.substr(heavyDataDir.size(),
+                               heavyDataPath.size() - heavyDataDir.size());
+        // Pull the file off of the end and place it in the DataPath
+      }
+      // Otherwise the full path is required
+    }
+    datastream << heavyDataPath;
+    datastream << array.getHeavyDataController(controllerIndex)->getDescriptor();
+    datastream << "|";
+    const std::vector<unsigned int> dimensions =
+      array.getHeavyDataController(controllerIndex)->getDimensions();
+    for (unsigned int i = 0; i < dimensions.size(); ++i) {
+      datastream << dimensions[i];
+      if (i < dimensions.size() - 1) {
+        datastream << " ";
+      }
+    }
+    if (controllerIndex + 1 < array.getNumberHeavyDataControllers()) {
+      datastream << "|";
+    }
+  }
+  return datastream.str();
+}
+
+shared_ptr<XdmfArray>
+XdmfTemplate::encodeValues(unsigned int arrayIndex)
+{
+  XdmfArray * array = mTrackedArrays[arrayIndex];
+  if (mKeyframeValues.size() <= arrayIndex) {
+    mKeyframeValues.resize(arrayIndex + 1);
+    mKeyframeSources.resize(arrayIndex + 1);
+    mKeyframeSteps.resize(arrayIndex + 1);
+  }
+  shared_ptr<XdmfArray> keyframe = mKeyframeValues[arrayIndex];
+  if (!keyframe ||
+      (unsigned int)mCurrentStep >= mKeyframeSteps[arrayIndex] + mKeyframeInterval ||
+      keyframe->getArrayType() != array->getArrayType() ||
+      keyframe->getSize() != array->getSize()) {
+    // Written in full as the next keyframe
+    return shared_ptr<XdmfArray>();
+  }
+  shared_ptr<XdmfArray> encodedValues = XdmfArray::New();
+  encodedValues->initialize(array->getArrayType(), array->getDimensions());
+  memcpy(encodedValues->getValuesInternal(),
+         array->getValuesInternal(),
+         array->getSize() * array->getArrayType()->getElementSize());
+  xorValues(*encodedValues, *keyframe);
+  // Write the encoded values in place of the originals
+  array->swap(encodedValues);
+  return encodedValues;
+}
+
+int
+XdmfTemplate::findUnchangedEntry(unsigned int arrayIndex, unsigned long long hash)
+{
+  if (mStepHashes.size() <= arrayIndex) {
+    return -1;
+  }
+  std::map<unsigned long long, unsigned int>::const_iterator iter =
+    mStepHashes[arrayIndex].find(hash);
+  if (iter == mStepHashes[arrayIndex].end() ||
+      iter->second >= mDataDescriptions.size()) {
+    return -1;
+  }
+  // Compare the values in case of a collision
+  if (!equalValues(*mTrackedArrays[arrayIndex],
+                   *this->readEntry(iter->second, arrayIndex))) {
+    return -1;
+  }
+  return iter->second;
+}
+
+std::vector<shared_ptr<XdmfHeavyDataController> >
+XdmfTemplate::generateControllers(const std::string & dataType,
+                                  const std::string & description,
+                                  unsigned int arrayIndex)
+{
+  if (!mItemFactory) {
+    mItemFactory = XdmfItemFactory::New();
+  }
+  std::map<std::string, std::string> populateProperties;
+  if (mHeavyWriter) {
+    // The heavy writer provides the XMLDir, which is used to get full paths for the controllers
+    std::string filepath = XdmfSystemUtils::getRealPath(mHeavyWriter->getFilePath());
+    size_t index = filepath.find_last_of("/\\");
+    filepath = filepath.substr(0, index + 1);
+    populateProperties["XMLDir"] = filepath;
+  }
+  populateProperties["Content"] = description;
+  return mItemFactory->generateHeavyDataControllers(populateProperties,
+                                                    mTrackedArrayDims[arrayIndex],
+                                                    mTrackedArrayTypes[arrayIndex],
+                                                    dataType);
+}
+
 shared_ptr<XdmfItem>
 XdmfTemplate::getBase()
 {
@@ -663,6 +887,12 @@ XdmfTemplate::getItemTag() const
   return ItemTag;
 }
 
+unsigned int
+XdmfTemplate::getKeyframeInterval() const
+{
+  return mKeyframeInterval;
+}
+
 unsigned int
 XdmfTemplate::getNumberSteps() const
 {
@@ -675,12 +905,66 @@ XdmfTemplate::getNumberTrackedArrays() const
   return mTrackedArrays.size();
 }
 
+unsigned int
+XdmfTemplate::getPrefetch() const
+{
+  return mPrefetch;
+}
+
 XdmfArray *
 XdmfTemplate::getTrackedArray(unsigned int index)
 {
   return mTrackedArrays[index];
 }
 
+shared_ptr<XdmfArray>
+XdmfTemplate::loadKeyframe(unsigned int entryIndex, unsigned int arrayIndex)
+{
+  if (mKeyframeValues.size() <= arrayIndex) {
+    mKeyframeValues.resize(arrayIndex + 1);
+    mKeyframeSources.resize(arrayIndex + 1);
+    mKeyframeSteps.resize(arrayIndex + 1);
+  }
+  const std::pair<std::string, std::string> source(mKeyframeTypes[entryIndex],
+                                                   mKeyframeDescriptions[entryIndex]);
+  if (!mKeyframeValues[arrayIndex] || mKeyframeSources[arrayIndex] != source) {
+    shared_ptr<XdmfArray> keyframe = XdmfArray::New();
+    std::vector<shared_ptr<XdmfHeavyDataController> > keyframeControllers =
+      this->generateControllers(source.first, source.second, arrayIndex);
+    keyframe->setHeavyDataController(keyframeControllers);
+    keyframe->read();
+    mKeyframeValues[arrayIndex] = keyframe;
+    mKeyframeSources[arrayIndex] = source;
+  }
+  return mKeyframeValues[arrayIndex];
+}
+
+std::vector<shared_ptr<XdmfHeavyDataController> >
+XdmfTemplate::findStepControllers(unsigned int stepId, unsigned int arrayIndex)
+{
+  if (mControllerStarts.size() < mDataControllers.size()) {
+    mControllerStarts.resize(mDataControllers.size());
+  }
+  if (mControllerStarts[arrayIndex].size() != mDataControllers[arrayIndex].size() + 1) {
+    mControllerStarts[arrayIndex] = getControllerStarts(mDataControllers[arrayIndex]);
+  }
+  if (stepId >= this->getNumberSteps()) {
+    return getStepControllers(stepId, mTrackedArrayDims[arrayIndex], mDataControllers[arrayIndex], mControllerStarts[arrayIndex]);
+  }
+  if (mStepControllers.size() < this->getNumberSteps()) {
+    mStepControllers.resize(this->getNumberSteps());
+  }
+  if (mStepControllers[stepId].size() < mTrackedArrays.size()) {
+    mStepControllers[stepId].resize(mTrackedArrays.size());
+  }
+  std::vector<shared_ptr<XdmfHeavyDataController> > & stepControllers =
+    mStepControllers[stepId][arrayIndex];
+  if (stepControllers.size() == 0) {
+    stepControllers = getStepControllers(stepId, mTrackedArrayDims[arrayIndex], mDataControllers[arrayIndex], mControllerStarts[arrayIndex]);
+  }
+  return stepControllers;
+}
+
 
 void
 XdmfTemplate::populateItem(const std::map<std::string, std::string> & itemProperties,
@@ -709,24 +993,7 @@ XdmfTemplate::populateItem(const std::map<std::string, std::string> & itemProper
           // Split description into substrings based on the " character
           array->read();
 
-          std::string descriptionString;
-          if (array->getArrayType() == XdmfArrayType::Int8())
-          {
-            descriptionString = std::string((char *)array->getValuesInternal());
-          }
-          else if (array->getArrayType() == XdmfArrayType::String())
-          {
-            std::stringstream descriptionstream;
-            for (unsigned int i = 0; i < array->getSize(); ++i)
-            {
-              descriptionstream << array->getValue<std::string>(i);
-              if (i < array->getSize() - 1)
-              {
-                descriptionstream << '|';
-              }
-            }
-            descriptionString = descriptionstream.str();
-          }
+          std::string descriptionString = getDescriptionString(array);
 
           size_t index = descriptionString.find_first_of("\"");
           size_t previousIndex = 0;
@@ -759,6 +1026,9 @@ XdmfTemplate::populateItem(const std::map<std::string, std::string> & itemProper
             }
           }
         }
+        else if (array->getName().compare("Keyframe Description") == 0) {
+          this->populateKeyframes(array);
+        }
         else {
           mTrackedArrays.push_back(array.get());
           mTrackedArrayDims.push_back(array->getDimensions());
@@ -833,124 +1103,110 @@ XdmfTemplate::populateItem(const std::map<std::string, std::string> & itemProper
   else {
     mNumSteps = mDataControllers.size() / mTrackedArrays.size();
   }
+  this->resetStepIndex();
   this->setStep(0);
 }
 
+void
+XdmfTemplate::populateKeyframes(const shared_ptr<XdmfArray> keyframeArray)
+{
+  keyframeArray->read();
+  const std::string keyframeString = getDescriptionString(keyframeArray);
+  // Each encoded step is written as "entry"type"description
+  std::vector<std::string> fields;
+  size_t previousIndex = keyframeString.find_first_of("\"");
+  while (previousIndex != std::string::npos) {
+    size_t index = keyframeString.find_first_of("\"", previousIndex + 1);
+    fields.push_back(keyframeString.substr(previousIndex + 1,
+                                           index == std::string::npos ?
+                                           std::string::npos :
+                                           index - previousIndex - 1));
+    previousIndex = index;
+  }
+  if (fields.size() % 3 != 0) {
+    XdmfError::message(XdmfError::FATAL, "Error: Invalid keyframe description in XdmfTemplate::populateKeyframes");
+  }
+  for (unsigned int i = 0; i < fields.size(); i += 3) {
+    const unsigned int entryIndex = atoi(fields[i].c_str());
+    if (mKeyframeTypes.size() <= entryIndex) {
+      mKeyframeTypes.resize(entryIndex + 1);
+      mKeyframeDescriptions.resize(entryIndex + 1);
+    }
+    mKeyframeTypes[entryIndex] = fields[i + 1];
+    mKeyframeDescriptions[entryIndex] = fields[i + 2];
+  }
+}
+
 void
 XdmfTemplate::preallocateSteps(unsigned int numSteps)
 {
   // Preallocate steps based on the current size of the arrays
-  // Use a temporary array to write data to hdf5
+  // Use a temporary array to write data to heavy data
   shared_ptr<XdmfArray> tempArray = XdmfArray::New();
   // Set to Default mode so that the new allocations are in new locations
   mHeavyWriter->setMode(XdmfHeavyDataWriter::Default);
-  int preallocatedSize = 0;
-  int numberSetsPreallocated = 0;
+  // hdf5 datasets can be allocated without writing to them
+  shared_ptr<XdmfHDF5Writer> hdf5Writer =
+    shared_dynamic_cast<XdmfHDF5Writer>(mHeavyWriter);
+  if (mHeavyWriter->getFileSizeLimit() > 0) {
+    hdf5Writer = shared_ptr<XdmfHDF5Writer>();
+  }
   std::stringstream datastream;
   for (unsigned int i = 0; i < mTrackedArrays.size(); ++i) {
-    preallocatedSize = mTrackedArrays[i]->getSize() * numSteps;
-///*
-    numberSetsPreallocated = 1;
-
-    int adjustment = 1;
-    while (preallocatedSize / (numSteps/adjustment) != mTrackedArrays[i]->getSize() || 0 > (int)preallocatedSize) {
-//      XdmfError::message(XdmfError::WARNING, "Overflow error");
-      ++adjustment;
-      while (numSteps % adjustment != 0) {
-//printf("%d / %d remainder %d\n", numSteps, adjustment, (numSteps % adjustment));
-        ++adjustment;
-      }
-      numberSetsPreallocated = numberSetsPreallocated * adjustment;
-      preallocatedSize = mTrackedArrays[i]->getSize() * (numSteps / adjustment);
-//printf("%d / %d = %d ?= %d\n", preallocatedSize , (numSteps/adjustment), preallocatedSize / (numSteps/adjustment), mTrackedArrays[i]->getSize());
+    if (mDataControllers.size() <= i) {
+      mDataControllers.push_back(std::vector<shared_ptr<XdmfHeavyDataController> >());
     }
-
-    // If adjusted, split one more time, to ensure that the dataset fits.
-    if (adjustment > 1) {
-      ++adjustment;
-      while (numSteps % adjustment != 0) {
-        ++adjustment;
+    const unsigned int stepSize = mTrackedArrays[i]->getSize();
+    // Each dataset holds as many whole steps as its size can address
+    unsigned int stepsPerSet = numSteps;
+    if (stepSize > 0 && stepsPerSet > INT_MAX / stepSize) {
+      stepsPerSet = INT_MAX / stepSize;
+      if (stepsPerSet == 0) {
+        XdmfError::message(XdmfError::FATAL,
+                           "Error: Step too large to preallocate in XdmfTemplate");
       }
-      numberSetsPreallocated = numberSetsPreallocated * adjustment;
-      preallocatedSize = mTrackedArrays[i]->getSize() * (numSteps / adjustment);
     }
-
-    bool allocateSucceeded = false;
-    while (!allocateSucceeded)
-    {
-      try {
-        mHeavyWriter->openFile();
-//printf("now size %d allocated %d times\n", preallocatedSize, numberSetsPreallocated);
-        for (unsigned int allocateIteration = 0;
-             allocateIteration < numberSetsPreallocated;
-             ++allocateIteration)
-        {
-//printf("allocating subsection %u\n", allocateIteration);
-//*/
-//printf("initializing base array\n");
-          tempArray->initialize(mTrackedArrays[i]->getArrayType(), preallocatedSize);
-//printf("writing subsection");
+    unsigned int stepsAllocated = 0;
+    mHeavyWriter->openFile();
+    while (stepsAllocated < numSteps) {
+      const unsigned int setSteps = std::min(stepsPerSet, numSteps - stepsAllocated);
+      if (hdf5Writer && stepSize > 0) {
+        // One extendible dataset, chunked by step
+        mDataControllers[i].push_back(
+          hdf5Writer->allocateDataSet(mTrackedArrays[i]->getArrayType(),
+                                      setSteps * stepSize,
+                                      stepSize));
+      }
+      else {
+        try {
+          tempArray->initialize(mTrackedArrays[i]->getArrayType(), setSteps * stepSize);
           tempArray->accept(mHeavyWriter);
-//printf("subsection written\n");
-//          mHeavyWriter->clearCache();
-///*
-          if (mDataControllers.size() <= i) {
-            mDataControllers.push_back(std::vector<shared_ptr<XdmfHeavyDataController> >());
-          }
-          // Clean Array for the next iteration
+        }
+        catch (...) {
           while (tempArray->getNumberHeavyDataControllers() > 0) {
-            mDataControllers[i].push_back(tempArray->getHeavyDataController(0));
-            if (mDataTypes.size() <= i) {
-              mDataTypes.push_back(tempArray->getHeavyDataController(0)->getName());
-            }
             tempArray->removeHeavyDataController(0);
           }
           tempArray->release();
-//*/
-///*
-//printf("moving to next allocation\n");
+          if (stepsPerSet <= 1) {
+            mHeavyWriter->closeFile();
+            throw;
+          }
+          // Try again with smaller sets
+          stepsPerSet = (stepsPerSet + 1) / 2;
+          continue;
         }
-        mHeavyWriter->closeFile();
-        allocateSucceeded = true;
-//*/
-//TODO catch the controllers created by this.
-///*
-      }
-      catch (...)
-      {
         while (tempArray->getNumberHeavyDataControllers() > 0) {
+          mDataControllers[i].push_back(tempArray->getHeavyDataController(0));
           tempArray->removeHeavyDataController(0);
         }
         tempArray->release();
-//        XdmfError::message(XdmfError::WARNING, "Array Allocation failed");
-        int factor = 2;
-        while (preallocatedSize % factor != 0) {
-//printf("%d / %d remainder %d\n", preallocatedSize, factor, (preallocatedSize % factor));
-          factor = factor + 1;
-        }
-//printf("adjusted factor %d\n", factor);
-        numberSetsPreallocated = numberSetsPreallocated * factor;
-        preallocatedSize = (preallocatedSize) / factor;
-//printf("now size %d allocated %d times\n", preallocatedSize, numberSetsPreallocated);
       }
+      stepsAllocated += setSteps;
     }
-//printf("Done writing to hdf5\n");
-//*/
-/*
-    // Transfer controllers to the appropriate slot before clearing them
-    if (mDataControllers.size() <= i) {
-      mDataControllers.push_back(std::vector<shared_ptr<XdmfHeavyDataController> >());
-    }
-    // Clean Array for the next iteration
-    while (tempArray->getNumberHeavyDataControllers() > 0) {
-      mDataControllers[i].push_back(tempArray->getHeavyDataController(0));
-      if (mDataTypes.size() <= i) {
-        mDataTypes.push_back(tempArray->getHeavyDataController(0)->getName());
-      }
-      tempArray->removeHeavyDataController(0);
+    mHeavyWriter->closeFile();
+    if (mDataTypes.size() <= i && mDataControllers[i].size() > 0) {
+      mDataTypes.push_back(mDataControllers[i][0]->getName());
     }
-    tempArray->release();
-*/
     datastream.str(std::string());
     for (unsigned int controllerIndex = 0; controllerIndex < mDataControllers[i].size(); ++controllerIndex) {
       // TODO throw error if controller types don't match
@@ -989,8 +1245,163 @@ XdmfTemplate::preallocateSteps(unsigned int numSteps)
   }
   // To end set the heavy writer to overwrite mode
   mHeavyWriter->setMode(XdmfHeavyDataWriter::Hyperslab);
+  this->resetStepIndex();
+}
+
+
+void
+XdmfTemplate::prefetchStep(unsigned int stepId, unsigned int arrayIndex)
+{
+  unsigned int stepSize = 1;
+  for (unsigned int i = 0; i < mTrackedArrayDims[arrayIndex].size(); ++i) {
+    stepSize *= mTrackedArrayDims[arrayIndex][i];
+  }
+  if (stepSize == 0) {
+    return;
+  }
+  if (mPrefetchArrays.size() < mTrackedArrays.size()) {
+    mPrefetchArrays.resize(mTrackedArrays.size());
+    mPrefetchStarts.resize(mTrackedArrays.size());
+  }
+  shared_ptr<XdmfArray> & prefetchArray = mPrefetchArrays[arrayIndex];
+  unsigned int & prefetchStart = mPrefetchStarts[arrayIndex];
+  if (!prefetchArray ||
+      stepId < prefetchStart ||
+      stepId >= prefetchStart + prefetchArray->getSize() / stepSize) {
+    // Read this step and the ones after it in one go
+    unsigned int numSteps = std::min(mPrefetch + 1, this->getNumberSteps() - stepId);
+    std::vector<shared_ptr<XdmfHeavyDataController> > windowControllers =
+      getDatasetControllers(stepId * stepSize,
+                            numSteps * stepSize,
+                            mDataControllers[arrayIndex],
+                            mControllerStarts[arrayIndex]);
+    prefetchArray = XdmfArray::New();
+    prefetchArray->setHeavyDataController(windowControllers);
+    prefetchArray->read();
+    prefetchStart = stepId;
+  }
+  mTrackedArrays[arrayIndex]->initialize(prefetchArray->getArrayType(),
+                                         mTrackedArrayDims[arrayIndex]);
+  mTrackedArrays[arrayIndex]->insert(0,
+                                     prefetchArray,
+                                     (stepId - prefetchStart) * stepSize,
+                                     stepSize);
+}
+
+shared_ptr<XdmfArray>
+XdmfTemplate::readEntry(unsigned int entryIndex, unsigned int arrayIndex)
+{
+  // The latest keyframe is already in memory
+  if (arrayIndex < mKeyframeValues.size() &&
+      mKeyframeValues[arrayIndex] &&
+      mKeyframeSources[arrayIndex].first == mDataTypes[entryIndex] &&
+      mKeyframeSources[arrayIndex].second == mDataDescriptions[entryIndex]) {
+    return mKeyframeValues[arrayIndex];
+  }
+  std::vector<shared_ptr<XdmfHeavyDataController> > entryControllers =
+    mDataControllers[entryIndex];
+  if (entryControllers.size() == 0) {
+    entryControllers = this->generateControllers(mDataTypes[entryIndex],
+                                                 mDataDescriptions[entryIndex],
+                                                 arrayIndex);
+  }
+  shared_ptr<XdmfArray> values = XdmfArray::New();
+  if (entryControllers.size() > 0) {
+    values->setHeavyDataController(entryControllers);
+    values->read();
+  }
+  else {
+    // Data is contained in the content
+    values->initialize(mTrackedArrayTypes[arrayIndex], mTrackedArrayDims[arrayIndex]);
+    unsigned int index = 0;
+    boost::char_separator<char> sep(" \t\n");
+    boost::tokenizer<boost::char_separator<char> > valtokens(mDataDescriptions[entryIndex], sep);
+    for(boost::tokenizer<boost::char_separator<char> >::const_iterator
+          iter = valtokens.begin();
+        iter != valtokens.end();
+        ++iter, ++index) {
+      if (mTrackedArrayTypes[arrayIndex] == XdmfArrayType::String()) {
+        values->insert(index, *iter);
+      }
+      else {
+        values->insert(index, atof((*iter).c_str()));
+      }
+    }
+  }
+  if (entryIndex < mKeyframeTypes.size() &&
+      mKeyframeTypes[entryIndex].size() > 0) {
+    xorValues(*values, *this->loadKeyframe(entryIndex, arrayIndex));
+  }
+  return values;
+}
+
+shared_ptr<XdmfArray>
+XdmfTemplate::readStep(unsigned int stepId, unsigned int arrayIndex)
+{
+  if (stepId >= this->getNumberSteps() || arrayIndex >= mTrackedArrays.size()) {
+    XdmfError::message(XdmfError::FATAL, "Error: Template attempting to read invalid step");
+  }
+  if (mHeavyWriter &&
+      (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Append ||
+       mHeavyWriter->getMode() == XdmfHeavyDataWriter::Hyperslab)) {
+    if (mDataControllers[arrayIndex].size() == 0) {
+      mDataControllers[arrayIndex] = this->generateControllers(mDataTypes[arrayIndex],
+                                                               mDataDescriptions[arrayIndex],
+                                                               arrayIndex);
+      this->resetStepIndex();
+    }
+    std::vector<shared_ptr<XdmfHeavyDataController> > stepControllers =
+      this->findStepControllers(stepId, arrayIndex);
+    shared_ptr<XdmfArray> values = XdmfArray::New();
+    values->setHeavyDataController(stepControllers);
+    values->read();
+    return values;
+  }
+  return this->readEntry(arrayIndex + stepId * mTrackedArrays.size(), arrayIndex);
 }
 
+void
+XdmfTemplate::recordStep(unsigned int arrayIndex,
+                         unsigned int entryIndex,
+                         unsigned long long hash,
+                         shared_ptr<XdmfArray> originalValues)
+{
+  XdmfArray * array = mTrackedArrays[arrayIndex];
+  if (originalValues) {
+    // Restore the values that were encoded, the written
+    // controllers reference the encoded values so they are not kept
+    array->swap(originalValues);
+    while (array->getNumberHeavyDataControllers() > 0) {
+      array->removeHeavyDataController(0);
+    }
+  }
+  if (mDataDescriptions.size() <= entryIndex) {
+    // Nothing was written
+    return;
+  }
+  if (originalValues) {
+    mKeyframeTypes.resize(entryIndex + 1);
+    mKeyframeDescriptions.resize(entryIndex + 1);
+    mKeyframeTypes[entryIndex] = mKeyframeSources[arrayIndex].first;
+    mKeyframeDescriptions[entryIndex] = mKeyframeSources[arrayIndex].second;
+  }
+  else {
+    // Keep the values of the new keyframe to encode the next steps
+    shared_ptr<XdmfArray> keyframe = XdmfArray::New();
+    keyframe->initialize(array->getArrayType(), array->getDimensions());
+    memcpy(keyframe->getValuesInternal(),
+           array->getValuesInternal(),
+           array->getSize() * array->getArrayType()->getElementSize());
+    mKeyframeValues[arrayIndex] = keyframe;
+    mKeyframeSources[arrayIndex] =
+      std::make_pair(mDataTypes[entryIndex], mDataDescriptions[entryIndex]);
+    mKeyframeSteps[arrayIndex] = mCurrentStep;
+  }
+  if (mStepHashes.size() <= arrayIndex) {
+    mStepHashes.resize(arrayIndex + 1);
+  }
+  mStepHashes[arrayIndex].insert(std::make_pair(hash, entryIndex));
+}
 
 void
 XdmfTemplate::removeStep(unsigned int stepId)
@@ -1014,20 +1425,61 @@ XdmfTemplate::removeStep(unsigned int stepId)
         mDataTypes.erase(mDataTypes.begin() + (stepId*mTrackedArrays.size()));
         mDataDescriptions.erase(mDataDescriptions.begin() + (stepId*mTrackedArrays.size()));
         mDataControllers.erase(mDataControllers.begin() + (stepId*mTrackedArrays.size()));
+        if (stepId*mTrackedArrays.size() < mKeyframeTypes.size()) {
+          mKeyframeTypes.erase(mKeyframeTypes.begin() + (stepId*mTrackedArrays.size()));
+          mKeyframeDescriptions.erase(mKeyframeDescriptions.begin() + (stepId*mTrackedArrays.size()));
+        }
       }
     }
+    // Entry indices have shifted
+    mStepHashes.clear();
     --mNumSteps;
+    if (stepId == 0 && mHeavyWriter) {
+      // The base refers to the first step, so when it was stored relative
+      // to the keyframe just removed it is written in full as a keyframe
+      for (unsigned int i = 0;
+           i < mTrackedArrays.size() && i < mKeyframeTypes.size();
+           ++i) {
+        if (mKeyframeTypes[i].size() == 0) {
+          continue;
+        }
+        shared_ptr<XdmfArray> values = this->readEntry(i, i);
+        values->accept(mHeavyWriter);
+        if (values->getNumberHeavyDataControllers() == 0) {
+          continue;
+        }
+        mDataControllers[i].clear();
+        for (unsigned int j = 0; j < values->getNumberHeavyDataControllers(); ++j) {
+          mDataControllers[i].push_back(values->getHeavyDataController(j));
+        }
+        mDataTypes[i] = values->getHeavyDataController(0)->getName();
+        mDataDescriptions[i] = this->describeHeavyData(*values);
+        mKeyframeTypes[i].clear();
+        mKeyframeDescriptions[i].clear();
+      }
+    }
   }
   mCurrentStep = -1;
+  this->resetStepIndex();
   this->setIsChanged(true);
 }
 
+void
+XdmfTemplate::resetStepIndex()
+{
+  mStepControllers.clear();
+  mControllerStarts.clear();
+  mPrefetchArrays.clear();
+  mPrefetchStarts.clear();
+}
+
 void
 XdmfTemplate::setBase(shared_ptr<XdmfItem> newBase)
 {
   shared_ptr<XdmfArrayGatherer> accumulator = XdmfArrayGatherer::New(&mTrackedArrays);
   newBase->accept(accumulator);
   mBase = newBase;
+  this->resetStepIndex();
   this->setIsChanged(true);
 }
 
@@ -1035,6 +1487,21 @@ void
 XdmfTemplate::setHeavyDataWriter(shared_ptr<XdmfHeavyDataWriter> writer)
 {
   mHeavyWriter = writer;
+  this->resetStepIndex();
+}
+
+void
+XdmfTemplate::setKeyframeInterval(unsigned int numSteps)
+{
+  mKeyframeInterval = numSteps;
+}
+
+void
+XdmfTemplate::setPrefetch(unsigned int numSteps)
+{
+  mPrefetch = numSteps;
+  mPrefetchArrays.clear();
+  mPrefetchStarts.clear();
 }
 
 void
@@ -1063,9 +1530,12 @@ XdmfTemplate::setStep(unsigned int stepId)
           if(mHeavyWriter) {
             if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Append ||
                 mHeavyWriter->getMode() == XdmfHeavyDataWriter::Hyperslab) {
-              std::vector<shared_ptr<XdmfHeavyDataController> > insertVector =
-                getStepControllers(stepId, mTrackedArrayDims[i], mDataControllers[i]);
-               mTrackedArrays[i]->setHeavyDataController(insertVector);
+              std::vector<shared_ptr<XdmfHeavyDataController> > stepControllers =
+                this->findStepControllers(stepId, i);
+              mTrackedArrays[i]->setHeavyDataController(stepControllers);
+              if (mPrefetch > 0) {
+                this->prefetchStep(stepId, i);
+              }
             }
             else {
               mTrackedArrays[i]->setHeavyDataController(mDataControllers[i+(stepId*mTrackedArrays.size())]);
@@ -1088,12 +1558,14 @@ XdmfTemplate::setStep(unsigned int stepId)
           }
           populateProperties["Content"] = mDataDescriptions[arrayIndex];
           std::vector<shared_ptr<XdmfHeavyDataController> > readControllers;
+          // Controllers kept for later steps, the whole dataset when steps share one
+          std::vector<shared_ptr<XdmfHeavyDataController> > storedControllers;
           if (mHeavyWriter) {
             if (mHeavyWriter->getMode() == XdmfHeavyDataWriter::Append ||
                 mHeavyWriter->getMode() == XdmfHeavyDataWriter::Hyperslab) {
-              std::vector<shared_ptr<XdmfHeavyDataController> > totalControllers =
+              storedControllers =
                 mItemFactory->generateHeavyDataControllers(populateProperties, mTrackedArrayDims[i], mTrackedArrayTypes[i], mDataTypes[i+(stepId*mTrackedArrays.size())]);
-              readControllers = getStepControllers(stepId, mTrackedArrayDims[i], totalControllers);
+              readControllers = getStepControllers(stepId, mTrackedArrayDims[i], storedControllers);
             }
             else {
               readControllers = mItemFactory->generateHeavyDataControllers(populateProperties, mTrackedArrayDims[i], mTrackedArrayTypes[i], mDataTypes[i+(stepId*mTrackedArrays.size())]);
@@ -1105,7 +1577,11 @@ XdmfTemplate::setStep(unsigned int stepId)
           if (readControllers.size() > 0) {
             // Heavy data controllers reference the data
             mTrackedArrays[i]->setHeavyDataController(readControllers);
-            mDataControllers[arrayIndex] = readControllers; 
+            if (storedControllers.size() == 0) {
+              storedControllers = readControllers;
+            }
+            mDataControllers[arrayIndex] = storedControllers;
+            this->resetStepIndex();
           }
           else {
             // Data is contained in the content
@@ -1134,6 +1610,15 @@ XdmfTemplate::setStep(unsigned int stepId)
             }
           }
         }
+        if (arrayIndex < mKeyframeTypes.size() &&
+            mKeyframeTypes[arrayIndex].size() > 0) {
+          // Stored relative to a keyframe, decoded in memory
+          mTrackedArrays[i]->read();
+          xorValues(*mTrackedArrays[i], *this->loadKeyframe(arrayIndex, i));
+          while (mTrackedArrays[i]->getNumberHeavyDataControllers() > 0) {
+            mTrackedArrays[i]->removeHeavyDataController(0);
+          }
+        }
       }
     }
     else {
@@ -1156,6 +1641,7 @@ XdmfTemplate::trackArray(shared_ptr<XdmfArray> newArray)
 
   if (!found) {
     mTrackedArrays.push_back(newArray.get());
+    this->resetStepIndex();
   }
   this->setIsChanged(true);
 }
@@ -1233,6 +1719,22 @@ XdmfTemplate::traverse(const shared_ptr<XdmfBaseVisitor> visitor)
 
   dataInfoArray->accept(visitor);
 
+  std::stringstream keyframeInfo;
+  for (i = 0; i < mKeyframeTypes.size(); ++i) {
+    if (mKeyframeTypes[i].size() > 0) {
+      keyframeInfo << "\"" << i << "\"" << mKeyframeTypes[i] << "\"" << mKeyframeDescriptions[i];
+    }
+  }
+
+  if (keyframeInfo.str().size() > 0) {
+    // Only written when steps are stored relative to keyframes
+    shared_ptr<XdmfArray> keyframeInfoArray = XdmfArray::New();
+    keyframeInfoArray->setName("Keyframe Description");
+    keyframeInfoArray->insert(0, keyframeInfo.str().c_str(), keyframeInfo.str().length());
+    keyframeInfoArray->insert(keyframeInfoArray->getSize(), 0);
+    keyframeInfoArray->accept(visitor);
+  }
+
   if (shared_ptr<XdmfWriter> writer =
         shared_dynamic_cast<XdmfWriter>(visitor)) {
     writer->setWriteXPaths(originalXPath);
@@ -93,6 +93,14 @@ public:
 
   std::string getItemTag() const;
 
+  /**
+   * Gets the number of steps between keyframes of the tracked arrays.
+   *
+   * @return    The number of steps between keyframes, 0 if the steps
+   *            are not encoded.
+   */
+  unsigned int getKeyframeInterval() const;
+
   /**
    * Gets the number of steps currently contained within the template.
    *
@@ -107,6 +115,13 @@ public:
    */
   unsigned int getNumberTrackedArrays() const;
 
+  /**
+   * Gets the number of steps read ahead along with each step loaded.
+   *
+   * @return    The number of steps read ahead, 0 if disabled.
+   */
+  unsigned int getPrefetch() const;
+
   /**
    * Gets the tracked array at the specified index. The index of the array
    * depends on when the internal visitor encountered the array in question.
@@ -145,6 +160,42 @@ public:
    */
   void setHeavyDataWriter(shared_ptr<XdmfHeavyDataWriter> writer);
 
+  /**
+   * Sets the number of steps between keyframes, encoding the steps
+   * added afterwards against them.
+   *
+   * Applies to steps written to their own heavy data sets (Default
+   * mode). A tracked array whose values are identical to those of an
+   * earlier step refers to the heavy data of that step instead of
+   * being written again. Otherwise the values are written in full
+   * every numSteps steps as a keyframe, and the steps in between store
+   * the bitwise exclusive or of their values with the keyframe. Those
+   * are mostly zero bits for slowly changing arrays, so they compress
+   * well when the heavy data writer compresses its output.
+   *
+   * setStep decodes encoded steps, reading their values into the
+   * tracked arrays.
+   *
+   * @param     numSteps        The number of steps between keyframes,
+   *                            0 writes every step in full.
+   */
+  void setKeyframeInterval(unsigned int numSteps);
+
+  /**
+   * Sets the number of steps to read ahead when a step is loaded.
+   *
+   * When the steps are appended to a common dataset (Append or Hyperslab
+   * mode), setStep reads the values of the tracked arrays for the
+   * requested step and the following numSteps steps in one read. Loading
+   * any of those steps afterwards copies their values from memory
+   * instead of reading from heavy data. The tracked arrays are
+   * initialized by setStep when this is enabled.
+   *
+   * @param     numSteps        The number of steps to read ahead,
+   *                            0 disables reading ahead.
+   */
+  void setPrefetch(unsigned int numSteps);
+
   /**
    * Reads in the heavy data associated with the provided step id.
    *
@@ -177,6 +228,42 @@ protected:
                const std::vector<shared_ptr<XdmfItem> > & childItems,
                const XdmfCoreReader * const reader);
 
+  /**
+   * Reads the keyframes of the encoded steps from the array they were
+   * written to.
+   *
+   * @param     keyframeArray   The array holding the keyframe descriptions.
+   */
+  void populateKeyframes(const shared_ptr<XdmfArray> keyframeArray);
+
+  /**
+   * Reads the values of a tracked array for a step without changing
+   * the step that is loaded.
+   *
+   * @param     stepId          The id of the step to read.
+   * @param     arrayIndex      The index of the tracked array to read.
+   * @return                    The values of the array for the step.
+   */
+  shared_ptr<XdmfArray> readStep(unsigned int stepId, unsigned int arrayIndex);
+
+  /**
+   * Discards the step index and the steps read ahead, called whenever
+   * the stored heavy data controllers change.
+   */
+  void resetStepIndex();
+
+  /**
+   * Gets the heavy data controllers holding a step of a tracked array
+   * when steps are appended to common datasets. They are replaced
+   * whenever the stored heavy data controllers change.
+   *
+   * @param     stepId          The id of the step.
+   * @param     arrayIndex      The index of the tracked array.
+   * @return                    The controllers of the step.
+   */
+  std::vector<shared_ptr<XdmfHeavyDataController> >
+  findStepControllers(unsigned int stepId, unsigned int arrayIndex);
+
   shared_ptr<XdmfHeavyDataWriter> mHeavyWriter;
 
   shared_ptr<XdmfItem> mBase;
@@ -192,6 +279,50 @@ protected:
 
 private:
 
+  void prefetchStep(unsigned int stepId, unsigned int arrayIndex);
+
+  std::string describeHeavyData(const XdmfArray & array);
+
+  shared_ptr<XdmfArray> encodeValues(unsigned int arrayIndex);
+
+  int findUnchangedEntry(unsigned int arrayIndex, unsigned long long hash);
+
+  std::vector<shared_ptr<XdmfHeavyDataController> >
+  generateControllers(const std::string & dataType,
+                      const std::string & description,
+                      unsigned int arrayIndex);
+
+  shared_ptr<XdmfArray> loadKeyframe(unsigned int entryIndex,
+                                     unsigned int arrayIndex);
+
+  shared_ptr<XdmfArray> readEntry(unsigned int entryIndex,
+                                  unsigned int arrayIndex);
+
+  void recordStep(unsigned int arrayIndex,
+                  unsigned int entryIndex,
+                  unsigned long long hash,
+                  shared_ptr<XdmfArray> originalValues);
+
+  // Controllers of each step in a common dataset, by step then array
+  std::vector<std::vector<std::vector<shared_ptr<XdmfHeavyDataController> > > > mStepControllers;
+  // Offset of each stored controller within the dataset, by array
+  std::vector<std::vector<unsigned int> > mControllerStarts;
+  unsigned int mPrefetch;
+  // Values of the steps read ahead and the first step they hold, by array
+  std::vector<shared_ptr<XdmfArray> > mPrefetchArrays;
+  std::vector<unsigned int> mPrefetchStarts;
+  unsigned int mKeyframeInterval;
+  // Keyframe each stored step is encoded against, empty if stored in full
+  std::vector<std::string> mKeyframeTypes;
+  std::vector<std::string> mKeyframeDescriptions;
+  // Values of the keyframe last written or read, the type and
+  // description they were read from, and the step it was written for
+  std::vector<shared_ptr<XdmfArray> > mKeyframeValues;
+  std::vector<std::pair<std::string, std::string> > mKeyframeSources;
+  std::vector<unsigned int> mKeyframeSteps;
+  // Stored step of the values hashed, by array
+  std::vector<std::map<unsigned long long, unsigned int> > mStepHashes;
+
   XdmfTemplate(const XdmfTemplate &);  // Not implemented.
   void operator=(const XdmfTemplate &);  // Not implemented.
 
@@ -24,6 +24,9 @@
 #include "XdmfError.hpp"
 #include "XdmfGeometry.hpp"
 #include "XdmfGeometryType.hpp"
+#include "XdmfImplicitGeometryController.hpp"
+#include "XdmfImplicitTopologyController.hpp"
+#include "XdmfRectilinearGrid.hpp"
 #include "XdmfRegularGrid.hpp"
 #include "XdmfTopology.hpp"
 #include "XdmfTopologyType.hpp"
@@ -34,83 +37,37 @@
  */
 namespace {
 
+  // Points and connectivity of the structured grid are generated on
+  // demand by the controllers rather than stored in the arrays.
   void
-  convertRegularGeometry(unsigned int          index,
-                         shared_ptr<XdmfArray> point,
-                         shared_ptr<XdmfArray> dimensions,
-                         shared_ptr<XdmfArray> brickSize,
-                         shared_ptr<XdmfArray> mGeometry) {
-
-    const unsigned int nDim = dimensions->getValue<unsigned int>(index);
-    const double nBrickSize = brickSize->getValue<double>(index);
-    const double originalPoint = point->getValue<double>(index);
-
-    for(unsigned int i=0; i<nDim; ++i) {
-      if(index == 0) {
-        mGeometry->insert(mGeometry->getSize(),
-                          point,
-                          0,
-                          point->getSize());
-      }
-      else {
-        convertRegularGeometry(index - 1,
-                               point,
-                               dimensions,
-                               brickSize,
-                               mGeometry);
-      }
-      const double currPoint = point->getValue<double>(index);
-      point->insert(index, currPoint + nBrickSize);
+  setStructuredControllers(const std::vector<unsigned int> & pointDimensions,
+                           const shared_ptr<XdmfImplicitGeometryController> geometryController,
+                           const shared_ptr<XdmfGeometry> geometry,
+                           const shared_ptr<XdmfTopology> topology)
+  {
+    shared_ptr<const XdmfGeometryType> geometryType;
+    shared_ptr<const XdmfTopologyType> topologyType;
+    if(pointDimensions.size() == 2) {
+      geometryType = XdmfGeometryType::XY();
+      topologyType = XdmfTopologyType::Quadrilateral();
+    }
+    else if(pointDimensions.size() == 3) {
+      geometryType = XdmfGeometryType::XYZ();
+      topologyType = XdmfTopologyType::Hexahedron();
+    }
+    else {
+      XdmfError::message(XdmfError::FATAL, 
+                         "Cannot convert structured grid of dimensions not "
+                         "2 or 3 to XdmfUnstructuredGrid in "
+                         "XdmfUnstructuredGrid constructor");
     }
+    geometry->setType(geometryType);
+    topology->setType(topologyType);
 
-    point->insert(index, originalPoint);
+    geometry->insert(geometryController);
+    topology->insert(XdmfImplicitTopologyController::New(pointDimensions));
   }
 
-  void
-  convertRegularTopology(shared_ptr<XdmfArray> dimensions,
-                         shared_ptr<XdmfArray> mTopology) 
-  {
-
-    if(dimensions->getSize() == 2) {
-      const unsigned int nx = dimensions->getValue<unsigned int>(0);
-      const unsigned int ny = dimensions->getValue<unsigned int>(1);
-      unsigned int offset = 0;
-      for(unsigned int i=1; i<ny; ++i) {
-        for(unsigned int j=1; j<nx; ++j) {
-          mTopology->pushBack<unsigned int>(offset);
-          mTopology->pushBack<unsigned int>(offset + 1);
-          mTopology->pushBack<unsigned int>(offset + nx + 1);
-          mTopology->pushBack<unsigned int>(offset + nx);
-          ++offset;
-        }
-        ++offset;
-      }
-    }
-    else if(dimensions->getSize() == 3) {
-      const unsigned int nx = dimensions->getValue<unsigned int>(0);
-      const unsigned int ny = dimensions->getValue<unsigned int>(1);
-      const unsigned int nz = dimensions->getValue<unsigned int>(2);
-      const unsigned int zOffset = nx * ny;
-      unsigned int offset = 0;
-      for(unsigned int i=1; i<nz; ++i) {
-        for(unsigned int j=1; j<ny; ++j) {
-          for(unsigned int k=1; k<nx; ++k) {
-            mTopology->pushBack<unsigned int>(offset);
-            mTopology->pushBack<unsigned int>(offset + 1);
-            mTopology->pushBack<unsigned int>(offset + nx + 1);
-            mTopology->pushBack<unsigned int>(offset + nx);
-            mTopology->pushBack<unsigned int>(offset + zOffset);
-            mTopology->pushBack<unsigned int>(offset + zOffset + 1);
-            mTopology->pushBack<unsigned int>(offset + zOffset + nx + 1);
-            mTopology->pushBack<unsigned int>(offset + zOffset + nx);
-            ++offset;
-          }
-          ++offset;
-        }
-        offset += nx;
-      }
-    }
-  }      
 }
 
 class XdmfUnstructuredGrid::XdmfUnstructuredGridImpl : public XdmfGridImpl
@@ -150,6 +107,13 @@ XdmfUnstructuredGrid::New(const shared_ptr<XdmfRegularGrid> regularGrid)
   return p;
 }
 
+shared_ptr<XdmfUnstructuredGrid>
+XdmfUnstructuredGrid::New(const shared_ptr<XdmfRectilinearGrid> rectilinearGrid)
+{
+  shared_ptr<XdmfUnstructuredGrid> p(new XdmfUnstructuredGrid(rectilinearGrid));
+  return p;
+}
+
 XdmfUnstructuredGrid::XdmfUnstructuredGrid() :
   XdmfGrid(XdmfGeometry::New(), XdmfTopology::New())
 {
@@ -174,60 +138,41 @@ XdmfUnstructuredGrid::XdmfUnstructuredGrid(const shared_ptr<XdmfRegularGrid> reg
                        "XdmfUnstructuredGrid constructor");
   }
 
-  bool releaseOrigin = false;
-  bool releaseBrickSize = false;
   bool releaseDimensions = false;
-  if(!origin->isInitialized()) {
-    origin->read();
-    releaseOrigin = true;
-  }
-  if(!brickSize->isInitialized()) {
-    brickSize->read();
-    releaseBrickSize = true;
-  }  
   if(!dimensions->isInitialized()) {
     dimensions->read();
     releaseDimensions = true;
   }
-  
-  shared_ptr<const XdmfGeometryType> geometryType;
-  shared_ptr<const XdmfTopologyType> topologyType;
-  if(origin->getSize() == 2) {
-    geometryType = XdmfGeometryType::XY();
-    topologyType = XdmfTopologyType::Quadrilateral();
-  }
-  else if(origin->getSize() == 3) {
-    geometryType = XdmfGeometryType::XYZ();
-    topologyType = XdmfTopologyType::Hexahedron();
-  }
-  else {
-    XdmfError::message(XdmfError::FATAL, 
-                       "Cannot convert regular grid of dimensions not 2 or 3 "
-                       "to XdmfUnstructuredGrid in XdmfUnstructuredGrid "
-                       "constructor");
-  }
-  mGeometry->setType(geometryType);
-  mTopology->setType(topologyType);
-
-  shared_ptr<XdmfArray> point = XdmfArray::New();
-  point->insert(0, origin, 0, origin->getSize());
-  convertRegularGeometry(dimensions->getSize() - 1,
-                         point,
-                         dimensions,
-                         brickSize,
-                         mGeometry);
-  convertRegularTopology(dimensions,
-                         mTopology);
-  
-  if(releaseOrigin) {
-    origin->release();
-  }
-  if(releaseBrickSize) {
-    brickSize->release();
+  std::vector<unsigned int> pointDimensions(dimensions->getSize());
+  if(dimensions->getSize() > 0) {
+    dimensions->getValues(0, &pointDimensions[0], dimensions->getSize());
   }
   if(releaseDimensions) {
     dimensions->release();
-  }  
+  }
+
+  setStructuredControllers(pointDimensions,
+                           XdmfImplicitGeometryController::New(regularGrid),
+                           mGeometry,
+                           mTopology);
+}
+
+XdmfUnstructuredGrid::XdmfUnstructuredGrid(const shared_ptr<XdmfRectilinearGrid> rectilinearGrid) :
+  XdmfGrid(XdmfGeometry::New(), XdmfTopology::New())
+{
+  mImpl = new XdmfUnstructuredGridImpl();
+
+  const std::vector<shared_ptr<XdmfArray> > coordinates =
+    rectilinearGrid->getCoordinates();
+  std::vector<unsigned int> pointDimensions;
+  for(unsigned int i=0; i<coordinates.size(); ++i) {
+    pointDimensions.push_back(coordinates[i]->getSize());
+  }
+
+  setStructuredControllers(pointDimensions,
+                           XdmfImplicitGeometryController::New(rectilinearGrid),
+                           mGeometry,
+                           mTopology);
 }
 
 XdmfUnstructuredGrid::XdmfUnstructuredGrid(XdmfUnstructuredGrid & refGrid) :
@@ -359,6 +304,18 @@ XDMFUNSTRUCTUREDGRID * XdmfUnstructuredGridNewFromRegularGrid(XDMFREGULARGRID *
   return NULL;
 }
 
+XDMFUNSTRUCTUREDGRID * XdmfUnstructuredGridNewFromRectilinearGrid(XDMFRECTILINEARGRID * rectilinearGrid, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  XdmfItem * tempPointer = (XdmfItem *)rectilinearGrid;
+  XdmfRectilinearGrid * classedPointer = dynamic_cast<XdmfRectilinearGrid *>(tempPointer);
+  shared_ptr<XdmfRectilinearGrid> originGrid = shared_ptr<XdmfRectilinearGrid>(classedPointer, XdmfNullDeleter());
+  shared_ptr<XdmfUnstructuredGrid> generatedGrid = XdmfUnstructuredGrid::New(originGrid);
+  return (XDMFUNSTRUCTUREDGRID *)((void *)((XdmfItem *)(new XdmfUnstructuredGrid(*generatedGrid.get()))));
+  XDMF_ERROR_WRAP_END(status)
+  return NULL;
+}
+
 XDMFGEOMETRY * XdmfUnstructuredGridGetGeometry(XDMFUNSTRUCTUREDGRID * grid)
 {
   XdmfItem * tempPointer = (XdmfItem *)grid;
@@ -27,11 +27,13 @@
 // C Compatible Includes
 #include "Xdmf.hpp"
 #include "XdmfGrid.hpp"
+#include "XdmfRectilinearGrid.hpp"
 #include "XdmfRegularGrid.hpp"
 
 #ifdef __cplusplus
 
 // Forward Declarations
+class XdmfRectilinearGrid;
 class XdmfRegularGrid;
 
 /**
@@ -71,6 +73,11 @@ public:
   /**
    * Create a new XdmfUnstructuredGrid from a XdmfRegularGrid.
    *
+   * The geometry and topology of the created grid are not stored.
+   * They are backed by an XdmfImplicitGeometryController and an
+   * XdmfImplicitTopologyController, so points and connectivity are
+   * generated when the arrays are read.
+   *
    * Example of use:
    *
    * C++
@@ -92,6 +99,19 @@ public:
   static shared_ptr<XdmfUnstructuredGrid> 
   New(const shared_ptr<XdmfRegularGrid> regularGrid);
 
+  /**
+   * Create a new XdmfUnstructuredGrid from a XdmfRectilinearGrid.
+   *
+   * As with regular grids, the geometry and topology of the created
+   * grid are generated when the arrays are read.
+   *
+   * @param     rectilinearGrid The grid that the unstructured grid will be created from
+   *
+   * @return                    Constructed XdmfUnstructuredGrid.
+   */
+  static shared_ptr<XdmfUnstructuredGrid>
+  New(const shared_ptr<XdmfRectilinearGrid> rectilinearGrid);
+
   virtual ~XdmfUnstructuredGrid();
 
   static const std::string ItemTag;
@@ -218,6 +238,7 @@ protected:
 
   XdmfUnstructuredGrid();
   XdmfUnstructuredGrid(const shared_ptr<XdmfRegularGrid> regularGrid);
+  XdmfUnstructuredGrid(const shared_ptr<XdmfRectilinearGrid> rectilinearGrid);
 
   virtual void
   copyGrid(shared_ptr<XdmfGrid> sourceGrid);
@@ -249,6 +270,8 @@ XDMF_EXPORT XDMFUNSTRUCTUREDGRID * XdmfUnstructuredGridNew();
 
 XDMF_EXPORT XDMFUNSTRUCTUREDGRID * XdmfUnstructuredGridNewFromRegularGrid(XDMFREGULARGRID * regularGrid, int * status);
 
+XDMF_EXPORT XDMFUNSTRUCTUREDGRID * XdmfUnstructuredGridNewFromRectilinearGrid(XDMFRECTILINEARGRID * rectilinearGrid, int * status);
+
 XDMF_EXPORT XDMFGEOMETRY * XdmfUnstructuredGridGetGeometry(XDMFUNSTRUCTUREDGRID * grid);
 
 XDMF_EXPORT XDMFTOPOLOGY * XdmfUnstructuredGridGetTopology(XDMFUNSTRUCTUREDGRID * grid);
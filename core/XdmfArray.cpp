@@ -44,6 +44,275 @@ XDMF_CHILDREN_IMPLEMENTATION(XdmfArray,
                              HeavyDataController,
                              Name)
 
+namespace {
+
+  // Rows along the first dimension of the values selected by a start,
+  // stride, and count in each dimension of an array, with the first
+  // dimension varying fastest.
+  class StridedRows {
+  public:
+
+    StridedRows(const std::vector<unsigned int> & start,
+                const std::vector<unsigned int> & stride,
+                const std::vector<unsigned int> & count,
+                const std::vector<unsigned int> & dimensions) :
+      mOffset(0),
+      mCounts(count),
+      mIndex(count.size(), 0)
+    {
+      unsigned int dimTotal = 1;
+      for(unsigned int i = 0; i < count.size(); ++i) {
+        mOffset += start[i] * dimTotal;
+        mStrides.push_back(stride[i] * dimTotal);
+        dimTotal *= dimensions[i];
+      }
+    }
+
+    unsigned int
+    getLength() const
+    {
+      return mCounts[0];
+    }
+
+    unsigned int
+    getOffset() const
+    {
+      return mOffset;
+    }
+
+    unsigned int
+    getStride() const
+    {
+      return mStrides[0];
+    }
+
+    void
+    next()
+    {
+      for(unsigned int i = 1; i < mCounts.size(); ++i) {
+        mOffset += mStrides[i];
+        if(++mIndex[i] < mCounts[i]) {
+          return;
+        }
+        mOffset -= mStrides[i] * mCounts[i];
+        mIndex[i] = 0;
+      }
+    }
+
+  private:
+
+    unsigned int mOffset;
+    std::vector<unsigned int> mCounts;
+    std::vector<unsigned int> mIndex;
+    std::vector<unsigned int> mStrides;
+  };
+
+  // Copies a strided run of values, converting them the same as
+  // XdmfArray::getValues()
+  template <typename T, typename U>
+  struct StridedCopy {
+    static void
+    copy(const U * source,
+         const unsigned int sourceStride,
+         T * destination,
+         const unsigned int destinationStride,
+         const unsigned int numValues)
+    {
+      if(sourceStride == 1 && destinationStride == 1) {
+        for(unsigned int i = 0; i < numValues; ++i) {
+          destination[i] = (T)source[i];
+        }
+      }
+      else {
+        for(unsigned int i = 0; i < numValues; ++i) {
+          destination[i * destinationStride] = (T)source[i * sourceStride];
+        }
+      }
+    }
+  };
+
+  template <typename T>
+  struct StridedCopy<T, T> {
+    static void
+    copy(const T * source,
+         const unsigned int sourceStride,
+         T * destination,
+         const unsigned int destinationStride,
+         const unsigned int numValues)
+    {
+      if(sourceStride == 1 && destinationStride == 1) {
+        memcpy(destination, source, numValues * sizeof(T));
+      }
+      else {
+        for(unsigned int i = 0; i < numValues; ++i) {
+          destination[i * destinationStride] = source[i * sourceStride];
+        }
+      }
+    }
+  };
+
+  template <typename T>
+  struct StridedCopy<T, std::string> {
+    static void
+    copy(const std::string * source,
+         const unsigned int sourceStride,
+         T * destination,
+         const unsigned int destinationStride,
+         const unsigned int numValues)
+    {
+      for(unsigned int i = 0; i < numValues; ++i) {
+        destination[i * destinationStride] =
+          (T)atof(source[i * sourceStride].c_str());
+      }
+    }
+  };
+
+  template <typename U>
+  struct StridedCopy<std::string, U> {
+    static void
+    copy(const U * source,
+         const unsigned int sourceStride,
+         std::string * destination,
+         const unsigned int destinationStride,
+         const unsigned int numValues)
+    {
+      for(unsigned int i = 0; i < numValues; ++i) {
+        std::stringstream value;
+        value << source[i * sourceStride];
+        destination[i * destinationStride] = value.str();
+      }
+    }
+  };
+
+  template <>
+  struct StridedCopy<std::string, std::string> {
+    static void
+    copy(const std::string * source,
+         const unsigned int sourceStride,
+         std::string * destination,
+         const unsigned int destinationStride,
+         const unsigned int numValues)
+    {
+      for(unsigned int i = 0; i < numValues; ++i) {
+        destination[i * destinationStride] = source[i * sourceStride];
+      }
+    }
+  };
+
+  // Copies the values selected in the source array to those selected
+  // in the destination, in a single pass over both.
+  template <typename T>
+  class CopyStridedValues : public boost::static_visitor<void> {
+  public:
+
+    CopyStridedValues(T * const destination,
+                      const StridedRows & destinationRows,
+                      const StridedRows & sourceRows,
+                      const unsigned int numValues) :
+      mDestination(destination),
+      mDestinationRows(destinationRows),
+      mSourceRows(sourceRows),
+      mNumValues(numValues)
+    {
+    }
+
+    void
+    operator()(const boost::blank &) const
+    {
+      return;
+    }
+
+    template<typename U>
+    void
+    operator()(const shared_ptr<std::vector<U> > & array) const
+    {
+      if(!array->empty()) {
+        this->copy(&(array->operator[](0)));
+      }
+    }
+
+    template<typename U>
+    void
+    operator()(const boost::shared_array<const U> & array) const
+    {
+      this->copy(array.get());
+    }
+
+  private:
+
+    template<typename U>
+    void
+    copy(const U * const source) const
+    {
+      StridedRows sourceRows(mSourceRows);
+      StridedRows destinationRows(mDestinationRows);
+      unsigned int sourcePosition = 0;
+      unsigned int destinationPosition = 0;
+      unsigned int remaining = mNumValues;
+      while(remaining > 0) {
+        // Copy up to the end of the current row of either selection
+        const unsigned int numCopied =
+          std::min(std::min(sourceRows.getLength() - sourcePosition,
+                            destinationRows.getLength() - destinationPosition),
+                   remaining);
+        StridedCopy<T, U>::copy(source + sourceRows.getOffset() +
+                                sourcePosition * sourceRows.getStride(),
+                                sourceRows.getStride(),
+                                mDestination + destinationRows.getOffset() +
+                                destinationPosition * destinationRows.getStride(),
+                                destinationRows.getStride(),
+                                numCopied);
+        remaining -= numCopied;
+        sourcePosition += numCopied;
+        if(sourcePosition == sourceRows.getLength()) {
+          sourceRows.next();
+          sourcePosition = 0;
+        }
+        destinationPosition += numCopied;
+        if(destinationPosition == destinationRows.getLength()) {
+          destinationRows.next();
+          destinationPosition = 0;
+        }
+      }
+    }
+
+    T * const mDestination;
+    const StridedRows mDestinationRows;
+    const StridedRows mSourceRows;
+    const unsigned int mNumValues;
+  };
+
+  unsigned int
+  getReadSize(const std::vector<unsigned int> & dimensions)
+  {
+    unsigned int size = 1;
+    for(unsigned int i = 0; i < dimensions.size(); ++i) {
+      size *= dimensions[i];
+    }
+    return size;
+  }
+
+  // Catches controllers that did not read all the values they report,
+  // such as from a truncated file, and returns the number of values read
+  unsigned int
+  checkReadSize(const shared_ptr<XdmfHeavyDataController> & controller,
+                const XdmfArray * const array)
+  {
+    const unsigned int readSize =
+      getReadSize(controller->getReadDimensions());
+    if(array->getSize() != readSize) {
+      std::stringstream errorStream;
+      errorStream << "Error: " << controller->getName() << " controller for "
+                  << controller->getFilePath() << " read "
+                  << array->getSize() << " values, expected " << readSize
+                  << " in XdmfArray::readController";
+      XdmfError::message(XdmfError::FATAL, errorStream.str());
+    }
+    return readSize;
+  }
+
+}
+
 class XdmfArray::Clear : public boost::static_visitor<void> {
 public:
 
@@ -417,6 +686,83 @@ private:
   const shared_ptr<const XdmfArray> mArrayToCopy;
 };
 
+class XdmfArray::InsertArrayStrided : public boost::static_visitor<void> {
+public:
+
+  InsertArrayStrided(XdmfArray * const array,
+                     const StridedRows & arrayRows,
+                     const StridedRows & valuesRows,
+                     const unsigned int numValues,
+                     std::vector<unsigned int> & dimensions,
+                     const shared_ptr<const XdmfArray> & arrayToCopy) :
+    mArray(array),
+    mArrayRows(arrayRows),
+    mValuesRows(valuesRows),
+    mNumValues(numValues),
+    mDimensions(dimensions),
+    mArrayToCopy(arrayToCopy)
+  {
+  }
+
+  void
+  operator()(const boost::blank &) const
+  {
+    const shared_ptr<const XdmfArrayType> copyType =
+      mArrayToCopy->getArrayType();
+    if(copyType == XdmfArrayType::Uninitialized()) {
+      return;
+    }
+    mArray->initialize(copyType);
+    boost::apply_visitor(*this,
+                         mArray->mArray);
+  }
+
+  template<typename T>
+  void
+  operator()(const shared_ptr<std::vector<T> > & array) const
+  {
+    // Grow to hold the last value of each row written
+    unsigned int size = 0;
+    StridedRows rows(mArrayRows);
+    for(unsigned int remaining = mNumValues; remaining > 0;) {
+      const unsigned int length = std::min(rows.getLength(), remaining);
+      size = std::max(size,
+                      rows.getOffset() + (length - 1) * rows.getStride() + 1);
+      remaining -= length;
+      rows.next();
+    }
+    if(array->size() < size) {
+      array->resize(size);
+      mDimensions.clear();
+    }
+    if(size > 0) {
+      boost::apply_visitor(CopyStridedValues<T>(&(array->operator[](0)),
+                                                mArrayRows,
+                                                mValuesRows,
+                                                mNumValues),
+                           mArrayToCopy->mArray);
+    }
+  }
+
+  template<typename T>
+  void
+  operator()(const boost::shared_array<const T> &) const
+  {
+    mArray->internalizeArrayPointer();
+    boost::apply_visitor(*this,
+                         mArray->mArray);
+  }
+
+private:
+
+  XdmfArray * const mArray;
+  const StridedRows mArrayRows;
+  const StridedRows mValuesRows;
+  const unsigned int mNumValues;
+  std::vector<unsigned int> & mDimensions;
+  const shared_ptr<const XdmfArray> mArrayToCopy;
+};
+
 class XdmfArray::InternalizeArrayPointer : public boost::static_visitor<void> {
 public:
 
@@ -574,8 +920,10 @@ XdmfArray::XdmfArray() :
 
 XdmfArray::XdmfArray(XdmfArray & refArray):
   XdmfItem(refArray),
+  mArrayPointerNumValues(0),
   mDimensions(refArray.getDimensions()),
   mName(refArray.getName()),
+  mTmpReserveSize(0),
   mReadMode(refArray.getReadMode())
 {
   if (refArray.getArrayType() != XdmfArrayType::Uninitialized()) {
@@ -873,101 +1221,39 @@ XdmfArray::insert(const std::vector<unsigned int> startIndex,
       && (numInserted.size() == startIndex.size()
       && startIndex.size() == this->getDimensions().size()
       && this->getDimensions().size() == arrayStride.size())) {
-    // Pull data from values
-    std::vector<unsigned int > dimTotalVector;
-    unsigned int dimTotal = 1;
-    for (unsigned int i = 0; i < values->getDimensions().size(); ++i) {
-      dimTotalVector.push_back(dimTotal);
-      dimTotal *= values->getDimensions()[i];
-    }
-    std::vector<unsigned int> indexVector;
-    for (unsigned int i = 0; i < values->getDimensions().size(); ++i) {
-      indexVector.push_back(0);
-    }
-    shared_ptr<XdmfArray> holderArray = XdmfArray::New();
-    unsigned int holderoffset = 0;
-    // End when the last index is incremented
-    while (indexVector[indexVector.size()-1] < 1) {
-      // Initialize the section of the array you're pulling from
-      unsigned int startTotal = 0;
-      dimTotal = 1;
-      for (unsigned int i = 0; i < values->getDimensions().size(); ++i) {
-        // Stride doesn't factor in to the first dimension
-        // Since it's being used with the insert call
-        if (i == 0) {
-          startTotal += valuesStartIndex[i] * dimTotal;
-        }
-        else {
-          startTotal += valuesStartIndex[i] * dimTotal
-                        + valuesStride[i] * dimTotal * indexVector[i-1];
-        }
-        dimTotal *= values->getDimensions()[i];
-      }
-      // Insert the subsection
-      holderArray->insert(holderoffset,
-                          values,
-                          startTotal,
-                          numValues[0],
-                          1,
-                          valuesStride[0]);
-      holderoffset+=numValues[0];
-      // Increment up the vector
-      bool increment = true;
-      for (unsigned int i = 0; i < indexVector.size() && increment; ++i) {
-        indexVector[i]++;
-        // To keep the loop from breaking at the end
-        if (i+1 < numValues.size()) {
-          if (indexVector[i] >= numValues[i+1]) {
-            indexVector[i] = indexVector[i] % numValues[i+1];
-          }
-          else {
-            increment = false;
-          }
-        }
-      }
-    }
-    // Values being inserted retrieved
-    // Use an variation of the last loop to insert into this array
-
-    indexVector.clear();
-    for (unsigned int i = 0; i < this->getDimensions().size(); ++i) {
-      indexVector.push_back(0);
-    }
-    holderoffset = 0;
-    // End when the last index is incremented
-    while (indexVector[indexVector.size()-1] < 1) {
-      // Initialize the section of the array you're pulling from
-      unsigned int startTotal = 0;
-      dimTotal = 1;
-      for (unsigned int i = 0; i < this->getDimensions().size(); ++i) {
-        if (i == 0) {
-          // Stride doesn't factor in to the first dimension
-          // Since it's being used with the insert call
-          startTotal += startIndex[i] * dimTotal;
-        }
-        else {
-          startTotal += startIndex[i] * dimTotal + arrayStride[i] * dimTotal * indexVector[i-1];
-        }
-        dimTotal *= this->getDimensions()[i];
-      }
-      // Insert the subsection
-      this->insert(startTotal, holderArray, holderoffset, numInserted[0], arrayStride[0], 1);
-      holderoffset+=numInserted[0];
-      // Increment up the vector
-      bool increment = true;
-      for (unsigned int i = 0; i < indexVector.size() && increment; ++i) {
-        indexVector[i]++;
-        if (i+1 < numInserted.size()) {
-          // To keep the loop from breaking at the end
-          if (indexVector[i] >= numInserted[i+1]) {
-            indexVector[i] = indexVector[i] % numInserted[i+1];
-          }
-          else {
-            increment = false;
-          }
-        }
-      }
+    // Both selections are walked in the order of their first dimension,
+    // copying as many values as the smaller of the two holds
+    const StridedRows arrayRows(startIndex,
+                                arrayStride,
+                                numInserted,
+                                this->getDimensions());
+    const StridedRows valuesRows(valuesStartIndex,
+                                 valuesStride,
+                                 numValues,
+                                 values->getDimensions());
+    const unsigned int numCopied =
+      std::min(std::accumulate(numValues.begin(),
+                               numValues.end(),
+                               1,
+                               std::multiplies<unsigned int>()),
+               std::accumulate(numInserted.begin(),
+                               numInserted.end(),
+                               1,
+                               std::multiplies<unsigned int>()));
+    // Inserting an array into itself reads from a copy
+    shared_ptr<const XdmfArray> source = values;
+    if(values.get() == this) {
+      shared_ptr<XdmfArray> copy = XdmfArray::New();
+      copy->insert(0, values, 0, values->getSize());
+      source = copy;
     }
+    boost::apply_visitor(InsertArrayStrided(this,
+                                            arrayRows,
+                                            valuesRows,
+                                            numCopied,
+                                            mDimensions,
+                                            source),
+                         mArray);
     this->setIsChanged(true);
   }
   else {
@@ -1284,10 +1570,8 @@ XdmfArray::readController()
     for (unsigned int i = 0; i < mHeavyDataControllers.size(); ++i) {
       shared_ptr<XdmfArray> tempArray = XdmfArray::New();
       mHeavyDataControllers[i]->read(tempArray.get());
-      unsigned int dimTotal = 1;
-      for (unsigned int j = 0; j < mHeavyDataControllers[i]->getDimensions().size(); ++j) {
-        dimTotal *= mHeavyDataControllers[i]->getDimensions()[j];
-      }
+      const unsigned int dimTotal =
+        checkReadSize(mHeavyDataControllers[i], tempArray.get());
       this->insert(mHeavyDataControllers[i]->getArrayOffset(), tempArray, 0, dimTotal, 1, 1);
     }
     std::vector<unsigned int> returnDimensions;
@@ -1297,35 +1581,48 @@ XdmfArray::readController()
     unsigned int dimSizeMax = 0;
     unsigned int dimTotal = 0;
     for (unsigned int i = 0; i < mHeavyDataControllers.size(); ++i) {
-        dimTotal += mHeavyDataControllers[i]->getSize();
-        if (mHeavyDataControllers[i]->getSize() > dimSizeMax) {
-          dimSizeMax = mHeavyDataControllers[i]->getSize();
+        const unsigned int readSize =
+          getReadSize(mHeavyDataControllers[i]->getReadDimensions());
+        dimTotal += readSize;
+        if (readSize > dimSizeMax) {
+          dimSizeMax = readSize;
           dimControllerIndex = i;
         }
     }
     // Total up the size of the lower dimensions
+    const std::vector<unsigned int> readDimensions =
+      mHeavyDataControllers[dimControllerIndex]->getReadDimensions();
     int controllerDimensionSubtotal = 1;
     for (unsigned int i = 0;
-         i < mHeavyDataControllers[dimControllerIndex]->getDimensions().size() - 1;
+         i < readDimensions.size() - 1;
          ++i) {
-      returnDimensions.push_back(mHeavyDataControllers[dimControllerIndex]->getDimensions()[i]);
-      controllerDimensionSubtotal *= mHeavyDataControllers[dimControllerIndex]->getDimensions()[i];
+      returnDimensions.push_back(readDimensions[i]);
+      controllerDimensionSubtotal *= readDimensions[i];
     }
     // Divide the total contained by the dimensions by the size of the lower dimensions
-    returnDimensions.push_back(dimTotal/controllerDimensionSubtotal);
+    if (controllerDimensionSubtotal > 0) {
+      returnDimensions.push_back(dimTotal/controllerDimensionSubtotal);
+    }
+    else {
+      // Every controller read an empty share
+      returnDimensions.push_back(0);
+    }
     mDimensions = returnDimensions;
   }
   else if (mHeavyDataControllers.size() == 1 && mHeavyDataControllers[0]->getArrayOffset() == 0) {
     this->release();
     mHeavyDataControllers[0]->read(this);
-    mDimensions = mHeavyDataControllers[0]->getDimensions();
+    checkReadSize(mHeavyDataControllers[0], this);
+    mDimensions = mHeavyDataControllers[0]->getReadDimensions();
   }
   else if (mHeavyDataControllers.size() == 1 && mHeavyDataControllers[0]->getArrayOffset() > 0) {
     this->release();
     shared_ptr<XdmfArray> tempArray = XdmfArray::New();
     mHeavyDataControllers[0]->read(tempArray.get());
-    this->insert(mHeavyDataControllers[0]->getArrayOffset(), tempArray, 0, mHeavyDataControllers[0]->getSize(), 1, 1);
-    mDimensions = mHeavyDataControllers[0]->getDimensions();
+    const unsigned int readSize =
+      checkReadSize(mHeavyDataControllers[0], tempArray.get());
+    this->insert(mHeavyDataControllers[0]->getArrayOffset(), tempArray, 0, readSize, 1, 1);
+    mDimensions = mHeavyDataControllers[0]->getReadDimensions();
   }
   this->setIsChanged(true);
 }
@@ -1382,6 +1679,7 @@ XdmfArray::setHeavyDataController(std::vector<shared_ptr<XdmfHeavyDataController
 void
 XdmfArray::setName(const std::string & name)
 {
+  XdmfChildIndex::rename(*this);
   mName = name;
   this->setIsChanged(true);
 }
@@ -1485,6 +1485,7 @@ private:
   class GetValuesString;
   template <typename T> class Insert;
   class InsertArray;
+  class InsertArrayStrided;
   class InternalizeArrayPointer;
   class IsInitialized;
   struct NullDeleter;
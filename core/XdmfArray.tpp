@@ -680,6 +680,7 @@ XdmfArray::insert(const unsigned int index,
                                  0,
                                  mDimensions),
                        mArray);
+  this->setIsChanged(true);
 }
 
 template <typename T>
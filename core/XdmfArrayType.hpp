@@ -75,6 +75,7 @@ public:
   virtual ~XdmfArrayType();
 
   friend class XdmfArray;
+  friend class XdmfBinaryLightData;
   friend class XdmfCoreItemFactory;
 
   enum Format {
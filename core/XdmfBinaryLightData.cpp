@@ -0,0 +1,576 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfBinaryLightData.cpp                                             */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <libxml/xmlsave.h>
+#include <sstream>
+#include <vector>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfBinaryLightData.hpp"
+#include "XdmfCoreConfig.hpp"
+#include "XdmfError.hpp"
+
+/**
+ * Binary light data is laid out as:
+ *
+ *   header:  "XdmfBLD" followed by the version byte, then one byte that
+ *            is 1 when raw values are big endian and 0 otherwise
+ *   element: name, number of attributes, each attribute name and value,
+ *            content, number of child elements, each child element
+ *   content: 0 for none, 1 followed by the size and bytes of its text,
+ *            or 2 followed by the element size, the size and the bytes
+ *            of its raw values
+ *
+ * Numbers are written as unsigned LEB128. Names and attribute values are
+ * written as an index into a string table built while reading; an index
+ * equal to the size of the table is followed by the size and bytes of a
+ * new string that is added to it.
+ */
+namespace {
+
+  const char magic[] = "XdmfBLD";
+  const char version = 1;
+  const unsigned int headerSize = 9;
+
+  // Marks documents read from binary light data, set as the _private
+  // data of the document. Elements with raw values hold them as their
+  // _private data.
+  char binaryDocument = 0;
+
+  enum ContentType {
+    NoContent = 0,
+    TextContent = 1,
+    ValuesContent = 2
+  };
+
+  class Encoder {
+
+  public:
+
+    Encoder(const std::map<xmlNodePtr, std::string> & values,
+            std::ostream & stream) :
+      mStream(stream),
+      mValues(values)
+    {
+    }
+
+    void
+    writeElement(const xmlNodePtr node)
+    {
+      this->writeString(getQualifiedName(node->ns, node->name));
+
+      std::vector<std::pair<std::string, std::string> > attributes;
+      for(xmlNsPtr ns = node->nsDef; ns != NULL; ns = ns->next) {
+        std::string name = "xmlns";
+        if(ns->prefix) {
+          name = name + ":" + (const char *)ns->prefix;
+        }
+        attributes.push_back(std::make_pair(name,
+                                            std::string((const char *)ns->href)));
+      }
+      for(xmlAttrPtr attribute = node->properties;
+          attribute != NULL;
+          attribute = attribute->next) {
+        xmlChar * value = xmlNodeGetContent((xmlNodePtr)attribute);
+        attributes.push_back(std::make_pair(getQualifiedName(attribute->ns,
+                                                             attribute->name),
+                                            std::string(value ? (const char *)value : "")));
+        xmlFree(value);
+      }
+      this->writeNumber(attributes.size());
+      for(unsigned int i = 0; i < attributes.size(); ++i) {
+        this->writeString(attributes[i].first);
+        this->writeString(attributes[i].second);
+      }
+
+      std::vector<xmlNodePtr> children;
+      std::string text;
+      for(xmlNodePtr child = node->children; child != NULL; child = child->next) {
+        if(child->type == XML_ELEMENT_NODE) {
+          children.push_back(child);
+        }
+        else if((child->type == XML_TEXT_NODE ||
+                 child->type == XML_CDATA_SECTION_NODE) &&
+                child->content) {
+          text += (const char *)child->content;
+        }
+      }
+
+      std::map<xmlNodePtr, std::string>::const_iterator values =
+        mValues.find(node);
+      if(values != mValues.end()) {
+        const std::string & rawValues = values->second;
+        mStream.put(ValuesContent);
+        // Element sizes are recorded so that values can be swapped
+        // when read on a machine of the other byte order
+        xmlChar * type = xmlGetProp(node, (xmlChar *)"Precision");
+        this->writeNumber(type ? atoi((const char *)type) : 1);
+        xmlFree(type);
+        this->writeNumber(rawValues.size());
+        mStream.write(rawValues.data(), rawValues.size());
+      }
+      else if(text.find_first_not_of(" \t\r\n") != std::string::npos) {
+        mStream.put(TextContent);
+        this->writeNumber(text.size());
+        mStream.write(text.data(), text.size());
+      }
+      else {
+        mStream.put(NoContent);
+      }
+
+      this->writeNumber(children.size());
+      for(unsigned int i = 0; i < children.size(); ++i) {
+        this->writeElement(children[i]);
+      }
+    }
+
+  private:
+
+    static std::string
+    getQualifiedName(const xmlNsPtr ns,
+                     const xmlChar * name)
+    {
+      if(ns && ns->prefix) {
+        return std::string((const char *)ns->prefix) + ":" +
+          (const char *)name;
+      }
+      return std::string((const char *)name);
+    }
+
+    void
+    writeNumber(unsigned long number)
+    {
+      do {
+        unsigned char byte = number & 0x7f;
+        number >>= 7;
+        if(number != 0) {
+          byte |= 0x80;
+        }
+        mStream.put(byte);
+      } while(number != 0);
+    }
+
+    void
+    writeString(const std::string & value)
+    {
+      std::map<std::string, unsigned long>::const_iterator index =
+        mStrings.find(value);
+      if(index != mStrings.end()) {
+        this->writeNumber(index->second);
+        return;
+      }
+      const unsigned long newIndex = mStrings.size();
+      mStrings.insert(std::make_pair(value, newIndex));
+      this->writeNumber(newIndex);
+      this->writeNumber(value.size());
+      mStream.write(value.data(), value.size());
+    }
+
+    std::ostream & mStream;
+    std::map<std::string, unsigned long> mStrings;
+    const std::map<xmlNodePtr, std::string> & mValues;
+  };
+
+  class Decoder {
+
+  public:
+
+    Decoder(const std::string & contents,
+            const std::string & filePath) :
+      mContents(contents),
+      mFilePath(filePath),
+      mPosition(headerSize)
+    {
+#ifdef XDMF_BIG_ENDIAN
+      const char byteOrder = 1;
+#else
+      const char byteOrder = 0;
+#endif
+      mSwap = contents[headerSize - 1] != byteOrder;
+    }
+
+    void
+    readElement(const xmlDocPtr document,
+                const xmlNodePtr parent)
+    {
+      const std::string name = this->readString();
+      xmlNodePtr node = xmlNewDocNode(document,
+                                      NULL,
+                                      (xmlChar *)name.c_str(),
+                                      NULL);
+      if(parent) {
+        xmlAddChild(parent, node);
+      }
+      else {
+        xmlDocSetRootElement(document, node);
+      }
+
+      const unsigned long numberAttributes = this->readNumber();
+      for(unsigned long i = 0; i < numberAttributes; ++i) {
+        const std::string attributeName = this->readString();
+        const std::string value = this->readString();
+        if(attributeName.compare("xmlns") == 0) {
+          xmlNewNs(node, (xmlChar *)value.c_str(), NULL);
+        }
+        else if(attributeName.compare(0, 6, "xmlns:") == 0) {
+          xmlNewNs(node,
+                   (xmlChar *)value.c_str(),
+                   (xmlChar *)attributeName.substr(6).c_str());
+        }
+        else {
+          const size_t separator = attributeName.find(':');
+          xmlNsPtr ns = NULL;
+          if(separator != std::string::npos) {
+            ns = xmlSearchNs(document,
+                             node,
+                             (xmlChar *)attributeName.substr(0, separator).c_str());
+          }
+          if(ns) {
+            xmlNewNsProp(node,
+                         ns,
+                         (xmlChar *)attributeName.substr(separator + 1).c_str(),
+                         (xmlChar *)value.c_str());
+          }
+          else {
+            xmlNewProp(node,
+                       (xmlChar *)attributeName.c_str(),
+                       (xmlChar *)value.c_str());
+          }
+        }
+      }
+
+      // Resolve the namespace of the element as the XML parser does
+      const size_t separator = name.find(':');
+      if(separator != std::string::npos) {
+        xmlNsPtr ns = xmlSearchNs(document,
+                                  node,
+                                  (xmlChar *)name.substr(0, separator).c_str());
+        if(ns) {
+          xmlSetNs(node, ns);
+          xmlNodeSetName(node, (xmlChar *)name.substr(separator + 1).c_str());
+        }
+      }
+
+      const char contentType = this->readByte();
+      if(contentType == TextContent) {
+        const unsigned long size = this->readNumber();
+        const char * text = this->readBytes(size);
+        xmlAddChild(node, xmlNewTextLen((xmlChar *)text, size));
+      }
+      else if(contentType == ValuesContent) {
+        const unsigned long elementSize = this->readNumber();
+        const unsigned long size = this->readNumber();
+        const char * values = this->readBytes(size);
+        std::string * rawValues = new std::string(values, size);
+        if(mSwap && elementSize > 1) {
+          for(unsigned long i = 0; i + elementSize <= size; i += elementSize) {
+            std::reverse(rawValues->begin() + i,
+                         rawValues->begin() + i + elementSize);
+          }
+        }
+        node->_private = rawValues;
+      }
+      else if(contentType != NoContent) {
+        this->fail();
+      }
+
+      const unsigned long numberChildren = this->readNumber();
+      for(unsigned long i = 0; i < numberChildren; ++i) {
+        this->readElement(document, node);
+      }
+    }
+
+  private:
+
+    void
+    fail() const
+    {
+      XdmfError::message(XdmfError::FATAL,
+                         "Error: Invalid binary light data in " + mFilePath +
+                         " in XdmfBinaryLightData::read");
+    }
+
+    char
+    readByte()
+    {
+      return *this->readBytes(1);
+    }
+
+    const char *
+    readBytes(const unsigned long size)
+    {
+      if(size > mContents.size() - mPosition) {
+        this->fail();
+      }
+      const char * bytes = mContents.data() + mPosition;
+      mPosition += size;
+      return bytes;
+    }
+
+    unsigned long
+    readNumber()
+    {
+      unsigned long number = 0;
+      unsigned int shift = 0;
+      unsigned char byte;
+      do {
+        if(shift >= 8 * sizeof(unsigned long)) {
+          this->fail();
+        }
+        byte = this->readByte();
+        number |= (unsigned long)(byte & 0x7f) << shift;
+        shift += 7;
+      } while(byte & 0x80);
+      return number;
+    }
+
+    const std::string &
+    readString()
+    {
+      const unsigned long index = this->readNumber();
+      if(index < mStrings.size()) {
+        return mStrings[index];
+      }
+      if(index != mStrings.size()) {
+        this->fail();
+      }
+      const unsigned long size = this->readNumber();
+      const char * bytes = this->readBytes(size);
+      mStrings.push_back(std::string(bytes, size));
+      return mStrings.back();
+    }
+
+    const std::string & mContents;
+    const std::string mFilePath;
+    unsigned long mPosition;
+    std::vector<std::string> mStrings;
+    bool mSwap;
+  };
+
+  void
+  freeValues(const xmlNodePtr node)
+  {
+    for(xmlNodePtr child = node; child != NULL; child = child->next) {
+      if(child->type == XML_ELEMENT_NODE) {
+        delete (std::string *)child->_private;
+        child->_private = NULL;
+        freeValues(child->children);
+      }
+    }
+  }
+
+}
+
+XdmfBinaryLightData::XdmfBinaryLightData()
+{
+}
+
+XdmfBinaryLightData::~XdmfBinaryLightData()
+{
+}
+
+void
+XdmfBinaryLightData::freeDocument(xmlDocPtr document)
+{
+  if(document == NULL) {
+    return;
+  }
+  if(document->_private == &binaryDocument) {
+    freeValues(xmlDocGetRootElement(document));
+  }
+  xmlFreeDoc(document);
+}
+
+const std::string *
+XdmfBinaryLightData::getValues(const xmlNodePtr node)
+{
+  if(node->doc == NULL || node->doc->_private != &binaryDocument) {
+    return NULL;
+  }
+  return (const std::string *)node->_private;
+}
+
+bool
+XdmfBinaryLightData::isBinary(const std::string & filePath)
+{
+  std::ifstream fileStream(filePath.c_str(), std::ios::binary);
+  char header[headerSize - 2];
+  if(!fileStream.read(header, sizeof(header))) {
+    return false;
+  }
+  return memcmp(header, magic, sizeof(header)) == 0;
+}
+
+xmlDocPtr
+XdmfBinaryLightData::read(const std::string & filePath)
+{
+  std::ifstream fileStream(filePath.c_str(), std::ios::binary);
+  if(!fileStream) {
+    return NULL;
+  }
+  std::stringstream contentsStream;
+  contentsStream << fileStream.rdbuf();
+  const std::string contents = contentsStream.str();
+
+  if(contents.size() < headerSize ||
+     contents.compare(0, headerSize - 2, magic) != 0) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: " + filePath + " does not hold binary light "
+                       "data in XdmfBinaryLightData::read");
+  }
+  if(contents[headerSize - 2] != version) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: Unsupported binary light data version in " +
+                       filePath + " in XdmfBinaryLightData::read");
+  }
+
+  xmlDocPtr document = xmlNewDoc((xmlChar*)"1.0");
+  document->_private = &binaryDocument;
+  // Used to resolve XIncludes relative to the file
+  document->URL = xmlStrdup((xmlChar *)filePath.c_str());
+  try {
+    Decoder decoder(contents, filePath);
+    decoder.readElement(document, NULL);
+  }
+  catch (XdmfError &) {
+    freeDocument(document);
+    throw;
+  }
+  return document;
+}
+
+void
+XdmfBinaryLightData::toBinary(const std::string & xmlFilePath,
+                              const std::string & binaryFilePath)
+{
+  xmlDocPtr document = xmlReadFile(xmlFilePath.c_str(), NULL, 0);
+  if(document == NULL) {
+    XdmfError::message(XdmfError::FATAL,
+                       "xmlReadFile could not read " + xmlFilePath +
+                       " in XdmfBinaryLightData::toBinary");
+  }
+  std::ofstream fileStream(binaryFilePath.c_str(), std::ios::binary);
+  write(document, std::map<xmlNodePtr, std::string>(), fileStream);
+  fileStream.close();
+  xmlFreeDoc(document);
+}
+
+void
+XdmfBinaryLightData::toXML(const std::string & binaryFilePath,
+                           const std::string & xmlFilePath)
+{
+  xmlDocPtr document = read(binaryFilePath);
+  if(document == NULL) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: Could not read " + binaryFilePath +
+                       " in XdmfBinaryLightData::toXML");
+  }
+
+  // Raw values are written as text the same as XdmfWriter does
+  std::vector<xmlNodePtr> elements(1, xmlDocGetRootElement(document));
+  while(elements.size() > 0) {
+    xmlNodePtr node = elements.back();
+    elements.pop_back();
+    for(xmlNodePtr child = node->children; child != NULL; child = child->next) {
+      if(child->type == XML_ELEMENT_NODE) {
+        elements.push_back(child);
+      }
+    }
+    const std::string * rawValues = getValues(node);
+    if(rawValues) {
+      std::map<std::string, std::string> properties;
+      for(xmlAttrPtr attribute = node->properties;
+          attribute != NULL;
+          attribute = attribute->next) {
+        xmlChar * value = xmlNodeGetContent((xmlNodePtr)attribute);
+        properties[(const char *)attribute->name] = (const char *)value;
+        xmlFree(value);
+      }
+      shared_ptr<const XdmfArrayType> arrayType =
+        XdmfArrayType::New(properties);
+      const unsigned int elementSize = arrayType->getElementSize();
+      if(elementSize == 0 || rawValues->size() % elementSize != 0) {
+        freeDocument(document);
+        XdmfError::message(XdmfError::FATAL,
+                           "Error: Binary light data values do not "
+                           "match their array in "
+                           "XdmfBinaryLightData::toXML");
+      }
+      shared_ptr<XdmfArray> array = XdmfArray::New();
+      array->initialize(arrayType, rawValues->size() / elementSize);
+      memcpy(array->getValuesInternal(), rawValues->data(), rawValues->size());
+      xmlAddChild(node,
+                  xmlNewText((xmlChar *)array->getValuesString().c_str()));
+    }
+  }
+
+  std::ofstream fileStream(xmlFilePath.c_str());
+  xmlBufferPtr buffer = xmlBufferCreate();
+  xmlOutputBuffer * outputBuffer = xmlOutputBufferCreateBuffer(buffer,
+                                                               NULL);
+  xmlSaveFormatFileTo(outputBuffer,
+                      document,
+                      "utf-8",
+                      1);
+  fileStream << buffer->content;
+  xmlBufferFree(buffer);
+  fileStream.close();
+  freeDocument(document);
+}
+
+void
+XdmfBinaryLightData::write(const xmlDocPtr document,
+                           const std::map<xmlNodePtr, std::string> & values,
+                           std::ostream & stream)
+{
+  stream.write(magic, headerSize - 2);
+  stream.put(version);
+#ifdef XDMF_BIG_ENDIAN
+  stream.put(1);
+#else
+  stream.put(0);
+#endif
+  Encoder encoder(values, stream);
+  encoder.writeElement(xmlDocGetRootElement(document));
+}
+
+// C Wrappers
+
+void
+XdmfBinaryLightDataToBinary(char * xmlFilePath, char * binaryFilePath, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  XdmfBinaryLightData::toBinary(xmlFilePath, binaryFilePath);
+  XDMF_ERROR_WRAP_END(status)
+}
+
+void
+XdmfBinaryLightDataToXML(char * binaryFilePath, char * xmlFilePath, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  XdmfBinaryLightData::toXML(binaryFilePath, xmlFilePath);
+  XDMF_ERROR_WRAP_END(status)
+}
@@ -0,0 +1,154 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfBinaryLightData.hpp                                             */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef XDMFBINARYLIGHTDATA_HPP_
+#define XDMFBINARYLIGHTDATA_HPP_
+
+// C Compatible Includes
+#include "XdmfCore.hpp"
+
+#ifdef __cplusplus
+
+// Includes
+#include <iosfwd>
+#include <libxml/tree.h>
+#include <map>
+#include <string>
+
+/**
+ * @brief Compact binary encoding of Xdmf light data.
+ *
+ * Light data is the XML description of the items in a file. The binary
+ * encoding holds the same elements, with their names and attributes
+ * written once to a string table and referenced by index, and with the
+ * values of arrays written to light data stored as raw bytes instead of
+ * text. Reading it skips parsing XML text and values.
+ *
+ * Binary light data is read into a libxml2 document like the one parsed
+ * from XML, so XdmfCoreReader reads either transparently, including
+ * xpointers between elements. Files are written by
+ * XdmfBinaryLightDataWriter, and converted to and from XML with
+ * toBinary() and toXML().
+ */
+class XDMFCORE_EXPORT XdmfBinaryLightData {
+
+public:
+
+  /**
+   * Frees a document read by read() or parsed from XML, along with the
+   * values stored for its elements.
+   *
+   * @param     document        The document to free.
+   */
+  static void freeDocument(xmlDocPtr document);
+
+  /**
+   * Gets the raw values stored for an element of a document read by
+   * read(), in the byte order of this machine.
+   *
+   * @param     node            The element to get the values of.
+   *
+   * @return    The values of the element, or NULL if it has none.
+   */
+  static const std::string * getValues(const xmlNodePtr node);
+
+  /**
+   * Checks whether a file holds binary light data.
+   *
+   * @param     filePath        The path of the file to check.
+   *
+   * @return    Whether the file holds binary light data.
+   */
+  static bool isBinary(const std::string & filePath);
+
+  /**
+   * Reads binary light data into a document. The document is freed with
+   * freeDocument().
+   *
+   * @param     filePath        The path of the file to read.
+   *
+   * @return    The document read, or NULL if the file could not be read.
+   */
+  static xmlDocPtr read(const std::string & filePath);
+
+  /**
+   * Converts an XML file to binary light data.
+   *
+   * @param     xmlFilePath     The path of the XML file to convert.
+   * @param     binaryFilePath  The path of the binary file to write.
+   */
+  static void toBinary(const std::string & xmlFilePath,
+                       const std::string & binaryFilePath);
+
+  /**
+   * Converts binary light data to an XML file, written the same as by
+   * XdmfWriter.
+   *
+   * @param     binaryFilePath  The path of the binary file to convert.
+   * @param     xmlFilePath     The path of the XML file to write.
+   */
+  static void toXML(const std::string & binaryFilePath,
+                    const std::string & xmlFilePath);
+
+  /**
+   * Writes a document as binary light data.
+   *
+   * @param     document        The document to write.
+   * @param     values          Raw values of arrays, written in place
+   *                            of the text of the elements they belong
+   *                            to.
+   * @param     stream          The stream to write to.
+   */
+  static void write(const xmlDocPtr document,
+                    const std::map<xmlNodePtr, std::string> & values,
+                    std::ostream & stream);
+
+protected:
+
+  XdmfBinaryLightData();
+  ~XdmfBinaryLightData();
+
+private:
+
+  XdmfBinaryLightData(const XdmfBinaryLightData &);  // Not implemented.
+  void operator=(const XdmfBinaryLightData &);  // Not implemented.
+
+};
+
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C wrappers go here
+
+XDMFCORE_EXPORT void XdmfBinaryLightDataToBinary(char * xmlFilePath, char * binaryFilePath, int * status);
+
+XDMFCORE_EXPORT void XdmfBinaryLightDataToXML(char * binaryFilePath, char * xmlFilePath, int * status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XDMFBINARYLIGHTDATA_HPP_ */
@@ -0,0 +1,64 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfBinaryLightDataWriter.cpp                                       */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <sstream>
+#include "XdmfBinaryLightDataWriter.hpp"
+#include "XdmfHDF5Writer.hpp"
+
+shared_ptr<XdmfBinaryLightDataWriter>
+XdmfBinaryLightDataWriter::New(const std::string & filePath)
+{
+  std::stringstream heavyFileName;
+  size_t extension = filePath.rfind(".");
+  if(extension != std::string::npos) {
+    heavyFileName << filePath.substr(0, extension) << ".h5";
+  }
+  else {
+    heavyFileName << filePath << ".h5";
+  }
+  shared_ptr<XdmfHDF5Writer> hdf5Writer =
+    XdmfHDF5Writer::New(heavyFileName.str());
+  shared_ptr<XdmfBinaryLightDataWriter>
+    p(new XdmfBinaryLightDataWriter(filePath, hdf5Writer));
+  return p;
+}
+
+shared_ptr<XdmfBinaryLightDataWriter>
+XdmfBinaryLightDataWriter::New(const std::string & filePath,
+                               const shared_ptr<XdmfHeavyDataWriter> heavyDataWriter)
+{
+  shared_ptr<XdmfBinaryLightDataWriter>
+    p(new XdmfBinaryLightDataWriter(filePath, heavyDataWriter));
+  return p;
+}
+
+XdmfBinaryLightDataWriter::XdmfBinaryLightDataWriter(const std::string & filePath,
+                                                     shared_ptr<XdmfHeavyDataWriter> heavyDataWriter) :
+  XdmfWriter(filePath, heavyDataWriter)
+{
+  this->setBinaryLightData(true);
+}
+
+XdmfBinaryLightDataWriter::~XdmfBinaryLightDataWriter()
+{
+}
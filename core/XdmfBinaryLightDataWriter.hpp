@@ -0,0 +1,95 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfBinaryLightDataWriter.hpp                                       */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef XDMFBINARYLIGHTDATAWRITER_HPP_
+#define XDMFBINARYLIGHTDATAWRITER_HPP_
+
+// C Compatible Includes
+#include "XdmfCore.hpp"
+#include "XdmfBinaryLightData.hpp"
+#include "XdmfWriter.hpp"
+
+#ifdef __cplusplus
+
+/**
+ * @brief Traverse the Xdmf graph and write light data as binary and heavy
+ * data to disk.
+ *
+ * XdmfBinaryLightDataWriter writes the same items as XdmfWriter, with
+ * the light data encoded as described in XdmfBinaryLightData instead
+ * of XML. Values of arrays written to light data are kept as raw bytes.
+ * Files written are read by XdmfReader like XML files, and converted to
+ * and from XML with XdmfBinaryLightData.
+ *
+ * Streaming the light data is not supported by the binary encoding, so
+ * setStreamXML() has no effect.
+ */
+class XDMFCORE_EXPORT XdmfBinaryLightDataWriter : public XdmfWriter {
+
+public:
+
+  /**
+   * Create a new XdmfBinaryLightDataWriter to write Xdmf data to
+   * disk. This will create its own hdf5 writer based on the file path,
+   * like XdmfWriter.
+   *
+   * @param     filePath        The path of the light data file to write
+   *                            to.
+   *
+   * @return    The new XdmfBinaryLightDataWriter.
+   */
+  static shared_ptr<XdmfBinaryLightDataWriter>
+  New(const std::string & filePath);
+
+  /**
+   * Create a new XdmfBinaryLightDataWriter to write Xdmf data to
+   * disk. This will utilize the passed heavy data writer to write any
+   * heavy data to disk.
+   *
+   * @param     filePath        The path of the light data file to write
+   *                            to.
+   * @param     heavyDataWriter The heavy data writer to use when writing.
+   *
+   * @return    The new XdmfBinaryLightDataWriter.
+   */
+  static shared_ptr<XdmfBinaryLightDataWriter>
+  New(const std::string & filePath,
+      const shared_ptr<XdmfHeavyDataWriter> heavyDataWriter);
+
+  virtual ~XdmfBinaryLightDataWriter();
+
+protected:
+
+  XdmfBinaryLightDataWriter(const std::string & filePath,
+                            shared_ptr<XdmfHeavyDataWriter> heavyDataWriter);
+
+private:
+
+  XdmfBinaryLightDataWriter(const XdmfBinaryLightDataWriter &);  // Not implemented.
+  void operator=(const XdmfBinaryLightDataWriter &);  // Not implemented.
+
+};
+
+#endif
+
+#endif /* XDMFBINARYLIGHTDATAWRITER_HPP_ */
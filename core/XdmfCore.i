@@ -79,6 +79,7 @@ swig -v -c++ -python -o XdmfCorePython.cpp XdmfCore.i
 %ignore XdmfItemRemoveInformation(XDMFITEM * item, unsigned int index);
 %ignore XdmfItemRemoveInformationByKey(XDMFITEM * item, char * key);
 %ignore XdmfItemGetItemTag(XDMFITEM * item);
+%ignore XdmfChildIndex;
 
 // XdmfArray
 
@@ -24,11 +24,14 @@
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
 #include <cstring>
+#include <list>
 #include <map>
 #include <sstream>
+#include <sys/stat.h>
 #include <utility>
 #include "XdmfArray.hpp"
 #include "XdmfArrayType.hpp"
+#include "XdmfBinaryLightData.hpp"
 #include "XdmfCoreItemFactory.hpp"
 #include "XdmfCoreReader.hpp"
 #include "XdmfError.hpp"
@@ -37,6 +40,280 @@
 #include "XdmfItem.hpp"
 #include "XdmfSystemUtils.hpp"
 
+namespace {
+
+  /**
+   * Reads a file as binary light data or parses it as XML.
+   */
+  xmlDocPtr
+  readDocument(const std::string & filePath,
+               const int options)
+  {
+    if(XdmfBinaryLightData::isBinary(filePath)) {
+      return XdmfBinaryLightData::read(filePath);
+    }
+    return xmlReadFile(filePath.c_str(), NULL, options);
+  }
+
+  /**
+   * Parsed documents shared by every reader in the process, along with
+   * the nodes that XPaths evaluated on them matched. A document stays
+   * valid while the file it was read from keeps the same modification
+   * time and size. Documents in use by a reader are never freed until
+   * released.
+   */
+  class XdmfDocumentCache {
+
+  public:
+
+    static XdmfDocumentCache &
+    instance()
+    {
+      static XdmfDocumentCache cache;
+      return cache;
+    }
+
+    /**
+     * Gets the parsed document for a file, parsing it if it is not
+     * cached or changed since it was. Returns NULL if it can not be parsed.
+     */
+    xmlDocPtr
+    acquire(const std::string & filePath,
+            const int options)
+    {
+      struct stat fileStatus;
+      if(mMaxSize == 0 || stat(filePath.c_str(), &fileStatus) != 0) {
+        // Not cached, freed when released
+        return readDocument(filePath, options);
+      }
+
+      long modified = (long)fileStatus.st_mtime;
+#ifdef __linux__
+      long modifiedNano = fileStatus.st_mtim.tv_nsec;
+#else
+      long modifiedNano = 0;
+#endif
+
+      // Parsed from the real path so that relative XIncludes resolve
+      // from any working directory
+      const std::string realPath = XdmfSystemUtils::getRealPath(filePath);
+      std::stringstream keyStream;
+      keyStream << options << ":" << realPath;
+      const std::string key = keyStream.str();
+
+      std::map<std::string, CachedDocument>::iterator iter =
+        mDocuments.find(key);
+      if(iter != mDocuments.end()) {
+        CachedDocument & cached = iter->second;
+        if(cached.mModified == modified &&
+           cached.mModifiedNano == modifiedNano &&
+           cached.mSize == (unsigned long)fileStatus.st_size) {
+          ++cached.mUsers;
+          this->touch(iter);
+          return cached.mDocument;
+        }
+        // Stale, drop it from the cache
+        this->remove(iter);
+      }
+
+      xmlDocPtr document = readDocument(realPath, options);
+      if(document == NULL) {
+        return NULL;
+      }
+
+      CachedDocument cached;
+      cached.mDocument = document;
+      cached.mModified = modified;
+      cached.mModifiedNano = modifiedNano;
+      cached.mSize = fileStatus.st_size;
+      cached.mUsers = 1;
+      cached.mStale = false;
+      mLeastRecent.push_front(key);
+      cached.mUse = mLeastRecent.begin();
+      mDocuments.insert(std::make_pair(key, cached));
+      mKeys.insert(std::make_pair(document, key));
+      mTotalSize += cached.mSize;
+
+      this->evict();
+      return document;
+    }
+
+    void
+    clear()
+    {
+      std::map<std::string, CachedDocument>::iterator iter =
+        mDocuments.begin();
+      while(iter != mDocuments.end()) {
+        std::map<std::string, CachedDocument>::iterator current = iter++;
+        this->remove(current);
+      }
+    }
+
+    bool
+    empty() const
+    {
+      return mDocuments.empty();
+    }
+
+    /**
+     * Gets the nodes an XPath matched in a cached document, or NULL if
+     * the XPath has not been evaluated on it.
+     */
+    const std::vector<xmlNodePtr> *
+    findPath(const xmlDocPtr document,
+             const std::string & xPath) const
+    {
+      std::map<xmlDocPtr, std::string>::const_iterator key =
+        mKeys.find(document);
+      if(key == mKeys.end()) {
+        return NULL;
+      }
+      const CachedDocument & cached = mDocuments.find(key->second)->second;
+      std::map<std::string, std::vector<xmlNodePtr> >::const_iterator iter =
+        cached.mPaths.find(xPath);
+      if(iter == cached.mPaths.end()) {
+        return NULL;
+      }
+      return &(iter->second);
+    }
+
+    unsigned long
+    getMaxSize() const
+    {
+      return mMaxSize;
+    }
+
+    void
+    release(const xmlDocPtr document)
+    {
+      std::map<xmlDocPtr, std::string>::iterator key = mKeys.find(document);
+      if(key == mKeys.end()) {
+        XdmfBinaryLightData::freeDocument(document);
+        return;
+      }
+      std::map<std::string, CachedDocument>::iterator iter =
+        mDocuments.find(key->second);
+      --iter->second.mUsers;
+      if(iter->second.mStale) {
+        this->remove(iter);
+      }
+      else {
+        this->evict();
+      }
+    }
+
+    void
+    setMaxSize(const unsigned long size)
+    {
+      mMaxSize = size;
+      this->evict();
+    }
+
+    void
+    storePath(const xmlDocPtr document,
+              const std::string & xPath,
+              const std::vector<xmlNodePtr> & nodes)
+    {
+      std::map<xmlDocPtr, std::string>::const_iterator key =
+        mKeys.find(document);
+      if(key != mKeys.end()) {
+        mDocuments.find(key->second)->second.mPaths[xPath] = nodes;
+      }
+    }
+
+  private:
+
+    struct CachedDocument {
+      xmlDocPtr mDocument;
+      long mModified;
+      long mModifiedNano;
+      std::map<std::string, std::vector<xmlNodePtr> > mPaths;
+      unsigned long mSize;
+      bool mStale;
+      std::list<std::string>::iterator mUse;
+      unsigned int mUsers;
+    };
+
+    XdmfDocumentCache() :
+      mMaxSize(64 * 1024 * 1024),
+      mTotalSize(0)
+    {
+    }
+
+    ~XdmfDocumentCache()
+    {
+      this->clear();
+    }
+
+    /**
+     * Frees least recently used documents until the cache fits.
+     */
+    void
+    evict()
+    {
+      std::list<std::string>::iterator use = mLeastRecent.end();
+      while(mTotalSize > mMaxSize && use != mLeastRecent.begin()) {
+        std::list<std::string>::iterator current = use;
+        --current;
+        std::map<std::string, CachedDocument>::iterator iter =
+          mDocuments.find(*current);
+        if(iter->second.mUsers == 0) {
+          this->remove(iter);
+        }
+        else {
+          use = current;
+        }
+      }
+    }
+
+    /**
+     * Frees a document, or marks it stale to be freed when the last
+     * reader using it releases it.
+     */
+    void
+    remove(std::map<std::string, CachedDocument>::iterator iter)
+    {
+      CachedDocument & cached = iter->second;
+      if(cached.mUsers > 0) {
+        if(!cached.mStale) {
+          cached.mStale = true;
+          mTotalSize -= cached.mSize;
+          // Rekey so that a fresh copy of the file can be cached
+          mLeastRecent.erase(cached.mUse);
+          std::stringstream staleKey;
+          staleKey << "stale:" << (void *)cached.mDocument;
+          mLeastRecent.push_back(staleKey.str());
+          cached.mUse = --mLeastRecent.end();
+          mKeys[cached.mDocument] = staleKey.str();
+          mDocuments.insert(std::make_pair(staleKey.str(), cached));
+          mDocuments.erase(iter);
+        }
+        return;
+      }
+      if(!cached.mStale) {
+        mTotalSize -= cached.mSize;
+      }
+      XdmfBinaryLightData::freeDocument(cached.mDocument);
+      mKeys.erase(cached.mDocument);
+      mLeastRecent.erase(cached.mUse);
+      mDocuments.erase(iter);
+    }
+
+    void
+    touch(std::map<std::string, CachedDocument>::iterator iter)
+    {
+      mLeastRecent.splice(mLeastRecent.begin(), mLeastRecent, iter->second.mUse);
+    }
+
+    std::map<std::string, CachedDocument> mDocuments;
+    std::map<xmlDocPtr, std::string> mKeys;
+    std::list<std::string> mLeastRecent;
+    unsigned long mMaxSize;
+    unsigned long mTotalSize;
+  };
+
+}
+
 /**
  * PIMPL
  */
@@ -60,13 +337,17 @@ public:
   {
     mXPathMap.clear();
     xmlXPathFreeContext(mXPathContext);
+    XdmfDocumentCache & cache = XdmfDocumentCache::instance();
     for(std::map<std::string, xmlDocPtr>::const_iterator iter = 
 	  mDocuments.begin(); iter != mDocuments.end(); ++iter) {
-      xmlFreeDoc(iter->second);
+      cache.release(iter->second);
     }
     mDocuments.clear();
     
-    xmlCleanupParser();
+    // Cached documents outlive the read
+    if(cache.empty()) {
+      xmlCleanupParser();
+    }
   }
 
   void
@@ -78,7 +359,8 @@ public:
       mXMLDir = mXMLDir.substr(0, index + 1);
     }
 
-    mDocument = xmlReadFile(filePath.c_str(), NULL, XML_PARSE_NOENT);
+    mDocument = XdmfDocumentCache::instance().acquire(filePath,
+                                                      XML_PARSE_NOENT);
 
     if(mDocument == NULL) {
       XdmfError::message(XdmfError::FATAL,
@@ -86,7 +368,7 @@ public:
                          " in XdmfCoreReader::XdmfCoreReaderImpl::openFile");
     }
 
-    mDocuments.insert(std::make_pair((char*)mDocument->URL, mDocument));
+    mDocuments.insert(std::make_pair(filePath, mDocument));
 
     mXPathContext = xmlXPtrNewContext(mDocument, NULL, NULL);
     mXPathMap.clear();
@@ -157,13 +439,20 @@ public:
       xmlXPathContextPtr oldContext = mXPathContext;
       if(href) {
         xmlDocPtr document;
-        xmlChar * filePath = xmlBuildURI(href, mDocument->URL);
+        xmlChar * builtPath = xmlBuildURI(href, mDocument->URL);
+        const std::string filePath((char*)builtPath);
+        xmlFree(builtPath);
         std::map<std::string, xmlDocPtr>::const_iterator iter = 
-          mDocuments.find((char*)filePath);
+          mDocuments.find(filePath);
         if(iter == mDocuments.end()) {
-          document = xmlReadFile((char*)filePath, NULL, 0);
-          mDocuments.insert(std::make_pair((char*)document->URL, 
-                                           document));
+          document = XdmfDocumentCache::instance().acquire(filePath, 0);
+          if(document == NULL) {
+            XdmfError::message(XdmfError::FATAL,
+                               "xmlReadFile could not read " + filePath +
+                               " in XdmfCoreReader::XdmfCoreReaderImpl::"
+                               "readSingleNode");
+          }
+          mDocuments.insert(std::make_pair(filePath, document));
         }
         else {
           document = iter->second;
@@ -173,18 +462,15 @@ public:
       }
       
       if(xpointer) {
-        xmlXPathObjectPtr result = xmlXPtrEval(xpointer, mXPathContext);
-        if(result && !xmlXPathNodeSetIsEmpty(result->nodesetval)) {
-          for(int i=0; i<result->nodesetval->nodeNr; ++i) {
-            this->readSingleNode(result->nodesetval->nodeTab[i],
-                                 myItems);
-          }
-        }
-        else {
+        const std::vector<xmlNodePtr> nodes =
+          this->evaluate("xpointer:" + std::string((char*)xpointer));
+        if(nodes.size() == 0) {
           XdmfError::message(XdmfError::FATAL,
                              "Invalid xpointer encountered.");
         }
-        xmlXPathFreeObject(result);
+        for(unsigned int i=0; i<nodes.size(); ++i) {
+          this->readSingleNode(nodes[i], myItems);
+        }
       }
       
       if(href) {
@@ -207,9 +493,17 @@ public:
         // Otherwise, generate a new XdmfItem from the node
         std::map<std::string, std::string> itemProperties;
 
+        // Values stored as raw bytes in binary light data
+        const std::string * values =
+          XdmfBinaryLightData::getValues(currNode);
+
         xmlNodePtr childNode = currNode->children;
         // generate content if an array or arrayReference
-        if (mItemFactory->isArrayTag((char *)currNode->name)) {
+        if (values) {
+          itemProperties.insert(std::make_pair("Content", ""));
+          itemProperties.insert(std::make_pair("XMLDir", mXMLDir));
+        }
+        else if (mItemFactory->isArrayTag((char *)currNode->name)) {
           while(childNode != NULL) {
             if(childNode->type == XML_TEXT_NODE && childNode->content) {
               const char * content = (char*)childNode->content;
@@ -266,24 +560,71 @@ public:
                               childItems,
                               mCoreReader);
 
+        if (values) {
+          // Initialized to the size of the values by populateItem
+          shared_ptr<XdmfArray> array =
+            shared_dynamic_cast<XdmfArray>(newItem);
+          if (!array ||
+              array->getSize() * array->getArrayType()->getElementSize() !=
+              values->size()) {
+            XdmfError::message(XdmfError::FATAL,
+                               "Error: Binary light data values do not "
+                               "match their array in XdmfCoreReader::"
+                               "XdmfCoreReaderImpl::readSingleNode");
+          }
+          memcpy(array->getValuesInternal(), values->data(), values->size());
+        }
+
         myItems.push_back(newItem);
         mXPathMap.insert(std::make_pair(currNode, newItem));
       }
     }
   }
 
+  /**
+   * Gets the nodes matched by an XPath, or an XPointer when prefixed
+   * with "xpointer:", in the current context. The nodes are kept in the
+   * document cache so that reading the same path again skips evaluating
+   * it.
+   */
+  std::vector<xmlNodePtr>
+  evaluate(const std::string & path)
+  {
+    XdmfDocumentCache & cache = XdmfDocumentCache::instance();
+    const std::vector<xmlNodePtr> * cachedNodes =
+      cache.findPath(mXPathContext->doc, path);
+    if(cachedNodes) {
+      return *cachedNodes;
+    }
+
+    std::vector<xmlNodePtr> nodes;
+    xmlXPathObjectPtr xPathObject;
+    if(path.compare(0, 9, "xpointer:") == 0) {
+      xPathObject = xmlXPtrEval((xmlChar*)path.c_str() + 9, mXPathContext);
+    }
+    else {
+      xPathObject = xmlXPathEvalExpression((xmlChar*)path.c_str(),
+                                           mXPathContext);
+    }
+    if(xPathObject && xPathObject->nodesetval) {
+      nodes.assign(xPathObject->nodesetval->nodeTab,
+                   xPathObject->nodesetval->nodeTab +
+                   xPathObject->nodesetval->nodeNr);
+    }
+    xmlXPathFreeObject(xPathObject);
+
+    cache.storePath(mXPathContext->doc, path, nodes);
+    return nodes;
+  }
+
   void
   readPathObjects(const std::string & xPath,
                   std::vector<shared_ptr<XdmfItem> > & myItems)
   {
-    xmlXPathObjectPtr xPathObject =
-      xmlXPathEvalExpression((xmlChar*)xPath.c_str(), mXPathContext);
-    if(xPathObject && xPathObject->nodesetval) {
-      for(int i=0; i<xPathObject->nodesetval->nodeNr; ++i) {
-        this->readSingleNode(xPathObject->nodesetval->nodeTab[i], myItems);
-      }
+    const std::vector<xmlNodePtr> nodes = this->evaluate(xPath);
+    for(unsigned int i=0; i<nodes.size(); ++i) {
+      this->readSingleNode(nodes[i], myItems);
     }
-    xmlXPathFreeObject(xPathObject);
   }
 
   xmlDocPtr mDocument;
@@ -305,6 +646,24 @@ XdmfCoreReader::~XdmfCoreReader()
   delete mImpl;
 }
 
+void
+XdmfCoreReader::clearDocumentCache()
+{
+  XdmfDocumentCache::instance().clear();
+}
+
+unsigned long
+XdmfCoreReader::getDocumentCacheSize()
+{
+  return XdmfDocumentCache::instance().getMaxSize();
+}
+
+void
+XdmfCoreReader::setDocumentCacheSize(const unsigned long size)
+{
+  XdmfDocumentCache::instance().setMaxSize(size);
+}
+
 XdmfItem *
 XdmfCoreReader::DuplicatePointer(shared_ptr<XdmfItem> original) const
 {
@@ -391,6 +750,18 @@ XdmfCoreReader::readPathObjects(const std::string & xPath) const
 
 // C Wrappers
 
+void
+XdmfCoreReaderClearDocumentCache()
+{
+  XdmfCoreReader::clearDocumentCache();
+}
+
+unsigned long
+XdmfCoreReaderGetDocumentCacheSize()
+{
+  return XdmfCoreReader::getDocumentCacheSize();
+}
+
 XDMFITEM *
 XdmfCoreReaderRead(XDMFCOREREADER * reader, char * filePath, int * status)
 {
@@ -400,3 +771,9 @@ XdmfCoreReaderRead(XDMFCOREREADER * reader, char * filePath, int * status)
   XDMF_ERROR_WRAP_END(status)
   return NULL;
 }
+
+void
+XdmfCoreReaderSetDocumentCacheSize(unsigned long size)
+{
+  XdmfCoreReader::setDocumentCacheSize(size);
+}
@@ -56,6 +56,39 @@ public:
 
   virtual ~XdmfCoreReader() = 0;
 
+  /**
+   * Frees every document held in the shared document cache.
+   *
+   * Documents that a reader is still reading from are freed once that
+   * read completes.
+   */
+  static void clearDocumentCache();
+
+  /**
+   * Gets the maximum size of the shared document cache.
+   *
+   * @return    The maximum combined size, in bytes, of the Xdmf files
+   *            kept parsed between reads.
+   */
+  static unsigned long getDocumentCacheSize();
+
+  /**
+   * Sets the maximum size of the shared document cache.
+   *
+   * Every reader in the process keeps the files it parsed in this
+   * cache, keyed by their real path and modification time, along with
+   * the nodes matched by the XPaths evaluated on them. Reading the same
+   * file again, as grid controllers and XIncludes into a common file do,
+   * skips parsing it and reevaluating those XPaths. The least recently
+   * used files are freed once the combined size of the cached files
+   * exceeds this size. The cache is not safe to use from several threads
+   * at once.
+   *
+   * @param     size    The maximum combined size, in bytes, of the files
+   *                    in the cache. 0 disables the cache.
+   */
+  static void setDocumentCacheSize(const unsigned long size);
+
   /**
    * Uses the internal item factory to create a copy of the internal pointer
    * of the provided shared pointer. Primarily used for C wrapping.
@@ -249,8 +282,14 @@ extern "C" {
 struct XDMFCOREREADER; // Simply as a typedef to ensure correct typing
 typedef struct XDMFCOREREADER XDMFCOREREADER;
 
+XDMFCORE_EXPORT void XdmfCoreReaderClearDocumentCache();
+
+XDMFCORE_EXPORT unsigned long XdmfCoreReaderGetDocumentCacheSize();
+
 XDMFCORE_EXPORT XDMFITEM * XdmfCoreReaderRead(XDMFCOREREADER * reader, char * filePath, int * status);
 
+XDMFCORE_EXPORT void XdmfCoreReaderSetDocumentCacheSize(unsigned long size);
+
 #define XDMF_CORE_READER_C_CHILD_DECLARE(ClassName, CClassName, Level)                      \
                                                                                             \
 Level##_EXPORT XDMFITEM * ClassName##Read( CClassName * reader, char * filePath, int * status);
@@ -41,6 +41,185 @@ namespace {
 
   const static unsigned int DEFAULT_CHUNK_SIZE = 1000;
 
+  const static char * CONTENT_HASH_ATTRIBUTE = "XdmfContentHash";
+
+  // Returns -1 for types hdf5 can't store, string types need to be closed
+  hid_t
+  getDatatype(const shared_ptr<const XdmfArrayType> type)
+  {
+    if(type == XdmfArrayType::Int8()) {
+      return H5T_NATIVE_CHAR;
+    }
+    else if(type == XdmfArrayType::Int16()) {
+      return H5T_NATIVE_SHORT;
+    }
+    else if(type == XdmfArrayType::Int32()) {
+      return H5T_NATIVE_INT;
+    }
+    else if(type == XdmfArrayType::Int64()) {
+      return H5T_NATIVE_LONG;
+    }
+    else if(type == XdmfArrayType::Float32()) {
+      return H5T_NATIVE_FLOAT;
+    }
+    else if(type == XdmfArrayType::Float64()) {
+      return H5T_NATIVE_DOUBLE;
+    }
+    else if(type == XdmfArrayType::UInt8()) {
+      return H5T_NATIVE_UCHAR;
+    }
+    else if(type == XdmfArrayType::UInt16()) {
+      return H5T_NATIVE_USHORT;
+    }
+    else if(type == XdmfArrayType::UInt32()) {
+      return H5T_NATIVE_UINT;
+    }
+    else if(type == XdmfArrayType::String()) {
+      // Strings are a special case as they have mutable size
+      hid_t datatype = H5Tcopy(H5T_C_S1);
+      H5Tset_size(datatype, H5T_VARIABLE);
+      return datatype;
+    }
+    return -1;
+  }
+
+  // 64 bit MurmurHash2, continued from seed
+  unsigned long long
+  hashBytes(const void * data,
+            const size_t length,
+            const unsigned long long seed)
+  {
+    const unsigned long long m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    unsigned long long hash = seed ^ (length * m);
+
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    const unsigned char * end = bytes + (length / 8) * 8;
+    for(; bytes != end; bytes += 8) {
+      unsigned long long block;
+      memcpy(&block, bytes, 8);
+      block *= m;
+      block ^= block >> r;
+      block *= m;
+      hash ^= block;
+      hash *= m;
+    }
+
+    // Each remaining byte falls through to the ones before it
+    switch(length & 7) {
+    case 7: hash ^= (unsigned long long)bytes[6] << 48;
+      // fall through
+    case 6: hash ^= (unsigned long long)bytes[5] << 40;
+      // fall through
+    case 5: hash ^= (unsigned long long)bytes[4] << 32;
+      // fall through
+    case 4: hash ^= (unsigned long long)bytes[3] << 24;
+      // fall through
+    case 3: hash ^= (unsigned long long)bytes[2] << 16;
+      // fall through
+    case 2: hash ^= (unsigned long long)bytes[1] << 8;
+      // fall through
+    case 1: hash ^= (unsigned long long)bytes[0];
+            hash *= m;
+    };
+
+    hash ^= hash >> r;
+    hash *= m;
+    hash ^= hash >> r;
+    return hash;
+  }
+
+  // Hash of the values of an array, along with its type and dimensions
+  // since those describe the dataset written
+  unsigned long long
+  hashContents(const XdmfArray & array)
+  {
+    std::stringstream description;
+    description << array.getArrayType()->getName() << " "
+                << array.getArrayType()->getElementSize() << " "
+                << array.getDimensionsString();
+    const std::string descriptionString = description.str();
+    const unsigned long long hash = hashBytes(descriptionString.c_str(),
+                                              descriptionString.size(),
+                                              0);
+    return hashBytes(array.getValuesInternal(),
+                     array.getSize() *
+                     array.getArrayType()->getElementSize(),
+                     hash);
+  }
+
+  // Whether a dataset holds exactly the values of an array, since
+  // arrays with different values may share a hash
+  bool
+  equalContents(const hid_t file,
+                const std::string & dataSetPath,
+                const hid_t datatype,
+                const XdmfArray & array)
+  {
+    const hid_t dataset = H5Dopen(file, dataSetPath.c_str(), H5P_DEFAULT);
+    if(dataset < 0) {
+      return false;
+    }
+    bool equal = false;
+    const hid_t dataspace = H5Dget_space(dataset);
+    const hid_t datasetType = H5Dget_type(dataset);
+    const size_t elementSize = array.getArrayType()->getElementSize();
+    if(dataspace >= 0 && datasetType >= 0 &&
+       H5Sget_simple_extent_npoints(dataspace) == (hssize_t)array.getSize() &&
+       H5Tget_class(datasetType) == H5Tget_class(datatype) &&
+       H5Tget_size(datasetType) == elementSize) {
+      std::vector<char> values(array.getSize() * elementSize);
+      if(values.size() == 0) {
+        equal = true;
+      }
+      else if(H5Dread(dataset,
+                      datatype,
+                      H5S_ALL,
+                      H5S_ALL,
+                      H5P_DEFAULT,
+                      &values[0]) >= 0) {
+        equal = memcmp(&values[0],
+                       array.getValuesInternal(),
+                       values.size()) == 0;
+      }
+    }
+    if(datasetType >= 0) {
+      H5Tclose(datasetType);
+    }
+    if(dataspace >= 0) {
+      H5Sclose(dataspace);
+    }
+    H5Dclose(dataset);
+    return equal;
+  }
+
+  herr_t
+  readContentHash(hid_t group,
+                  const char * name,
+                  const H5L_info_t * info,
+                  void * index)
+  {
+    if(info->type == H5L_TYPE_HARD &&
+       H5Aexists_by_name(group,
+                         name,
+                         CONTENT_HASH_ATTRIBUTE,
+                         H5P_DEFAULT) > 0) {
+      hid_t attribute = H5Aopen_by_name(group,
+                                        name,
+                                        CONTENT_HASH_ATTRIBUTE,
+                                        H5P_DEFAULT,
+                                        H5P_DEFAULT);
+      unsigned long long hash;
+      if(attribute >= 0) {
+        if(H5Aread(attribute, H5T_NATIVE_ULLONG, &hash) >= 0) {
+          (*static_cast<std::map<unsigned long long, std::string> *>(index))[hash] = name;
+        }
+        H5Aclose(attribute);
+      }
+    }
+    return 0;
+  }
+
 }
 
 XdmfHDF5Writer::XdmfHDF5WriterImpl::XdmfHDF5WriterImpl():
@@ -104,6 +283,8 @@ XdmfHDF5Writer::XdmfHDF5WriterImpl::openFile(const std::string & filePath,
                             H5F_ACC_TRUNC,
                             H5P_DEFAULT,
                             mFapl);
+    // Anything indexed from a previous file at this path is gone
+    mContentIndex.erase(filePath);
   }
 
   // Restore previous error handler
@@ -112,6 +293,73 @@ XdmfHDF5Writer::XdmfHDF5WriterImpl::openFile(const std::string & filePath,
   return toReturn;
 }
 
+std::map<unsigned long long, std::string> &
+XdmfHDF5Writer::XdmfHDF5WriterImpl::getContentIndex()
+{
+  std::map<std::string, std::map<unsigned long long, std::string> >::iterator
+    index = mContentIndex.find(mOpenFile);
+  if(index == mContentIndex.end()) {
+    index = mContentIndex.insert(std::make_pair(mOpenFile,
+                                                std::map<unsigned long long, std::string>())).first;
+    // Read the hashes written to the file by earlier runs
+    H5E_auto_t old_func;
+    void * old_client_data;
+    H5Eget_auto(0, &old_func, &old_client_data);
+    H5Eset_auto2(0, NULL, NULL);
+    H5Literate(mHDF5Handle,
+               H5_INDEX_NAME,
+               H5_ITER_NATIVE,
+               NULL,
+               readContentHash,
+               &(index->second));
+    H5Eset_auto2(0, old_func, old_client_data);
+  }
+  return index->second;
+}
+
+void
+XdmfHDF5Writer::XdmfHDF5WriterImpl::removeContentHash(hid_t dataset,
+                                                      const std::string & dataSetPath)
+{
+  if(H5Aexists(dataset, CONTENT_HASH_ATTRIBUTE) > 0) {
+    H5Adelete(dataset, CONTENT_HASH_ATTRIBUTE);
+    std::map<std::string, std::map<unsigned long long, std::string> >::iterator
+      index = mContentIndex.find(mOpenFile);
+    if(index != mContentIndex.end()) {
+      for(std::map<unsigned long long, std::string>::iterator iter =
+            index->second.begin();
+          iter != index->second.end();
+          ++iter) {
+        if(iter->second.compare(dataSetPath) == 0) {
+          index->second.erase(iter);
+          break;
+        }
+      }
+    }
+  }
+}
+
+void
+XdmfHDF5Writer::XdmfHDF5WriterImpl::writeContentHash(hid_t dataset,
+                                                     const std::string & dataSetPath,
+                                                     const unsigned long long hash)
+{
+  hid_t dataspace = H5Screate(H5S_SCALAR);
+  hid_t attribute = H5Acreate(dataset,
+                              CONTENT_HASH_ATTRIBUTE,
+                              H5T_STD_U64LE,
+                              dataspace,
+                              H5P_DEFAULT,
+                              H5P_DEFAULT);
+  if(attribute >= 0) {
+    if(H5Awrite(attribute, H5T_NATIVE_ULLONG, &hash) >= 0) {
+      this->getContentIndex()[hash] = dataSetPath;
+    }
+    H5Aclose(attribute);
+  }
+  H5Sclose(dataspace);
+}
+
 shared_ptr<XdmfHDF5Writer>
 XdmfHDF5Writer::New(const std::string & filePath,
                     const bool clobberFile)
@@ -128,7 +376,8 @@ XdmfHDF5Writer::XdmfHDF5Writer(const std::string & filePath) :
   XdmfHeavyDataWriter(filePath, 1, 800),
   mImpl(new XdmfHDF5WriterImpl()),
   mUseDeflate(false),
-  mDeflateFactor(0)
+  mDeflateFactor(0),
+  mDeduplicate(false)
 {
 }
 
@@ -137,7 +386,8 @@ XdmfHDF5Writer::XdmfHDF5Writer(const XdmfHDF5Writer & writerRef) :
   XdmfHeavyDataWriter(writerRef.getFilePath(), 1, 800),
   mImpl(new XdmfHDF5WriterImpl()),
   mUseDeflate(false),
-  mDeflateFactor(0)
+  mDeflateFactor(0),
+  mDeduplicate(false)
 {
 }
 
@@ -146,6 +396,109 @@ XdmfHDF5Writer::~XdmfHDF5Writer()
   delete mImpl;
 }
 
+shared_ptr<XdmfHeavyDataController>
+XdmfHDF5Writer::allocateDataSet(const shared_ptr<const XdmfArrayType> type,
+                                const unsigned int numValues,
+                                const unsigned int chunkSize)
+{
+  hid_t datatype = getDatatype(type);
+  if(datatype == -1) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Array of unsupported type in "
+                       "XdmfHDF5Writer::allocateDataSet");
+  }
+
+  bool closeFile = false;
+  if (mImpl->mOpenFile.compare(mFilePath) != 0) {
+    if(mImpl->mHDF5Handle < 0) {
+      closeFile = true;
+    }
+    mImpl->openFile(mFilePath,
+                    mDataSetId);
+  }
+
+  // Find an unused dataset name
+  std::stringstream dataSetPath;
+  dataSetPath << "Data" << mDataSetId;
+  while(H5Lexists(mImpl->mHDF5Handle,
+                  dataSetPath.str().c_str(),
+                  H5P_DEFAULT) > 0) {
+    dataSetPath.str(std::string());
+    dataSetPath << "Data" << ++mDataSetId;
+  }
+
+  // Extendible, and chunked so that later writes fill whole chunks
+  hsize_t current_dims = numValues;
+  hsize_t maximum_dims = H5S_UNLIMITED;
+  hsize_t chunk_size = chunkSize;
+  if(chunk_size == 0) {
+    chunk_size = mImpl->mChunkSize;
+  }
+  if(chunk_size == 0) {
+    chunk_size = 1;
+  }
+
+  hid_t dataspace = H5Screate_simple(1,
+                                     &current_dims,
+                                     &maximum_dims);
+  hid_t property = H5Pcreate(H5P_DATASET_CREATE);
+  bool propertySet = property >= 0;
+  if (propertySet && mUseDeflate)
+  {
+    propertySet = H5Pset_deflate(property, mDeflateFactor) >= 0;
+  }
+  if (propertySet) {
+    propertySet = H5Pset_chunk(property, 1, &chunk_size) >= 0;
+  }
+  hid_t dataset = -1;
+  if (propertySet) {
+    dataset = H5Dcreate(mImpl->mHDF5Handle,
+                        dataSetPath.str().c_str(),
+                        datatype,
+                        dataspace,
+                        H5P_DEFAULT,
+                        property,
+                        H5P_DEFAULT);
+  }
+  if(property >= 0) {
+    H5Pclose(property);
+  }
+  H5Sclose(dataspace);
+  if(type == XdmfArrayType::String()) {
+    H5Tclose(datatype);
+  }
+
+  if(dataset < 0) {
+    if(closeFile) {
+      mImpl->closeFile();
+    }
+    if(!propertySet) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Setting the chunked layout failed in "
+                         "XdmfHDF5Writer::allocateDataSet");
+    }
+    XdmfError::message(XdmfError::FATAL,
+                       "H5Dcreate returned failure in "
+                       "XdmfHDF5Writer::allocateDataSet");
+  }
+  H5Dclose(dataset);
+
+  if(closeFile) {
+    mImpl->closeFile();
+  }
+
+  shared_ptr<XdmfHeavyDataController> controller =
+    this->createController(mFilePath,
+                           dataSetPath.str(),
+                           type,
+                           std::vector<unsigned int>(1, 0),
+                           std::vector<unsigned int>(1, 1),
+                           std::vector<unsigned int>(1, numValues),
+                           std::vector<unsigned int>(1, numValues));
+  ++mDataSetId;
+  return controller;
+}
+
 void
 XdmfHDF5Writer::controllerSplitting(XdmfArray & array,
                                     int & controllerIndexOffset,
@@ -999,12 +1352,24 @@ XdmfHDF5Writer::getDataSetSize(const std::string & fileName, const std::string &
   return checksize;
 }
 
+bool
+XdmfHDF5Writer::getDeduplicate() const
+{
+  return mDeduplicate;
+}
+
 int
 XdmfHDF5Writer::getDeflateFactor() const
 {
   return mDeflateFactor;
 }
 
+bool
+XdmfHDF5Writer::getFileIsOpen() const
+{
+  return !mImpl->mOpenFile.empty() && mImpl->mOpenFile.compare(mFilePath) == 0;
+}
+
 bool
 XdmfHDF5Writer::getUseDeflate() const
 {
@@ -1030,6 +1395,12 @@ XdmfHDF5Writer::setChunkSize(const unsigned int chunkSize)
   mImpl->mChunkSize = chunkSize;
 }
 
+void
+XdmfHDF5Writer::setDeduplicate(const bool deduplicate)
+{
+  mDeduplicate = deduplicate;
+}
+
 void
 XdmfHDF5Writer::setDeflateFactor(int factor)
 {
@@ -1093,40 +1464,9 @@ XdmfHDF5Writer::write(XdmfArray & array)
 
   // Determining data type
   if(array.isInitialized()) {
-    if(array.getArrayType() == XdmfArrayType::Int8()) {
-      datatype = H5T_NATIVE_CHAR;
-    }
-    else if(array.getArrayType() == XdmfArrayType::Int16()) {
-      datatype = H5T_NATIVE_SHORT;
-    }
-    else if(array.getArrayType() == XdmfArrayType::Int32()) {
-      datatype = H5T_NATIVE_INT;
-    }
-    else if(array.getArrayType() == XdmfArrayType::Int64()) {
-      datatype = H5T_NATIVE_LONG;
-    }
-    else if(array.getArrayType() == XdmfArrayType::Float32()) {
-      datatype = H5T_NATIVE_FLOAT;
-    }
-    else if(array.getArrayType() == XdmfArrayType::Float64()) {
-      datatype = H5T_NATIVE_DOUBLE;
-    }
-    else if(array.getArrayType() == XdmfArrayType::UInt8()) {
-      datatype = H5T_NATIVE_UCHAR;
-    }
-    else if(array.getArrayType() == XdmfArrayType::UInt16()) {
-      datatype = H5T_NATIVE_USHORT;
-    }
-    else if(array.getArrayType() == XdmfArrayType::UInt32()) {
-      datatype = H5T_NATIVE_UINT;
-    }
-    else if(array.getArrayType() == XdmfArrayType::String()) {
-      // Strings are a special case as they have mutable size
-      datatype = H5Tcopy(H5T_C_S1);
-      H5Tset_size(datatype, H5T_VARIABLE);
-      closeDatatype = true;
-    }
-    else {
+    datatype = getDatatype(array.getArrayType());
+    closeDatatype = array.getArrayType() == XdmfArrayType::String();
+    if(datatype == -1) {
       XdmfError::message(XdmfError::FATAL,
                          "Array of unsupported type in "
                          "XdmfHDF5Writer::write");
@@ -1171,6 +1511,72 @@ XdmfHDF5Writer::write(XdmfArray & array)
       array.removeHeavyDataController(array.getNumberHeavyDataControllers() -1);
     }
 
+    // Arrays written to a new dataset may instead share one with the
+    // same contents
+    const bool deduplicate = mDeduplicate &&
+      array.getArrayType() != XdmfArrayType::String() &&
+      getFileSizeLimit() <= 0 &&
+      (mMode == Default ||
+       (mMode != Hyperslab && previousControllers.size() == 0));
+    unsigned long long contentHash = 0;
+
+    if(deduplicate) {
+      contentHash = hashContents(array);
+
+      bool closeFile = false;
+      if (mImpl->mOpenFile.compare(mFilePath) != 0) {
+        if(mImpl->mHDF5Handle < 0) {
+          closeFile = true;
+        }
+        mImpl->openFile(mFilePath,
+                        mDataSetId);
+      }
+
+      std::string sharedDataSetPath;
+      std::map<unsigned long long, std::string> & index =
+        mImpl->getContentIndex();
+      std::map<unsigned long long, std::string>::iterator match =
+        index.find(contentHash);
+      if(match != index.end()) {
+        if(H5Lexists(mImpl->mHDF5Handle,
+                     match->second.c_str(),
+                     H5P_DEFAULT) > 0) {
+          // Compare the values in case of a collision
+          if(equalContents(mImpl->mHDF5Handle,
+                           match->second,
+                           datatype,
+                           array)) {
+            sharedDataSetPath = match->second;
+          }
+        }
+        else {
+          index.erase(match);
+        }
+      }
+
+      if(closeFile) {
+        mImpl->closeFile();
+      }
+
+      if(!sharedDataSetPath.empty()) {
+        const std::vector<unsigned int> dimensions = array.getDimensions();
+        array.insert(this->createController(mFilePath,
+                                            sharedDataSetPath,
+                                            array.getArrayType(),
+                                            std::vector<unsigned int>(dimensions.size(), 0),
+                                            std::vector<unsigned int>(dimensions.size(), 1),
+                                            dimensions,
+                                            dimensions));
+        if(closeDatatype) {
+          status = H5Tclose(datatype);
+        }
+        if(mReleaseData) {
+          array.release();
+        }
+        return;
+      }
+    }
+
     bool hasControllers = true;
 
     if (previousControllers.size() == 0) {
@@ -1384,10 +1790,14 @@ XdmfHDF5Writer::write(XdmfArray & array)
 
         hid_t dataspace = H5S_ALL;
         hid_t memspace = H5S_ALL;
+        // Size of the dataset after appending to it
+        hsize_t appendedSize = 0;
 
         std::vector<hsize_t> current_dims(curDataSize.begin(),
                                           curDataSize.end());
 
+        bool createdDataSet = true;
+
         if(dataset < 0) {
           // If the dataset doesn't contain anything
 
@@ -1438,6 +1848,11 @@ XdmfHDF5Writer::write(XdmfArray & array)
                               H5P_DEFAULT);
           status = H5Pclose(property);
         }
+        else {
+          // The contents of the dataset are changing
+          mImpl->removeContentHash(dataset, dataSetPath.str());
+          createdDataSet = false;
+        }
 
         if(mMode == Append) {
           // Need to resize dataset to fit new data
@@ -1468,8 +1883,8 @@ XdmfHDF5Writer::write(XdmfArray & array)
           }
 
           // Resize to fit size of old and new data.
-          hsize_t newSize = sizeTotal + datasize;
-          status = H5Dset_extent(dataset, &newSize);
+          appendedSize = sizeTotal + datasize;
+          status = H5Dset_extent(dataset, &appendedSize);
           
           // Select hyperslab to write to.
           memspace = H5Screate_simple(1, &size, NULL);
@@ -1551,6 +1966,12 @@ XdmfHDF5Writer::write(XdmfArray & array)
                              "-- status: " + status);
         }
 
+        // Only hash datasets holding exactly the values of the array
+        if(deduplicate && createdDataSet && arraysWritten.size() == 1 &&
+           (mMode != Append || appendedSize == size)) {
+          mImpl->writeContentHash(dataset, dataSetPath.str(), contentHash);
+        }
+
         if(dataspace != H5S_ALL) {
           status = H5Sclose(dataspace);
         }
@@ -1564,6 +1985,7 @@ XdmfHDF5Writer::write(XdmfArray & array)
         H5Fflush(mImpl->mHDF5Handle, H5F_SCOPE_GLOBAL);
 
 	// This is causing a lot of overhead
+        // Callers appending repeatedly keep the file open themselves
         if(closeFile) {
           mImpl->closeFile();
         }
@@ -1573,22 +1995,10 @@ XdmfHDF5Writer::write(XdmfArray & array)
           shared_ptr<XdmfHDF5Controller>();
         //This generates an empty pointer
 
-        unsigned int newSize;
         if(mMode == Append) {
-          // Find data size
-          mImpl->openFile(curFileName,
-                          mDataSetId);
-          hid_t checkset = H5Dopen(mImpl->mHDF5Handle,
-                                   dataSetPath.str().c_str(),
-                                   H5P_DEFAULT);
-          hid_t checkspace = H5S_ALL;
-          checkspace = H5Dget_space(checkset);
-          newSize = H5Sget_simple_extent_npoints(checkspace);
-          status = H5Dclose(checkset);
-	  if(checkspace != H5S_ALL) {
-	    status = H5Sclose(checkspace);
-          }
- 
+          // The dataset now covers the old and new data
+          const unsigned int newSize = appendedSize;
+
           std::vector<unsigned int> insertStarts;
           insertStarts.push_back(0);
           std::vector<unsigned int> insertStrides;
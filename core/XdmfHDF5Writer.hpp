@@ -47,6 +47,7 @@ class XdmfHDF5Controller;
 
 // Includes
 #include <list>
+#include <map>
 #include <set>
 
 /**
@@ -94,6 +95,24 @@ public:
 
   virtual ~XdmfHDF5Writer();
 
+  /**
+   * Create an empty dataset in the hdf5 file, large enough to hold the
+   * specified number of values, without writing any of them. The
+   * dataset can be extended and is chunked along its only dimension,
+   * so that it may be filled a section at a time in Hyperslab mode or
+   * grown in Append mode. Values that are never written read as zero.
+   *
+   * @param     type            The type of the values held by the dataset.
+   * @param     numValues       The number of values to allocate.
+   * @param     chunkSize       The number of values per chunk, 0 to use
+   *                            the chunk size of the writer.
+   *
+   * @return                    A controller referencing the whole dataset.
+   */
+  shared_ptr<XdmfHeavyDataController>
+  allocateDataSet(const shared_ptr<const XdmfArrayType> type,
+                  const unsigned int numValues,
+                  const unsigned int chunkSize = 0);
 
   virtual void closeFile();
 
@@ -123,6 +142,31 @@ public:
   virtual int getDataSetSize(const std::string & fileName,
                              const std::string & dataSetName);
 
+  /**
+   * Gets whether arrays with the same contents share a dataset.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5Writer.cpp
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#getDeduplicate
+   * @until //#getDeduplicate
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5Writer.py
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//getDeduplicate
+   * @until #//getDeduplicate
+   *
+   * @return    Whether writes of identical contents are deduplicated.
+   */
+  bool getDeduplicate() const;
+
   /**
    * Gets the factor that Deflate uses to compress data.
    *
@@ -148,6 +192,32 @@ public:
    */
   int getDeflateFactor() const;
 
+  /**
+   * Gets whether the file of this writer is held open, such as by
+   * openFile(), so that writes do not reopen and close it.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5Writer.cpp
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#getFileIsOpen
+   * @until //#getFileIsOpen
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5Writer.py
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//getFileIsOpen
+   * @until #//getFileIsOpen
+   *
+   * @return    Whether the file of this writer is open.
+   */
+  bool getFileIsOpen() const;
+
   /**
    * Gets whether Deflate is enabled.
    *
@@ -200,6 +270,45 @@ public:
    */
   void setChunkSize(const unsigned int chunkSize);
 
+  /**
+   * Sets whether arrays with the same contents share a dataset. When
+   * enabled, the values of each array written to a new dataset are
+   * hashed along with their type and dimensions. An array matching a
+   * dataset already written to the file is given a controller to that
+   * dataset instead of being written again.
+   *
+   * The hash of each dataset is stored in the hdf5 file as its
+   * XdmfContentHash attribute, so that arrays are also matched against
+   * datasets written by earlier runs, such as when appending to a file.
+   * Writing to a dataset in Overwrite, Append, or Hyperslab mode removes
+   * its hash. Since arrays matched share a dataset, overwriting one of
+   * them changes the values of the others.
+   *
+   * String arrays and arrays split across files are always written.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5Writer.cpp
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#setDeduplicate
+   * @until //#setDeduplicate
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5Writer.py
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//setDeduplicate
+   * @until #//setDeduplicate
+   *
+   * @param     deduplicate     Whether to deduplicate writes of identical
+   *                            contents.
+   */
+  void setDeduplicate(const bool deduplicate);
+
   /**
    * Sets the factor that Deflate will use to compress data.
    *
@@ -318,18 +427,34 @@ protected:
     openFile(const std::string & filePath,
              const int mDataSetId);
 
+    std::map<unsigned long long, std::string> &
+    getContentIndex();
+
+    void
+    removeContentHash(hid_t dataset,
+                      const std::string & dataSetPath);
+
+    void
+    writeContentHash(hid_t dataset,
+                     const std::string & dataSetPath,
+                     const unsigned long long hash);
+
     hid_t mHDF5Handle;
     int mFapl;
     unsigned int mChunkSize;
     std::string mOpenFile;
     int mDepth;
     std::set<const XdmfItem *> mWrittenItems;
+    // Content hashes of the datasets in each file, loaded when first used
+    std::map<std::string, std::map<unsigned long long, std::string> >
+      mContentIndex;
   };
 
   XdmfHDF5WriterImpl * mImpl;
 
   bool mUseDeflate;
   int mDeflateFactor;
+  bool mDeduplicate;
 
 private:
 
@@ -146,6 +146,12 @@ XdmfHeavyDataController::getStride() const
   return mStride;
 }
 
+std::vector<unsigned int>
+XdmfHeavyDataController::getReadDimensions() const
+{
+  return this->getDimensions();
+}
+
 unsigned int
 XdmfHeavyDataController::getSize() const
 {
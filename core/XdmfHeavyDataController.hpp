@@ -223,6 +223,34 @@ public:
    */
   virtual std::string getName() const = 0;
 
+  /**
+   * Get the dimensions of the values this controller reads into an
+   * array. These match getDimensions() unless the controller reads only
+   * a share of its selection, as controllers reading collectively do.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHeavyDataController.cpp
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#getReadDimensions
+   * @until //#getReadDimensions
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHeavyDataController.py
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//getReadDimensions
+   * @until #//getReadDimensions
+   *
+   * @return    A vector containing the size in each dimension of the
+   *            values read by this controller.
+   */
+  virtual std::vector<unsigned int> getReadDimensions() const;
+
   /**
    * Get the size of the heavy data set owned by this controller.
    *
@@ -139,6 +139,7 @@ XdmfInformation::populateItem(const std::map<std::string, std::string> & itemPro
 void
 XdmfInformation::setKey(const std::string & key)
 {
+  XdmfChildIndex::rename(*this);
   mKey = key;
   this->setIsChanged(true);
 }
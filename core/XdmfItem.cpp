@@ -27,16 +27,36 @@
 #include "XdmfError.hpp"
 #include "string.h"
 
+unsigned int XdmfChildIndex::RenameCount = 0;
+
+void
+XdmfChildIndex::insertChild(XdmfItem * child)
+{
+  if(child) {
+    child->mIsChild = true;
+  }
+}
+
+void
+XdmfChildIndex::rename(const XdmfItem & item)
+{
+  if(item.mIsChild) {
+    ++RenameCount;
+  }
+}
+
 XDMF_CHILDREN_IMPLEMENTATION(XdmfItem, XdmfInformation, Information, Key)
 
 XdmfItem::XdmfItem() :
-  mIsChanged(true)
+  mIsChanged(true),
+  mIsChild(false)
 {
 }
 
 XdmfItem::XdmfItem(const XdmfItem &refItem) :
   mInformations(refItem.mInformations),
-  mIsChanged(true)
+  mIsChanged(true),
+  mIsChild(false)
 {
 }
 
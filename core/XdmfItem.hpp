@@ -46,8 +46,145 @@ class XdmfVisitor;
 #include <set>
 #include <string>
 #include <vector>
+#include <boost/unordered_map.hpp>
 #include "XdmfSharedPtr.hpp"
 
+class XdmfItem;
+
+/**
+ * @brief Index from names to positions in a list of children attached
+ * with XDMF_CHILDREN.
+ *
+ * Lookups only read the index, so they can run at the same time on one
+ * item. Inserting and removing children update it, and a non-const
+ * lookup rebuilds it when it is out of date. Renaming an item that is
+ * a child in any list puts every index out of date, because an earlier
+ * child may now have the name of a later one. Until an index is rebuilt
+ * its list is searched in order.
+ */
+class XDMFCORE_EXPORT XdmfChildIndex {
+
+public:
+
+  // Lists shorter than this are searched without an index
+  static const unsigned int Threshold = 16;
+
+  XdmfChildIndex() :
+    mDuplicates(false),
+    mRenameCount(0),
+    mSize(0)
+  {
+  }
+
+  void clear()
+  {
+    mPositions.clear();
+    mDuplicates = false;
+    mSize = 0;
+  }
+
+  /**
+   * Removes the child at position, moving the later children down one.
+   * If the removed child was the first with its name, next is the
+   * position of the next child with that name after the removal.
+   */
+  void erase(const std::string & name,
+             const unsigned int position,
+             const unsigned int next)
+  {
+    boost::unordered_map<std::string, unsigned int>::iterator iter =
+      mPositions.find(name);
+    if(iter != mPositions.end() && iter->second == position) {
+      mPositions.erase(iter);
+    }
+    for(iter = mPositions.begin(); iter != mPositions.end(); ++iter) {
+      if(iter->second > position) {
+        --iter->second;
+      }
+    }
+    --mSize;
+    if(next < mSize) {
+      mPositions.insert(std::make_pair(name, next));
+    }
+  }
+
+  /**
+   * Gets the position of the first child indexed with a name, or the
+   * size of the list if there is none.
+   */
+  unsigned int find(const std::string & name) const
+  {
+    boost::unordered_map<std::string, unsigned int>::const_iterator iter =
+      mPositions.find(name);
+    if(iter == mPositions.end()) {
+      return mSize;
+    }
+    return iter->second;
+  }
+
+  /**
+   * Whether a name indexed at position may also be used by a later
+   * child.
+   */
+  bool hasDuplicate(const std::string & name,
+                    const unsigned int position) const
+  {
+    return mDuplicates && this->find(name) == position;
+  }
+
+  /**
+   * Indexes the child appended at position, keeping earlier children
+   * with the same name first.
+   */
+  void insert(const std::string & name,
+              const unsigned int position)
+  {
+    if(!mPositions.insert(std::make_pair(name, position)).second) {
+      mDuplicates = true;
+    }
+    mSize = position + 1;
+  }
+
+  bool isCurrent(const unsigned int size) const
+  {
+    return mSize == size && size > 0 && mRenameCount == RenameCount;
+  }
+
+  /**
+   * Marks the index as covering the first size children as they are
+   * named now.
+   */
+  void setSize(const unsigned int size)
+  {
+    mRenameCount = RenameCount;
+    mSize = size;
+  }
+
+  /**
+   * Records that an item was inserted as a child, so that renaming it
+   * puts indexes out of date. Children that are not items can not be
+   * renamed.
+   */
+  static void insertChild(XdmfItem * child);
+  static void insertChild(const void *)
+  {
+  }
+
+  /**
+   * Called by the setters of the names children are indexed by.
+   */
+  static void rename(const XdmfItem & item);
+
+private:
+
+  static unsigned int RenameCount;
+
+  boost::unordered_map<std::string, unsigned int> mPositions;
+  bool mDuplicates;
+  unsigned int mRenameCount;
+  unsigned int mSize;
+};
+
 // Macro that allows children XdmfItems to be attached to a parent XdmfItem.
 // -- For Header File
 #define XDMF_CHILDREN(ParentClass, ChildClass, ChildName, SearchName)         \
@@ -195,7 +332,22 @@ public:                                                                       \
                                                                               \
 protected :                                                                   \
                                                                               \
+  /** Get the position of the first ChildClass with SearchName, or the
+      number of ChildClass##s if none has it.
+  */                                                                          \
+  unsigned int find##ChildName##Index(const std::string & SearchName) const;  \
+                                                                              \
+  /** Rebuild the index of ChildClass##s by SearchName, or clear it when
+      there are too few to need one.
+  */                                                                          \
+  void rebuild##ChildName##Index();                                           \
+                                                                              \
+  /** Remove the ChildClass at index, keeping the index current.
+  */                                                                          \
+  void erase##ChildName(const unsigned int index);                            \
+                                                                              \
   std::vector<shared_ptr<ChildClass> > m##ChildName##s;                       \
+  XdmfChildIndex m##ChildName##Index;                                         \
                                                                               \
 public :
 
@@ -225,6 +377,10 @@ public :
   shared_ptr<ChildClass>                                                      \
   ParentClass::get##ChildName(const std::string & SearchName)                 \
   {                                                                           \
+    if(m##ChildName##s.size() >= XdmfChildIndex::Threshold &&                 \
+       !m##ChildName##Index.isCurrent(m##ChildName##s.size())) {              \
+      this->rebuild##ChildName##Index();                                      \
+    }                                                                         \
     return boost::const_pointer_cast<ChildClass>                              \
       (static_cast<const ParentClass &>(*this).get##ChildName(SearchName));   \
   }                                                                           \
@@ -232,18 +388,49 @@ public :
   shared_ptr<const ChildClass>                                                \
   ParentClass::get##ChildName(const std::string & SearchName) const           \
   {                                                                           \
-    for(std::vector<shared_ptr<ChildClass> >::const_iterator iter =           \
-          m##ChildName##s.begin();                                            \
-        iter != m##ChildName##s.end();                                        \
-        ++iter) {                                                             \
-      if((*iter)->get##SearchName().compare(SearchName) == 0) {               \
-        return *iter;                                                         \
-      }                                                                       \
+    const unsigned int index = this->find##ChildName##Index(SearchName);      \
+    if(index < m##ChildName##s.size()) {                                      \
+      return m##ChildName##s[index];                                          \
     }                                                                         \
     return shared_ptr<ChildClass>();                                          \
   }                                                                           \
                                                                               \
   unsigned int                                                                \
+  ParentClass::find##ChildName##Index(const std::string & SearchName) const   \
+  {                                                                           \
+    const unsigned int size = m##ChildName##s.size();                         \
+    if(m##ChildName##Index.isCurrent(size)) {                                 \
+      const unsigned int index = m##ChildName##Index.find(SearchName);        \
+      if(index < size &&                                                      \
+         m##ChildName##s[index]->get##SearchName().compare(SearchName) == 0) {\
+        return index;                                                         \
+      }                                                                       \
+    }                                                                         \
+    for(unsigned int i = 0; i < size; ++i) {                                  \
+      if(m##ChildName##s[i]->get##SearchName().compare(SearchName) == 0) {    \
+        return i;                                                             \
+      }                                                                       \
+    }                                                                         \
+    return size;                                                              \
+  }                                                                           \
+                                                                              \
+  void                                                                        \
+  ParentClass::rebuild##ChildName##Index()                                    \
+  {                                                                           \
+    m##ChildName##Index.clear();                                              \
+    const unsigned int size = m##ChildName##s.size();                         \
+    if(size >= XdmfChildIndex::Threshold) {                                   \
+      for(unsigned int i = 0; i < size; ++i) {                                \
+        if(m##ChildName##s[i]) {                                              \
+          m##ChildName##Index.insert(m##ChildName##s[i]->get##SearchName(),   \
+                                     i);                                      \
+        }                                                                     \
+      }                                                                       \
+      m##ChildName##Index.setSize(size);                                      \
+    }                                                                         \
+  }                                                                           \
+                                                                              \
+  unsigned int                                                                \
   ParentClass::getNumber##ChildName##s() const                                \
   {                                                                           \
     return m##ChildName##s.size();                                            \
@@ -252,15 +439,53 @@ public :
   void                                                                        \
   ParentClass::insert(const shared_ptr<ChildClass> ChildName)                 \
   {                                                                           \
+    const unsigned int index = m##ChildName##s.size();                        \
     m##ChildName##s.push_back(ChildName);                                     \
+    XdmfChildIndex::insertChild(ChildName.get());                             \
+    if(!m##ChildName##Index.isCurrent(index)) {                               \
+      this->rebuild##ChildName##Index();                                      \
+    }                                                                         \
+    else if(ChildName) {                                                      \
+      m##ChildName##Index.insert(ChildName->get##SearchName(), index);        \
+    }                                                                         \
+    else {                                                                    \
+      m##ChildName##Index.setSize(index + 1);                                 \
+    }                                                                         \
     this->setIsChanged(true);                                                 \
   }                                                                           \
                                                                               \
   void                                                                        \
+  ParentClass::erase##ChildName(const unsigned int index)                     \
+  {                                                                           \
+    const unsigned int size = m##ChildName##s.size();                         \
+    if(!m##ChildName##Index.isCurrent(size) || !m##ChildName##s[index]) {     \
+      m##ChildName##s.erase(m##ChildName##s.begin() + index);                 \
+      this->rebuild##ChildName##Index();                                      \
+      return;                                                                 \
+    }                                                                         \
+    const std::string name = m##ChildName##s[index]->get##SearchName();       \
+    const bool findNext = m##ChildName##Index.hasDuplicate(name, index);      \
+    m##ChildName##s.erase(m##ChildName##s.begin() + index);                   \
+    unsigned int next = size - 1;                                             \
+    if(findNext) {                                                            \
+      for(next = index; next < size - 1; ++next) {                            \
+        if(m##ChildName##s[next] &&                                           \
+           m##ChildName##s[next]->get##SearchName().compare(name) == 0) {     \
+          break;                                                              \
+        }                                                                     \
+      }                                                                       \
+    }                                                                         \
+    m##ChildName##Index.erase(name, index, next);                             \
+    if(size - 1 < XdmfChildIndex::Threshold) {                                \
+      m##ChildName##Index.clear();                                            \
+    }                                                                         \
+  }                                                                           \
+                                                                              \
+  void                                                                        \
   ParentClass::remove##ChildName(const unsigned int index)                    \
   {                                                                           \
     if(index < m##ChildName##s.size()) {                                      \
-      m##ChildName##s.erase(m##ChildName##s.begin() + index);                 \
+      this->erase##ChildName(index);                                          \
     }                                                                         \
     this->setIsChanged(true);                                                 \
   }                                                                           \
@@ -268,14 +493,13 @@ public :
   void                                                                        \
   ParentClass::remove##ChildName(const std::string & SearchName)              \
   {                                                                           \
-    for(std::vector<shared_ptr<ChildClass> >::iterator iter =                 \
-          m##ChildName##s.begin();                                            \
-        iter != m##ChildName##s.end();                                        \
-        ++iter) {                                                             \
-        if((*iter)->get##SearchName().compare(SearchName) == 0) {             \
-          m##ChildName##s.erase(iter);                                        \
-          return;                                                             \
-        }                                                                     \
+    if(m##ChildName##s.size() >= XdmfChildIndex::Threshold &&                 \
+       !m##ChildName##Index.isCurrent(m##ChildName##s.size())) {              \
+      this->rebuild##ChildName##Index();                                      \
+    }                                                                         \
+    const unsigned int index = this->find##ChildName##Index(SearchName);      \
+    if(index < m##ChildName##s.size()) {                                      \
+      this->erase##ChildName(index);                                          \
     }                                                                         \
     this->setIsChanged(true);                                                 \
   }
@@ -296,6 +520,7 @@ public:
 
   LOKI_DEFINE_VISITABLE_BASE()
   XDMF_CHILDREN(XdmfItem, XdmfInformation, Information, Key)
+  friend class XdmfChildIndex;
   friend class XdmfCoreReader;
   friend class XdmfWriter;
   friend class XdmfHeavyDataWriter;
@@ -409,6 +634,12 @@ protected:
   std::set<XdmfItem *> mParents;
 
   bool mIsChanged;
+  // Whether this item was ever inserted as a child of another
+  bool mIsChild;
+
+  // Created when an XdmfWriter first archives the item. Writers keep
+  // weak references to it to tell whether the item still exists.
+  shared_ptr<bool> mArchiveToken;
 
 private:
 
@@ -28,8 +28,10 @@
 
 #include "XdmfCoreConfig.hpp"
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 
 using boost::shared_ptr;
+using boost::weak_ptr;
 
 #ifdef HAVE_BOOST_SHARED_DYNAMIC_CAST
 
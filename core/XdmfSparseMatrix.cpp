@@ -231,6 +231,7 @@ XdmfSparseMatrix::setColumnIndex(const shared_ptr<XdmfArray> columnIndex)
 void
 XdmfSparseMatrix::setName(const std::string & name)
 {
+  XdmfChildIndex::rename(*this);
   mName = name;
   this->setIsChanged(true);
 }
@@ -21,6 +21,7 @@
 /*                                                                           */
 /*****************************************************************************/
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include "XdmfArray.hpp"
@@ -31,6 +32,431 @@
 #include "tiff.h"
 #include "tiffio.h"
 
+#ifndef _WIN32
+  #include <pthread.h>
+  #include <unistd.h>
+#endif
+
+namespace {
+
+  enum SampleType {
+    Int8Sample,
+    Int16Sample,
+    Int32Sample,
+    UInt8Sample,
+    UInt16Sample,
+    UInt32Sample,
+    Float32Sample,
+    Float64Sample
+  };
+
+  // Layout of a directory read a strip or tile at a time
+  struct TIFFLayout {
+    unsigned int directory;
+    unsigned int index; // of the directory in the selection
+    bool tiled;
+    SampleType sampleType;
+    unsigned int sampleSize;
+    unsigned int imageLength;
+    unsigned int rowSize; // values in a row of the image
+    unsigned int blockLength; // rows in a strip or tile
+    unsigned int blockRowSize; // values in a row of a strip or tile
+    unsigned int blocksAcross;
+    unsigned int blockSize; // bytes of a decoded strip or tile
+  };
+
+  // A strip or tile holding selected values
+  struct TIFFBlock {
+    unsigned int layout;
+    unsigned int block;
+    unsigned int firstRow;
+    unsigned int firstValue;
+  };
+
+  // Values selected along one dimension
+  struct TIFFSelection {
+    unsigned int start;
+    unsigned int stride;
+    unsigned int count;
+
+    // Index of the first selected value at or after value, or count
+    unsigned int
+    first(const unsigned int value) const
+    {
+      if(value <= start) {
+        return 0;
+      }
+      return std::min(count, (value - start + stride - 1) / stride);
+    }
+  };
+
+  template <typename T, typename U>
+  void
+  copyBlock(T * destination,
+            const U * source,
+            const TIFFLayout & layout,
+            const TIFFBlock & block,
+            const TIFFSelection & values,
+            const TIFFSelection & rows)
+  {
+    const unsigned int endRow = std::min(block.firstRow + layout.blockLength,
+                                         layout.imageLength);
+    const unsigned int endValue = std::min(block.firstValue + layout.blockRowSize,
+                                           layout.rowSize);
+    const unsigned int firstValue = values.first(block.firstValue);
+    T * const plane = destination + layout.index * values.count * rows.count;
+    for(unsigned int j = rows.first(block.firstRow); j < rows.count; ++j) {
+      const unsigned int row = rows.start + j * rows.stride;
+      if(row >= endRow) {
+        break;
+      }
+      const U * const sourceRow =
+        source + (row - block.firstRow) * layout.blockRowSize - block.firstValue;
+      T * const destinationRow = plane + j * values.count;
+      for(unsigned int i = firstValue; i < values.count; ++i) {
+        const unsigned int value = values.start + i * values.stride;
+        if(value >= endValue) {
+          break;
+        }
+        destinationRow[i] = (T)sourceRow[value];
+      }
+    }
+  }
+
+  template <typename T>
+  void
+  copyBlock(T * destination,
+            const void * source,
+            const TIFFLayout & layout,
+            const TIFFBlock & block,
+            const TIFFSelection & values,
+            const TIFFSelection & rows)
+  {
+    switch(layout.sampleType) {
+    case Int8Sample:
+      copyBlock(destination, (const char *)source, layout, block, values, rows);
+      break;
+    case Int16Sample:
+      copyBlock(destination, (const short *)source, layout, block, values, rows);
+      break;
+    case Int32Sample:
+      copyBlock(destination, (const int *)source, layout, block, values, rows);
+      break;
+    case UInt8Sample:
+      copyBlock(destination, (const unsigned char *)source, layout, block, values, rows);
+      break;
+    case UInt16Sample:
+      copyBlock(destination, (const unsigned short *)source, layout, block, values, rows);
+      break;
+    case UInt32Sample:
+      copyBlock(destination, (const unsigned int *)source, layout, block, values, rows);
+      break;
+    case Float32Sample:
+      copyBlock(destination, (const float *)source, layout, block, values, rows);
+      break;
+    case Float64Sample:
+      copyBlock(destination, (const double *)source, layout, block, values, rows);
+      break;
+    }
+  }
+
+  // Decodes blocks, shared by the threads reading them
+  class TIFFBlockReader {
+  public:
+
+    TIFFBlockReader(const std::string & filePath,
+                    const std::vector<TIFFLayout> & layouts,
+                    const std::vector<TIFFBlock> & blocks,
+                    const TIFFSelection & values,
+                    const TIFFSelection & rows,
+                    const shared_ptr<const XdmfArrayType> & type,
+                    void * destination) :
+      mFilePath(filePath),
+      mLayouts(layouts),
+      mBlocks(blocks),
+      mValues(values),
+      mRows(rows),
+      mType(type),
+      mDestination(destination),
+      mNextBlock(0)
+    {
+#ifndef _WIN32
+      pthread_mutex_init(&mMutex, NULL);
+#endif
+    }
+
+    ~TIFFBlockReader()
+    {
+#ifndef _WIN32
+      pthread_mutex_destroy(&mMutex);
+#endif
+    }
+
+    void
+    read(unsigned int numberThreads)
+    {
+#ifndef _WIN32
+      numberThreads = std::min(numberThreads, (unsigned int)mBlocks.size());
+      if(numberThreads > 1) {
+        std::vector<pthread_t> threads(numberThreads - 1);
+        unsigned int started = 0;
+        // Blocks left to threads that could not be started are taken
+        // by this one
+        while(started < threads.size() &&
+              pthread_create(&threads[started], NULL, run, this) == 0) {
+          ++started;
+        }
+        this->decode();
+        for(unsigned int i = 0; i < started; ++i) {
+          pthread_join(threads[i], NULL);
+        }
+      }
+      else {
+        this->decode();
+      }
+#else
+      this->decode();
+#endif
+      if(mError.size() > 0) {
+        XdmfError::message(XdmfError::FATAL, mError);
+      }
+    }
+
+  private:
+
+    static void *
+    run(void * reader)
+    {
+      static_cast<TIFFBlockReader *>(reader)->decode();
+      return NULL;
+    }
+
+    // Takes the next block to decode, false when none are left
+    bool
+    next(unsigned int & block)
+    {
+#ifndef _WIN32
+      pthread_mutex_lock(&mMutex);
+#endif
+      const bool found = mError.size() == 0 && mNextBlock < mBlocks.size();
+      if(found) {
+        block = mNextBlock++;
+      }
+#ifndef _WIN32
+      pthread_mutex_unlock(&mMutex);
+#endif
+      return found;
+    }
+
+    void
+    fail(const std::string & error)
+    {
+#ifndef _WIN32
+      pthread_mutex_lock(&mMutex);
+#endif
+      if(mError.size() == 0) {
+        mError = error;
+      }
+#ifndef _WIN32
+      pthread_mutex_unlock(&mMutex);
+#endif
+    }
+
+    void
+    decode()
+    {
+      TIFF * tif = TIFFOpen(mFilePath.c_str(), "r");
+      if(!tif) {
+        this->fail("Error: Invalid TIFF file");
+        return;
+      }
+      std::vector<char> buffer;
+      unsigned int directory = 0;
+      unsigned int blockIndex;
+      while(this->next(blockIndex)) {
+        const TIFFBlock & block = mBlocks[blockIndex];
+        const TIFFLayout & layout = mLayouts[block.layout];
+        if(layout.directory != directory) {
+          if(!TIFFSetDirectory(tif, layout.directory)) {
+            this->fail("Error: Invalid directory in TIFF file");
+            break;
+          }
+          directory = layout.directory;
+        }
+        if(buffer.size() < layout.blockSize) {
+          buffer.resize(layout.blockSize);
+        }
+        tsize_t decoded;
+        if(layout.tiled) {
+          decoded = TIFFReadEncodedTile(tif, block.block, &buffer[0], -1);
+        }
+        else {
+          decoded = TIFFReadEncodedStrip(tif, block.block, &buffer[0], -1);
+        }
+        if(decoded < 0) {
+          this->fail("Error: Could not decode TIFF data");
+          break;
+        }
+        this->copy(&buffer[0], layout, block);
+      }
+      TIFFClose(tif);
+    }
+
+    void
+    copy(const void * source,
+         const TIFFLayout & layout,
+         const TIFFBlock & block) const
+    {
+      if(mType == XdmfArrayType::Int8()) {
+        copyBlock((char *)mDestination, source, layout, block, mValues, mRows);
+      }
+      else if(mType == XdmfArrayType::Int16()) {
+        copyBlock((short *)mDestination, source, layout, block, mValues, mRows);
+      }
+      else if(mType == XdmfArrayType::Int32()) {
+        copyBlock((int *)mDestination, source, layout, block, mValues, mRows);
+      }
+      else if(mType == XdmfArrayType::Int64()) {
+        copyBlock((long *)mDestination, source, layout, block, mValues, mRows);
+      }
+      else if(mType == XdmfArrayType::Float32()) {
+        copyBlock((float *)mDestination, source, layout, block, mValues, mRows);
+      }
+      else if(mType == XdmfArrayType::Float64()) {
+        copyBlock((double *)mDestination, source, layout, block, mValues, mRows);
+      }
+      else if(mType == XdmfArrayType::UInt8()) {
+        copyBlock((unsigned char *)mDestination, source, layout, block, mValues, mRows);
+      }
+      else if(mType == XdmfArrayType::UInt16()) {
+        copyBlock((unsigned short *)mDestination, source, layout, block, mValues, mRows);
+      }
+      else if(mType == XdmfArrayType::UInt32()) {
+        copyBlock((unsigned int *)mDestination, source, layout, block, mValues, mRows);
+      }
+    }
+
+    const std::string mFilePath;
+    const std::vector<TIFFLayout> & mLayouts;
+    const std::vector<TIFFBlock> & mBlocks;
+    const TIFFSelection mValues;
+    const TIFFSelection mRows;
+    const shared_ptr<const XdmfArrayType> mType;
+    void * const mDestination;
+    unsigned int mNextBlock;
+    std::string mError;
+#ifndef _WIN32
+    pthread_mutex_t mMutex;
+#endif
+  };
+
+  // Reads the layout of the current directory, false if it can not be
+  // read a strip or tile at a time
+  bool
+  readLayout(TIFF * tif,
+             TIFFLayout & layout)
+  {
+    unsigned short bitsPerSample = 0;
+    unsigned short samplesPerPixel = 1;
+    unsigned short planarConfig = PLANARCONFIG_CONTIG;
+    unsigned short sampleFormat = SAMPLEFORMAT_UINT;
+    unsigned int imageWidth = 0;
+    unsigned int imageLength = 0;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planarConfig);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sampleFormat);
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &imageWidth);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &imageLength);
+
+    if(planarConfig != PLANARCONFIG_CONTIG && samplesPerPixel > 1) {
+      return false;
+    }
+
+    switch(sampleFormat) {
+    case SAMPLEFORMAT_INT:
+      if(bitsPerSample == 8) {
+        layout.sampleType = Int8Sample;
+      }
+      else if(bitsPerSample == 16) {
+        layout.sampleType = Int16Sample;
+      }
+      else if(bitsPerSample == 32) {
+        layout.sampleType = Int32Sample;
+      }
+      else {
+        return false;
+      }
+      break;
+    case SAMPLEFORMAT_IEEEFP:
+      if(bitsPerSample == 32) {
+        layout.sampleType = Float32Sample;
+      }
+      else if(bitsPerSample == 64) {
+        layout.sampleType = Float64Sample;
+      }
+      else {
+        return false;
+      }
+      break;
+    default:
+      if(bitsPerSample == 8) {
+        layout.sampleType = UInt8Sample;
+      }
+      else if(bitsPerSample == 16) {
+        layout.sampleType = UInt16Sample;
+      }
+      else if(bitsPerSample == 32) {
+        layout.sampleType = UInt32Sample;
+      }
+      else {
+        return false;
+      }
+      break;
+    }
+
+    layout.sampleSize = bitsPerSample / 8;
+    layout.imageLength = imageLength;
+    layout.rowSize = imageWidth * samplesPerPixel;
+    layout.tiled = TIFFIsTiled(tif) != 0;
+    if(layout.tiled) {
+      unsigned int tileWidth = 0;
+      unsigned int tileLength = 0;
+      TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tileWidth);
+      TIFFGetField(tif, TIFFTAG_TILELENGTH, &tileLength);
+      if(tileWidth == 0 || tileLength == 0) {
+        return false;
+      }
+      layout.blockLength = tileLength;
+      layout.blockRowSize = tileWidth * samplesPerPixel;
+      layout.blocksAcross = (imageWidth + tileWidth - 1) / tileWidth;
+      layout.blockSize = TIFFTileSize(tif);
+    }
+    else {
+      unsigned int rowsPerStrip = imageLength;
+      TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+      layout.blockLength = std::max(1u, std::min(rowsPerStrip, imageLength));
+      layout.blockRowSize = layout.rowSize;
+      layout.blocksAcross = 1;
+      layout.blockSize = TIFFStripSize(tif);
+    }
+    return true;
+  }
+
+  unsigned int
+  getNumberProcessors()
+  {
+#ifndef _WIN32
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    if(processors > 0) {
+      return processors;
+    }
+#endif
+    return 1;
+  }
+
+}
+
 shared_ptr<XdmfTIFFController>
 XdmfTIFFController::New(const std::string & filePath,
                         const shared_ptr<const XdmfArrayType> & type,
@@ -73,12 +499,14 @@ XdmfTIFFController::XdmfTIFFController(const std::string & filePath,
                           starts,
                           strides,
                           dimensions,
-                          dataspaces)
+                          dataspaces),
+  mNumberThreads(0)
 {
 }
 
 XdmfTIFFController::XdmfTIFFController(const XdmfTIFFController& refController):
-  XdmfHeavyDataController(refController)
+  XdmfHeavyDataController(refController),
+  mNumberThreads(refController.getNumberThreads())
 {
 }
 
@@ -91,12 +519,15 @@ XdmfTIFFController::createSubController(const std::vector<unsigned int> & starts
                                         const std::vector<unsigned int> & strides,
                                         const std::vector<unsigned int> & dimensions)
 {
-  return XdmfTIFFController::New(mFilePath,
-                                 mType,
-                                 starts,
-                                 strides,
-                                 dimensions,
-                                 mDataspaceDimensions);
+  shared_ptr<XdmfTIFFController> subController =
+    XdmfTIFFController::New(mFilePath,
+                            mType,
+                            starts,
+                            strides,
+                            dimensions,
+                            mDataspaceDimensions);
+  subController->setNumberThreads(mNumberThreads);
+  return subController;
 }
 
 void
@@ -149,14 +580,18 @@ XdmfTIFFController::getNumberDirectories() const
   TIFF* tif = TIFFOpen(mFilePath.c_str(), "r");
   unsigned int count = 0;
   if (tif) {
-    do {
-      count++;
-    } while (TIFFReadDirectory(tif));
+    count = TIFFNumberOfDirectories(tif);
     TIFFClose(tif);
   }
   return count;
 }
 
+unsigned int
+XdmfTIFFController::getNumberThreads() const
+{
+  return mNumberThreads;
+}
+
 void
 XdmfTIFFController::getProperties(std::map<std::string, std::string> & collectedProperties) const
 {
@@ -167,6 +602,10 @@ XdmfTIFFController::getProperties(std::map<std::string, std::string> & collected
 void
 XdmfTIFFController::read(XdmfArray * const array)
 {
+  if (this->readBlocks(array)) {
+    return;
+  }
+
   TIFF* tif = TIFFOpen(mFilePath.c_str(), "r");
 
   unsigned int compression = 0;
@@ -419,6 +858,130 @@ XdmfTIFFController::read(XdmfArray * const array)
   TIFFClose(tif);
 }
 
+bool
+XdmfTIFFController::readBlocks(XdmfArray * const array)
+{
+  if (mDimensions.size() != 2 && mDimensions.size() != 3) {
+    return false;
+  }
+
+  shared_ptr<const XdmfArrayType> type = array->getArrayType();
+  if (!array->isInitialized()) {
+    type = this->getType();
+  }
+  if (type == XdmfArrayType::String() ||
+      type == XdmfArrayType::Uninitialized()) {
+    return false;
+  }
+
+  TIFFSelection values;
+  values.start = mStart[0];
+  values.stride = mStride[0];
+  values.count = mDimensions[0];
+  TIFFSelection rows;
+  rows.start = mStart[1];
+  rows.stride = mStride[1];
+  rows.count = mDimensions[1];
+  TIFFSelection directories;
+  directories.start = 0;
+  directories.stride = 1;
+  directories.count = 1;
+  if (mDimensions.size() == 3) {
+    directories.start = mStart[2];
+    directories.stride = mStride[2];
+    directories.count = mDimensions[2];
+  }
+  if (values.stride == 0 || rows.stride == 0 || directories.stride == 0) {
+    return false;
+  }
+
+  TIFF * tif = TIFFOpen(mFilePath.c_str(), "r");
+  if (!tif) {
+    return false;
+  }
+
+  // A two dimensional selection of a file with more directories is
+  // read as one stream of values
+  if (mDimensions.size() == 2 && TIFFNumberOfDirectories(tif) > 1) {
+    TIFFClose(tif);
+    return false;
+  }
+
+  // Only strips and tiles holding selected values are decoded
+  std::vector<TIFFLayout> layouts;
+  std::vector<TIFFBlock> blocks;
+  for (unsigned int k = 0; k < directories.count; ++k) {
+    TIFFLayout layout;
+    layout.directory = directories.start + k * directories.stride;
+    layout.index = k;
+    if (!TIFFSetDirectory(tif, layout.directory)) {
+      // Directories past the end of the file are left empty
+      break;
+    }
+    if (!readLayout(tif, layout)) {
+      TIFFClose(tif);
+      return false;
+    }
+    TIFFBlock block;
+    block.layout = layouts.size();
+    unsigned int lastBlockRow = layout.imageLength;
+    for (unsigned int j = 0; j < rows.count; ++j) {
+      const unsigned int row = rows.start + j * rows.stride;
+      if (row >= layout.imageLength) {
+        break;
+      }
+      const unsigned int blockRow = row / layout.blockLength;
+      if (blockRow == lastBlockRow) {
+        continue;
+      }
+      lastBlockRow = blockRow;
+      block.firstRow = blockRow * layout.blockLength;
+      unsigned int lastBlockColumn = layout.blocksAcross;
+      for (unsigned int i = 0; i < values.count; ++i) {
+        const unsigned int value = values.start + i * values.stride;
+        if (value >= layout.rowSize) {
+          break;
+        }
+        const unsigned int blockColumn = value / layout.blockRowSize;
+        if (blockColumn == lastBlockColumn) {
+          continue;
+        }
+        lastBlockColumn = blockColumn;
+        block.firstValue = blockColumn * layout.blockRowSize;
+        block.block = blockRow * layout.blocksAcross + blockColumn;
+        blocks.push_back(block);
+      }
+    }
+    layouts.push_back(layout);
+  }
+  TIFFClose(tif);
+
+  if (!array->isInitialized()) {
+    array->initialize(type);
+  }
+  array->resize(mDimensions, 0);
+
+  unsigned int numberThreads = mNumberThreads;
+  if (numberThreads == 0) {
+    numberThreads = getNumberProcessors();
+  }
+  TIFFBlockReader reader(mFilePath,
+                         layouts,
+                         blocks,
+                         values,
+                         rows,
+                         type,
+                         array->getValuesInternal());
+  reader.read(numberThreads);
+  return true;
+}
+
+void
+XdmfTIFFController::setNumberThreads(const unsigned int numberThreads)
+{
+  mNumberThreads = numberThreads;
+}
+
 // C Wrappers
 
 XDMFTIFFCONTROLLER * XdmfTIFFControllerNew(char * filePath,
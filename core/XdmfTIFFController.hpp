@@ -118,11 +118,82 @@ public:
 
   virtual std::string getName() const;
 
+  /**
+   * Gets the number of threads used to decode the strips, tiles, and
+   * directories read.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfTIFFController.cpp
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#getNumberThreads
+   * @until //#getNumberThreads
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleTIFFController.py
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//getNumberThreads
+   * @until #//getNumberThreads
+   *
+   * @return    The number of threads, 0 for one per processor.
+   */
+  unsigned int getNumberThreads() const;
+
   virtual void 
   getProperties(std::map<std::string, std::string> & collectedProperties) const;
 
+  /**
+   * Reads the selected values into the array.
+   *
+   * Selections of two or three dimensions, of images with 8, 16, 32, or
+   * 64 bit samples, are read a strip or tile at a time. The first
+   * dimension selects values along a row of the image, the second
+   * selects rows, and the third selects directories. Only the strips
+   * or tiles holding selected rows and values are decoded, in parallel
+   * across them and across directories, each thread with its own
+   * handle to the file, and their values are copied directly into the
+   * array. A two dimensional selection reads this way only from a file
+   * with one directory.
+   *
+   * Other selections are read one scanline or strip at a time, treating
+   * the image as a single stream of values.
+   *
+   * @param     array   The array to read into.
+   */
   virtual void read(XdmfArray * const array);
 
+  /**
+   * Sets the number of threads used to decode the strips, tiles, and
+   * directories read. By default one thread runs per processor.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfTIFFController.cpp
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#setNumberThreads
+   * @until //#setNumberThreads
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleTIFFController.py
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//setNumberThreads
+   * @until #//setNumberThreads
+   *
+   * @param     numberThreads   The number of threads, 0 for one per
+   *                            processor.
+   */
+  void setNumberThreads(const unsigned int numberThreads);
+
   XdmfTIFFController(const XdmfTIFFController &);
 
 protected:
@@ -141,6 +212,17 @@ protected:
 
   unsigned int getNumberDirectories() const;
 
+  /**
+   * Reads a selection of two or three dimensions a strip or tile at a
+   * time, as described in read().
+   *
+   * @param     array   The array to read into.
+   *
+   * @return    Whether the selection could be read this way. If not,
+   *            the array is left unchanged.
+   */
+  bool readBlocks(XdmfArray * const array);
+
   void readToArray(XdmfArray * const array,
                    void * pointer,
                    unsigned int offset,
@@ -149,6 +231,8 @@ protected:
                    unsigned int amount,
                    shared_ptr<const XdmfArrayType> type);
 
+  unsigned int mNumberThreads;
+
 private:
 
   void operator=(const XdmfTIFFController &);  // Not implemented.
@@ -25,6 +25,8 @@
 #include <sstream>
 #include <utility>
 #include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfBinaryLightData.hpp"
 #include "XdmfInformation.hpp"
 #include "XdmfHeavyDataWriter.hpp"
 #include "XdmfHDF5Controller.hpp"
@@ -36,6 +38,71 @@
 #include "XdmfError.hpp"
 #include "string.h"
 
+namespace {
+
+  // Marks XML nodes whose items and descendants are unchanged since the
+  // last write, set as the _private data of the node
+  char unchangedNode = 0;
+
+  bool
+  isUnchanged(xmlNodePtr node)
+  {
+    return node->_private == &unchangedNode;
+  }
+
+  // Element name and attributes, as written in the start tag
+  std::string
+  getElementSignature(xmlNodePtr node)
+  {
+    std::stringstream signature;
+    signature << (const char *)node->name;
+    for (xmlAttrPtr attribute = node->properties;
+         attribute != NULL;
+         attribute = attribute->next) {
+      xmlChar * value = xmlNodeGetContent((xmlNodePtr)attribute);
+      signature << " " << (const char *)attribute->name << "=\""
+                << (value ? (const char *)value : "") << "\"";
+      xmlFree(value);
+    }
+    return signature.str();
+  }
+
+  // Element children of the node, false if it also has text content
+  bool
+  getElementChildren(xmlNodePtr node,
+                     std::vector<xmlNodePtr> & children)
+  {
+    for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
+      if (child->type == XML_ELEMENT_NODE) {
+        children.push_back(child);
+      }
+      else if (child->type == XML_TEXT_NODE && !xmlIsBlankNode(child)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Element as written within the document at the given level, without
+  // the indentation of its first line
+  std::string
+  dumpNode(xmlDocPtr document,
+           xmlNodePtr node,
+           const int level)
+  {
+    xmlBufferPtr buffer = xmlBufferCreate();
+    xmlOutputBufferPtr outputBuffer = xmlOutputBufferCreateBuffer(buffer,
+                                                                  NULL);
+    xmlNodeDumpOutput(outputBuffer, document, node, level, 1, "utf-8");
+    xmlOutputBufferClose(outputBuffer);
+    const std::string contents((const char *)xmlBufferContent(buffer),
+                               xmlBufferLength(buffer));
+    xmlBufferFree(buffer);
+    return contents;
+  }
+
+}
+
 /**
  * PIMPL
  */
@@ -46,14 +113,17 @@ public:
   XdmfWriterImpl(const std::string & xmlFilePath,
                  const shared_ptr<XdmfHeavyDataWriter> heavyDataWriter,
                  std::ostream * stream) :
+    mBinaryLightData(false),
     mDepth(0),
     mDocumentTitle("Xdmf"),
     mHeavyDataWriter(heavyDataWriter),
     mHeavyWriterIsOpen(false),
     mLastXPathed(false),
+    mLastFileSize(0),
     mLightDataLimit(100),
     mMode(Default),
     mStream(stream),
+    mWriteImplicit(false),
     mWriteXPaths(true),
     mXPathParse(true),
     mXMLCurrentNode(NULL),
@@ -61,7 +131,10 @@ public:
     mXMLFilePath(XdmfSystemUtils::getRealPath(xmlFilePath)),
     mXPathCount(0),
     mXPathString(""),
-    mVersionString(XdmfVersion.getShort())
+    mVersionString(XdmfVersion.getShort()),
+    mStreamOutput(NULL),
+    mStreamXML(false),
+    mWritingTemporary(false)
   {
   };
 
@@ -70,33 +143,69 @@ public:
   };
 
   void
-  closeFile()
+  closeFile(const bool updateInPlace)
   {
     mXPath.clear();
     mXPathCount = 0;
 
-    // This section writes to file
-    std::ofstream fileStream;
-    if(!mStream) {
-      fileStream.open(mXMLFilePath.c_str());
-      mStream = &fileStream;
+    if(mBinaryLightData) {
+      std::ofstream fileStream;
+      if(!mStream) {
+        fileStream.open(mXMLFilePath.c_str(), std::ios::binary);
+        mStream = &fileStream;
+      }
+      XdmfBinaryLightData::write(mXMLDocument, mBinaryValues, *mStream);
+      // Values of archived nodes are written again with them
+      if(!updateInPlace) {
+        mBinaryValues.clear();
+      }
+      mLastElements.clear();
+      if(fileStream.is_open()) {
+        fileStream.close();
+        mStream = NULL;
+      }
+    }
+    else if(mStreamOutput) {
+      // The rest of the document follows the elements already streamed
+      while(mStreamedElements.size() > 0) {
+        this->closeStreamedElement();
+      }
+      mStreamOutput->flush();
+      if(mStreamFile.is_open()) {
+        mStreamFile.close();
+      }
+      mStreamOutput = NULL;
+      mLastElements.clear();
     }
+    else if(mStream || !updateInPlace || !this->updateFile()) {
+      // This section writes to file
+      std::ofstream fileStream;
+      if(!mStream) {
+        fileStream.open(mXMLFilePath.c_str());
+        mStream = &fileStream;
+      }
 
-    xmlBufferPtr buffer = xmlBufferCreate();
-    xmlOutputBuffer * outputBuffer = xmlOutputBufferCreateBuffer(buffer,
-                                                                 NULL);
-    xmlSaveFormatFileTo(outputBuffer,
-                        mXMLDocument,
-                        "utf-8",
-                        1);
-    *mStream << buffer->content;
-    xmlBufferFree(buffer);
-    
-    if(fileStream.is_open()) {
-      fileStream.close();
-      mStream = NULL;
+      xmlBufferPtr buffer = xmlBufferCreate();
+      xmlOutputBuffer * outputBuffer = xmlOutputBufferCreateBuffer(buffer,
+                                                                   NULL);
+      xmlSaveFormatFileTo(outputBuffer,
+                          mXMLDocument,
+                          "utf-8",
+                          1);
+      *mStream << buffer->content;
+      xmlBufferFree(buffer);
+
+      mLastElements.clear();
+      if(fileStream.is_open()) {
+        if(updateInPlace) {
+          mLastFileSize = fileStream.tellp();
+          this->recordLastElements();
+        }
+        fileStream.close();
+        mStream = NULL;
+      }
     }
-    
+
 //    xmlFreeDoc(mXMLDocument);
     xmlCleanupParser();
 
@@ -107,9 +216,26 @@ public:
     }
   };
 
+  // Writes the remaining children and the closing tag of the element
+  // streamed last
+  void
+  closeStreamedElement()
+  {
+    xmlNodePtr node = mStreamedElements.back();
+    const unsigned int level = mStreamedElements.size() - 1;
+    while(node->children != NULL) {
+      this->writeStreamedNode(node->children, level + 1);
+    }
+    *mStreamOutput << std::string(2 * level, ' ') << "</"
+                   << (const char *)node->name << ">\n";
+    mStreamedElements.pop_back();
+  }
+
   void
   openFile()
   {
+    mStreamedElements.clear();
+    mStreamOutput = NULL;
     mXMLDocument = xmlNewDoc((xmlChar*)"1.0");
     mXMLCurrentNode = xmlNewNode(NULL, (xmlChar*)mDocumentTitle.c_str());
     xmlNewProp(mXMLCurrentNode,
@@ -124,14 +250,202 @@ public:
     }
   }
 
+  // Writes the element and the complete elements before it to file,
+  // after the start tags of the elements holding it, and releases them
+  void
+  streamElement(xmlNodePtr node)
+  {
+    if(!mStreamOutput) {
+      if(mStream) {
+        mStreamOutput = mStream;
+      }
+      else {
+        mStreamFile.open(mXMLFilePath.c_str());
+        mStreamOutput = &mStreamFile;
+      }
+      *mStreamOutput << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+    }
+
+    std::vector<xmlNodePtr> elements(1, node);
+    for(xmlNodePtr parent = node->parent;
+        parent != NULL && parent->type == XML_ELEMENT_NODE;
+        parent = parent->parent) {
+      elements.insert(elements.begin(), parent);
+    }
+
+    // Elements holding this one are open, so everything written within
+    // them before it is complete
+    for(unsigned int level = 0; level + 1 < elements.size(); ++level) {
+      xmlNodePtr parent = elements[level];
+      if(level == mStreamedElements.size()) {
+        xmlNodePtr startElement = xmlCopyNode(parent, 2);
+        std::string startTag = dumpNode(mXMLDocument, startElement, level);
+        xmlFreeNode(startElement);
+        // Written as an empty element, without children
+        startTag.replace(startTag.size() - 2, 2, ">");
+        *mStreamOutput << std::string(2 * level, ' ') << startTag << "\n";
+        mStreamedElements.push_back(parent);
+      }
+      while(parent->children != elements[level + 1]) {
+        this->writeStreamedNode(parent->children, level + 1);
+      }
+    }
+    this->writeStreamedNode(node, elements.size() - 1);
+  }
+
+  // Streams the element of an item once the item has been written
+  void
+  streamItem(xmlNodePtr node)
+  {
+    if(mStreamedElements.size() > 0 && mStreamedElements.back() == node) {
+      this->closeStreamedElement();
+      xmlUnlinkNode(node);
+      xmlFreeNode(node);
+    }
+    else if(xmlStrcmp(node->name, (xmlChar*)"Grid") == 0) {
+      // Values are added to data items after they are visited, so
+      // grids are the smallest elements known to be complete
+      this->streamElement(node);
+    }
+  }
+
+  void
+  writeStreamedNode(xmlNodePtr node,
+                    const unsigned int level)
+  {
+    *mStreamOutput << std::string(2 * level, ' ')
+                   << dumpNode(mXMLDocument, node, level) << "\n";
+    xmlUnlinkNode(node);
+    xmlFreeNode(node);
+  }
+
+  // Records the last element of each level of the document written
+  void
+  recordLastElements()
+  {
+    mLastElements.clear();
+    xmlNodePtr node = xmlDocGetRootElement(mXMLDocument);
+    while(node != NULL) {
+      std::vector<xmlNodePtr> children;
+      getElementChildren(node, children);
+      mLastElements.push_back(std::make_pair(getElementSignature(node),
+                                             (unsigned int)children.size()));
+      node = children.size() > 0 ? children.back() : NULL;
+    }
+  }
+
+  // Updates the file last written when the document only differs from
+  // it by elements added after the last element of one of its levels,
+  // writing those elements in place of the closing tags that follow.
+  // Returns false when the document must be written in full.
+  bool
+  updateFile()
+  {
+    if(mLastElements.size() == 0) {
+      return false;
+    }
+
+    std::vector<xmlNodePtr> openElements;
+    std::vector<xmlNodePtr> addedElements;
+    xmlNodePtr node = xmlDocGetRootElement(mXMLDocument);
+    while(addedElements.size() == 0) {
+      const unsigned int level = openElements.size();
+      if(level >= mLastElements.size() ||
+         getElementSignature(node) != mLastElements[level].first) {
+        return false;
+      }
+      openElements.push_back(node);
+      std::vector<xmlNodePtr> children;
+      const unsigned int numberWritten = mLastElements[level].second;
+      if(!getElementChildren(node, children) ||
+         numberWritten == 0 ||
+         children.size() < numberWritten) {
+        return false;
+      }
+      for(unsigned int i = 0; i + 1 < numberWritten; ++i) {
+        if(!isUnchanged(children[i])) {
+          return false;
+        }
+      }
+      if(isUnchanged(children[numberWritten - 1])) {
+        if(children.size() == numberWritten) {
+          // Nothing changed since the last write
+          return true;
+        }
+        addedElements.assign(children.begin() + numberWritten, children.end());
+      }
+      else if(children.size() == numberWritten) {
+        node = children[numberWritten - 1];
+      }
+      else {
+        return false;
+      }
+    }
+
+    std::string closingTags;
+    for(unsigned int i = openElements.size(); i > 0; --i) {
+      closingTags += std::string(2 * (i - 1), ' ') + "</" +
+        (const char *)openElements[i - 1]->name + ">\n";
+    }
+
+    std::fstream fileStream(mXMLFilePath.c_str(),
+                            std::ios::in | std::ios::out | std::ios::binary);
+    if(!fileStream.is_open()) {
+      return false;
+    }
+    fileStream.seekg(0, std::ios::end);
+    const std::streamoff fileSize = fileStream.tellg();
+    if(fileSize != mLastFileSize ||
+       fileSize < (std::streamoff)closingTags.size()) {
+      return false;
+    }
+    std::string writtenTags(closingTags.size(), ' ');
+    fileStream.seekg(fileSize - closingTags.size());
+    fileStream.read(&writtenTags[0], writtenTags.size());
+    if(!fileStream || writtenTags != closingTags) {
+      return false;
+    }
+
+    std::stringstream addedText;
+    const std::string indent(2 * openElements.size(), ' ');
+    for(unsigned int i = 0; i < addedElements.size(); ++i) {
+      addedText << indent
+                << dumpNode(mXMLDocument, addedElements[i], openElements.size())
+                << "\n";
+    }
+    addedText << closingTags;
+
+    fileStream.seekp(fileSize - closingTags.size());
+    fileStream << addedText.str();
+    mLastFileSize = fileStream.tellp();
+    fileStream.close();
+    this->recordLastElements();
+    return true;
+  }
+
+  // Items written within each grid whose XML is archived, and the
+  // items being written within the grids currently being archived.
+  // Each item is kept with a weak reference to its archive token, an
+  // expired token means the item was destroyed since it was written.
+  typedef std::pair<XdmfItem *, weak_ptr<bool> > ArchivedItem;
+  std::map<const XdmfItem *, std::vector<ArchivedItem> > mArchivedItems;
+  std::vector<std::vector<ArchivedItem> > mArchivingItems;
+  // Raw values of the data items written when writing binary light data
+  bool mBinaryLightData;
+  std::map<xmlNodePtr, std::string> mBinaryValues;
   int mDepth;
   std::string mDocumentTitle;
   shared_ptr<XdmfHeavyDataWriter> mHeavyDataWriter;
   bool mHeavyWriterIsOpen;
   bool mLastXPathed;
+  // Signature and number of element children of the last element of
+  // each level of the file last written, and the size of the file
+  std::vector<std::pair<std::string, unsigned int> > mLastElements;
+  std::streamoff mLastFileSize;
   unsigned int mLightDataLimit;
   Mode mMode;
   std::ostream * mStream;
+  bool mWriteImplicit;
   bool mWriteXPaths;
   bool mXPathParse;
   xmlNodePtr mXMLCurrentNode;
@@ -141,6 +455,13 @@ public:
   unsigned int mXPathCount;
   std::string mXPathString;
   std::string mVersionString;
+  // Elements whose start tags were streamed, from the root down, and the
+  // stream they were written to
+  std::vector<xmlNodePtr> mStreamedElements;
+  std::ofstream mStreamFile;
+  std::ostream * mStreamOutput;
+  bool mStreamXML;
+  bool mWritingTemporary;
 
 };
 
@@ -242,6 +563,12 @@ XdmfWriter::getRebuildXML()
   return mRebuildAlreadyVisited;
 }
 
+bool
+XdmfWriter::getStreamXML() const
+{
+  return mImpl->mStreamXML;
+}
+
 xmlNodePtr
 XdmfWriter::getXMLNode(XdmfItem * item, xmlDocPtr parentDoc, xmlNodePtr parentNode)
 {
@@ -249,8 +576,10 @@ XdmfWriter::getXMLNode(XdmfItem * item, xmlDocPtr parentDoc, xmlNodePtr parentNo
     mXMLArchive.find(item);
   if (node != mXMLArchive.end())
   {
-    xmlAddChild(parentNode, mXMLArchive[item]);
-    return mXMLArchive[item];
+    // Move the node from the document it was last written to
+    xmlUnlinkNode(node->second);
+    xmlAddChild(parentNode, node->second);
+    return node->second;
   }
   else
   {
@@ -258,6 +587,41 @@ XdmfWriter::getXMLNode(XdmfItem * item, xmlDocPtr parentDoc, xmlNodePtr parentNo
   }
 }
 
+bool
+XdmfWriter::getArchiveIsCurrent(XdmfItem * item)
+{
+  if (item->getIsChanged() || !getHasXMLArchive(item))
+  {
+    return false;
+  }
+  std::map<const XdmfItem *, std::vector<XdmfWriterImpl::ArchivedItem> >::const_iterator archivedItems =
+    mImpl->mArchivedItems.find(item);
+  if (archivedItems == mImpl->mArchivedItems.end())
+  {
+    return false;
+  }
+  // Items are in the order they were written, starting with the grid
+  // itself, so parents are checked before the items they hold
+  for (unsigned int i = 0; i < archivedItems->second.size(); ++i)
+  {
+    XdmfItem * archivedItem = archivedItems->second[i].first;
+    // A destroyed item may have been replaced by another at the same
+    // address, only items still alive can be looked at
+    if (!archivedItem || archivedItems->second[i].second.expired() ||
+        archivedItem->getIsChanged())
+    {
+      return false;
+    }
+    if (archivedItem != item &&
+        mImpl->mArchivedItems.find(archivedItem) != mImpl->mArchivedItems.end() &&
+        !getArchiveIsCurrent(archivedItem))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool
 XdmfWriter::getHasXMLArchive(XdmfItem * item)
 {
@@ -273,6 +637,12 @@ XdmfWriter::getHasXMLArchive(XdmfItem * item)
   }
 }
 
+bool
+XdmfWriter::getWriteImplicit() const
+{
+  return mImpl->mWriteImplicit;
+}
+
 bool
 XdmfWriter::getWriteXPaths() const
 {
@@ -285,6 +655,12 @@ XdmfWriter::getXPathParse() const
   return mImpl->mXPathParse;
 }
 
+void
+XdmfWriter::setBinaryLightData(const bool binary)
+{
+  mImpl->mBinaryLightData = binary;
+}
+
 void
 XdmfWriter::setDocumentTitle(std::string title)
 {
@@ -315,6 +691,12 @@ XdmfWriter::setRebuildXML(bool newStatus)
   mRebuildAlreadyVisited = newStatus;
 }
 
+void
+XdmfWriter::setStreamXML(const bool streamXML)
+{
+  mImpl->mStreamXML = streamXML;
+}
+
 void
 XdmfWriter::setVersionString(std::string version)
 {
@@ -324,7 +706,15 @@ XdmfWriter::setVersionString(std::string version)
 void
 XdmfWriter::setXMLNode(XdmfItem * item, xmlNodePtr & newNode)
 {
-    mXMLArchive[item] = xmlCopyNode(newNode, 1);
+    // Documents are kept until the writer is destroyed, so the node is
+    // moved into later documents rather than copied
+    mXMLArchive[item] = newNode;
+}
+
+void
+XdmfWriter::setWriteImplicit(const bool writeImplicit)
+{
+  mImpl->mWriteImplicit = writeImplicit;
 }
 
 void
@@ -373,27 +763,52 @@ XdmfWriter::visit(XdmfArray & array,
 
     if(array.getSize() > 0 && !(mImpl->mLastXPathed && isSubclassed)) {
       std::vector<std::string> xmlTextValues;
+      std::string rawValues;
+      bool hasRawValues = false;
+
+      // Controllers without a backing file generate their values on
+      // demand. Small arrays are written inline like any light data,
+      // larger ones to heavy data, or as the description the values
+      // are generated from when implicit output is requested.
+      bool isGenerated = false;
+      bool writeInline = false;
+      bool writeDescription = false;
+      if(array.getHeavyDataController(0) &&
+         array.getHeavyDataController(0)->getFilePath().empty()) {
+        isGenerated = true;
+        if(array.getSize() <= mImpl->mLightDataLimit) {
+          writeInline = true;
+        }
+        else if(mImpl->mWriteImplicit && !array.isInitialized()) {
+          writeDescription = true;
+        }
+        if(!writeDescription && !array.isInitialized()) {
+          array.read();
+        }
+      }
 
       // Take care of writing to single heavy data file (Default behavior)
-      if(!array.isInitialized() && array.getHeavyDataController(0) &&
-         mImpl->mMode == Default) {
+      if(!isGenerated && !array.isInitialized() &&
+         array.getHeavyDataController(0) && mImpl->mMode == Default) {
         if (array.getHeavyDataController(0)->getFilePath().compare(mImpl->mHeavyDataWriter->getFilePath()) != 0)
         {
           array.read();
         }
       }
 
-      if(array.getHeavyDataController(0) ||
+      if((array.getHeavyDataController(0) && !isGenerated) ||
          array.getSize() > mImpl->mLightDataLimit) {
         // Write values to heavy data
 
-        // This takes about half the time needed
-        if ((!mImpl->mHeavyWriterIsOpen) &&
-            mImpl->mHeavyDataWriter->getMode() == XdmfHeavyDataWriter::Default) {
-          mImpl->mHeavyDataWriter->openFile();
-          mImpl->mHeavyWriterIsOpen = true;
+        if(!writeDescription) {
+          // This takes about half the time needed
+          if ((!mImpl->mHeavyWriterIsOpen) &&
+              mImpl->mHeavyDataWriter->getMode() == XdmfHeavyDataWriter::Default) {
+            mImpl->mHeavyDataWriter->openFile();
+            mImpl->mHeavyWriterIsOpen = true;
+          }
+          mImpl->mHeavyDataWriter->visit(array, mImpl->mHeavyDataWriter);
         }
-        mImpl->mHeavyDataWriter->visit(array, mImpl->mHeavyDataWriter);
 
         std::stringstream valuesStream;
         for(unsigned int i = 0; i < array.getNumberHeavyDataControllers(); ++i) {
@@ -428,6 +843,14 @@ XdmfWriter::visit(XdmfArray & array,
           xmlTextValues.push_back(valuesStream.str());
         }
       }
+      else if(mImpl->mBinaryLightData &&
+              array.getArrayType() != XdmfArrayType::String()) {
+        // Binary light data holds the values as they are in memory
+        rawValues.assign((const char *)array.getValuesInternal(),
+                         array.getSize() *
+                         array.getArrayType()->getElementSize());
+        hasRawValues = true;
+      }
       else {
         // Write values to XML
         xmlTextValues.push_back(array.getValuesString());
@@ -443,16 +866,30 @@ XdmfWriter::visit(XdmfArray & array,
         mImpl->mWriteXPaths = false;
         const unsigned int parentCount = mImpl->mXPathCount;
         mImpl->mXPathCount = 0;
+        // Swapping values marks the array as changed, keep its status
+        const bool arrayChanged = array.getIsChanged();
         shared_ptr<XdmfArray> arrayToWrite = XdmfArray::New();
         array.swap(arrayToWrite);
         mImpl->mXMLCurrentNode = mImpl->mXMLCurrentNode->last;
+        mImpl->mWritingTemporary = true;
         this->visit(dynamic_cast<XdmfItem &>(*arrayToWrite.get()), visitor);
+        mImpl->mWritingTemporary = false;
         for(unsigned int i = 0; i<xmlTextValues.size(); ++i) {
           xmlAddChild(mImpl->mXMLCurrentNode->last,
                       xmlNewText((xmlChar*)xmlTextValues[i].c_str()));
         }
+        if(hasRawValues) {
+          mImpl->mBinaryValues[mImpl->mXMLCurrentNode->last].swap(rawValues);
+        }
+        if(writeInline) {
+          // The generated values were written in place of the description
+          xmlSetProp(mImpl->mXMLCurrentNode->last,
+                     (xmlChar*)"Format",
+                     (xmlChar*)"XML");
+        }
         mImpl->mXMLCurrentNode = mImpl->mXMLCurrentNode->parent;
         array.swap(arrayToWrite);
+        array.setIsChanged(arrayChanged);
         mImpl->mXPathCount = parentCount;
         mImpl->mLastXPathed = false;
       }
@@ -465,6 +902,15 @@ XdmfWriter::visit(XdmfArray & array,
             xmlAddChild(mImpl->mXMLCurrentNode->last,
                         xmlNewText((xmlChar*)xmlTextValues[i].c_str()));
           }
+          if(hasRawValues) {
+            mImpl->mBinaryValues[mImpl->mXMLCurrentNode->last].swap(rawValues);
+          }
+          if(writeInline) {
+            // The generated values were written in place of the description
+            xmlSetProp(mImpl->mXMLCurrentNode->last,
+                       (xmlChar*)"Format",
+                       (xmlChar*)"XML");
+          }
         }
       }
       mImpl->mWriteXPaths = oldWriteXPaths;
@@ -486,7 +932,7 @@ XdmfWriter::visit(XdmfArray & array,
 
   mImpl->mDepth--;
   if(mImpl->mDepth <= 0) {
-    mImpl->closeFile();
+    mImpl->closeFile(!mRebuildAlreadyVisited);
   }
 }
 
@@ -499,9 +945,27 @@ XdmfWriter::visit(XdmfItem & item,
   }
   mImpl->mDepth++;
 
+  if (!mRebuildAlreadyVisited && !mImpl->mWritingTemporary) {
+    // Items written without XPaths may be temporary and can't be
+    // checked later, so the grids holding them are always rewritten
+    XdmfWriterImpl::ArchivedItem archivedItem;
+    if (mImpl->mWriteXPaths) {
+      if (!item.mArchiveToken) {
+        item.mArchiveToken.reset(new bool(true));
+      }
+      archivedItem.first = &item;
+      archivedItem.second = item.mArchiveToken;
+    }
+    for (unsigned int i = 0; i < mImpl->mArchivingItems.size(); ++i) {
+      mImpl->mArchivingItems[i].push_back(archivedItem);
+    }
+  }
+  const bool itemChanged = item.getIsChanged();
+
   if ((item.getItemTag().compare("Grid") != 0) || // If not a grid
       (item.getItemTag().compare("Grid") == 0 && item.getIsChanged()) || // If a Grid that is changed
       (item.getItemTag().compare("Grid") == 0 && !getHasXMLArchive(&item)) || // If the grid doesn't have an XML Archive
+      (item.getItemTag().compare("Grid") == 0 && !getArchiveIsCurrent(&item)) || // If an item within the grid changed
       mRebuildAlreadyVisited) // If Rebuild
   {
     std::string tag = item.getItemTag();
@@ -509,6 +973,17 @@ XdmfWriter::visit(XdmfItem & item,
       item.traverse(visitor);
     }
     else {
+      const bool archiveItem = !mRebuildAlreadyVisited && tag.compare("Grid") == 0;
+      if (archiveItem) {
+        // The grid itself comes first, a grid at the address of a
+        // destroyed one is then never mistaken for it
+        if (!item.mArchiveToken) {
+          item.mArchiveToken.reset(new bool(true));
+        }
+        mImpl->mArchivingItems.push_back(
+          std::vector<XdmfWriterImpl::ArchivedItem>(1,
+            XdmfWriterImpl::ArchivedItem(&item, item.mArchiveToken)));
+      }
       if(mImpl->mWriteXPaths) {
         if (tag == "Information" && mImpl->mXPathParse) {
           XdmfInformation & xpathinfo = dynamic_cast<XdmfInformation &>(item);
@@ -663,18 +1138,43 @@ XdmfWriter::visit(XdmfItem & item,
 
       if (!mRebuildAlreadyVisited)
       {
-        if (item.getItemTag().compare("Grid") == 0)
+        xmlNodePtr itemNode = mImpl->mXMLCurrentNode;
+        const bool isInclude =
+          xmlStrcmp(itemNode->name, (xmlChar*)"xi:include") == 0;
+        // Unchanged when the item and everything written within it are
+        bool unchanged = !itemChanged && !isInclude;
+        for (xmlNodePtr child = itemNode->children;
+             child != NULL && unchanged;
+             child = child->next) {
+          if (child->type == XML_ELEMENT_NODE && !isUnchanged(child)) {
+            unchanged = false;
+          }
+        }
+        itemNode->_private = unchanged ? &unchangedNode : NULL;
+        if (archiveItem)
         {
-          setXMLNode(&item, mImpl->mXMLCurrentNode);
+          if (!isInclude)
+          {
+            setXMLNode(&item, mImpl->mXMLCurrentNode);
+            mImpl->mArchivedItems[&item].swap(mImpl->mArchivingItems.back());
+          }
+          mImpl->mArchivingItems.pop_back();
         }
         item.setIsChanged(false);
       }
 
-      mImpl->mXMLCurrentNode = mImpl->mXMLCurrentNode->parent;
+      xmlNodePtr writtenNode = mImpl->mXMLCurrentNode;
+      mImpl->mXMLCurrentNode = writtenNode->parent;
+      if (mImpl->mStreamXML && mRebuildAlreadyVisited &&
+          !mImpl->mBinaryLightData) {
+        mImpl->streamItem(writtenNode);
+      }
     }
   }
   else
   {
+    // The archived grid takes the place of a newly written one
+    mImpl->mXPathCount++;
     std::map<const XdmfItem * const, std::string>::const_iterator iter =
       mImpl->mXPath.find(&item);
     if(iter != mImpl->mXPath.end()) {
@@ -689,14 +1189,16 @@ XdmfWriter::visit(XdmfItem & item,
       mImpl->mXMLCurrentNode = mImpl->mXMLCurrentNode->parent;
     }
     else {
-      this->getXMLNode(&item, mImpl->mXMLDocument, mImpl->mXMLCurrentNode);
+      xmlNodePtr archivedNode =
+        this->getXMLNode(&item, mImpl->mXMLDocument, mImpl->mXMLCurrentNode);
+      archivedNode->_private = &unchangedNode;
     }
   }
 
   mImpl->mDepth--;
   if(mImpl->mDepth <= 0) {
     mImpl->mXPathCount = 0 ;
-    mImpl->closeFile();
+    mImpl->closeFile(!mRebuildAlreadyVisited);
   }
 }
 
@@ -296,6 +296,58 @@ public:
    */
   bool getRebuildXML();
 
+  /**
+   * Gets whether XML is streamed to file as it is written.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfWriter.cpp
+   * @skipline //#heavyinitialization
+   * @until //#heavyinitialization
+   * @skipline //#getStreamXML
+   * @until //#getStreamXML
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleWriter.py
+   * @skipline #//heavyinitialization
+   * @until #//heavyinitialization
+   * @skipline #//getStreamXML
+   * @until #//getStreamXML
+   *
+   * @return    Whether XML will be streamed.
+   */
+  bool getStreamXML() const;
+
+  /**
+   * Gets whether arrays generated on demand, such as the points and
+   * connectivity of a converted structured grid, are written as the
+   * description they are generated from instead of as heavy data.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfWriter.cpp
+   * @skipline //#heavyinitialization
+   * @until //#heavyinitialization
+   * @skipline //#getWriteImplicit
+   * @until //#getWriteImplicit
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleWriter.py
+   * @skipline #//heavyinitialization
+   * @until #//heavyinitialization
+   * @skipline #//getWriteImplicit
+   * @until #//getWriteImplicit
+   *
+   * @return    Whether generated arrays are written as descriptions.
+   */
+  bool getWriteImplicit() const;
+
   /**
    * Get whether this writer is set to write xpaths.
    *
@@ -430,6 +482,15 @@ public:
   /**
    * Sets whether XML will be rebuilt with each write.
    *
+   * When XML is not rebuilt, grids whose items are unchanged since the
+   * last write are written from the XML kept for them without visiting
+   * their arrays. If the only difference from the file last written is
+   * elements added after the last element of some level of the document,
+   * such as grids appended to a temporal collection, those elements are
+   * written in place of the closing tags at the end of the file instead
+   * of rewriting it, and the file is left as is when nothing changed.
+   * This relies on items being marked as changed when modified.
+   *
    * Example of use:
    *
    * C++
@@ -452,6 +513,69 @@ public:
    */
   void setRebuildXML(bool newStatus);
 
+  /**
+   * Sets whether XML will be streamed to file as it is written.
+   *
+   * When streamed, each grid is written out as soon as it has been
+   * visited and its XML is released, so the memory used does not grow
+   * with the number of grids written, e.g. for large temporal
+   * collections. The output is the same as when the whole document is
+   * written at the end. Grids written before are still referenced by
+   * xpath. Streaming only applies when XML is rebuilt with each write,
+   * see setRebuildXML().
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfWriter.cpp
+   * @skipline //#heavyinitialization
+   * @until //#heavyinitialization
+   * @skipline //#setStreamXML
+   * @until //#setStreamXML
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleWriter.py
+   * @skipline #//heavyinitialization
+   * @until #//heavyinitialization
+   * @skipline #//setStreamXML
+   * @until #//setStreamXML
+   *
+   * @param     streamXML       Whether to stream XML.
+   */
+  void setStreamXML(const bool streamXML);
+
+  /**
+   * Sets whether arrays generated on demand that exceed the light data
+   * limit are written as the description they are generated from, with
+   * Format="Implicit", instead of writing their values to heavy data.
+   * Implicit descriptions are only read back by XdmfReader. Off by
+   * default.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfWriter.cpp
+   * @skipline //#heavyinitialization
+   * @until //#heavyinitialization
+   * @skipline //#setWriteImplicit
+   * @until //#setWriteImplicit
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleWriter.py
+   * @skipline #//heavyinitialization
+   * @until #//heavyinitialization
+   * @skipline #//setWriteImplicit
+   * @until #//setWriteImplicit
+   *
+   * @param     writeImplicit   Whether to write generated arrays as
+   *                            descriptions.
+   */
+  void setWriteImplicit(const bool writeImplicit);
+
   /**
    * Set whether to write xpaths for this writer.
    *
@@ -557,9 +681,17 @@ protected:
              std::ostream * stream = NULL);
 
   xmlNodePtr getXMLNode(XdmfItem * item, xmlDocPtr parentDoc, xmlNodePtr parentNode);
+  bool getArchiveIsCurrent(XdmfItem * item);
   bool getHasXMLArchive(XdmfItem * item);
   void setXMLNode(XdmfItem * item, xmlNodePtr & newNode);
 
+  /**
+   * Sets whether light data is written as binary, as described in
+   * XdmfBinaryLightData, instead of XML.
+   *
+   * @param     binary          Whether to write binary light data.
+   */
+  void setBinaryLightData(const bool binary);
   void setDocumentTitle(std::string title);
   void setVersionString(std::string version);
 
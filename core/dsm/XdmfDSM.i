@@ -27,6 +27,10 @@ swig -v -c++ -python -o XdmfDSMPython.cpp XdmfDSM.i
     #include <XdmfHDF5Writer.hpp>
     #include <XdmfHDF5ControllerDSM.hpp>
     #include <XdmfHDF5WriterDSM.hpp>
+#ifdef XDMF_DSM_HAVE_PARALLEL_HDF5
+    #include <XdmfHDF5WriterParallel.hpp>
+    #include <XdmfHDF5ControllerParallel.hpp>
+#endif
     #include <XdmfInformation.hpp>
     #include <XdmfItem.hpp>
     #include <XdmfItemProperty.hpp>
@@ -165,6 +169,63 @@ swig -v -c++ -python -o XdmfDSMPython.cpp XdmfDSM.i
 %ignore XdmfHDF5WriterDSMSetMode(XDMFHDF5WRITERDSM * writer, int mode, int * status);
 %ignore XdmfHDF5WriterDSMSetReleaseData(XDMFHDF5WRITERDSM * writer, int releaseData);
 
+// XdmfHDF5WriterParallel
+
+%ignore XdmfHDF5WriterParallelNew(char * filePath,
+                                  MPI_Comm comm,
+                                  int clobberFile,
+                                  int * status);
+%ignore XdmfHDF5WriterParallelGetComm(XDMFHDF5WRITERPARALLEL * writer);
+// XdmfHDF5WriterParallel inherited from XdmfHDF5Writer
+%ignore XdmfHDF5WriterParallelCloseFile(XDMFHDF5WRITERPARALLEL * writer, int * status);
+%ignore XdmfHDF5WriterParallelGetChunkSize(XDMFHDF5WRITERPARALLEL * writer, int * status);
+%ignore XdmfHDF5WriterParallelOpenFile(XDMFHDF5WRITERPARALLEL * writer, int * status);
+%ignore XdmfHDF5WriterParallelSetChunkSize(XDMFHDF5WRITERPARALLEL * writer, unsigned int chunkSize, int * status);
+// XdmfHDF5WriterParallel inherited from XdmfHeavyDataWriter
+%ignore XdmfHDF5WriterParallelFree(XDMFHDF5WRITERPARALLEL * item);
+%ignore XdmfHDF5WriterParallelGetAllowSetSplitting(XDMFHDF5WRITERPARALLEL * writer);
+%ignore XdmfHDF5WriterParallelGetFileIndex(XDMFHDF5WRITERPARALLEL * writer);
+%ignore XdmfHDF5WriterParallelGetFileOverhead(XDMFHDF5WRITERPARALLEL * writer);
+%ignore XdmfHDF5WriterParallelGetFilePath(XDMFHDF5WRITERPARALLEL * writer);
+%ignore XdmfHDF5WriterParallelGetFileSizeLimit(XDMFHDF5WRITERPARALLEL * writer);
+%ignore XdmfHDF5WriterParallelGetMode(XDMFHDF5WRITERPARALLEL * writer);
+%ignore XdmfHDF5WriterParallelGetReleaseData(XDMFHDF5WRITERPARALLEL * writer);
+%ignore XdmfHDF5WriterParallelSetAllowSetSplitting(XDMFHDF5WRITERPARALLEL * writer, int newAllow);
+%ignore XdmfHDF5WriterParallelSetFileIndex(XDMFHDF5WRITERPARALLEL * writer, int newIndex);
+%ignore XdmfHDF5WriterParallelSetFileSizeLimit(XDMFHDF5WRITERPARALLEL * writer, int newSize);
+%ignore XdmfHDF5WriterParallelSetMode(XDMFHDF5WRITERPARALLEL * writer, int mode, int * status);
+%ignore XdmfHDF5WriterParallelSetReleaseData(XDMFHDF5WRITERPARALLEL * writer, int releaseData);
+
+// XdmfHDF5ControllerParallel
+
+%ignore XdmfHDF5ControllerParallelNew(char * hdf5FilePath,
+                                      char * dataSetPath,
+                                      int type,
+                                      unsigned int * start,
+                                      unsigned int * stride,
+                                      unsigned int * dimensions,
+                                      unsigned int * dataspaceDimensions,
+                                      unsigned int numDims,
+                                      MPI_Comm comm,
+                                      int * status);
+%ignore XdmfHDF5ControllerParallelGetComm(XDMFHDF5CONTROLLERPARALLEL * controller);
+// XdmfHDF5ControllerParallel inherited from XdmfHDF5Controller
+%ignore XdmfHDF5ControllerParallelGetDataSetPath(XDMFHDF5CONTROLLERPARALLEL * controller);
+// XdmfHDF5ControllerParallel inherited from XdmfHeavyDataController
+%ignore XdmfHDF5ControllerParallelFree(XDMFHDF5CONTROLLERPARALLEL * item);
+%ignore XdmfHDF5ControllerParallelGetDataspaceDimensions(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelGetDimensions(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelGetFilePath(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelGetName(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelGetNumberDimensions(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelGetSize(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelGetStart(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelGetStride(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelSetArrayOffset(XDMFHDF5CONTROLLERPARALLEL * controller, unsigned int newOffset);
+%ignore XdmfHDF5ControllerParallelGetArrayOffset(XDMFHDF5CONTROLLERPARALLEL * controller);
+%ignore XdmfHDF5ControllerParallelGetType(XDMFHDF5CONTROLLERPARALLEL * controller, int * status);
+%ignore XdmfHDF5ControllerParallelRead(XDMFHDF5CONTROLLERPARALLEL * controller, void * array, int * status);
+
 // XdmfDSMCommMPI
 
 %ignore XdmfDSMCommMPINew();
@@ -218,7 +279,7 @@ swig -v -c++ -python -o XdmfDSMPython.cpp XdmfDSM.i
 %ignore XdmfDSMBufferCreate(XDMFDSMBUFFER * buffer, int comm, int startId, int endId, int * status);
 %ignore XdmfDSMBufferDisconnect(XDMFDSMBUFFER * buffer, int * status);
 %ignore XdmfDSMBufferGet(XDMFDSMBUFFER * buffer, long Address, long aLength, void * Data, int * status);
-%ignore XdmfDSMBufferGetAddressRangeForId(XDMFDSMBUFFER * buffer, int Id, int * Start, int * End, int * status);
+%ignore XdmfDSMBufferGetAddressRangeForId(XDMFDSMBUFFER * buffer, int Id, long * Start, long * End, int * status);
 %ignore XdmfDSMBufferGetBlockLength(XDMFDSMBUFFER * buffer);
 %ignore XdmfDSMBufferGetComm(XDMFDSMBUFFER * buffer);
 %ignore XdmfDSMBufferGetDataPointer(XDMFDSMBUFFER * buffer);
@@ -245,17 +306,17 @@ swig -v -c++ -python -o XdmfDSMPython.cpp XdmfDSM.i
 %ignore XdmfDSMBufferReceiveCommandHeader(XDMFDSMBUFFER * buffer,
                                           int * opcode,
                                           int * source,
-                                          int * address,
-                                          int * aLength,
+                                          long * address,
+                                          long * aLength,
                                           int comm,
                                           int remoteSource,
                                           int * status);
 %ignore XdmfDSMBufferReceiveData(XDMFDSMBUFFER * buffer,
                                  int source,
                                  char * data,
-                                 int aLength,
+                                 long aLength,
                                  int tag,
-                                 int aAddress,
+                                 long aAddress,
                                  int comm,
                                  int * status);
 %ignore XdmfDSMBufferReceiveInfo(XDMFDSMBUFFER * buffer,
@@ -270,16 +331,16 @@ swig -v -c++ -python -o XdmfDSMPython.cpp XdmfDSM.i
 %ignore XdmfDSMBufferSendCommandHeader(XDMFDSMBUFFER * buffer,
                                        int opcode,
                                        int dest,
-                                       int address,
-                                       int aLength,
+                                       long address,
+                                       long aLength,
                                        int comm,
                                        int * status);
 %ignore XdmfDSMBufferSendData(XDMFDSMBUFFER * buffer,
                               int dest,
                               char * data,
-                              int aLength,
+                              long aLength,
                               int tag,
-                              int aAddress,
+                              long aAddress,
                               int comm,
                               int * status);
 %ignore XdmfDSMBufferSendDone(XDMFDSMBUFFER * buffer, int * status);
@@ -364,11 +425,19 @@ swig -v -c++ -python -o XdmfDSMPython.cpp XdmfDSM.i
 // Shared Pointer Templates
 %shared_ptr(XdmfHDF5ControllerDSM)
 %shared_ptr(XdmfHDF5WriterDSM)
+#ifdef XDMF_DSM_HAVE_PARALLEL_HDF5
+  %shared_ptr(XdmfHDF5WriterParallel)
+  %shared_ptr(XdmfHDF5ControllerParallel)
+#endif
 %shared_ptr(XdmfDSMItemFactory)
 
 %include XdmfDSM.hpp
 %include XdmfHDF5ControllerDSM.hpp
 %include XdmfHDF5WriterDSM.hpp
+#ifdef XDMF_DSM_HAVE_PARALLEL_HDF5
+  %include XdmfHDF5WriterParallel.hpp
+  %include XdmfHDF5ControllerParallel.hpp
+#endif
 %include XdmfDSMBuffer.hpp
 %include XdmfDSMCommMPI.hpp
 %include XdmfDSMItemFactory.hpp
@@ -58,11 +58,191 @@
 #include <string.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <fstream>
+
+#include <pthread.h>
+#include <sched.h>
 
 #ifndef _WIN32
   #include <unistd.h>
 #endif
 
+// Polls for commands that only yield before the service threads'
+// dispatcher starts sleeping between them
+#define XDMF_DSM_SERVICE_SPIN_POLLS 64u
+
+#ifdef XDMF_DSM_HAVE_ZLIB
+  #include <zlib.h>
+#endif
+
+/**
+ * local functions
+ */
+namespace {
+
+  // Scrambles the index of a round of pages. Every core computes
+  // the same value, so random placement needs no communication.
+  unsigned int
+  hashPageRound(unsigned int round)
+  {
+    unsigned int hash = round + 0x9e3779b9;
+    hash = (hash ^ (hash >> 16)) * 0x85ebca6b;
+    hash = (hash ^ (hash >> 13)) * 0xc2b2ae35;
+    return hash ^ (hash >> 16);
+  }
+
+  // Zeroed memory aligned for the transports that expose it
+  char *
+  allocateAligned(long aLength)
+  {
+    char * data = NULL;
+#ifdef _WIN32
+    data = static_cast<char *>(calloc(aLength, sizeof(char)));
+#else
+    if (posix_memalign((void **)(&data), XDMF_DSM_ALIGNMENT, aLength) != 0) {
+      return NULL;
+    }
+    memset(data, 0, aLength);
+#endif
+    return data;
+  }
+
+  // Inserts the role and id of a core before the extension of a
+  // statistics file name so that every core writes its own file.
+  std::string
+  statisticsFileName(const std::string & base, bool isServer, int id)
+  {
+    std::stringstream name;
+    std::string::size_type extension = base.rfind('.');
+    std::string::size_type directory = base.find_last_of("/\\");
+    if (extension == std::string::npos ||
+        (directory != std::string::npos && extension < directory)) {
+      extension = base.size();
+    }
+    name << base.substr(0, extension)
+         << (isServer ? ".server" : ".client") << id
+         << base.substr(extension);
+    return name.str();
+  }
+
+  unsigned int
+  greatestCommonDivisor(unsigned int a, unsigned int b)
+  {
+    while (b != 0) {
+      unsigned int remainder = a % b;
+      a = b;
+      b = remainder;
+    }
+    return a;
+  }
+
+  // Groups the bytes of equal significance of each element together,
+  // bytes past the last whole element are left in place.
+  void
+  shuffleBytes(const char * data, long aLength, int elementSize, char * output)
+  {
+    long numElements = aLength / elementSize;
+    for (int byte = 0; byte < elementSize; ++byte) {
+      for (long i = 0; i < numElements; ++i) {
+        output[byte * numElements + i] = data[i * elementSize + byte];
+      }
+    }
+    memcpy(output + numElements * elementSize,
+           data + numElements * elementSize,
+           aLength - numElements * elementSize);
+  }
+
+  void
+  unshuffleBytes(const char * data, long aLength, int elementSize, char * output)
+  {
+    long numElements = aLength / elementSize;
+    for (int byte = 0; byte < elementSize; ++byte) {
+      for (long i = 0; i < numElements; ++i) {
+        output[i * elementSize + byte] = data[byte * numElements + i];
+      }
+    }
+    memcpy(output + numElements * elementSize,
+           data + numElements * elementSize,
+           aLength - numElements * elementSize);
+  }
+
+  // Each run starts with a control byte, values below 128 are followed
+  // by that many plus one literal bytes, others by a single byte
+  // repeated that many minus 125 times.
+  // Returns -1 if the result does not fit in maxLength.
+  long
+  runLengthEncode(const unsigned char * data, long aLength, unsigned char * output, long maxLength)
+  {
+    long in = 0;
+    long out = 0;
+    long literalStart = 0;
+    while (in <= aLength) {
+      long run = 1;
+      if (in < aLength) {
+        while (in + run < aLength && run < 130 && data[in + run] == data[in]) {
+          ++run;
+        }
+      }
+      // Flush pending literals before a repeat or at the end
+      if (in == aLength || run >= 3) {
+        while (literalStart < in) {
+          long literals = std::min(in - literalStart, 128L);
+          if (out + 1 + literals > maxLength) {
+            return -1;
+          }
+          output[out++] = (unsigned char)(literals - 1);
+          memcpy(output + out, data + literalStart, literals);
+          out += literals;
+          literalStart += literals;
+        }
+        if (in == aLength) {
+          break;
+        }
+        if (out + 2 > maxLength) {
+          return -1;
+        }
+        output[out++] = (unsigned char)(run + 125);
+        output[out++] = data[in];
+        in += run;
+        literalStart = in;
+      }
+      else {
+        in += run;
+      }
+    }
+    return out;
+  }
+
+  long
+  runLengthDecode(const unsigned char * data, long aLength, unsigned char * output, long maxLength)
+  {
+    long in = 0;
+    long out = 0;
+    while (in < aLength) {
+      long control = data[in++];
+      if (control < 128) {
+        long literals = control + 1;
+        if (in + literals > aLength || out + literals > maxLength) {
+          return -1;
+        }
+        memcpy(output + out, data + in, literals);
+        in += literals;
+        out += literals;
+      }
+      else {
+        long run = control - 125;
+        if (in >= aLength || out + run > maxLength) {
+          return -1;
+        }
+        memset(output + out, data[in++], run);
+        out += run;
+      }
+    }
+    return out;
+  }
+
+}
+
 XdmfDSMBuffer::XdmfDSMBuffer()
 {
   this->CommChannel = XDMF_DSM_INTER_COMM;
@@ -81,14 +261,60 @@ XdmfDSMBuffer::XdmfDSMBuffer()
   this->InterCommType = XDMF_DSM_COMM_MPI;
   this->IsConnected = false;
   this->ResizeFactor = 1;
+  this->TransportType = XDMF_DSM_TRANSPORT_MESSAGE;
+  this->DataWindow = MPI_WIN_NULL;
+  this->NodeComm = MPI_COMM_NULL;
+  this->CompressionType = XDMF_DSM_COMPRESSION_NONE;
+  this->CompressionElementSize = 4;
+  this->CompressedBytes = 0;
+  this->UncompressedBytes = 0;
+  this->CompressionTime = 0;
+  this->ServiceThreads = 0;
+  this->ServicePool = NULL;
+  if (getenv("XDMF_DSM_SERVICE_THREADS")) {
+    this->ServiceThreads = std::max(atoi(getenv("XDMF_DSM_SERVICE_THREADS")), 0);
+  }
+  this->LockWaitTime = 0;
+  this->NotifyWaitTime = 0;
+  this->PageLookups = 0;
+  this->ServiceBusyTime = 0;
+  this->ServiceIdleTime = 0;
+  if (getenv("XDMF_DSM_STATISTICS_FILE")) {
+    this->StatisticsFileName = getenv("XDMF_DSM_STATISTICS_FILE");
+  }
 }
 
 XdmfDSMBuffer::~XdmfDSMBuffer()
 {
+  if (this->DataWindow != MPI_WIN_NULL) {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+      if (this->TransportType == XDMF_DSM_TRANSPORT_RMA && this->DataPointer) {
+        MPI_Win_detach(this->DataWindow, this->DataPointer);
+        for (unsigned int i = 0; i < this->Slabs.size(); ++i) {
+          MPI_Win_detach(this->DataWindow, this->Slabs[i]);
+        }
+      }
+      MPI_Win_free(&this->DataWindow);
+      if (this->NodeComm != MPI_COMM_NULL) {
+        MPI_Comm_free(&this->NodeComm);
+      }
+    }
+    // Shared memory is owned by its window and released with it
+    if (this->TransportType == XDMF_DSM_TRANSPORT_SHARED) {
+      this->DataPointer = NULL;
+    }
+  }
   if (this->DataPointer) {
     free(this->DataPointer);
   }
   this->DataPointer = NULL;
+  for (unsigned int i = 0; i < this->Slabs.size(); ++i) {
+    free(this->Slabs[i]);
+  }
+  this->Slabs.clear();
+  this->SlabAddresses.clear();
 }
 
 class XdmfDSMBuffer::CommandMsg
@@ -97,23 +323,258 @@ class XdmfDSMBuffer::CommandMsg
     int Opcode;
     int Source;
     int  Target;
-    int Address;
-    int Length;
+    long Address;
+    long Length;
 };
 
 class XdmfDSMBuffer::InfoMsg
 {
   public:
     int type;
-    unsigned int length;
-    unsigned int total_length;
-    unsigned int block_length;
+    long length;
+    long total_length;
+    long block_length;
     int start_server_id;
     int end_server_id;
 };
 
+class XdmfDSMBuffer::CompressionHeader
+{
+  public:
+    int Type;
+    int ElementSize;
+    long Length;
+};
+
+class XdmfDSMBuffer::DataSegment
+{
+  public:
+    int Server;
+    long Address;
+    long Length;
+    char * Data;
+};
+
+// Threads serving Put and Get requests for the service loop.
+// Each thread has its own queue so that the requests of a core
+// are served in the order they were sent.
+class XdmfDSMBuffer::ServiceThreadPool
+{
+  public:
+
+    class Request
+    {
+      public:
+        int Opcode;
+        int Source;
+        long Address;
+        long Length;
+    };
+
+    class Worker
+    {
+      public:
+        ServiceThreadPool * Pool;
+        pthread_t Thread;
+        std::queue<Request> Requests;
+    };
+
+    ServiceThreadPool(XdmfDSMBuffer * buffer, int numThreads) :
+      Buffer(buffer),
+      Workers(numThreads),
+      Pending(0),
+      Stopping(false),
+      PageLocks(XDMF_DSM_SERVICE_LOCKS)
+    {
+      pthread_mutex_init(&Mutex, NULL);
+      pthread_mutex_init(&CounterMutex, NULL);
+      pthread_cond_init(&WorkReady, NULL);
+      pthread_cond_init(&WorkDone, NULL);
+      for (unsigned int i = 0; i < PageLocks.size(); ++i) {
+        pthread_mutex_init(&PageLocks[i], NULL);
+      }
+      for (unsigned int i = 0; i < Workers.size(); ++i) {
+        Workers[i].Pool = this;
+        pthread_create(&Workers[i].Thread, NULL, Run, &Workers[i]);
+      }
+    }
+
+    ~ServiceThreadPool()
+    {
+      pthread_mutex_lock(&Mutex);
+      Stopping = true;
+      pthread_cond_broadcast(&WorkReady);
+      pthread_mutex_unlock(&Mutex);
+      for (unsigned int i = 0; i < Workers.size(); ++i) {
+        pthread_join(Workers[i].Thread, NULL);
+      }
+      for (unsigned int i = 0; i < PageLocks.size(); ++i) {
+        pthread_mutex_destroy(&PageLocks[i]);
+      }
+      pthread_cond_destroy(&WorkDone);
+      pthread_cond_destroy(&WorkReady);
+      pthread_mutex_destroy(&CounterMutex);
+      pthread_mutex_destroy(&Mutex);
+    }
+
+    void Enqueue(const Request & request)
+    {
+      pthread_mutex_lock(&Mutex);
+      Workers[request.Source % Workers.size()].Requests.push(request);
+      ++Pending;
+      pthread_cond_broadcast(&WorkReady);
+      pthread_mutex_unlock(&Mutex);
+    }
+
+    // Waits until every queued request has been served
+    void Drain()
+    {
+      pthread_mutex_lock(&Mutex);
+      while (Pending > 0) {
+        pthread_cond_wait(&WorkDone, &Mutex);
+      }
+      std::string error = Error;
+      Error.clear();
+      pthread_mutex_unlock(&Mutex);
+      if (error.size() > 0) {
+        XdmfError::message(XdmfError::FATAL, error);
+      }
+    }
+
+    bool HasError()
+    {
+      pthread_mutex_lock(&Mutex);
+      bool hasError = Error.size() > 0;
+      pthread_mutex_unlock(&Mutex);
+      return hasError;
+    }
+
+    static void * Run(void * workerPointer)
+    {
+      Worker * worker = (Worker *)workerPointer;
+      ServiceThreadPool * pool = worker->Pool;
+      pthread_mutex_lock(&pool->Mutex);
+      while (true) {
+        while (worker->Requests.empty() && !pool->Stopping) {
+          pthread_cond_wait(&pool->WorkReady, &pool->Mutex);
+        }
+        if (worker->Requests.empty()) {
+          break;
+        }
+        Request request = worker->Requests.front();
+        worker->Requests.pop();
+        pthread_mutex_unlock(&pool->Mutex);
+
+        double startTime = MPI_Wtime();
+        std::vector<unsigned int> locks = pool->LockPages(request.Address, request.Length);
+        std::string error;
+        try {
+          pool->Buffer->ServiceCommand(request.Opcode,
+                                       request.Source,
+                                       request.Address,
+                                       request.Length);
+        }
+        catch (XdmfError & e) {
+          error = e.what();
+        }
+        pool->UnlockPages(locks);
+        pool->Buffer->CountServiceTime(MPI_Wtime() - startTime, 0);
+
+        pthread_mutex_lock(&pool->Mutex);
+        if (error.size() > 0 && pool->Error.size() == 0) {
+          pool->Error = error;
+        }
+        if (--pool->Pending == 0) {
+          pthread_cond_broadcast(&pool->WorkDone);
+        }
+      }
+      pthread_mutex_unlock(&pool->Mutex);
+      return NULL;
+    }
+
+    // Locks are taken in increasing order so that requests
+    // covering several pages can not deadlock.
+    std::vector<unsigned int> LockPages(long address, long aLength)
+    {
+      std::vector<unsigned int> locks;
+      long firstPage = address / XDMF_DSM_ALIGNMENT;
+      long lastPage = (address + std::max(aLength, 1L) - 1) / XDMF_DSM_ALIGNMENT;
+      if (lastPage - firstPage + 1 >= (long)PageLocks.size()) {
+        for (unsigned int i = 0; i < PageLocks.size(); ++i) {
+          locks.push_back(i);
+        }
+      }
+      else {
+        for (long page = firstPage; page <= lastPage; ++page) {
+          locks.push_back(page % PageLocks.size());
+        }
+        std::sort(locks.begin(), locks.end());
+        locks.erase(std::unique(locks.begin(), locks.end()), locks.end());
+      }
+      for (unsigned int i = 0; i < locks.size(); ++i) {
+        pthread_mutex_lock(&PageLocks[locks[i]]);
+      }
+      return locks;
+    }
+
+    void UnlockPages(const std::vector<unsigned int> & locks)
+    {
+      for (unsigned int i = 0; i < locks.size(); ++i) {
+        pthread_mutex_unlock(&PageLocks[locks[i]]);
+      }
+    }
+
+    XdmfDSMBuffer * Buffer;
+    std::vector<Worker> Workers;
+    int Pending;
+    bool Stopping;
+    std::string Error;
+    pthread_mutex_t Mutex;
+    pthread_cond_t WorkReady;
+    pthread_cond_t WorkDone;
+    std::vector<pthread_mutex_t> PageLocks;
+    // Guards the compression and transfer statistics
+    pthread_mutex_t CounterMutex;
+};
+
+void
+XdmfDSMBuffer::AddSegment(std::vector<DataSegment> & segments,
+                          int server,
+                          long address,
+                          long aLength,
+                          char * data)
+{
+  if (segments.size() > 0) {
+    // Merge with the previous segment if it ends where this one starts,
+    // both in the server's buffer and in the local data.
+    DataSegment & previous = segments.back();
+    if (previous.Server == server &&
+        previous.Address + previous.Length == address &&
+        previous.Data + previous.Length == data) {
+      long merged = std::min(aLength,
+                             XDMF_DSM_MAX_MESSAGE_LENGTH - previous.Length);
+      previous.Length += merged;
+      address += merged;
+      aLength -= merged;
+      data += merged;
+    }
+  }
+  // Segments are split so that each fits in a single message
+  while (aLength > 0) {
+    DataSegment newSegment;
+    newSegment.Server = server;
+    newSegment.Address = address;
+    newSegment.Length = std::min(aLength, (long)XDMF_DSM_MAX_MESSAGE_LENGTH);
+    newSegment.Data = data;
+    segments.push_back(newSegment);
+    address += newSegment.Length;
+    aLength -= newSegment.Length;
+    data += newSegment.Length;
+  }
+}
+
 int
-XdmfDSMBuffer::AddressToId(int Address)
+XdmfDSMBuffer::AddressToId(long Address)
 {
   int   ServerId = XDMF_DSM_FAIL;
 
@@ -137,6 +598,11 @@ XdmfDSMBuffer::AddressToId(int Address)
         }
       }
       break;
+    case XDMF_DSM_TYPE_BLOCK_CYCLIC :
+    case XDMF_DSM_TYPE_BLOCK_RANDOM :
+      // Addresses are divided into blocks that are placed like pages
+      ServerId = this->PageToId(Address / this->BlockLength);
+      break;
     default :
       // Not Implemented
       try {
@@ -175,9 +641,8 @@ int
 XdmfDSMBuffer::BufferService(int *returnOpcode)
 {
   int        opcode, who;
-  int        aLength;
-  int          address;
-  char        *datap;
+  long       aLength;
+  long         address;
   static int syncId      = -1;
 
   if (this->CommChannel == XDMF_DSM_ANY_COMM) {
@@ -197,6 +662,7 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
     }
   }
 
+  double startTime = MPI_Wtime();
   try {
     this->ReceiveCommandHeader(&opcode,
                                &who,
@@ -208,6 +674,22 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
   catch (XdmfError & e) {
     throw e;
   }
+  double receiveTime = MPI_Wtime();
+
+  int status = this->ServiceCommand(opcode, who, address, aLength);
+
+  this->CountServiceTime(MPI_Wtime() - receiveTime, receiveTime - startTime);
+
+  if (returnOpcode) *returnOpcode = opcode;
+  return(status);
+}
+
+int
+XdmfDSMBuffer::ServiceCommand(int opcode, int who, long address, long aLength)
+{
+  char        *datap;
+  // Holds transfers that cross from one slab of the buffer into the next
+  std::vector<char> spanned;
 
   // Connection is an ID for client or server,
 //  int communicatorId = this->CommChannel;
@@ -216,7 +698,8 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
 
   // H5FD_DSM_OPCODE_PUT
   case XDMF_DSM_OPCODE_PUT:
-    if (((unsigned int) aLength + address) > this->Length) {
+  case XDMF_DSM_OPCODE_PUT_COMPRESSED:
+    if (aLength + address > this->Length) {
       try {
         std::stringstream message;
         message << "Length " << aLength << " too long for Address " << address 
@@ -237,23 +720,46 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
          throw e;
        }
     }
-    datap += address;
-    try {
-      this->ReceiveData(who,
-                        datap,
-                        aLength,
-                        XDMF_DSM_PUT_DATA_TAG,
-                        0,
-                        this->CommChannel);
+    // Transfers that cross slabs are staged, as are transfers into a
+    // buffer exposed through a window, which are copied under its lock
+    if ((datap = this->SlabPointer(address, aLength)) == NULL ||
+        this->DataWindow != MPI_WIN_NULL) {
+      spanned.resize(aLength);
+      datap = &spanned[0];
     }
-    catch (XdmfError & e) {
-      throw e;
+    this->CountTransfer(XDMF_DSM_OPCODE_PUT, who, aLength);
+    if (opcode == XDMF_DSM_OPCODE_PUT_COMPRESSED) {
+      // Compressed transfers always fit in one message
+      std::vector<char> compressed(this->CompressedBound(aLength));
+      this->Comm->Receive(&compressed[0],
+                          compressed.size(),
+                          who,
+                          this->CommChannel,
+                          XDMF_DSM_PUT_DATA_TAG);
+      this->Decompress(&compressed[0], datap, aLength);
+    }
+    else {
+      try {
+        this->ReceiveData(who,
+                          datap,
+                          aLength,
+                          XDMF_DSM_PUT_DATA_TAG,
+                          0,
+                          this->CommChannel);
+      }
+      catch (XdmfError & e) {
+        throw e;
+      }
+    }
+    if (spanned.size() > 0) {
+      this->LocalAccess(XDMF_DSM_OPCODE_PUT, address, aLength, datap);
     }
     break;
 
   // H5FD_DSM_OPCODE_GET
   case XDMF_DSM_OPCODE_GET:
-    if (((unsigned int) aLength + address) > this->Length) {
+  case XDMF_DSM_OPCODE_GET_COMPRESSED:
+    if (aLength + address > this->Length) {
       try {
         std::stringstream message;
         message << "Length " << aLength << " too long for Address " << address
@@ -274,7 +780,34 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
          throw e;
        }
     }
-    datap += address;
+    if ((datap = this->SlabPointer(address, aLength)) == NULL ||
+        this->DataWindow != MPI_WIN_NULL) {
+      spanned.resize(aLength);
+      datap = &spanned[0];
+      this->LocalAccess(XDMF_DSM_OPCODE_GET, address, aLength, datap);
+    }
+    this->CountTransfer(XDMF_DSM_OPCODE_GET, who, aLength);
+    if (opcode == XDMF_DSM_OPCODE_GET_COMPRESSED) {
+      // The requesting core sends the compression it wants
+      int requested;
+      this->ReceiveAcknowledgment(who,
+                                  requested,
+                                  XDMF_DSM_EXCHANGE_TAG,
+                                  this->CommChannel);
+      std::vector<char> compressed(this->CompressedBound(aLength));
+      long compressedLength = this->Compress(datap,
+                                             aLength,
+                                             &compressed[0],
+                                             requested >> 16,
+                                             requested & 0xFFFF);
+      this->SendData(who,
+                     &compressed[0],
+                     compressedLength,
+                     XDMF_DSM_GET_DATA_TAG,
+                     0,
+                     this->CommChannel);
+      break;
+    }
     try {
       this->SendData(who,
                      datap,
@@ -501,6 +1034,11 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
     }
 
     // If old description exists, overwrite it.
+    // Clients compare versions to know whether the file changed
+    if (FileDefinitions.count(std::string(newfile->name)) > 0)
+    {
+      newfile->version = FileDefinitions[std::string(newfile->name)]->version + 1;
+    }
 
     FileDefinitions[std::string(newfile->name)] = newfile;
 
@@ -544,22 +1082,24 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
       filedesc->pages = NULL;
     }
 
-    int datasize = 0;
+    haddr_t datasize = 0;
 
     // Request size required for the file
-    this->ReceiveAcknowledgment(who,
-                                datasize,
-                                XDMF_DSM_EXCHANGE_TAG,
-                                this->CommChannel);
+    this->ReceiveData(who,
+                      (char*)&datasize,
+                      sizeof(haddr_t),
+                      XDMF_DSM_EXCHANGE_TAG,
+                      0,
+                      this->CommChannel);
 
     // TODO Error handling block length must be greater than 0
     // If Block size = 0 then do nothing?
     // Then return blank data?
 
-    int requestedblocks = ((double)datasize) / this->BlockLength;
+    unsigned int requestedblocks = datasize / this->BlockLength;
 
     // Round up
-    if (requestedblocks * this->BlockLength != datasize)
+    if ((haddr_t)requestedblocks * this->BlockLength != datasize)
     {
       ++requestedblocks;
     }
@@ -635,11 +1175,13 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
                    this->CommChannel);
 
     // Notify the current size of the buffer
-    int currentLength = this->Length;
-    this->SendAcknowledgment(who,
-                             currentLength,
-                             XDMF_DSM_EXCHANGE_TAG,
-                             this->CommChannel);
+    long currentLength = this->Length;
+    this->SendData(who,
+                   (char*)&currentLength,
+                   sizeof(long),
+                   XDMF_DSM_EXCHANGE_TAG,
+                   0,
+                   this->CommChannel);
 
     break;
   }
@@ -703,6 +1245,11 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
                      XDMF_DSM_EXCHANGE_TAG,
                      0,
                      this->CommChannel);
+
+      this->SendAcknowledgment(who,
+                               filedesc->version,
+                               XDMF_DSM_EXCHANGE_TAG,
+                               this->CommChannel);
     }
     else
     {
@@ -811,6 +1358,54 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
 
     break;
   }
+  case XDMF_DSM_SET_TRANSPORT:
+  {
+    // The requested transport type is passed as the address
+    if (this->Comm->GetId() == 0)
+    {
+      // Send XDMF_DSM_SET_TRANSPORT to all server cores in order of increasing id
+      for (int i = this->GetStartServerId() + 1; // Since this is core 0 sending it
+           i <= this->GetEndServerId();
+           ++i) {
+        if (i != this->Comm->GetInterId())
+        {
+          this->SendCommandHeader(XDMF_DSM_SET_TRANSPORT, i, address, 0, XDMF_DSM_INTER_COMM);
+        }
+      }
+    }
+    // Window creation is collective with the non-server cores
+    this->UpdateDataWindow(address);
+    break;
+  }
+  case XDMF_DSM_REQUEST_WINDOW:
+  {
+    // Report where each region of this buffer is attached to the window
+    std::vector<long> addresses;
+    std::vector<MPI_Aint> bases;
+    this->WindowRegions(addresses, bases);
+
+    this->SendAcknowledgment(who,
+                             bases.size(),
+                             XDMF_DSM_EXCHANGE_TAG,
+                             this->CommChannel);
+
+    this->SendData(who,
+                   (char *)&addresses[0],
+                   addresses.size() * sizeof(long),
+                   XDMF_DSM_EXCHANGE_TAG,
+                   0,
+                   this->CommChannel);
+
+    if (bases.size() > 0) {
+      this->SendData(who,
+                     (char *)&bases[0],
+                     bases.size() * sizeof(MPI_Aint),
+                     XDMF_DSM_EXCHANGE_TAG,
+                     0,
+                     this->CommChannel);
+    }
+    break;
+  }
   case XDMF_DSM_LOCK_ACQUIRE:
     // Currently unsupported
     break;
@@ -838,7 +1433,6 @@ XdmfDSMBuffer::BufferService(int *returnOpcode)
     }
   }
 
-  if (returnOpcode) *returnOpcode = opcode;
   return(XDMF_DSM_SUCCESS);
 }
 
@@ -846,38 +1440,248 @@ void
 XdmfDSMBuffer::BufferServiceLoop(int *returnOpcode)
 {
   int op, status = XDMF_DSM_SUCCESS;
-  while (status == XDMF_DSM_SUCCESS) {
+  if (this->ServiceThreads > 0) {
+    int provided;
+    MPI_Query_thread(&provided);
+    if (provided != MPI_THREAD_MULTIPLE) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Error: DSM service threads require MPI_THREAD_MULTIPLE");
+    }
+    if (this->CommChannel == XDMF_DSM_ANY_COMM) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Error: DSM service threads require a single comm channel");
+    }
+    MPI_Comm serviceComm = this->Comm->GetInterComm();
+    if (this->CommChannel == XDMF_DSM_INTRA_COMM) {
+      serviceComm = this->Comm->GetIntraComm();
+    }
+    this->ServicePool = new ServiceThreadPool(this, this->ServiceThreads);
     try {
-      status = this->BufferService(&op);
+      double idleStart = MPI_Wtime();
+      unsigned int idlePolls = 0;
+      while (true) {
+        // Poll for the next command so that failed transfers are noticed
+        int found = 0;
+        MPI_Message message;
+        MPI_Status messageStatus;
+        MPI_Improbe(MPI_ANY_SOURCE, XDMF_DSM_COMMAND_TAG, serviceComm,
+                    &found, &message, &messageStatus);
+        if (!found) {
+          if (this->ServicePool->HasError()) {
+            this->ServicePool->Drain();
+          }
+          // Back off while idle, up to a millisecond between polls, so
+          // that an idle server does not keep its core busy
+          ++idlePolls;
+          if (idlePolls < XDMF_DSM_SERVICE_SPIN_POLLS) {
+            sched_yield();
+          }
+          else {
+#ifdef _WIN32
+            Sleep(1);
+#else
+            usleep(std::min((idlePolls - XDMF_DSM_SERVICE_SPIN_POLLS + 1) * 10, 1000u));
+#endif
+          }
+          continue;
+        }
+        idlePolls = 0;
+        double commandTime = MPI_Wtime();
+        this->CountServiceTime(0, commandTime - idleStart);
+        CommandMsg cmd;
+        MPI_Mrecv(&cmd, sizeof(CommandMsg), MPI_UNSIGNED_CHAR, &message, &messageStatus);
+        if (cmd.Opcode == XDMF_DSM_OPCODE_PUT ||
+            cmd.Opcode == XDMF_DSM_OPCODE_GET ||
+            cmd.Opcode == XDMF_DSM_OPCODE_PUT_COMPRESSED ||
+            cmd.Opcode == XDMF_DSM_OPCODE_GET_COMPRESSED) {
+          ServiceThreadPool::Request request;
+          request.Opcode = cmd.Opcode;
+          request.Source = cmd.Source;
+          request.Address = cmd.Address;
+          request.Length = cmd.Length;
+          this->ServicePool->Enqueue(request);
+          idleStart = MPI_Wtime();
+          continue;
+        }
+        // Everything else may depend on the transfers before it
+        this->ServicePool->Drain();
+        commandTime = MPI_Wtime();
+        this->ServiceCommand(cmd.Opcode, cmd.Source, cmd.Address, cmd.Length);
+        idleStart = MPI_Wtime();
+        this->CountServiceTime(idleStart - commandTime, 0);
+        if (returnOpcode) *returnOpcode = cmd.Opcode;
+        if (cmd.Opcode == XDMF_DSM_OPCODE_DONE) {
+          break;
+        }
+      }
     }
     catch (XdmfError & e) {
+      delete this->ServicePool;
+      this->ServicePool = NULL;
       throw e;
     }
-    if (returnOpcode) *returnOpcode = op;
-    if (op == XDMF_DSM_OPCODE_DONE) {
-      break;
-    }
+    delete this->ServicePool;
+    this->ServicePool = NULL;
   }
-}
-
-void
-XdmfDSMBuffer::Create(MPI_Comm newComm, int startId, int endId)
-{
-  //
-  // Create DSM communicator
-  //
-  switch (this->InterCommType) {
-    case XDMF_DSM_COMM_MPI:
-      this->Comm = new XdmfDSMCommMPI();
-      break;
-    default:
+  else {
+    while (status == XDMF_DSM_SUCCESS) {
       try {
-        XdmfError::message(XdmfError::FATAL, "DSM communication type not supported");
+        status = this->BufferService(&op);
       }
       catch (XdmfError & e) {
         throw e;
       }
-  }
+      if (returnOpcode) *returnOpcode = op;
+      if (op == XDMF_DSM_OPCODE_DONE) {
+        break;
+      }
+    }
+  }
+  if (this->StatisticsFileName.size() > 0) {
+    this->WriteStatistics(statisticsFileName(this->StatisticsFileName,
+                                             this->IsServer,
+                                             this->Comm->GetId()));
+  }
+}
+
+long
+XdmfDSMBuffer::Compress(char * data, long aLength, char * output, int type, int elementSize)
+{
+  double startTime = MPI_Wtime();
+  CompressionHeader header;
+  header.Type = type;
+  header.ElementSize = std::max(elementSize, 1);
+  header.Length = -1;
+  char * payload = output + sizeof(CompressionHeader);
+
+  std::vector<char> shuffled(aLength);
+  shuffleBytes(data, aLength, header.ElementSize, &shuffled[0]);
+  if (type == XDMF_DSM_COMPRESSION_SHUFFLE) {
+    header.Length = runLengthEncode((unsigned char *)&shuffled[0],
+                                    aLength,
+                                    (unsigned char *)payload,
+                                    aLength);
+  }
+#ifdef XDMF_DSM_HAVE_ZLIB
+  else if (type == XDMF_DSM_COMPRESSION_ZLIB) {
+    uLongf compressedLength = aLength;
+    if (compress2((Bytef *)payload,
+                  &compressedLength,
+                  (Bytef *)&shuffled[0],
+                  aLength,
+                  Z_BEST_SPEED) == Z_OK) {
+      header.Length = compressedLength;
+    }
+  }
+#endif
+  if (header.Length < 0 || header.Length >= aLength) {
+    // Not worth it, send the data as it is
+    header.Type = XDMF_DSM_COMPRESSION_NONE;
+    header.Length = aLength;
+    memcpy(payload, data, aLength);
+  }
+  memcpy(output, &header, sizeof(CompressionHeader));
+
+  if (this->ServicePool) {
+    pthread_mutex_lock(&this->ServicePool->CounterMutex);
+  }
+  this->UncompressedBytes += aLength;
+  this->CompressedBytes += sizeof(CompressionHeader) + header.Length;
+  this->CompressionTime += MPI_Wtime() - startTime;
+  if (this->ServicePool) {
+    pthread_mutex_unlock(&this->ServicePool->CounterMutex);
+  }
+  return sizeof(CompressionHeader) + header.Length;
+}
+
+long
+XdmfDSMBuffer::CompressedBound(long aLength)
+{
+  // Data that would grow is sent uncompressed
+  return sizeof(CompressionHeader) + aLength;
+}
+
+void
+XdmfDSMBuffer::CountServiceTime(double busyTime, double idleTime)
+{
+  if (this->ServicePool) {
+    pthread_mutex_lock(&this->ServicePool->CounterMutex);
+  }
+  this->ServiceBusyTime += busyTime;
+  this->ServiceIdleTime += idleTime;
+  if (this->ServicePool) {
+    pthread_mutex_unlock(&this->ServicePool->CounterMutex);
+  }
+}
+
+void
+XdmfDSMBuffer::CountTransfer(int opcode, int peer, long aLength)
+{
+  if (this->ServicePool) {
+    pthread_mutex_lock(&this->ServicePool->CounterMutex);
+  }
+  if (opcode == XDMF_DSM_OPCODE_PUT) {
+    this->BytesPut[peer] += aLength;
+  }
+  else {
+    this->BytesGot[peer] += aLength;
+  }
+  if (this->ServicePool) {
+    pthread_mutex_unlock(&this->ServicePool->CounterMutex);
+  }
+}
+
+void
+XdmfDSMBuffer::CopySlabs(int opcode, long address, long aLength, char * data)
+{
+  while (aLength > 0) {
+    // Find the slab holding the address, DataPointer holds
+    // everything before the first slab.
+    char * slab = this->DataPointer;
+    long slabAddress = 0;
+    long slabEnd = this->Length;
+    std::vector<long>::iterator next = std::upper_bound(this->SlabAddresses.begin(),
+                                                        this->SlabAddresses.end(),
+                                                        address);
+    if (next != this->SlabAddresses.begin()) {
+      unsigned int index = (next - this->SlabAddresses.begin()) - 1;
+      slab = this->Slabs[index];
+      slabAddress = this->SlabAddresses[index];
+    }
+    if (next != this->SlabAddresses.end()) {
+      slabEnd = *next;
+    }
+    long copyLength = std::min(aLength, slabEnd - address);
+    if (opcode == XDMF_DSM_OPCODE_PUT) {
+      memcpy(slab + (address - slabAddress), data, copyLength);
+    }
+    else {
+      memcpy(data, slab + (address - slabAddress), copyLength);
+    }
+    address += copyLength;
+    aLength -= copyLength;
+    data += copyLength;
+  }
+}
+
+void
+XdmfDSMBuffer::Create(MPI_Comm newComm, int startId, int endId)
+{
+  //
+  // Create DSM communicator
+  //
+  switch (this->InterCommType) {
+    case XDMF_DSM_COMM_MPI:
+      this->Comm = new XdmfDSMCommMPI();
+      break;
+    default:
+      try {
+        XdmfError::message(XdmfError::FATAL, "DSM communication type not supported");
+      }
+      catch (XdmfError & e) {
+        throw e;
+      }
+  }
 
   this->Comm->DupComm(newComm);
   this->Comm->Init();
@@ -1008,9 +1812,68 @@ XdmfDSMBuffer::Connect(bool persist)
   } while (persist && (status != MPI_SUCCESS));
 }
 
+void
+XdmfDSMBuffer::Decompress(char * data, char * output, long aLength)
+{
+  double startTime = MPI_Wtime();
+  CompressionHeader header;
+  memcpy(&header, data, sizeof(CompressionHeader));
+  char * payload = data + sizeof(CompressionHeader);
+
+  long decompressedLength = -1;
+  if (header.Type == XDMF_DSM_COMPRESSION_NONE) {
+    if (header.Length == aLength) {
+      memcpy(output, payload, aLength);
+      decompressedLength = aLength;
+    }
+  }
+  else {
+    std::vector<char> shuffled(aLength);
+    if (header.Type == XDMF_DSM_COMPRESSION_SHUFFLE) {
+      decompressedLength = runLengthDecode((unsigned char *)payload,
+                                           header.Length,
+                                           (unsigned char *)&shuffled[0],
+                                           aLength);
+    }
+#ifdef XDMF_DSM_HAVE_ZLIB
+    else if (header.Type == XDMF_DSM_COMPRESSION_ZLIB) {
+      uLongf uncompressedLength = aLength;
+      if (uncompress((Bytef *)&shuffled[0],
+                     &uncompressedLength,
+                     (Bytef *)payload,
+                     header.Length) == Z_OK) {
+        decompressedLength = uncompressedLength;
+      }
+    }
+#endif
+    if (decompressedLength == aLength) {
+      unshuffleBytes(&shuffled[0], aLength, header.ElementSize, output);
+    }
+  }
+  if (decompressedLength != aLength) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: Failed to decompress DSM transfer");
+  }
+
+  if (this->ServicePool) {
+    pthread_mutex_lock(&this->ServicePool->CounterMutex);
+  }
+  this->UncompressedBytes += aLength;
+  this->CompressedBytes += sizeof(CompressionHeader) + header.Length;
+  this->CompressionTime += MPI_Wtime() - startTime;
+  if (this->ServicePool) {
+    pthread_mutex_unlock(&this->ServicePool->CounterMutex);
+  }
+}
+
 void
 XdmfDSMBuffer::Disconnect()
 {
+  if (this->StatisticsFileName.size() > 0) {
+    this->WriteStatistics(statisticsFileName(this->StatisticsFileName,
+                                             this->IsServer,
+                                             this->Comm->GetId()));
+  }
   // Disconnecting is done manually
   try {
     this->GetComm()->Disconnect();
@@ -1024,9 +1887,10 @@ XdmfDSMBuffer::Disconnect()
 void
 XdmfDSMBuffer::Get(long Address, long aLength, void *Data)
 {
-  int   who, MyId = this->Comm->GetInterId();
-  int   astart, aend, len;
+  int   who;
+  long  astart, aend, len, localAddress;
   char   *datap = (char *)Data;
+  std::vector<DataSegment> segments;
 
   // While there is length left
   while(aLength) {
@@ -1040,44 +1904,31 @@ XdmfDSMBuffer::Get(long Address, long aLength, void *Data)
         throw e;
       }
     }
-    // Get the start and end of the block listed
-    this->GetAddressRangeForId(who, &astart, &aend);
-    // Determine the amount of data to be written to that core
-    // Basically, it's how much data will fit from
-    // the starting point of the address to the end
-    len = std::min(aLength, aend - Address + 1);
-    // If the data is on the core running this code, then the put is simple
-    if(who == MyId){
-      char *dp;
-      dp = this->DataPointer;
-      dp += Address - this->StartAddress;
-      memcpy(datap, dp, len);
-    }
-    else{
-      // Otherwise send it to the appropriate core to deal with
-      int   dataComm = XDMF_DSM_INTRA_COMM;
-      if (this->Comm->GetInterComm() != MPI_COMM_NULL) {
-        dataComm = XDMF_DSM_INTER_COMM;
-      }
-      try {
-        this->SendCommandHeader(XDMF_DSM_OPCODE_GET, who, Address - astart, len, dataComm);
-      }
-      catch (XdmfError & e) {
-        throw e;
-      }
-      try {
-        this->ReceiveData(who, datap, len, XDMF_DSM_GET_DATA_TAG, Address - astart, dataComm);
-      }
-      catch (XdmfError & e) {
-        throw e;
-      }
+    if (this->DsmType == XDMF_DSM_TYPE_BLOCK_CYCLIC ||
+        this->DsmType == XDMF_DSM_TYPE_BLOCK_RANDOM) {
+      // Only the rest of the block is contiguous on that core
+      len = std::min(aLength, (long)(this->BlockLength - Address % this->BlockLength));
+      localAddress = this->PageToAddress(Address / this->BlockLength) + Address % this->BlockLength;
     }
+    else {
+      // Get the start and end of the block listed
+      this->GetAddressRangeForId(who, &astart, &aend);
+      // Determine the amount of data to be written to that core
+      // Basically, it's how much data will fit from
+      // the starting point of the address to the end
+      len = std::min(aLength, aend - Address + 1);
+      localAddress = Address - astart;
+    }
+    this->AddSegment(segments, who, localAddress, len, datap);
     // Shift all the numbers by the length of the data written
     // Until aLength = 0
     aLength -= len;
     Address += len;
     datap += len;
   }
+
+  // Request every segment before waiting on any of them
+  this->TransferSegments(XDMF_DSM_OPCODE_GET, segments);
 }
 
 void
@@ -1093,7 +1944,9 @@ XdmfDSMBuffer::Get(unsigned int * pages, unsigned int numPages, long Address, lo
   long pointeroffset = 0;
 
   int serverCore;
-  int writeAddress;
+  long writeAddress;
+
+  std::vector<DataSegment> segments;
 
   while (aLength) {
     if (dataPage == 0) {
@@ -1110,10 +1963,10 @@ XdmfDSMBuffer::Get(unsigned int * pages, unsigned int numPages, long Address, lo
 
     currentStart = (char *)Data + pointeroffset;;
 
-    // Write page to DSM
+    // Read page from DSM
     // page to DSM server Id
     // page to address
-    // write to location
+    // read from location
 
     serverCore = PageToId(dsmPage);
     writeAddress = PageToAddress(dsmPage);
@@ -1133,41 +1986,8 @@ XdmfDSMBuffer::Get(unsigned int * pages, unsigned int numPages, long Address, lo
       writeAddress += startingAddress;
     }
 
-    // If the data is on the core running this code, then the put is simple
-    if(serverCore == this->Comm->GetInterId()){
-      char *dp;
-      dp = this->DataPointer;
-      dp += writeAddress;
-      memcpy(currentStart, dp, tranferedLength);
-    }
-    else{
-      // Otherwise send it to the appropriate core to deal with
-      int dataComm = XDMF_DSM_INTRA_COMM;
-      if (this->Comm->GetInterComm() != MPI_COMM_NULL) {
-        dataComm = XDMF_DSM_INTER_COMM;
-      }
-      try {
-        this->SendCommandHeader(XDMF_DSM_OPCODE_GET,
-                                serverCore,
-                                writeAddress,
-                                tranferedLength,
-                                dataComm);
-      }
-      catch (XdmfError & e) {
-        throw e;
-      }
-      try {
-        this->ReceiveData(serverCore,
-                          currentStart,
-                          tranferedLength,
-                          XDMF_DSM_GET_DATA_TAG,
-                          writeAddress,
-                          dataComm);
-      }
-      catch (XdmfError & e) {
-        throw e;
-      }
-    }
+    // Pages that follow each other on the same core are read together
+    this->AddSegment(segments, serverCore, writeAddress, tranferedLength, currentStart);
 
     aLength -= tranferedLength;
     pointeroffset += tranferedLength;
@@ -1175,10 +1995,13 @@ XdmfDSMBuffer::Get(unsigned int * pages, unsigned int numPages, long Address, lo
     ++currentPageId;
     ++dataPage;
   }
+
+  // Request every segment before waiting on any of them
+  this->TransferSegments(XDMF_DSM_OPCODE_GET, segments);
 }
 
 void
-XdmfDSMBuffer::GetAddressRangeForId(int Id, int *Start, int *End){
+XdmfDSMBuffer::GetAddressRangeForId(int Id, long *Start, long *End){
     switch(this->DsmType) {
       case XDMF_DSM_TYPE_UNIFORM :
       case XDMF_DSM_TYPE_UNIFORM_RANGE :
@@ -1213,12 +2036,48 @@ XdmfDSMBuffer::GetBlockLength()
   return this->BlockLength;
 }
 
+std::map<int, long>
+XdmfDSMBuffer::GetBytesGot()
+{
+  return this->BytesGot;
+}
+
+std::map<int, long>
+XdmfDSMBuffer::GetBytesPut()
+{
+  return this->BytesPut;
+}
+
 XdmfDSMCommMPI *
 XdmfDSMBuffer::GetComm()
 {
   return this->Comm;
 }
 
+long
+XdmfDSMBuffer::GetCompressedBytes()
+{
+  return this->CompressedBytes;
+}
+
+int
+XdmfDSMBuffer::GetCompressionElementSize()
+{
+  return this->CompressionElementSize;
+}
+
+double
+XdmfDSMBuffer::GetCompressionTime()
+{
+  return this->CompressionTime;
+}
+
+int
+XdmfDSMBuffer::GetCompressionType()
+{
+  return this->CompressionType;
+}
+
 char *
 XdmfDSMBuffer::GetDataPointer()
 {
@@ -1231,7 +2090,7 @@ XdmfDSMBuffer::GetDsmType()
   return this->DsmType;
 }
 
-int
+long
 XdmfDSMBuffer::GetEndAddress()
 {
   return this->EndAddress;
@@ -1277,13 +2136,49 @@ XdmfDSMBuffer::GetLocalBufferSizeMBytes()
   return this->LocalBufferSizeMBytes;
 }
 
+double
+XdmfDSMBuffer::GetLockWaitTime()
+{
+  return this->LockWaitTime;
+}
+
+double
+XdmfDSMBuffer::GetNotifyWaitTime()
+{
+  return this->NotifyWaitTime;
+}
+
+long
+XdmfDSMBuffer::GetPageLookups()
+{
+  return this->PageLookups;
+}
+
 double
 XdmfDSMBuffer::GetResizeFactor()
 {
   return this->ResizeFactor;
 }
 
+double
+XdmfDSMBuffer::GetServiceBusyTime()
+{
+  return this->ServiceBusyTime;
+}
+
+double
+XdmfDSMBuffer::GetServiceIdleTime()
+{
+  return this->ServiceIdleTime;
+}
+
 int
+XdmfDSMBuffer::GetServiceThreads()
+{
+  return this->ServiceThreads;
+}
+
+long
 XdmfDSMBuffer::GetStartAddress()
 {
   return this->StartAddress;
@@ -1295,12 +2190,30 @@ XdmfDSMBuffer::GetStartServerId()
   return this->StartServerId;
 }
 
+std::string
+XdmfDSMBuffer::GetStatisticsFileName()
+{
+  return this->StatisticsFileName;
+}
+
 long
 XdmfDSMBuffer::GetTotalLength()
 {
   return this->TotalLength;
 }
 
+int
+XdmfDSMBuffer::GetTransportType()
+{
+  return this->TransportType;
+}
+
+long
+XdmfDSMBuffer::GetUncompressedBytes()
+{
+  return this->UncompressedBytes;
+}
+
 void
 XdmfDSMBuffer::Lock(char * filename)
 {
@@ -1326,6 +2239,8 @@ XdmfDSMBuffer::Lock(char * filename)
 
   int isLocked = 0;
 
+  double startTime = MPI_Wtime();
+
   this->ReceiveAcknowledgment(this->GetStartServerId(),
                               isLocked,
                               XDMF_DSM_EXCHANGE_TAG,
@@ -1339,6 +2254,8 @@ XdmfDSMBuffer::Lock(char * filename)
                             XDMF_DSM_EXCHANGE_TAG,
                             XDMF_DSM_INTER_COMM);
   }
+
+  this->LockWaitTime += MPI_Wtime() - startTime;
 }
 
 int
@@ -1346,19 +2263,40 @@ XdmfDSMBuffer::PageToId(int pageId)
 {
   int   ServerId = XDMF_DSM_FAIL;
 
+  ++this->PageLookups;
+
   switch(this->DsmType) {
     case XDMF_DSM_TYPE_BLOCK_CYCLIC :
-    case XDMF_DSM_TYPE_BLOCK_RANDOM :
     {
       // Block based allocation should use PageToId
       // All Servers have same length
-      // This finds out which server the address provided starts on
-      int serversize = (this->EndServerId - this->StartServerId);
+      // Pages are dealt out to the servers in turn
+      int serversize = (this->EndServerId - this->StartServerId) + 1;
+      if (serversize < 1)
+      {
+        serversize = 1;
+      }
+      ServerId = pageId % serversize;
+      ServerId += this->StartServerId; // Apply the offset of the server if required.
+      break;
+    }
+    case XDMF_DSM_TYPE_BLOCK_RANDOM :
+    {
+      // Each round of pages places one page on every server,
+      // the order of the servers is shuffled for every round.
+      int serversize = (this->EndServerId - this->StartServerId) + 1;
       if (serversize < 1)
       {
         serversize = 1;
       }
-      ServerId = pageId % serversize;// This should only be called by the server
+      unsigned int hash = hashPageRound(pageId / serversize);
+      // Any multiplier coprime with the number of servers
+      // maps a round onto every server exactly once.
+      unsigned int multiplier = 1 + (hash >> 16) % serversize;
+      while (greatestCommonDivisor(multiplier, serversize) != 1) {
+        ++multiplier;
+      }
+      ServerId = (multiplier * (pageId % serversize) + hash % serversize) % serversize;
       ServerId += this->StartServerId; // Apply the offset of the server if required.
       break;
     }
@@ -1377,10 +2315,60 @@ XdmfDSMBuffer::PageToId(int pageId)
     return(ServerId);
 }
 
-int
+void
+XdmfDSMBuffer::LocalAccess(int opcode, long address, long aLength, char * data)
+{
+  if (this->DataWindow == MPI_WIN_NULL) {
+    this->CopySlabs(opcode, address, aLength, data);
+    return;
+  }
+  // Cores accessing this buffer through the window lock it, take the
+  // same locks on this core's own window rank
+  int windowRank = this->Comm->GetInterId();
+  if (this->TransportType == XDMF_DSM_TRANSPORT_SHARED) {
+    windowRank = this->SharedRanks[windowRank];
+  }
+  int lockType = MPI_LOCK_SHARED;
+  if (opcode == XDMF_DSM_OPCODE_PUT) {
+    lockType = MPI_LOCK_EXCLUSIVE;
+  }
+  int status = MPI_Win_lock(lockType, windowRank, 0, this->DataWindow);
+  if (status == MPI_SUCCESS) {
+    this->CopySlabs(opcode, address, aLength, data);
+    status = MPI_Win_unlock(windowRank, this->DataWindow);
+  }
+  if (status != MPI_SUCCESS) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: Failed to lock the local DSM buffer");
+  }
+}
+
+void
+XdmfDSMBuffer::MergeSlabs()
+{
+  if (this->Slabs.size() == 0) {
+    return;
+  }
+  char * merged = allocateAligned(this->Length);
+  if (merged == NULL) {
+    std::stringstream message;
+    message << "Allocation Failed, unable to allocate " << this->Length;
+    XdmfError::message(XdmfError::FATAL, message.str());
+  }
+  this->CopySlabs(XDMF_DSM_OPCODE_GET, 0, this->Length, merged);
+  free(this->DataPointer);
+  for (unsigned int i = 0; i < this->Slabs.size(); ++i) {
+    free(this->Slabs[i]);
+  }
+  this->Slabs.clear();
+  this->SlabAddresses.clear();
+  this->DataPointer = merged;
+}
+
+long
 XdmfDSMBuffer::PageToAddress(int pageId)
 {
-  int   resultAddress = XDMF_DSM_FAIL;
+  long  resultAddress = XDMF_DSM_FAIL;
 
   switch(this->DsmType) {
     case XDMF_DSM_TYPE_BLOCK_CYCLIC :
@@ -1388,9 +2376,9 @@ XdmfDSMBuffer::PageToAddress(int pageId)
     {
       // Block based allocation should use PageToId
       // All Servers have same length
-      // This finds out which server the address provided starts on
+      // Each round of pages uses the next block on every server
       // Since this is integers being divided the result is truncated.
-      int serversize = (this->EndServerId - this->StartServerId);
+      int serversize = (this->EndServerId - this->StartServerId) + 1;
       if (serversize < 1)
       {
         serversize = 1;
@@ -1469,9 +2457,10 @@ XdmfDSMBuffer::ProbeCommandHeader(int *comm)
 void
 XdmfDSMBuffer::Put(long Address, long aLength, const void *Data)
 {
-  int   who, MyId = this->Comm->GetInterId();
-  int   astart, aend, len;
+  int   who;
+  long  astart, aend, len, localAddress;
   char    *datap = (char *)Data;
+  std::vector<DataSegment> segments;
 
   // While there is length left
   while(aLength){
@@ -1485,53 +2474,31 @@ XdmfDSMBuffer::Put(long Address, long aLength, const void *Data)
         throw e;
       }
     }
-    // Get the start and end of the block listed
-    this->GetAddressRangeForId(who, &astart, &aend);
-    // Determine the amount of data to be written to that core
-    // Basically, it's how much data will fit from the starting point of
-    // the address to the end
-    len = std::min(aLength, aend - Address + 1);
-    // If the data is on the core running this code, then the put is simple
-    if(who == MyId){
-      char *dp;
-      dp = this->DataPointer;
-      dp += Address - this->StartAddress;
-      memcpy(dp, datap, len);
-    }
-    else{
-      // Otherwise send it to the appropriate core to deal with
-      int   dataComm = XDMF_DSM_INTRA_COMM;
-      if (this->Comm->GetInterComm() != MPI_COMM_NULL) {
-        dataComm = XDMF_DSM_INTER_COMM;
-      }
-      try {
-        this->SendCommandHeader(XDMF_DSM_OPCODE_PUT,
-                                who,
-                                Address - astart,
-                                len,
-                                dataComm);
-      }
-      catch (XdmfError & e) {
-        throw e;
-      }
-      try {
-        this->SendData(who,
-                       datap, 
-                       len,
-                       XDMF_DSM_PUT_DATA_TAG,
-                       Address - astart,
-                       dataComm);
-      }
-      catch (XdmfError & e) {
-        throw e;
-      }
+    if (this->DsmType == XDMF_DSM_TYPE_BLOCK_CYCLIC ||
+        this->DsmType == XDMF_DSM_TYPE_BLOCK_RANDOM) {
+      // Only the rest of the block is contiguous on that core
+      len = std::min(aLength, (long)(this->BlockLength - Address % this->BlockLength));
+      localAddress = this->PageToAddress(Address / this->BlockLength) + Address % this->BlockLength;
     }
+    else {
+      // Get the start and end of the block listed
+      this->GetAddressRangeForId(who, &astart, &aend);
+      // Determine the amount of data to be written to that core
+      // Basically, it's how much data will fit from the starting point of
+      // the address to the end
+      len = std::min(aLength, aend - Address + 1);
+      localAddress = Address - astart;
+    }
+    this->AddSegment(segments, who, localAddress, len, datap);
     // Shift all the numbers by the length of the data written
     // Until aLength = 0
     aLength -= len;
     Address += len;
     datap += len;
   }
+
+  // Send every segment before waiting on any of them
+  this->TransferSegments(XDMF_DSM_OPCODE_PUT, segments);
 }
 
 void
@@ -1549,7 +2516,9 @@ XdmfDSMBuffer::Put(unsigned int * pages, unsigned int numPages, haddr_t Address,
   unsigned int dataPage = 0;
 
   int serverCore = 0;
-  int writeAddress = 0;
+  long writeAddress = 0;
+
+  std::vector<DataSegment> segments;
 
   while (aLength) {
     if (dataPage == 0) {
@@ -1586,41 +2555,8 @@ XdmfDSMBuffer::Put(unsigned int * pages, unsigned int numPages, haddr_t Address,
       writeAddress += startingAddress;
     }
 
-    // If the data is on the core running this code, then the put is simple
-    if(serverCore == this->Comm->GetInterId()) {
-      char *dp;
-      dp = this->DataPointer;
-      dp += writeAddress;
-      memcpy(dp, currentStart, tranferedLength);
-    }
-    else{
-      // Otherwise send it to the appropriate core to deal with
-      int dataComm = XDMF_DSM_INTRA_COMM;
-      if (this->Comm->GetInterComm() != MPI_COMM_NULL) {
-        dataComm = XDMF_DSM_INTER_COMM;
-      }
-      try {
-        this->SendCommandHeader(XDMF_DSM_OPCODE_PUT,
-                                serverCore,
-                                writeAddress,
-                                tranferedLength,
-                                dataComm);
-      }
-      catch (XdmfError & e) {
-        throw e;
-      }
-      try {
-        this->SendData(serverCore,
-                       currentStart,
-                       tranferedLength,
-                       XDMF_DSM_PUT_DATA_TAG,
-                       writeAddress,
-                       dataComm);
-      }
-      catch (XdmfError & e) {
-        throw e;
-      }
-    }
+    // Pages that follow each other on the same core are written together
+    this->AddSegment(segments, serverCore, writeAddress, tranferedLength, currentStart);
 
     aLength -= tranferedLength;
     pointeroffset += tranferedLength;
@@ -1628,6 +2564,9 @@ XdmfDSMBuffer::Put(unsigned int * pages, unsigned int numPages, haddr_t Address,
     ++currentPageId;
     ++dataPage;
   }
+
+  // Send every segment before waiting on any of them
+  this->TransferSegments(XDMF_DSM_OPCODE_PUT, segments);
 }
 
 void
@@ -1654,7 +2593,7 @@ XdmfDSMBuffer::ReceiveAcknowledgment(int source, int &data, int tag, int comm)
 }
 
 void
-XdmfDSMBuffer::ReceiveCommandHeader(int *opcode, int *source, int *address, int *aLength, int comm, int remoteSource)
+XdmfDSMBuffer::ReceiveCommandHeader(int *opcode, int *source, long *address, long *aLength, int comm, int remoteSource)
 {
   CommandMsg cmd;
   memset(&cmd, 0, sizeof(CommandMsg));
@@ -1690,15 +2629,21 @@ XdmfDSMBuffer::ReceiveCommandHeader(int *opcode, int *source, int *address, int
 }
 
 void
-XdmfDSMBuffer::ReceiveData(int source, char * data, int aLength, int tag, int aAddress, int comm)
+XdmfDSMBuffer::ReceiveData(int source, char * data, long aLength, int tag, long aAddress, int comm)
 {
   int status;
   MPI_Status signalStatus;
-  this->Comm->Receive(data,
-                      aLength,
-                      source,
-                      comm,
-                      tag);
+  // Received in the same pieces as SendData sends them
+  do {
+    long messageLength = std::min(aLength, (long)XDMF_DSM_MAX_MESSAGE_LENGTH);
+    this->Comm->Receive(data,
+                        messageLength,
+                        source,
+                        comm,
+                        tag);
+    data += messageLength;
+    aLength -= messageLength;
+  } while (aLength > 0);
   status = MPI_SUCCESS;
   if (status != MPI_SUCCESS) {
     try {
@@ -1844,10 +2789,28 @@ XdmfDSMBuffer::ReceiveInfo()
   this->Comm->SetDsmProcessStructure(newStructure);
 }
 
-int
-XdmfDSMBuffer::RegisterFile(char * name, unsigned int * pages, unsigned int numPages, haddr_t start, haddr_t end)
+void
+XdmfDSMBuffer::ResetStatistics()
 {
-  this->SendCommandHeader(XDMF_DSM_REGISTER_FILE,
+  this->BytesPut.clear();
+  this->BytesGot.clear();
+  this->LockWaitTime = 0;
+  this->NotifyWaitTime = 0;
+  this->PageLookups = 0;
+  this->ServiceBusyTime = 0;
+  this->ServiceIdleTime = 0;
+  this->CompressedBytes = 0;
+  this->UncompressedBytes = 0;
+  this->CompressionTime = 0;
+  if (this->Comm) {
+    this->Comm->ResetStatistics();
+  }
+}
+
+int
+XdmfDSMBuffer::RegisterFile(char * name, unsigned int * pages, unsigned int numPages, haddr_t start, haddr_t end)
+{
+  this->SendCommandHeader(XDMF_DSM_REGISTER_FILE,
                           this->GetStartServerId(),
                           0,
                           0,
@@ -1900,7 +2863,7 @@ XdmfDSMBuffer::RegisterFile(char * name, unsigned int * pages, unsigned int numP
 }
 
 int
-XdmfDSMBuffer::RequestFileDescription(char * name, std::vector<unsigned int> & pages, unsigned int & numPages, haddr_t & start, haddr_t & end)
+XdmfDSMBuffer::RequestFileDescription(char * name, std::vector<unsigned int> & pages, unsigned int & numPages, haddr_t & start, haddr_t & end, unsigned int * version)
 {
   this->SendCommandHeader(XDMF_DSM_REQUEST_FILE,
                           this->GetStartServerId(),
@@ -1971,6 +2934,18 @@ XdmfDSMBuffer::RequestFileDescription(char * name, std::vector<unsigned int> & p
       pages.push_back(pagelist[i]);
     }
 
+    int fileVersion = 0;
+
+    this->ReceiveAcknowledgment(this->GetStartServerId(),
+                                fileVersion,
+                                XDMF_DSM_EXCHANGE_TAG,
+                                XDMF_DSM_INTER_COMM);
+
+    if (version != NULL)
+    {
+      *version = fileVersion;
+    }
+
     return XDMF_DSM_SUCCESS;
   }
   else
@@ -2010,10 +2985,12 @@ XdmfDSMBuffer::RequestPages(char * name,
                  XDMF_DSM_INTER_COMM);
 
   // Request size required for the file
-  this->SendAcknowledgment(this->GetStartServerId(),
-                           spaceRequired,
-                           XDMF_DSM_EXCHANGE_TAG,
-                           XDMF_DSM_INTER_COMM);
+  this->SendData(this->GetStartServerId(),
+                 (char*)&spaceRequired,
+                 sizeof(haddr_t),
+                 XDMF_DSM_EXCHANGE_TAG,
+                 0,
+                 XDMF_DSM_INTER_COMM);
 
   // Send back new page allocation pointer
 
@@ -2057,13 +3034,52 @@ XdmfDSMBuffer::RequestPages(char * name,
                     XDMF_DSM_INTER_COMM);
 
   // If resized, set up the reset the total length.
-  int currentLength = 0;
-  this->ReceiveAcknowledgment(this->GetStartServerId(),
-                              currentLength,
+  long currentLength = 0;
+  this->ReceiveData(this->GetStartServerId(),
+                    (char*)&currentLength,
+                    sizeof(long),
+                    XDMF_DSM_EXCHANGE_TAG,
+                    0,
+                    XDMF_DSM_INTER_COMM);
+
+  this->UpdateLength(currentLength);
+}
+
+void
+XdmfDSMBuffer::RequestWindowRegions(int server)
+{
+  this->SendCommandHeader(XDMF_DSM_REQUEST_WINDOW,
+                          server,
+                          0,
+                          0,
+                          XDMF_DSM_INTER_COMM);
+
+  int numRegions = 0;
+  this->ReceiveAcknowledgment(server,
+                              numRegions,
                               XDMF_DSM_EXCHANGE_TAG,
                               XDMF_DSM_INTER_COMM);
 
-  this->UpdateLength(currentLength);
+  std::vector<long> & addresses = this->WindowAddresses[server];
+  std::vector<MPI_Aint> & bases = this->WindowBases[server];
+  addresses.resize(numRegions + 1);
+  bases.resize(numRegions);
+
+  this->ReceiveData(server,
+                    (char *)&addresses[0],
+                    addresses.size() * sizeof(long),
+                    XDMF_DSM_EXCHANGE_TAG,
+                    0,
+                    XDMF_DSM_INTER_COMM);
+
+  if (numRegions > 0) {
+    this->ReceiveData(server,
+                      (char *)&bases[0],
+                      bases.size() * sizeof(MPI_Aint),
+                      XDMF_DSM_EXCHANGE_TAG,
+                      0,
+                      XDMF_DSM_INTER_COMM);
+  }
 }
 
 void
@@ -2102,7 +3118,7 @@ XdmfDSMBuffer::SendAcknowledgment(int dest, int data, int tag, int comm)
 }
 
 void
-XdmfDSMBuffer::SendCommandHeader(int opcode, int dest, int address, int aLength, int comm)
+XdmfDSMBuffer::SendCommandHeader(int opcode, int dest, long address, long aLength, int comm)
 {
   int status;
   CommandMsg cmd;
@@ -2135,15 +3151,21 @@ XdmfDSMBuffer::SendCommandHeader(int opcode, int dest, int address, int aLength,
 }
 
 void
-XdmfDSMBuffer::SendData(int dest, char * data, int aLength, int tag, int aAddress, int comm)
+XdmfDSMBuffer::SendData(int dest, char * data, long aLength, int tag, long aAddress, int comm)
 {
   int status;
 
-  this->Comm->Send(data,
-                   aLength,
-                   dest,
-                   comm,
-                   tag);
+  // Large buffers are sent in pieces that fit in an MPI count
+  do {
+    long messageLength = std::min(aLength, (long)XDMF_DSM_MAX_MESSAGE_LENGTH);
+    this->Comm->Send(data,
+                     messageLength,
+                     dest,
+                     comm,
+                     tag);
+    data += messageLength;
+    aLength -= messageLength;
+  } while (aLength > 0);
   status = MPI_SUCCESS;
   if (status != MPI_SUCCESS) {
     try {
@@ -2325,6 +3347,36 @@ XdmfDSMBuffer::SetComm(XdmfDSMCommMPI * newComm)
   this->Comm = newComm;
 }
 
+void
+XdmfDSMBuffer::SetCompressionElementSize(int newSize)
+{
+  if (newSize < 1 || newSize > 0xFFFF) {
+    std::stringstream message;
+    message << "Error: Invalid DSM compression element size " << newSize;
+    XdmfError::message(XdmfError::FATAL, message.str());
+  }
+  this->CompressionElementSize = newSize;
+}
+
+void
+XdmfDSMBuffer::SetCompressionType(int newType)
+{
+  if (newType != XDMF_DSM_COMPRESSION_NONE &&
+      newType != XDMF_DSM_COMPRESSION_SHUFFLE &&
+      newType != XDMF_DSM_COMPRESSION_ZLIB) {
+    std::stringstream message;
+    message << "Error: Unknown DSM compression type " << newType;
+    XdmfError::message(XdmfError::FATAL, message.str());
+  }
+#ifndef XDMF_DSM_HAVE_ZLIB
+  if (newType == XDMF_DSM_COMPRESSION_ZLIB) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: XdmfDSM was built without zlib compression");
+  }
+#endif
+  this->CompressionType = newType;
+}
+
 void
 XdmfDSMBuffer::SetDsmType(int newDsmType)
 {
@@ -2362,29 +3414,74 @@ XdmfDSMBuffer::SetResizeFactor(double newFactor)
   }
 }
 
+void
+XdmfDSMBuffer::SetServiceThreads(int newThreads)
+{
+  if (newThreads < 0) {
+    std::stringstream message;
+    message << "Error: Invalid number of DSM service threads " << newThreads;
+    XdmfError::message(XdmfError::FATAL, message.str());
+  }
+  if (this->ServicePool) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: DSM service threads can not change while serving");
+  }
+  this->ServiceThreads = newThreads;
+}
+
+void
+XdmfDSMBuffer::SetStatisticsFileName(std::string newName)
+{
+  this->StatisticsFileName = newName;
+}
+
 void
 XdmfDSMBuffer::SetLength(long aLength)
 {
-  this->Length = aLength;
+  // Memory added or removed is attached to or detached from the
+  // dynamic window of the RMA transport. The shared window keeps the
+  // memory it was allocated with, slabs past it stay private.
+  bool attach = this->DataWindow != MPI_WIN_NULL &&
+                this->TransportType == XDMF_DSM_TRANSPORT_RMA;
   if (this->DataPointer) {
-    // Try to reallocate
-    // This should not be called in most cases
-    this->DataPointer =
-      static_cast<char *>(realloc(this->DataPointer, this->Length*sizeof(char)));
+    // Drop the slabs that are no longer needed
+    while (this->SlabAddresses.size() > 0 &&
+           this->SlabAddresses.back() >= aLength) {
+      if (attach) {
+        MPI_Win_detach(this->DataWindow, this->Slabs.back());
+      }
+      free(this->Slabs.back());
+      this->Slabs.pop_back();
+      this->SlabAddresses.pop_back();
+    }
+    if (aLength > this->Length) {
+      // Grow by adding a slab after the end of the buffer,
+      // the data already stored never moves.
+      char * slab = allocateAligned(aLength - this->Length);
+      if (slab == NULL) {
+        std::stringstream message;
+        message << "Allocation Failed, unable to grow buffer to " << aLength;
+        XdmfError::message(XdmfError::FATAL, message.str());
+      }
+      if (attach &&
+          MPI_Win_attach(this->DataWindow, slab, aLength - this->Length) != MPI_SUCCESS) {
+        free(slab);
+        XdmfError::message(XdmfError::FATAL,
+                           "Error: Failed to attach buffer to RMA window");
+      }
+      this->Slabs.push_back(slab);
+      this->SlabAddresses.push_back(this->Length);
+    }
+    this->Length = aLength;
   }
   else {
-#ifdef _WIN32
-    this->DataPointer = calloc(this->Length, sizeof(char));
-#else
-  #ifdef _SC_PAGESIZE
-    posix_memalign((void **)(&this->DataPointer), sysconf(_SC_PAGESIZE), this->Length);
-    memset(this->DataPointer, 0, this->Length);
-  #else
-    // Older linux variation, for backwards compatibility
-    posix_memalign((void **)(&this->DataPointer), getpagesize(), this->Length);
-    memset(this->DataPointer, 0, this->Length);
-  #endif
-#endif
+    this->Length = aLength;
+    this->DataPointer = allocateAligned(this->Length);
+    if (attach && this->DataPointer &&
+        MPI_Win_attach(this->DataWindow, this->DataPointer, this->Length) != MPI_SUCCESS) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Error: Failed to attach buffer to RMA window");
+    }
   }
 
   if (this->DataPointer == NULL) {
@@ -2405,6 +3502,74 @@ XdmfDSMBuffer::SetLocalBufferSizeMBytes(unsigned int newSize)
   this->LocalBufferSizeMBytes = newSize;
 }
 
+void
+XdmfDSMBuffer::SetTransportType(int newType)
+{
+  if (newType != XDMF_DSM_TRANSPORT_MESSAGE &&
+      newType != XDMF_DSM_TRANSPORT_RMA &&
+      newType != XDMF_DSM_TRANSPORT_SHARED) {
+    std::stringstream message;
+    message << "Error: Unknown DSM transport type " << newType;
+    XdmfError::message(XdmfError::FATAL, message.str());
+  }
+  if (newType == this->TransportType) {
+    return;
+  }
+  if (!this->IsServer && this->Comm->GetId() == 0) {
+    // Server cores are waiting in the service loop,
+    // have them join in creating or freeing the window.
+    this->SendCommandHeader(XDMF_DSM_SET_TRANSPORT,
+                            this->GetStartServerId(),
+                            newType,
+                            0,
+                            XDMF_DSM_INTER_COMM);
+  }
+  this->UpdateDataWindow(newType);
+}
+
+void
+XdmfDSMBuffer::SharedAccess(int opcode, int server, char * data, long aLength, long aAddress)
+{
+  // Same locking as the RMA transport, reads may overlap
+  // while writes are applied one at a time.
+  int nodeRank = this->SharedRanks[server];
+  int lockType = MPI_LOCK_SHARED;
+  if (opcode == XDMF_DSM_OPCODE_PUT) {
+    lockType = MPI_LOCK_EXCLUSIVE;
+  }
+  int status = MPI_Win_lock(lockType, nodeRank, 0, this->DataWindow);
+  if (status == MPI_SUCCESS) {
+    char * serverData = this->SharedPointers[server] + aAddress;
+    if (opcode == XDMF_DSM_OPCODE_PUT) {
+      memcpy(serverData, data, aLength);
+    }
+    else {
+      memcpy(data, serverData, aLength);
+    }
+    status = MPI_Win_unlock(nodeRank, this->DataWindow);
+  }
+  if (status != MPI_SUCCESS) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: Failed to access shared server buffer");
+  }
+}
+
+char *
+XdmfDSMBuffer::SlabPointer(long address, long aLength)
+{
+  std::vector<long>::iterator next = std::upper_bound(this->SlabAddresses.begin(),
+                                                      this->SlabAddresses.end(),
+                                                      address);
+  if (next != this->SlabAddresses.end() && address + aLength > *next) {
+    return NULL;
+  }
+  if (next == this->SlabAddresses.begin()) {
+    return this->DataPointer + address;
+  }
+  unsigned int index = (next - this->SlabAddresses.begin()) - 1;
+  return this->Slabs[index] + (address - this->SlabAddresses[index]);
+}
+
 void
 XdmfDSMBuffer::Unlock(char * filename)
 {
@@ -2429,15 +3594,350 @@ XdmfDSMBuffer::Unlock(char * filename)
 }
 
 void
-XdmfDSMBuffer::UpdateLength(unsigned int newLength)
+XdmfDSMBuffer::TransferSegments(int opcode, std::vector<DataSegment> & segments)
+{
+  int MyId = this->Comm->GetInterId();
+  int dataComm = XDMF_DSM_INTRA_COMM;
+  if (this->Comm->GetInterComm() != MPI_COMM_NULL) {
+    dataComm = XDMF_DSM_INTER_COMM;
+  }
+  bool hasWindow = this->DataWindow != MPI_WIN_NULL &&
+                   dataComm == XDMF_DSM_INTER_COMM;
+  bool useWindow = hasWindow &&
+                   this->TransportType == XDMF_DSM_TRANSPORT_RMA;
+  bool useShared = hasWindow &&
+                   this->TransportType == XDMF_DSM_TRANSPORT_SHARED;
+
+  // Servers that grew since the shared window was allocated hold the
+  // rest of their buffer in private memory, split segments reaching
+  // past their shared memory so that only the rest is sent.
+  std::vector<bool> shared(segments.size(), false);
+  if (useShared) {
+    for (unsigned int i = 0; i < segments.size(); ++i) {
+      DataSegment segment = segments[i];
+      if (this->SharedPointers[segment.Server] == NULL) {
+        continue;
+      }
+      long sharedLength = this->SharedLengths[segment.Server];
+      if (segment.Address + segment.Length > sharedLength &&
+          segment.Address < sharedLength) {
+        segments[i].Length = sharedLength - segment.Address;
+        DataSegment rest = segment;
+        rest.Address = sharedLength;
+        rest.Length = segment.Length - segments[i].Length;
+        rest.Data = segment.Data + segments[i].Length;
+        segments.push_back(rest);
+        shared.push_back(false);
+      }
+      shared[i] = segments[i].Address + segments[i].Length <= sharedLength;
+    }
+  }
+
+  for (unsigned int i = 0; i < segments.size(); ++i) {
+    this->CountTransfer(opcode, segments[i].Server, segments[i].Length);
+  }
+
+  std::vector<MPI_Request> requests;
+  requests.reserve(segments.size());
+
+  // Segments sent through the service loop are compressed when they
+  // are long enough and still fit in a single message.
+  std::vector<std::vector<char> > compressed(segments.size());
+  if (this->CompressionType != XDMF_DSM_COMPRESSION_NONE && !useWindow) {
+    for (unsigned int i = 0; i < segments.size(); ++i) {
+      if (segments[i].Server != MyId &&
+          !shared[i] &&
+          segments[i].Length >= XDMF_DSM_COMPRESSION_MIN_LENGTH &&
+          this->CompressedBound(segments[i].Length) <= XDMF_DSM_MAX_MESSAGE_LENGTH) {
+        compressed[i].resize(this->CompressedBound(segments[i].Length));
+      }
+    }
+  }
+
+  if (opcode == XDMF_DSM_OPCODE_GET && !useWindow) {
+    // Post the receives first so that data from every server
+    // can arrive as soon as it is sent.
+    for (unsigned int i = 0; i < segments.size(); ++i) {
+      if (compressed[i].size() > 0) {
+        requests.push_back(MPI_REQUEST_NULL);
+        this->Comm->IReceive(&compressed[i][0],
+                             compressed[i].size(),
+                             segments[i].Server,
+                             dataComm,
+                             XDMF_DSM_GET_DATA_TAG,
+                             &requests.back());
+      }
+      else if (segments[i].Server != MyId && !shared[i]) {
+        requests.push_back(MPI_REQUEST_NULL);
+        this->Comm->IReceive(segments[i].Data,
+                             segments[i].Length,
+                             segments[i].Server,
+                             dataComm,
+                             XDMF_DSM_GET_DATA_TAG,
+                             &requests.back());
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < segments.size(); ++i) {
+    DataSegment & segment = segments[i];
+    // If the data is on the core running this code, copy it under the
+    // lock other cores take on its window
+    if (segment.Server == MyId) {
+      this->LocalAccess(opcode, segment.Address, segment.Length, segment.Data);
+    }
+    else if (shared[i]) {
+      // The server is on the same node, copy to or from its memory
+      this->SharedAccess(opcode, segment.Server, segment.Data, segment.Length, segment.Address);
+    }
+    else if (useWindow) {
+      // Access the server's buffer directly
+      this->WindowAccess(opcode, segment.Server, segment.Data, segment.Length, segment.Address);
+    }
+    else if (compressed[i].size() > 0) {
+      // Compressed transfers carry their own opcodes
+      if (opcode == XDMF_DSM_OPCODE_PUT) {
+        this->SendCommandHeader(XDMF_DSM_OPCODE_PUT_COMPRESSED,
+                                segment.Server,
+                                segment.Address,
+                                segment.Length,
+                                dataComm);
+        long compressedLength = this->Compress(segment.Data,
+                                               segment.Length,
+                                               &compressed[i][0],
+                                               this->CompressionType,
+                                               this->CompressionElementSize);
+        requests.push_back(MPI_REQUEST_NULL);
+        this->Comm->ISend(&compressed[i][0],
+                          compressedLength,
+                          segment.Server,
+                          dataComm,
+                          XDMF_DSM_PUT_DATA_TAG,
+                          &requests.back());
+      }
+      else {
+        this->SendCommandHeader(XDMF_DSM_OPCODE_GET_COMPRESSED,
+                                segment.Server,
+                                segment.Address,
+                                segment.Length,
+                                dataComm);
+        this->SendAcknowledgment(segment.Server,
+                                 (this->CompressionType << 16) | this->CompressionElementSize,
+                                 XDMF_DSM_EXCHANGE_TAG,
+                                 dataComm);
+      }
+    }
+    else {
+      // Otherwise send it to the appropriate core to deal with
+      try {
+        this->SendCommandHeader(opcode,
+                                segment.Server,
+                                segment.Address,
+                                segment.Length,
+                                dataComm);
+      }
+      catch (XdmfError & e) {
+        throw e;
+      }
+      if (opcode == XDMF_DSM_OPCODE_PUT) {
+        requests.push_back(MPI_REQUEST_NULL);
+        this->Comm->ISend(segment.Data,
+                          segment.Length,
+                          segment.Server,
+                          dataComm,
+                          XDMF_DSM_PUT_DATA_TAG,
+                          &requests.back());
+      }
+    }
+  }
+
+  if (requests.size() > 0) {
+    std::vector<MPI_Status> statuses(requests.size());
+    if (MPI_Waitall(requests.size(), &requests[0], &statuses[0]) != MPI_SUCCESS) {
+      XdmfError::message(XdmfError::FATAL, "Error: Failed to complete data transfer");
+    }
+    if (opcode == XDMF_DSM_OPCODE_GET) {
+      // Every request of a get is a receive
+      for (unsigned int i = 0; i < statuses.size(); ++i) {
+        this->Comm->CountReceive(&statuses[i]);
+      }
+    }
+  }
+
+  if (opcode == XDMF_DSM_OPCODE_GET) {
+    for (unsigned int i = 0; i < segments.size(); ++i) {
+      if (compressed[i].size() > 0) {
+        this->Decompress(&compressed[i][0], segments[i].Data, segments[i].Length);
+      }
+    }
+  }
+}
+
+void
+XdmfDSMBuffer::UpdateDataWindow(int newType)
+{
+  if (newType == this->TransportType) {
+    return;
+  }
+  MPI_Comm windowComm = this->Comm->GetInterComm();
+  if (windowComm == MPI_COMM_NULL) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: RMA and shared transports require a "
+                       "connection to the DSM");
+  }
+  int status;
+  if (this->DataWindow != MPI_WIN_NULL) {
+    MPI_Win oldWindow = this->DataWindow;
+    this->DataWindow = MPI_WIN_NULL;
+    if (this->TransportType == XDMF_DSM_TRANSPORT_SHARED) {
+      // Move the buffer back to private memory before
+      // the shared memory is released along with the window.
+      if (this->IsServer && this->DataPointer) {
+        long sharedLength = this->Length;
+        if (this->SlabAddresses.size() > 0) {
+          sharedLength = this->SlabAddresses[0];
+        }
+        char * privatePointer = allocateAligned(sharedLength);
+        if (privatePointer == NULL) {
+          std::stringstream message;
+          message << "Allocation Failed, unable to allocate " << sharedLength;
+          XdmfError::message(XdmfError::FATAL, message.str());
+        }
+        memcpy(privatePointer, this->DataPointer, sharedLength);
+        this->DataPointer = privatePointer;
+      }
+      MPI_Comm_free(&this->NodeComm);
+      this->SharedRanks.clear();
+      this->SharedPointers.clear();
+      this->SharedLengths.clear();
+    }
+    else if (this->DataPointer) {
+      MPI_Win_detach(oldWindow, this->DataPointer);
+      for (unsigned int i = 0; i < this->Slabs.size(); ++i) {
+        MPI_Win_detach(oldWindow, this->Slabs[i]);
+      }
+    }
+    this->WindowAddresses.clear();
+    this->WindowBases.clear();
+    status = MPI_Win_free(&oldWindow);
+    if (status != MPI_SUCCESS) {
+      XdmfError::message(XdmfError::FATAL, "Error: Failed to free RMA window");
+    }
+  }
+  if (newType == XDMF_DSM_TRANSPORT_SHARED && this->IsServer) {
+    // Shared windows expose a single allocation
+    this->MergeSlabs();
+  }
+  if (newType == XDMF_DSM_TRANSPORT_RMA) {
+    // Only server cores attach memory, other cores take part in the
+    // creation. Memory added later is attached as the buffer grows.
+    status = MPI_Win_create_dynamic(MPI_INFO_NULL,
+                                    windowComm,
+                                    &this->DataWindow);
+    if (status == MPI_SUCCESS && this->IsServer && this->DataPointer) {
+      std::vector<long> addresses;
+      std::vector<MPI_Aint> bases;
+      this->WindowRegions(addresses, bases);
+      status = MPI_Win_attach(this->DataWindow,
+                              this->DataPointer,
+                              addresses[1] - addresses[0]);
+      for (unsigned int i = 0; i < this->Slabs.size() && status == MPI_SUCCESS; ++i) {
+        status = MPI_Win_attach(this->DataWindow,
+                                this->Slabs[i],
+                                addresses[i + 2] - addresses[i + 1]);
+      }
+    }
+    if (status != MPI_SUCCESS) {
+      XdmfError::message(XdmfError::FATAL, "Error: Failed to create RMA window");
+    }
+  }
+  else if (newType == XDMF_DSM_TRANSPORT_SHARED) {
+    // Group the cores that can share memory with each other
+    status = MPI_Comm_split_type(windowComm,
+                                 MPI_COMM_TYPE_SHARED,
+                                 0,
+                                 MPI_INFO_NULL,
+                                 &this->NodeComm);
+    if (status != MPI_SUCCESS) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Error: Failed to split the DSM by node");
+    }
+    // Server cores move their buffer into shared memory,
+    // other cores take part with an empty allocation.
+    MPI_Aint windowSize = 0;
+    if (this->IsServer && this->DataPointer) {
+      windowSize = this->Length;
+    }
+    char * sharedPointer = NULL;
+    status = MPI_Win_allocate_shared(windowSize,
+                                     sizeof(char),
+                                     MPI_INFO_NULL,
+                                     this->NodeComm,
+                                     &sharedPointer,
+                                     &this->DataWindow);
+    if (status != MPI_SUCCESS) {
+      XdmfError::message(XdmfError::FATAL,
+                         "Error: Failed to allocate shared window");
+    }
+    if (windowSize > 0) {
+      memcpy(sharedPointer, this->DataPointer, this->Length);
+      free(this->DataPointer);
+      this->DataPointer = sharedPointer;
+    }
+    // No core may access the shared buffers until every
+    // server core has finished moving its data into them.
+    MPI_Barrier(windowComm);
+
+    // Find the buffers of the server cores on this node
+    int interSize = this->Comm->GetInterSize();
+    std::vector<int> interRanks(interSize);
+    for (int i = 0; i < interSize; ++i) {
+      interRanks[i] = i;
+    }
+    this->SharedRanks.assign(interSize, MPI_UNDEFINED);
+    this->SharedPointers.assign(interSize, (char *)NULL);
+    this->SharedLengths.assign(interSize, 0);
+    MPI_Group interGroup, nodeGroup;
+    MPI_Comm_group(windowComm, &interGroup);
+    MPI_Comm_group(this->NodeComm, &nodeGroup);
+    MPI_Group_translate_ranks(interGroup,
+                              interSize,
+                              &interRanks[0],
+                              nodeGroup,
+                              &this->SharedRanks[0]);
+    MPI_Group_free(&interGroup);
+    MPI_Group_free(&nodeGroup);
+    for (int i = this->StartServerId; i <= this->EndServerId; ++i) {
+      if (this->SharedRanks[i] != MPI_UNDEFINED) {
+        MPI_Aint sharedSize;
+        int displacementUnit;
+        char * sharedBase;
+        MPI_Win_shared_query(this->DataWindow,
+                             this->SharedRanks[i],
+                             &sharedSize,
+                             &displacementUnit,
+                             &sharedBase);
+        if (sharedSize > 0) {
+          this->SharedPointers[i] = sharedBase;
+          this->SharedLengths[i] = sharedSize;
+        }
+      }
+    }
+  }
+  this->TransportType = newType;
+}
+
+void
+XdmfDSMBuffer::UpdateLength(long newLength)
 {
   this->Length = newLength;
-  this->TotalLength = this->Length * (this->EndServerId - this->StartServerId);
+  this->TotalLength = this->Length * (this->EndServerId - this->StartServerId + 1);
 }
 
 void
 XdmfDSMBuffer::WaitRelease(std::string filename, std::string datasetname, int code)
 {
+  double startTime = MPI_Wtime();
   // Send Command Header
   this->SendCommandHeader(XDMF_DSM_CLEAR_NOTIFY,
                           this->GetStartServerId(),
@@ -2472,11 +3972,104 @@ XdmfDSMBuffer::WaitRelease(std::string filename, std::string datasetname, int co
                            code,
                            XDMF_DSM_EXCHANGE_TAG,
                            XDMF_DSM_INTER_COMM);
+  this->NotifyWaitTime += MPI_Wtime() - startTime;
+}
+
+void
+XdmfDSMBuffer::WindowAccess(int opcode, int server, char * data, long aLength, long aAddress)
+{
+  std::vector<long> & addresses = this->WindowAddresses[server];
+  if (addresses.size() == 0 || aAddress + aLength > addresses.back()) {
+    // The server may have grown since it last reported its regions
+    this->RequestWindowRegions(server);
+  }
+  if (aAddress + aLength > addresses.back()) {
+    std::stringstream message;
+    message << "Length " << aLength << " too long for Address " << aAddress
+            << " in RMA window of server " << server;
+    XdmfError::message(XdmfError::FATAL, message.str());
+  }
+  std::vector<MPI_Aint> & bases = this->WindowBases[server];
+
+  // Shared lock for gets, any number of cores may read at once.
+  // Exclusive lock for puts, writes are applied one at a time
+  // the same as when handled by the service loop.
+  int lockType = MPI_LOCK_SHARED;
+  if (opcode == XDMF_DSM_OPCODE_PUT) {
+    lockType = MPI_LOCK_EXCLUSIVE;
+  }
+  int status = MPI_Win_lock(lockType, server, 0, this->DataWindow);
+  unsigned int region = std::upper_bound(addresses.begin(),
+                                         addresses.end(),
+                                         aAddress) - addresses.begin() - 1;
+  long transferred = 0;
+  while (transferred < aLength && status == MPI_SUCCESS) {
+    // Each transfer stays within a region and the length of a message
+    long address = aAddress + transferred;
+    while (addresses[region + 1] <= address) {
+      ++region;
+    }
+    long count = std::min(aLength - transferred, addresses[region + 1] - address);
+    count = std::min(count, (long)XDMF_DSM_MAX_MESSAGE_LENGTH);
+    MPI_Aint displacement = bases[region] + (address - addresses[region]);
+    if (opcode == XDMF_DSM_OPCODE_PUT) {
+      status = MPI_Put(data + transferred,
+                       count,
+                       MPI_UNSIGNED_CHAR,
+                       server,
+                       displacement,
+                       count,
+                       MPI_UNSIGNED_CHAR,
+                       this->DataWindow);
+    }
+    else {
+      status = MPI_Get(data + transferred,
+                       count,
+                       MPI_UNSIGNED_CHAR,
+                       server,
+                       displacement,
+                       count,
+                       MPI_UNSIGNED_CHAR,
+                       this->DataWindow);
+    }
+    transferred += count;
+  }
+  if (status == MPI_SUCCESS) {
+    status = MPI_Win_unlock(server, this->DataWindow);
+  }
+  if (status != MPI_SUCCESS) {
+    if (opcode == XDMF_DSM_OPCODE_PUT) {
+      XdmfError::message(XdmfError::FATAL, "Error: Failed to put data through RMA window");
+    }
+    else {
+      XdmfError::message(XdmfError::FATAL, "Error: Failed to get data through RMA window");
+    }
+  }
+}
+
+void
+XdmfDSMBuffer::WindowRegions(std::vector<long> & addresses, std::vector<MPI_Aint> & bases)
+{
+  addresses.clear();
+  bases.clear();
+  if (this->DataPointer) {
+    MPI_Aint base;
+    MPI_Get_address(this->DataPointer, &base);
+    addresses.push_back(0);
+    bases.push_back(base);
+    for (unsigned int i = 0; i < this->Slabs.size(); ++i) {
+      MPI_Get_address(this->Slabs[i], &base);
+      addresses.push_back(this->SlabAddresses[i]);
+      bases.push_back(base);
+    }
+  }
+  addresses.push_back(this->Length);
 }
 
 int
 XdmfDSMBuffer::WaitOn(std::string filename, std::string datasetname)
 {
+  double startTime = MPI_Wtime();
   // Send Command Header
   this->SendCommandHeader(XDMF_DSM_SET_NOTIFY,
                           this->GetStartServerId(),
@@ -2513,10 +4106,79 @@ XdmfDSMBuffer::WaitOn(std::string filename, std::string datasetname)
                               XDMF_DSM_EXCHANGE_TAG,
                               this->CommChannel);
   delete sendPointer;
+  this->NotifyWaitTime += MPI_Wtime() - startTime;
   // Return Code from Notification
   return code;
 }
 
+void
+XdmfDSMBuffer::WriteStatistics(std::string filename)
+{
+  std::ofstream output(filename.c_str());
+  if (!output) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Error: Unable to open DSM statistics file " + filename);
+  }
+
+  // Every peer that data went to or came from
+  std::map<int, long>::iterator iter;
+  std::vector<int> peers;
+  for (iter = this->BytesPut.begin(); iter != this->BytesPut.end(); ++iter) {
+    peers.push_back(iter->first);
+  }
+  for (iter = this->BytesGot.begin(); iter != this->BytesGot.end(); ++iter) {
+    if (this->BytesPut.find(iter->first) == this->BytesPut.end()) {
+      peers.push_back(iter->first);
+    }
+  }
+  std::sort(peers.begin(), peers.end());
+
+  std::vector<std::pair<std::string, double> > values;
+  values.push_back(std::make_pair("id", (double)this->Comm->GetId()));
+  values.push_back(std::make_pair("server", (double)this->IsServer));
+  values.push_back(std::make_pair("messages_sent", (double)this->Comm->GetMessagesSent()));
+  values.push_back(std::make_pair("messages_received", (double)this->Comm->GetMessagesReceived()));
+  values.push_back(std::make_pair("bytes_sent", (double)this->Comm->GetBytesSent()));
+  values.push_back(std::make_pair("bytes_received", (double)this->Comm->GetBytesReceived()));
+  values.push_back(std::make_pair("lock_wait_time", this->LockWaitTime));
+  values.push_back(std::make_pair("notify_wait_time", this->NotifyWaitTime));
+  values.push_back(std::make_pair("service_busy_time", this->ServiceBusyTime));
+  values.push_back(std::make_pair("service_idle_time", this->ServiceIdleTime));
+  values.push_back(std::make_pair("page_lookups", (double)this->PageLookups));
+  values.push_back(std::make_pair("compressed_bytes", (double)this->CompressedBytes));
+  values.push_back(std::make_pair("uncompressed_bytes", (double)this->UncompressedBytes));
+  values.push_back(std::make_pair("compression_time", this->CompressionTime));
+
+  output.precision(12);
+  bool isCSV = filename.size() >= 4 &&
+               filename.compare(filename.size() - 4, 4, ".csv") == 0;
+  if (isCSV) {
+    output << "statistic,peer,value\n";
+    for (unsigned int i = 0; i < values.size(); ++i) {
+      output << values[i].first << ",," << values[i].second << "\n";
+    }
+    for (unsigned int i = 0; i < peers.size(); ++i) {
+      output << "bytes_put," << peers[i] << "," << this->BytesPut[peers[i]] << "\n";
+      output << "bytes_got," << peers[i] << "," << this->BytesGot[peers[i]] << "\n";
+    }
+  }
+  else {
+    output << "{\n";
+    for (unsigned int i = 0; i < values.size(); ++i) {
+      output << "  \"" << values[i].first << "\": " << values[i].second << ",\n";
+    }
+    output << "  \"peers\": [";
+    for (unsigned int i = 0; i < peers.size(); ++i) {
+      output << (i == 0 ? "\n" : ",\n")
+             << "    {\"peer\": " << peers[i]
+             << ", \"bytes_put\": " << this->BytesPut[peers[i]]
+             << ", \"bytes_got\": " << this->BytesGot[peers[i]] << "}";
+    }
+    output << (peers.size() > 0 ? "\n  ]\n" : "]\n");
+    output << "}\n";
+  }
+}
+
 // C Wrappers
 
 XDMFDSMBUFFER * XdmfDSMBufferNew()
@@ -2603,7 +4265,7 @@ void XdmfDSMBufferGet(XDMFDSMBUFFER * buffer, long Address, long aLength, void *
   XDMF_ERROR_WRAP_END(status)
 }
 
-void XdmfDSMBufferGetAddressRangeForId(XDMFDSMBUFFER * buffer, int Id, int * Start, int * End, int * status)
+void XdmfDSMBufferGetAddressRangeForId(XDMFDSMBUFFER * buffer, int Id, long * Start, long * End, int * status)
 {
   XDMF_ERROR_WRAP_START(status)
   ((XdmfDSMBuffer *)buffer)->GetAddressRangeForId(Id, Start, End);
@@ -2634,6 +4296,26 @@ XDMFDSMCOMMMPI * XdmfDSMBufferGetComm(XDMFDSMBUFFER * buffer)
   }
 }
 
+long XdmfDSMBufferGetCompressedBytes(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetCompressedBytes();
+}
+
+int XdmfDSMBufferGetCompressionElementSize(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetCompressionElementSize();
+}
+
+double XdmfDSMBufferGetCompressionTime(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetCompressionTime();
+}
+
+int XdmfDSMBufferGetCompressionType(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetCompressionType();
+}
+
 char * XdmfDSMBufferGetDataPointer(XDMFDSMBUFFER * buffer)
 {
   try
@@ -2658,7 +4340,7 @@ int XdmfDSMBufferGetDsmType(XDMFDSMBUFFER * buffer)
   }
 }
 
-int XdmfDSMBufferGetEndAddress(XDMFDSMBUFFER * buffer)
+long XdmfDSMBufferGetEndAddress(XDMFDSMBUFFER * buffer)
 {
   try
   {
@@ -2742,6 +4424,21 @@ unsigned int XdmfDSMBufferGetLocalBufferSizeMBytes(XDMFDSMBUFFER * buffer)
   }
 }
 
+double XdmfDSMBufferGetLockWaitTime(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetLockWaitTime();
+}
+
+double XdmfDSMBufferGetNotifyWaitTime(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetNotifyWaitTime();
+}
+
+long XdmfDSMBufferGetPageLookups(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetPageLookups();
+}
+
 double XdmfDSMBufferGetResizeFactor(XDMFDSMBUFFER * buffer)
 {
   try
@@ -2754,7 +4451,22 @@ double XdmfDSMBufferGetResizeFactor(XDMFDSMBUFFER * buffer)
   }
 }
 
-int XdmfDSMBufferGetStartAddress(XDMFDSMBUFFER * buffer)
+double XdmfDSMBufferGetServiceBusyTime(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetServiceBusyTime();
+}
+
+double XdmfDSMBufferGetServiceIdleTime(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetServiceIdleTime();
+}
+
+int XdmfDSMBufferGetServiceThreads(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetServiceThreads();
+}
+
+long XdmfDSMBufferGetStartAddress(XDMFDSMBUFFER * buffer)
 {
   try
   {
@@ -2766,6 +4478,12 @@ int XdmfDSMBufferGetStartAddress(XDMFDSMBUFFER * buffer)
   }
 }
 
+char * XdmfDSMBufferGetStatisticsFileName(XDMFDSMBUFFER * buffer)
+{
+  char * returnPointer = strdup(((XdmfDSMBuffer *)buffer)->GetStatisticsFileName().c_str());
+  return returnPointer;
+}
+
 int XdmfDSMBufferGetStartServerId(XDMFDSMBUFFER * buffer)
 {
   try
@@ -2790,6 +4508,23 @@ long XdmfDSMBufferGetTotalLength(XDMFDSMBUFFER * buffer)
   }
 }
 
+int XdmfDSMBufferGetTransportType(XDMFDSMBUFFER * buffer)
+{
+  try
+  {
+    return ((XdmfDSMBuffer *)buffer)->GetTransportType();
+  }
+  catch (...)
+  {
+    return ((XdmfDSMBuffer *)buffer)->GetTransportType();
+  }
+}
+
+long XdmfDSMBufferGetUncompressedBytes(XDMFDSMBUFFER * buffer)
+{
+  return ((XdmfDSMBuffer *)buffer)->GetUncompressedBytes();
+}
+
 void XdmfDSMBufferProbeCommandHeader(XDMFDSMBUFFER * buffer, int * comm, int * status)
 {
   XDMF_ERROR_WRAP_START(status)
@@ -2819,8 +4554,8 @@ void XdmfDSMBufferReceiveAcknowledgment(XDMFDSMBUFFER * buffer,
 void XdmfDSMBufferReceiveCommandHeader(XDMFDSMBUFFER * buffer,
                                        int * opcode,
                                        int * source,
-                                       int * address,
-                                       int * aLength,
+                                       long * address,
+                                       long * aLength,
                                        int comm,
                                        int remoteSource,
                                        int * status)
@@ -2833,9 +4568,9 @@ void XdmfDSMBufferReceiveCommandHeader(XDMFDSMBUFFER * buffer,
 void XdmfDSMBufferReceiveData(XDMFDSMBUFFER * buffer,
                               int source,
                               char * data,
-                              int aLength,
+                              long aLength,
                               int tag,
-                              int aAddress,
+                              long aAddress,
                               int comm,
                               int * status)
 {
@@ -2851,6 +4586,11 @@ void XdmfDSMBufferReceiveInfo(XDMFDSMBUFFER * buffer, int * status)
   XDMF_ERROR_WRAP_END(status)
 }
 
+void XdmfDSMBufferResetStatistics(XDMFDSMBUFFER * buffer)
+{
+  ((XdmfDSMBuffer *)buffer)->ResetStatistics();
+}
+
 void XdmfDSMBufferSendAccept(XDMFDSMBUFFER * buffer, unsigned int numConnects)
 {
   ((XdmfDSMBuffer *)buffer)->SendAccept(numConnects);
@@ -2871,8 +4611,8 @@ void XdmfDSMBufferSendAcknowledgment(XDMFDSMBUFFER * buffer,
 void XdmfDSMBufferSendCommandHeader(XDMFDSMBUFFER * buffer,
                                     int opcode,
                                     int dest,
-                                    int address,
-                                    int aLength,
+                                    long address,
+                                    long aLength,
                                     int comm,
                                     int * status)
 {
@@ -2884,9 +4624,9 @@ void XdmfDSMBufferSendCommandHeader(XDMFDSMBUFFER * buffer,
 void XdmfDSMBufferSendData(XDMFDSMBUFFER * buffer,
                            int dest,
                            char * data,
-                           int aLength,
+                           long aLength,
                            int tag,
-                           int aAddress,
+                           long aAddress,
                            int comm,
                            int * status)
 {
@@ -2933,6 +4673,20 @@ void XdmfDSMBufferSetComm(XDMFDSMBUFFER * buffer, XDMFDSMCOMMMPI * newComm)
   }
 }
 
+void XdmfDSMBufferSetCompressionElementSize(XDMFDSMBUFFER * buffer, int newSize, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  ((XdmfDSMBuffer *)buffer)->SetCompressionElementSize(newSize);
+  XDMF_ERROR_WRAP_END(status)
+}
+
+void XdmfDSMBufferSetCompressionType(XDMFDSMBUFFER * buffer, int newType, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  ((XdmfDSMBuffer *)buffer)->SetCompressionType(newType);
+  XDMF_ERROR_WRAP_END(status)
+}
+
 void XdmfDSMBufferSetDsmType(XDMFDSMBUFFER * buffer, int newDsmType)
 {
   try
@@ -3005,6 +4759,25 @@ void XdmfDSMBufferSetResizeFactor(XDMFDSMBUFFER * buffer, double newFactor)
   }
 }
 
+void XdmfDSMBufferSetServiceThreads(XDMFDSMBUFFER * buffer, int newThreads, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  ((XdmfDSMBuffer *)buffer)->SetServiceThreads(newThreads);
+  XDMF_ERROR_WRAP_END(status)
+}
+
+void XdmfDSMBufferSetStatisticsFileName(XDMFDSMBUFFER * buffer, char * newName)
+{
+  ((XdmfDSMBuffer *)buffer)->SetStatisticsFileName(std::string(newName));
+}
+
+void XdmfDSMBufferSetTransportType(XDMFDSMBUFFER * buffer, int newType, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  ((XdmfDSMBuffer *)buffer)->SetTransportType(newType);
+  XDMF_ERROR_WRAP_END(status)
+}
+
 void XdmfDSMBufferWaitRelease(XDMFDSMBUFFER * buffer, char * filename, char * datasetname, int code)
 {
   try
@@ -3028,3 +4801,10 @@ int XdmfDSMBufferWaitOn(XDMFDSMBUFFER * buffer, char * filename, char * datasetn
     return ((XdmfDSMBuffer *)buffer)->WaitOn(std::string(filename), std::string(datasetname));
   }
 }
+
+void XdmfDSMBufferWriteStatistics(XDMFDSMBUFFER * buffer, char * filename, int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  ((XdmfDSMBuffer *)buffer)->WriteStatistics(std::string(filename));
+  XDMF_ERROR_WRAP_END(status)
+}
@@ -86,9 +86,26 @@
 #define XDMF_DSM_TYPE_BLOCK_CYCLIC  3
 #define XDMF_DSM_TYPE_BLOCK_RANDOM  4
 
+#define XDMF_DSM_TRANSPORT_MESSAGE  0
+#define XDMF_DSM_TRANSPORT_RMA      1
+#define XDMF_DSM_TRANSPORT_SHARED   2
+
+#define XDMF_DSM_COMPRESSION_NONE    0
+#define XDMF_DSM_COMPRESSION_SHUFFLE 1
+#define XDMF_DSM_COMPRESSION_ZLIB    2
+
+// Transfers shorter than this are sent as they are
+#define XDMF_DSM_COMPRESSION_MIN_LENGTH 4096
+
 #define XDMF_DSM_DEFAULT_LENGTH 10000
 #define XDMF_DSM_DEFAULT_BLOCK_LENGTH 1024
 #define XDMF_DSM_ALIGNMENT 4096
+// Largest single message, MPI counts are limited to int
+#define XDMF_DSM_MAX_MESSAGE_LENGTH 1073741824
+
+// Number of locks guarding the pages of a server buffer
+// when the service loop runs with threads
+#define XDMF_DSM_SERVICE_LOCKS 64
 
 #define XDMF_DSM_OPCODE_PUT          0x01
 #define XDMF_DSM_OPCODE_GET          0x02
@@ -111,6 +128,13 @@
 #define XDMF_DSM_REQUEST_ACCESS      0x16
 #define XDMF_DSM_UNLOCK_FILE         0x17
 
+#define XDMF_DSM_SET_TRANSPORT       0x18
+
+#define XDMF_DSM_OPCODE_PUT_COMPRESSED 0x19
+#define XDMF_DSM_OPCODE_GET_COMPRESSED 0x1A
+
+#define XDMF_DSM_REQUEST_WINDOW      0x1B
+
 #define XDMF_DSM_OPCODE_DONE         0xFF
 
 #define XDMF_DSM_SUCCESS  1
@@ -242,6 +266,14 @@ public:
    * Starts up the service loop.
    * The loop then executes until the op code "Done" is sent to this core.
    *
+   * When service threads are set, the loop only receives the command
+   * headers and hands Put and Get requests to a pool of threads, so
+   * that a long transfer from one core does not hold up the others.
+   * Requests from the same core are served in order by the same thread
+   * and overlapping requests are serialized by locks on the pages of
+   * the buffer. Other commands wait for the pending transfers and are
+   * served by the loop itself.
+   *
    * Example of use:
    *
    * C++
@@ -450,6 +482,8 @@ public:
 
   /**
    * Disconnects the buffer from the port it was connected to.
+   * If a statistics file name is set the statistics of this core
+   * are written out first, see SetStatisticsFileName.
    *
    * Example of use:
    *
@@ -615,7 +649,7 @@ public:
    * @param     Start   A pointer in which the start address is to be placed
    * @param     End     A pointer in which the end address is to be placed
    */
-  void GetAddressRangeForId(int Id, int *Start, int *End);
+  void GetAddressRangeForId(int Id, long *Start, long *End);
 
   /**
    * Gets the size of the blocks for the data buffer.
@@ -670,6 +704,24 @@ public:
    */
   long GetBlockLength();
 
+  /**
+   * Gets the number of bytes this core has read from each peer.
+   * On a client the peers are the server cores that data was read
+   * from, on a server the cores that read data from it.
+   *
+   * @return    The bytes read, by the id of the peer
+   */
+  std::map<int, long> GetBytesGot();
+
+  /**
+   * Gets the number of bytes this core has written to each peer.
+   * On a client the peers are the server cores that data was written
+   * to, on a server the cores that wrote data into it.
+   *
+   * @return    The bytes written, by the id of the peer
+   */
+  std::map<int, long> GetBytesPut();
+
   /**
    * Gets the Comm being used to facilitate the communications for the DSM
    *
@@ -723,9 +775,43 @@ public:
    */
   XdmfDSMCommMPI * GetComm();
 
+  /**
+   * Gets the number of bytes this core has sent or received in
+   * compressed form, including the headers of compressed messages.
+   * Together with GetUncompressedBytes this gives the bytes saved.
+   *
+   * @return    The number of compressed bytes
+   */
+  long GetCompressedBytes();
+
+  /**
+   * Gets the size in bytes of the elements that are shuffled
+   * before compression.
+   *
+   * @return    The element size used by compression
+   */
+  int GetCompressionElementSize();
+
+  /**
+   * Gets the time in seconds this core has spent compressing and
+   * decompressing transfers.
+   *
+   * @return    The time spent on compression
+   */
+  double GetCompressionTime();
+
+  /**
+   * Gets the compression applied to data sent through the service loop.
+   *
+   * @return    The compression type of the buffer
+   */
+  int GetCompressionType();
+
   /**
    * Gets the data pointer that the buffer controls.
-   * Should be NULL on non-server cores.
+   * Should be NULL on non-server cores. When the buffer grows the
+   * new memory is added in separate slabs, so this only covers the
+   * length the buffer started with and never moves.
    *
    * Example of use:
    *
@@ -881,7 +967,7 @@ public:
    *
    * @return    The end address of the DSM buffer
    */
-  int GetEndAddress();
+  long GetEndAddress();
 
   /**
    * Gets the id of the last of the server cores that handle the DSM buffer.
@@ -1201,6 +1287,30 @@ public:
    */
   unsigned int GetLocalBufferSizeMBytes();
 
+  /**
+   * Gets the time in seconds this core has spent waiting to be
+   * granted access to files locked by other cores.
+   *
+   * @return    The time spent waiting on locks
+   */
+  double GetLockWaitTime();
+
+  /**
+   * Gets the time in seconds this core has spent in WaitOn and
+   * WaitRelease.
+   *
+   * @return    The time spent waiting on notifications
+   */
+  double GetNotifyWaitTime();
+
+  /**
+   * Gets the number of times this core has looked up the server
+   * holding a page of a paged DSM.
+   *
+   * @return    The number of page lookups
+   */
+  long GetPageLookups();
+
   /**
    * Gets the factor by which the size is multiplied when resizing the local buffer.
    * A factor of 1 doubles the size of the local buffer when resizing.
@@ -1242,6 +1352,39 @@ public:
    */
   double GetResizeFactor();
 
+  /**
+   * Gets the time in seconds the service loop of this core has spent
+   * serving commands. With service threads this is the sum over all
+   * threads and may exceed the time the loop ran.
+   *
+   * @return    The time spent serving commands
+   */
+  double GetServiceBusyTime();
+
+  /**
+   * Gets the time in seconds the service loop of this core has spent
+   * waiting for commands.
+   *
+   * @return    The time spent waiting for commands
+   */
+  double GetServiceIdleTime();
+
+  /**
+   * Gets the number of threads serving Put and Get requests in the
+   * service loop, 0 when the loop serves them itself.
+   *
+   * @return    The number of service threads
+   */
+  int GetServiceThreads();
+
+  /**
+   * Gets the file that the statistics of this core are written to
+   * when it disconnects or leaves the service loop.
+   *
+   * @return    The statistics file name, empty if none is written
+   */
+  std::string GetStatisticsFileName();
+
   /**
    * Gets the address at the beginning of the DSM buffer for this buffer.
    *
@@ -1293,7 +1436,7 @@ public:
    *
    * @return    The beginning address of the DSM buffer
    */
-  int GetStartAddress();
+  long GetStartAddress();
 
   /**
    * Gets the id of the first of the server cores that handle the DSM buffer.
@@ -1401,6 +1544,26 @@ public:
    */
   long GetTotalLength();
 
+  /**
+   * Gets the method used to move data to and from server cores.
+   * XDMF_DSM_TRANSPORT_MESSAGE (the default) sends each request to the
+   * service loop of the owning server core, XDMF_DSM_TRANSPORT_RMA
+   * accesses server buffers directly through one-sided MPI operations,
+   * XDMF_DSM_TRANSPORT_SHARED copies directly to and from the buffers
+   * of server cores on the same node and sends messages to the others.
+   *
+   * @return    The transport type of the buffer
+   */
+  int GetTransportType();
+
+  /**
+   * Gets the number of bytes this core has compressed before sending
+   * or decompressed after receiving.
+   *
+   * @return    The number of uncompressed bytes
+   */
+  long GetUncompressedBytes();
+
   /**
    * Probes inter and intra comms until a command is found.
    * Then sets the comm that the command was found on to the provided variable
@@ -1635,7 +1798,7 @@ public:
    *                            will occur
    * @param     remoteSource    If provided, the core being recieved from
    */
-  void ReceiveCommandHeader(int *opcode, int *source, int *address, int *aLength, int comm, int remoteSource = -1);
+  void ReceiveCommandHeader(int *opcode, int *source, long *address, long *aLength, int comm, int remoteSource = -1);
 
   /**
    * Recieves data from a specific core and stores it in a pointer.
@@ -1684,7 +1847,7 @@ public:
    * @param     comm            The comunicator over which the data transfer
    *                            will occur
    */
-  void ReceiveData(int source, char * data, int aLength, int tag, int aAddress, int comm);
+  void ReceiveData(int source, char * data, long aLength, int tag, long aAddress, int comm);
 
   /**
    * With the Comm with ID 0 recieve information
@@ -1728,6 +1891,12 @@ public:
    */
   void ReceiveInfo();
 
+  /**
+   * Sets every statistic of this core, including those of its comm
+   * and of compression, back to zero.
+   */
+  void ResetStatistics();
+
   /**
    * Registers a file with the provided information. Overwrites previously registered files.
    *
@@ -1775,7 +1944,8 @@ public:
                    haddr_t end);
 
   /**
-   * Requests a file's information from the DSM.
+   * Requests a file's information from the DSM. The version of the
+   * file is incremented each time it is registered.
    *
    * Example of use:
    *
@@ -1813,6 +1983,7 @@ public:
    * @param     numPages        The number of pages associated with the file (output)
    * @param     start           The starting address for the file (output)
    * @param     end             The ending address for the file (output)
+   * @param     version         The version of the file (output, optional)
    * @return                    XDMF_DSM_FAIL if the file does not exist in DSM,
    *                            otherwise XDMF_DSM_SUCCESS
    */
@@ -1820,7 +1991,8 @@ public:
                              std::vector<unsigned int> & pages,
                              unsigned int & numPages,
                              haddr_t & start,
-                             haddr_t & end);
+                             haddr_t & end,
+                             unsigned int * version = NULL);
 
   /**
    * Requests additional pages to cover needed data.
@@ -2025,7 +2197,7 @@ public:
    * @param     aLength         The length of the data to be used by the command
    * @param     comm            The communicator over which the transmission will occur
    */
-  void SendCommandHeader(int opcode, int dest, int address, int aLength, int comm);
+  void SendCommandHeader(int opcode, int dest, long address, long aLength, int comm);
 
   /**
    * Sends data from a pointer to a specified core.
@@ -2086,7 +2258,7 @@ public:
    * @param     comm            The communicator over which the data transfer
    *                            will take place
    */
-  void SendData(int dest, char * data, int aLength, int tag, int aAddress, int comm);
+  void SendData(int dest, char * data, long aLength, int tag, long aAddress, int comm);
 
   /**
    * Ends the service loop server cores associated with this buffer
@@ -2279,6 +2451,33 @@ public:
    */
   void SetComm(XdmfDSMCommMPI * newComm);
 
+  /**
+   * Sets the size in bytes of the elements that are shuffled before
+   * compression, grouping the bytes of equal significance together.
+   * This is normally the size of the values being written.
+   * A size of 1 disables the shuffle.
+   *
+   * @param     newSize         The element size used by compression
+   */
+  void SetCompressionElementSize(int newSize);
+
+  /**
+   * Sets the compression applied to data sent through the service loop.
+   *
+   * XDMF_DSM_COMPRESSION_SHUFFLE run length encodes the shuffled bytes,
+   * XDMF_DSM_COMPRESSION_ZLIB deflates them and is only available when
+   * XdmfDSM was built with zlib. Both are lossless and the data is
+   * stored uncompressed on the server cores, so it can be read back
+   * whatever compression the reader uses. Each Put or Get carries
+   * its compression, so the type may be changed between datasets and
+   * differ between cores. Transfers that do not shrink are sent
+   * as they are. Transfers through RMA or shared memory are not
+   * compressed.
+   *
+   * @param     newType         The compression type to be used
+   */
+  void SetCompressionType(int newType);
+
   /**
    * Sets the DSM type to the provided type.
    *
@@ -2598,6 +2797,57 @@ public:
    */
   void SetResizeFactor(double newFactor);
 
+  /**
+   * Sets the number of threads serving Put and Get requests in the
+   * service loop of this core. Must be set before the loop starts,
+   * the default is taken from the XDMF_DSM_SERVICE_THREADS environment
+   * variable or 0. Threads require MPI to be initialized with
+   * MPI_THREAD_MULTIPLE.
+   *
+   * @param     newThreads      The number of service threads
+   */
+  void SetServiceThreads(int newThreads);
+
+  /**
+   * Sets the file that the statistics of this core are written to when
+   * it disconnects or leaves the service loop. The role and id of the
+   * core are inserted before the extension, so that "dsm.json" becomes
+   * "dsm.client0.json" or "dsm.server1.json". The default is taken from
+   * the XDMF_DSM_STATISTICS_FILE environment variable.
+   *
+   * @param     newName         The statistics file name, empty for none
+   */
+  void SetStatisticsFileName(std::string newName);
+
+  /**
+   * Sets the method used to move data to and from server cores.
+   *
+   * With XDMF_DSM_TRANSPORT_RMA the buffers of the server cores are
+   * exposed through an MPI window and Put and Get access them with
+   * MPI_Put and MPI_Get under passive target locks. Transfers then
+   * no longer wait on the service loop of the server cores, which
+   * only handles file descriptions, locks and notifications.
+   * The window is created with MPI_Win_create_dynamic, memory added
+   * when a server buffer grows is attached to it and non-server cores
+   * ask a server for the location of its memory the first time they
+   * access addresses past what they already know of.
+   *
+   * With XDMF_DSM_TRANSPORT_SHARED the buffers of the server cores are
+   * moved into node shared memory allocated by MPI_Win_allocate_shared.
+   * Cores on the same node as a server core copy to and from its buffer
+   * directly under the same locks as the RMA transport, data for server
+   * cores on other nodes is still sent through the service loop. When a
+   * server buffer grows the memory added stays private to the server
+   * core, transfers past the shared memory go through its service loop.
+   *
+   * This call is collective across all non-server cores connected
+   * to the DSM, the server cores are notified through the service loop.
+   * Setting XDMF_DSM_TRANSPORT_MESSAGE releases the window.
+   *
+   * @param     newType         The transport type to be used
+   */
+  void SetTransportType(int newType);
+
   /**
    * Manually update the length of an individual core's buffer.
    *
@@ -2653,7 +2903,7 @@ public:
    *
    * @param     newLength       The new buffer length, in bytes.
    */
-  void UpdateLength(unsigned int newLength);
+  void UpdateLength(long newLength);
 
   /**
    * Releases all processes waiting on a specified dataset. Sends those processes a specified code.
@@ -2709,6 +2959,14 @@ public:
    */
   int WaitOn(std::string filename, std::string datasetname);
 
+  /**
+   * Writes the statistics of this core to a file, as CSV if the name
+   * ends in .csv and as JSON otherwise.
+   *
+   * @param     filename        The file to write to
+   */
+  void WriteStatistics(std::string filename);
+
 protected:
 
 class XDMF_file_desc
@@ -2721,6 +2979,7 @@ class XDMF_file_desc
       end = 0;
       numPages = 0;
       pages = NULL;
+      version = 0;
     }
 
     ~XDMF_file_desc()
@@ -2732,41 +2991,88 @@ class XDMF_file_desc
     haddr_t end;     /* current DSM end address                 */
     unsigned int numPages; /* number of pages assigned to the file    */
     unsigned int * pages;  /* list of pages assigned to the file      */
+    unsigned int version;  /* number of times the file was registered */
 };
 
-  int AddressToId(int Address);
+  int AddressToId(long Address);
 
   void Lock(char * filename);
 
   int PageToId(int pageId);
 
-  int PageToAddress(int pageId);
+  long PageToAddress(int pageId);
 
   void Unlock(char * filename);
 
 private:
 
+  class                 CompressionHeader;
+  class                 DataSegment;
+  class                 ServiceThreadPool;
+
+  void AddSegment(std::vector<DataSegment> & segments,
+                  int server,
+                  long address,
+                  long aLength,
+                  char * data);
+
+  long Compress(char * data, long aLength, char * output, int type, int elementSize);
+
+  long CompressedBound(long aLength);
+
+  void CountServiceTime(double busyTime, double idleTime);
+
+  void CopySlabs(int opcode, long address, long aLength, char * data);
+
+  void CountTransfer(int opcode, int peer, long aLength);
+
+  void Decompress(char * data, char * output, long aLength);
+
+  void LocalAccess(int opcode, long address, long aLength, char * data);
+
+  void MergeSlabs();
+
+  void RequestWindowRegions(int server);
+
+  int ServiceCommand(int opcode, int who, long address, long aLength);
+
   void SetLength(long aLength);
 
+  void TransferSegments(int opcode, std::vector<DataSegment> & segments);
+
+  void SharedAccess(int opcode, int server, char * data, long aLength, long aAddress);
+
+  char * SlabPointer(long address, long aLength);
+
+  void UpdateDataWindow(int newType);
+
+  void WindowAccess(int opcode, int server, char * data, long aLength, long aAddress);
+
+  void WindowRegions(std::vector<long> & addresses, std::vector<MPI_Aint> & bases);
+
   class                 CommandMsg;
   class                 InfoMsg;
 
   bool                  IsServer;
 
-  int                   EndAddress;
-  int                   StartAddress;
+  long                  EndAddress;
+  long                  StartAddress;
 
   int                   StartServerId;
   int                   EndServerId;
 
   unsigned int          LocalBufferSizeMBytes;
-  unsigned int          Length;
-  unsigned int          TotalLength;
-  unsigned int          BlockLength;
+  long                  Length;
+  long                  TotalLength;
+  long                  BlockLength;
 
   XdmfDSMCommMPI *      Comm;
 
   char *                DataPointer;
+  // Memory added when the buffer grows, each slab starts
+  // at the matching local address and ends where the next begins.
+  std::vector<char *>   Slabs;
+  std::vector<long>     SlabAddresses;
   unsigned int          NumPages;
   unsigned int          PagesAssigned;
 
@@ -2779,6 +3085,38 @@ private:
 
   double                ResizeFactor;
 
+  int                   TransportType;
+  MPI_Win               DataWindow;
+  // Local addresses each region of a server's buffer attached to the
+  // RMA window starts at, followed by the length of the buffer, and
+  // the window displacements of the regions, as last reported by it.
+  std::map<int, std::vector<long> >     WindowAddresses;
+  std::map<int, std::vector<MPI_Aint> > WindowBases;
+  MPI_Comm              NodeComm;
+  std::vector<int>      SharedRanks;
+  std::vector<char *>   SharedPointers;
+  // Length of the shared memory of each server, memory added when a
+  // server grows stays private and is reached through its service loop
+  std::vector<long>     SharedLengths;
+
+  int                   CompressionType;
+  int                   CompressionElementSize;
+  long                  CompressedBytes;
+  long                  UncompressedBytes;
+  double                CompressionTime;
+
+  int                   ServiceThreads;
+  ServiceThreadPool *   ServicePool;
+
+  std::map<int, long>   BytesPut;
+  std::map<int, long>   BytesGot;
+  double                LockWaitTime;
+  double                NotifyWaitTime;
+  long                  PageLookups;
+  double                ServiceBusyTime;
+  double                ServiceIdleTime;
+  std::string           StatisticsFileName;
+
   std::map<std::string, std::vector<unsigned int> > WaitingMap;
 
   std::map<std::string, std::queue<unsigned int> > LockedMap;
@@ -2802,7 +3140,7 @@ XDMFDSM_EXPORT XDMFDSMBUFFER * XdmfDSMBufferNew();
 
 XDMFDSM_EXPORT void XdmfDSMBufferFree(XDMFDSMBUFFER * item);
 
-XDMFDSM_EXPORT int XdmfDSMBufferAddressToId(XDMFDSMBUFFER * buffer, int Address, int * status);
+XDMFDSM_EXPORT int XdmfDSMBufferAddressToId(XDMFDSMBUFFER * buffer, long Address, int * status);
 
 XDMFDSM_EXPORT void XdmfDSMBufferBroadcastComm(XDMFDSMBUFFER * buffer, int *comm, int root, int * status);
 
@@ -2827,17 +3165,25 @@ XDMFDSM_EXPORT void XdmfDSMBufferDisconnect(XDMFDSMBUFFER * buffer, int * status
 
 XDMFDSM_EXPORT void XdmfDSMBufferGet(XDMFDSMBUFFER * buffer, long Address, long aLength, void * Data, int * status);
 
-XDMFDSM_EXPORT void XdmfDSMBufferGetAddressRangeForId(XDMFDSMBUFFER * buffer, int Id, int * Start, int * End, int * status);
+XDMFDSM_EXPORT void XdmfDSMBufferGetAddressRangeForId(XDMFDSMBUFFER * buffer, int Id, long * Start, long * End, int * status);
 
 XDMFDSM_EXPORT long XdmfDSMBufferGetBlockLength(XDMFDSMBUFFER * buffer);
 
 XDMFDSM_EXPORT XDMFDSMCOMMMPI * XdmfDSMBufferGetComm(XDMFDSMBUFFER * buffer);
 
+XDMFDSM_EXPORT long XdmfDSMBufferGetCompressedBytes(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT int XdmfDSMBufferGetCompressionElementSize(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT double XdmfDSMBufferGetCompressionTime(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT int XdmfDSMBufferGetCompressionType(XDMFDSMBUFFER * buffer);
+
 XDMFDSM_EXPORT char * XdmfDSMBufferGetDataPointer(XDMFDSMBUFFER * buffer);
 
 XDMFDSM_EXPORT int XdmfDSMBufferGetDsmType(XDMFDSMBUFFER * buffer);
 
-XDMFDSM_EXPORT int XdmfDSMBufferGetEndAddress(XDMFDSMBUFFER * buffer);
+XDMFDSM_EXPORT long XdmfDSMBufferGetEndAddress(XDMFDSMBUFFER * buffer);
 
 XDMFDSM_EXPORT int XdmfDSMBufferGetEndServerId(XDMFDSMBUFFER * buffer);
 
@@ -2851,14 +3197,32 @@ XDMFDSM_EXPORT long XdmfDSMBufferGetLength(XDMFDSMBUFFER * buffer);
 
 XDMFDSM_EXPORT unsigned int XdmfDSMBufferGetLocalBufferSizeMBytes(XDMFDSMBUFFER * buffer);
 
+XDMFDSM_EXPORT double XdmfDSMBufferGetLockWaitTime(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT double XdmfDSMBufferGetNotifyWaitTime(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT long XdmfDSMBufferGetPageLookups(XDMFDSMBUFFER * buffer);
+
 XDMFDSM_EXPORT double XdmfDSMBufferGetResizeFactor(XDMFDSMBUFFER * buffer);
 
-XDMFDSM_EXPORT int XdmfDSMBufferGetStartAddress(XDMFDSMBUFFER * buffer);
+XDMFDSM_EXPORT double XdmfDSMBufferGetServiceBusyTime(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT double XdmfDSMBufferGetServiceIdleTime(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT int XdmfDSMBufferGetServiceThreads(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT long XdmfDSMBufferGetStartAddress(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT char * XdmfDSMBufferGetStatisticsFileName(XDMFDSMBUFFER * buffer);
 
 XDMFDSM_EXPORT int XdmfDSMBufferGetStartServerId(XDMFDSMBUFFER * buffer);
 
 XDMFDSM_EXPORT long XdmfDSMBufferGetTotalLength(XDMFDSMBUFFER * buffer);
 
+XDMFDSM_EXPORT int XdmfDSMBufferGetTransportType(XDMFDSMBUFFER * buffer);
+
+XDMFDSM_EXPORT long XdmfDSMBufferGetUncompressedBytes(XDMFDSMBUFFER * buffer);
+
 XDMFDSM_EXPORT void XdmfDSMBufferProbeCommandHeader(XDMFDSMBUFFER * buffer, int * comm, int * status);
 
 XDMFDSM_EXPORT void XdmfDSMBufferPut(XDMFDSMBUFFER * buffer, long Address, long aLength, void * Data, int * status);
@@ -2873,8 +3237,8 @@ XDMFDSM_EXPORT void XdmfDSMBufferReceiveAcknowledgment(XDMFDSMBUFFER * buffer,
 XDMFDSM_EXPORT void XdmfDSMBufferReceiveCommandHeader(XDMFDSMBUFFER * buffer,
                                                       int * opcode,
                                                       int * source,
-                                                      int * address,
-                                                      int * aLength,
+                                                      long * address,
+                                                      long * aLength,
                                                       int comm,
                                                       int remoteSource,
                                                       int * status);
@@ -2882,15 +3246,17 @@ XDMFDSM_EXPORT void XdmfDSMBufferReceiveCommandHeader(XDMFDSMBUFFER * buffer,
 XDMFDSM_EXPORT void XdmfDSMBufferReceiveData(XDMFDSMBUFFER * buffer,
                                              int source,
                                              char * data,
-                                             int aLength,
+                                             long aLength,
                                              int tag,
-                                             int aAddress,
+                                             long aAddress,
                                              int comm,
                                              int * status);
 
 XDMFDSM_EXPORT void XdmfDSMBufferReceiveInfo(XDMFDSMBUFFER * buffer,
                                              int * status);
 
+XDMFDSM_EXPORT void XdmfDSMBufferResetStatistics(XDMFDSMBUFFER * buffer);
+
 XDMFDSM_EXPORT void XdmfDSMBufferSendAccept(XDMFDSMBUFFER * buffer, unsigned int numConnects);
 
 XDMFDSM_EXPORT void XdmfDSMBufferSendAcknowledgment(XDMFDSMBUFFER * buffer,
@@ -2903,17 +3269,17 @@ XDMFDSM_EXPORT void XdmfDSMBufferSendAcknowledgment(XDMFDSMBUFFER * buffer,
 XDMFDSM_EXPORT void XdmfDSMBufferSendCommandHeader(XDMFDSMBUFFER * buffer,
                                                    int opcode,
                                                    int dest,
-                                                   int address,
-                                                   int aLength,
+                                                   long address,
+                                                   long aLength,
                                                    int comm,
                                                    int * status);
 
 XDMFDSM_EXPORT void XdmfDSMBufferSendData(XDMFDSMBUFFER * buffer,
                                           int dest,
                                           char * data,
-                                          int aLength,
+                                          long aLength,
                                           int tag,
-                                          int aAddress,
+                                          long aAddress,
                                           int comm,
                                           int * status);
 
@@ -2925,6 +3291,10 @@ XDMFDSM_EXPORT void XdmfDSMBufferSetBlockLength(XDMFDSMBUFFER * buffer, long new
 
 XDMFDSM_EXPORT void XdmfDSMBufferSetComm(XDMFDSMBUFFER * buffer, XDMFDSMCOMMMPI * newComm);
 
+XDMFDSM_EXPORT void XdmfDSMBufferSetCompressionElementSize(XDMFDSMBUFFER * buffer, int newSize, int * status);
+
+XDMFDSM_EXPORT void XdmfDSMBufferSetCompressionType(XDMFDSMBUFFER * buffer, int newType, int * status);
+
 XDMFDSM_EXPORT void XdmfDSMBufferSetDsmType(XDMFDSMBUFFER * buffer, int newDsmType);
 
 XDMFDSM_EXPORT void XdmfDSMBufferSetInterCommType(XDMFDSMBUFFER * buffer, int newType);
@@ -2937,10 +3307,18 @@ XDMFDSM_EXPORT void XdmfDSMBufferSetLocalBufferSizeMBytes(XDMFDSMBUFFER * buffer
 
 XDMFDSM_EXPORT void XdmfDSMBufferSetResizeFactor(XDMFDSMBUFFER * buffer, double newFactor);
 
+XDMFDSM_EXPORT void XdmfDSMBufferSetServiceThreads(XDMFDSMBUFFER * buffer, int newThreads, int * status);
+
+XDMFDSM_EXPORT void XdmfDSMBufferSetStatisticsFileName(XDMFDSMBUFFER * buffer, char * newName);
+
+XDMFDSM_EXPORT void XdmfDSMBufferSetTransportType(XDMFDSMBUFFER * buffer, int newType, int * status);
+
 XDMFDSM_EXPORT void XdmfDSMBufferWaitRelease(XDMFDSMBUFFER * buffer, char * filename, char * datasetname, int code);
 
 XDMFDSM_EXPORT int XdmfDSMBufferWaitOn(XDMFDSMBUFFER * buffer, char * filename, char * datasetname);
 
+XDMFDSM_EXPORT void XdmfDSMBufferWriteStatistics(XDMFDSMBUFFER * buffer, char * filename, int * status);
+
 #ifdef __cplusplus
 }
 #endif
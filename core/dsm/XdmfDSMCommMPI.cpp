@@ -59,6 +59,25 @@
 #include <fstream>
 #include <iostream>
 
+/**
+ * local functions
+ */
+namespace {
+
+  // Buffers with service threads send and receive from several
+  // threads at once, so the counts are updated atomically.
+  inline void
+  addCount(long & counter, long value)
+  {
+#ifdef __GNUC__
+    __sync_fetch_and_add(&counter, value);
+#else
+    counter += value;
+#endif
+  }
+
+}
+
 bool XdmfDSMCommMPI::UseEnvFileName = false;
 
 XdmfDSMCommMPI::XdmfDSMCommMPI()
@@ -83,6 +102,10 @@ XdmfDSMCommMPI::XdmfDSMCommMPI()
   InterCommType = XDMF_DSM_COMM_MPI;
   HasOpenedPort = false;
   ApplicationName = "Application";
+  BytesReceived = 0;
+  BytesSent = 0;
+  MessagesReceived = 0;
+  MessagesSent = 0;
 }
 
 XdmfDSMCommMPI::~XdmfDSMCommMPI()
@@ -607,6 +630,18 @@ XdmfDSMCommMPI::GetApplicationName()
   return ApplicationName;
 }
 
+long
+XdmfDSMCommMPI::GetBytesReceived()
+{
+  return BytesReceived;
+}
+
+long
+XdmfDSMCommMPI::GetBytesSent()
+{
+  return BytesSent;
+}
+
 std::string
 XdmfDSMCommMPI::GetDsmFileName()
 {
@@ -667,6 +702,18 @@ XdmfDSMCommMPI::GetIntraSize()
   return this->IntraSize;
 }
 
+long
+XdmfDSMCommMPI::GetMessagesReceived()
+{
+  return MessagesReceived;
+}
+
+long
+XdmfDSMCommMPI::GetMessagesSent()
+{
+  return MessagesSent;
+}
+
 bool
 XdmfDSMCommMPI::GetUseEnvFileName()
 {
@@ -802,6 +849,91 @@ XdmfDSMCommMPI::ReadDsmPortName()
 #endif
 }
 
+void
+XdmfDSMCommMPI::ResetStatistics()
+{
+  BytesReceived = 0;
+  BytesSent = 0;
+  MessagesReceived = 0;
+  MessagesSent = 0;
+}
+
+void
+XdmfDSMCommMPI::IReceive(void * pointer,
+                         int sizebytes,
+                         int coreFrom,
+                         int comm,
+                         int tag,
+                         MPI_Request * request)
+{
+  int status = MPI_ERR_COMM;
+  if (comm == XDMF_DSM_INTRA_COMM) {
+    status = MPI_Irecv(pointer,
+                       sizebytes,
+                       MPI_UNSIGNED_CHAR,
+                       coreFrom,
+                       tag,
+                       IntraComm,
+                       request);
+  }
+  else if (comm == XDMF_DSM_INTER_COMM) {
+    status = MPI_Irecv(pointer,
+                       sizebytes,
+                       MPI_UNSIGNED_CHAR,
+                       coreFrom,
+                       tag,
+                       InterComm,
+                       request);
+  }
+  if (status != MPI_SUCCESS) {
+    XdmfError::message(XdmfError::FATAL, "Error: Failed to post receive");
+  }
+}
+
+void
+XdmfDSMCommMPI::CountReceive(MPI_Status * status)
+{
+  // The message may be shorter than the posted buffer
+  int received = 0;
+  MPI_Get_count(status, MPI_UNSIGNED_CHAR, &received);
+  addCount(MessagesReceived, 1);
+  addCount(BytesReceived, received);
+}
+
+void
+XdmfDSMCommMPI::ISend(void * pointer,
+                      int sizebytes,
+                      int coreTo,
+                      int comm,
+                      int tag,
+                      MPI_Request * request)
+{
+  int status = MPI_ERR_COMM;
+  if (comm == XDMF_DSM_INTRA_COMM) {
+    status = MPI_Isend(pointer,
+                       sizebytes,
+                       MPI_UNSIGNED_CHAR,
+                       coreTo,
+                       tag,
+                       IntraComm,
+                       request);
+  }
+  else if (comm == XDMF_DSM_INTER_COMM) {
+    status = MPI_Isend(pointer,
+                       sizebytes,
+                       MPI_UNSIGNED_CHAR,
+                       coreTo,
+                       tag,
+                       InterComm,
+                       request);
+  }
+  if (status != MPI_SUCCESS) {
+    XdmfError::message(XdmfError::FATAL, "Error: Failed to post send");
+  }
+  addCount(MessagesSent, 1);
+  addCount(BytesSent, sizebytes);
+}
+
 void
 XdmfDSMCommMPI::Send(void * pointer,
                      int sizebytes,
@@ -826,6 +958,8 @@ XdmfDSMCommMPI::Send(void * pointer,
                       tag,
                       InterComm);
   }
+  addCount(MessagesSent, 1);
+  addCount(BytesSent, sizebytes);
 }
 
 void
@@ -855,6 +989,10 @@ XdmfDSMCommMPI::Receive(void * pointer,
                       InterComm,
                       &signalStatus);
   }
+  int received = 0;
+  MPI_Get_count(&signalStatus, MPI_UNSIGNED_CHAR, &received);
+  addCount(MessagesReceived, 1);
+  addCount(BytesReceived, received);
 }
 
 void
@@ -966,6 +1104,16 @@ char * XdmfDSMCommMPIGetApplicationName(XDMFDSMCOMMMPI * dsmComm)
   }
 }
 
+long XdmfDSMCommMPIGetBytesReceived(XDMFDSMCOMMMPI * dsmComm)
+{
+  return ((XdmfDSMCommMPI *)dsmComm)->GetBytesReceived();
+}
+
+long XdmfDSMCommMPIGetBytesSent(XDMFDSMCOMMMPI * dsmComm)
+{
+  return ((XdmfDSMCommMPI *)dsmComm)->GetBytesSent();
+}
+
 char * XdmfDSMCommMPIGetDsmFileName(XDMFDSMCOMMMPI * dsmComm)
 {
   try
@@ -1109,6 +1257,16 @@ int XdmfDSMCommMPIGetIntraSize(XDMFDSMCOMMMPI * dsmComm)
   }
 }
 
+long XdmfDSMCommMPIGetMessagesReceived(XDMFDSMCOMMMPI * dsmComm)
+{
+  return ((XdmfDSMCommMPI *)dsmComm)->GetMessagesReceived();
+}
+
+long XdmfDSMCommMPIGetMessagesSent(XDMFDSMCOMMMPI * dsmComm)
+{
+  return ((XdmfDSMCommMPI *)dsmComm)->GetMessagesSent();
+}
+
 int XdmfDSMCommMPIGetUseEnvFileName(XDMFDSMCOMMMPI * dsmComm)
 {
   try
@@ -1147,6 +1305,11 @@ void XdmfDSMCommMPIReadDsmPortName(XDMFDSMCOMMMPI * dsmComm)
   }
 }
 
+void XdmfDSMCommMPIResetStatistics(XDMFDSMCOMMMPI * dsmComm)
+{
+  ((XdmfDSMCommMPI *)dsmComm)->ResetStatistics();
+}
+
 void XdmfDSMCommMPISetApplicationName(XDMFDSMCOMMMPI * dsmComm, char * newName)
 {
   try
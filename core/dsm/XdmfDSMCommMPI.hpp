@@ -516,6 +516,22 @@ public:
    */
   std::string GetApplicationName();
 
+  /**
+   * Gets the number of bytes received through this comm. Nonblocking
+   * receives are counted by the bytes actually received once they
+   * complete.
+   *
+   * @return    The number of bytes received
+   */
+  long GetBytesReceived();
+
+  /**
+   * Gets the number of bytes sent through this comm.
+   *
+   * @return    The number of bytes sent
+   */
+  long GetBytesSent();
+
   /**
    * Gets the current file name that connection info will be written to.
    *
@@ -1022,6 +1038,20 @@ public:
    */
   int GetIntraSize();
 
+  /**
+   * Gets the number of point to point messages received through this comm.
+   *
+   * @return    The number of messages received
+   */
+  long GetMessagesReceived();
+
+  /**
+   * Gets the number of point to point messages sent through this comm.
+   *
+   * @return    The number of messages sent
+   */
+  long GetMessagesSent();
+
   /**
    * If this is true then any created Comms will pull their dsm file name
    * from the environment instead of using the default.
@@ -1211,6 +1241,58 @@ public:
    */
   void ReadDsmPortName();
 
+  /**
+   * Sets the message and byte counts of this comm back to zero.
+   */
+  void ResetStatistics();
+
+  /**
+   * Equivalent to MPI_Irecv
+   *
+   * The request is completed with MPI_Wait or MPI_Waitall, after which
+   * its status is passed to CountReceive to add it to the statistics.
+   *
+   * @param     pointer          The pointer to place recieved data into.
+   * @param     sizebytes        The size of the buffer being transmitted.
+   * @param     coreFrom         The core to recieve data from.
+   * @param     comm             The Int code for the communicator to be used.
+   * @param     tag              The tag for the communication.
+   * @param     request          The request tracking the communication.
+   */
+  void IReceive(void * pointer,
+                int sizebytes,
+                int coreFrom,
+                int comm,
+                int tag,
+                MPI_Request * request);
+
+  /**
+   * Adds a completed nonblocking receive to the message and byte counts.
+   *
+   * @param     status          The status the receive completed with.
+   */
+  void CountReceive(MPI_Status * status);
+
+  /**
+   * Equivalent to MPI_Isend
+   *
+   * The request is completed with MPI_Wait or MPI_Waitall,
+   * the buffer must not be modified until then.
+   *
+   * @param     pointer          The pointer to send.
+   * @param     sizebytes        The size of the buffer being transmitted.
+   * @param     coreTo           The core to send data to.
+   * @param     comm             The Int code for the communicator to be used.
+   * @param     tag              The tag for the communication.
+   * @param     request          The request tracking the communication.
+   */
+  void ISend(void * pointer,
+             int sizebytes,
+             int coreTo,
+             int comm,
+             int tag,
+             MPI_Request * request);
+
   /**
    * Equivalent to MPI_recv
    *
@@ -1463,6 +1545,10 @@ private:
   static bool   UseEnvFileName;
   bool          HasOpenedPort;
   std::string   ApplicationName;
+  long          BytesReceived;
+  long          BytesSent;
+  long          MessagesReceived;
+  long          MessagesSent;
 
   // This is a vector of <application name, numprocs>
   std::vector<std::pair<std::string, unsigned int> > DsmProcessStructure;
@@ -1501,6 +1587,10 @@ XDMFDSM_EXPORT void XdmfDSMCommMPIDupInterComm(XDMFDSMCOMMMPI * dsmComm, MPI_Com
 
 XDMFDSM_EXPORT char * XdmfDSMCommMPIGetApplicationName(XDMFDSMCOMMMPI * dsmComm);
 
+XDMFDSM_EXPORT long XdmfDSMCommMPIGetBytesReceived(XDMFDSMCOMMMPI * dsmComm);
+
+XDMFDSM_EXPORT long XdmfDSMCommMPIGetBytesSent(XDMFDSMCOMMMPI * dsmComm);
+
 XDMFDSM_EXPORT char * XdmfDSMCommMPIGetDsmFileName(XDMFDSMCOMMMPI * dsmComm);
 
 XDMFDSM_EXPORT char * XdmfDSMCommMPIGetDsmPortName(XDMFDSMCOMMMPI * dsmComm);
@@ -1524,6 +1614,10 @@ XDMFDSM_EXPORT MPI_Comm XdmfDSMCommMPIGetIntraComm(XDMFDSMCOMMMPI * dsmComm);
 
 XDMFDSM_EXPORT int XdmfDSMCommMPIGetIntraSize(XDMFDSMCOMMMPI * dsmComm);
 
+XDMFDSM_EXPORT long XdmfDSMCommMPIGetMessagesReceived(XDMFDSMCOMMMPI * dsmComm);
+
+XDMFDSM_EXPORT long XdmfDSMCommMPIGetMessagesSent(XDMFDSMCOMMMPI * dsmComm);
+
 XDMFDSM_EXPORT int XdmfDSMCommMPIGetUseEnvFileName(XDMFDSMCOMMMPI * dsmComm);
 
 XDMFDSM_EXPORT void XdmfDSMCommMPIInit(XDMFDSMCOMMMPI * dsmComm, int * status);
@@ -1532,6 +1626,8 @@ XDMFDSM_EXPORT void XdmfDSMCommMPIOpenPort(XDMFDSMCOMMMPI * dsmComm, int * statu
 
 XDMFDSM_EXPORT void XdmfDSMCommMPIReadDsmPortName(XDMFDSMCOMMMPI * dsmComm);
 
+XDMFDSM_EXPORT void XdmfDSMCommMPIResetStatistics(XDMFDSMCOMMMPI * dsmComm);
+
 XDMFDSM_EXPORT void XdmfDSMCommMPISetApplicationName(XDMFDSMCOMMMPI * dsmComm, char * newName);
 
 XDMFDSM_EXPORT void XdmfDSMCommMPISetDsmFileName(XDMFDSMCOMMMPI * dsmComm, char * filename);
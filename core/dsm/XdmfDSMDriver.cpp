@@ -61,6 +61,8 @@
 
 #include <sstream>
 #include <map>
+#include <list>
+#include <algorithm>
 
 typedef struct XDMF_dsm_t
 {
@@ -94,9 +96,36 @@ static hid_t XDMF_DSM_g = 0;
 
 //from driver
 XdmfDSMBuffer *dsmBuffer = NULL;
-std::map<std::string, unsigned int> fileEOF; // holding previously created files
+std::map<std::string, haddr_t> fileEOF; // holding previously created files
 std::map<std::string, std::vector<unsigned int> > filePages;
 
+// Client side cache of pages read from files opened read-only
+#define XDMF_DSM_CACHE_PAGE_SIZE 4096
+// Larger reads bypass the cache
+#define XDMF_DSM_CACHE_MAX_READ  65536
+
+typedef std::pair<std::string, haddr_t> XdmfDSMCacheKey;
+
+typedef struct
+{
+  std::vector<char> data;
+  std::list<XdmfDSMCacheKey>::iterator use; /* position in cacheUse */
+} XdmfDSMCachePage;
+
+size_t cacheSize = 0; // 0 disables the cache
+size_t cacheUsed = 0;
+std::map<XdmfDSMCacheKey, XdmfDSMCachePage> cachePages;
+std::list<XdmfDSMCacheKey> cacheUse; // most recently used first
+std::map<std::string, unsigned int> cacheVersions; // file versions cached
+
+// Reads and writes made by HDF5 through the driver on this core
+unsigned long statReads = 0;
+unsigned long statBytesRead = 0;
+unsigned long statWrites = 0;
+unsigned long statBytesWritten = 0;
+unsigned long statCacheHits = 0;
+unsigned long statCacheMisses = 0;
+
 #define MAXADDR                 ((haddr_t)((~(size_t)0)-1))
 #define ADDR_OVERFLOW(A)        (HADDR_UNDEF==(A) || (A) > (haddr_t)MAXADDR)
 #define SIZE_OVERFLOW(Z)        ((Z) > (hsize_t)MAXADDR)
@@ -493,6 +522,7 @@ XDMF_dsm_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
   herr_t dsm_code = SUCCEED;
 
   unsigned int * newpages = NULL;
+  unsigned int version = 0;
 
 #if H5_VERSION_GE(1,8,9)
   FUNC_ENTER_NOAPI_NOINIT
@@ -546,7 +576,8 @@ XDMF_dsm_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
                                           filePages[file->name],
                                           file->numPages,
                                           file->start,
-                                          file->end) == XDMF_DSM_FAIL)
+                                          file->end,
+                                          &version) == XDMF_DSM_FAIL)
     {
       // File not found
       file->numPages = 0;
@@ -572,6 +603,19 @@ XDMF_dsm_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
                                   0,
                                   XDMF_DSM_INTRA_COMM);
 
+  dsmBuffer->GetComm()->Broadcast(&version,
+                                  sizeof(unsigned int),
+                                  0,
+                                  XDMF_DSM_INTRA_COMM);
+
+  /* Cores that only read never see the file being written,
+   * the version tells whether it changed since its pages were cached */
+  if (cacheVersions.count(file->name) == 0 ||
+      cacheVersions[file->name] != version) {
+    xdmf_dsm_invalidate_cache(file->name);
+    cacheVersions[file->name] = version;
+  }
+
   if (file->numPages > 0)
   {
     if (dsmBuffer->GetComm()->GetId() != 0)
@@ -590,6 +634,8 @@ XDMF_dsm_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
 
   if (H5F_ACC_RDWR & flags) {
     file->read_only = FALSE;
+    /* The file is about to change, cached pages can not be trusted */
+    xdmf_dsm_invalidate_cache(file->name);
   } else {
     file->read_only = TRUE;
   }
@@ -702,6 +748,10 @@ XDMF_dsm_close(H5FD_t *_file)
    */
   unlock_flag = (file->dirty) ? XDMF_DSM_NOTIFY_DATA : XDMF_DSM_NOTIFY_NONE;
 
+  if (file->dirty) {
+    xdmf_dsm_invalidate_cache(file->name);
+  }
+
   /* Release resources */
   if (file->name) HDfree(file->name);
   HDmemset(file, 0, sizeof(XDMF_dsm_t));
@@ -802,9 +852,9 @@ XDMF_dsm_set_eoa(H5FD_t * _file, H5FD_mem_t UNUSED type, haddr_t addr)
 
     // If requesting pages resized the pointer
     // Reset the total length to match the new size.
-    unsigned int currentLength = dsmBuffer->GetLength();
+    long currentLength = dsmBuffer->GetLength();
     dsmBuffer->GetComm()->Broadcast(&currentLength,
-                                    sizeof(unsigned int),
+                                    sizeof(long),
                                     0,
                                     XDMF_DSM_INTRA_COMM);
     if (currentLength != dsmBuffer->GetLength()) {
@@ -891,6 +941,95 @@ XDMF_dsm_get_eof(const H5FD_t *_file)
   FUNC_LEAVE_NOAPI(MAX(file->eof, file->eoa))
 }
 
+static void
+XDMF_dsm_cache_erase(std::map<XdmfDSMCacheKey, XdmfDSMCachePage>::iterator page)
+{
+  cacheUsed -= page->second.data.size();
+  cacheUse.erase(page->second.use);
+  cachePages.erase(page);
+}
+
+static void
+XDMF_dsm_cache_evict()
+{
+  // Drop the least recently used pages until the cache fits
+  while (cacheUsed > cacheSize && cacheUse.size() > 0) {
+    XDMF_dsm_cache_erase(cachePages.find(cacheUse.back()));
+  }
+}
+
+static herr_t
+XDMF_dsm_read_file(XDMF_dsm_t *file, haddr_t addr, size_t size, void *buf)
+{
+  int dsmType = dsmBuffer->GetDsmType();
+  if (dsmType == XDMF_DSM_TYPE_BLOCK_CYCLIC ||
+      dsmType == XDMF_DSM_TYPE_BLOCK_RANDOM) {
+    return xdmf_dsm_read_pages(&(filePages[file->name][0]), file->numPages, addr, size, buf);
+  }
+  else if (dsmType == XDMF_DSM_TYPE_UNIFORM ||
+           dsmType == XDMF_DSM_TYPE_UNIFORM_RANGE) {
+    return xdmf_dsm_read(file->start + addr, size, buf);
+  }
+  return FAIL;
+}
+
+static herr_t
+XDMF_dsm_cache_read(XDMF_dsm_t *file, haddr_t addr, size_t size, void *buf)
+{
+  const std::string name(file->name);
+  const haddr_t firstPage = addr - addr % XDMF_DSM_CACHE_PAGE_SIZE;
+  const haddr_t lastPage = (addr + size - 1) - (addr + size - 1) % XDMF_DSM_CACHE_PAGE_SIZE;
+
+  bool cached = true;
+  for (haddr_t page = firstPage; page <= lastPage && cached; page += XDMF_DSM_CACHE_PAGE_SIZE) {
+    std::map<XdmfDSMCacheKey, XdmfDSMCachePage>::iterator found =
+      cachePages.find(XdmfDSMCacheKey(name, page));
+    haddr_t needed = std::min(addr + size, page + XDMF_DSM_CACHE_PAGE_SIZE) - page;
+    cached = found != cachePages.end() && found->second.data.size() >= needed;
+  }
+
+  if (cached) {
+    ++statCacheHits;
+  }
+  else {
+    ++statCacheMisses;
+    // Fetch every page of the read at once, up to the end of the file
+    haddr_t fetchEnd = std::min(lastPage + XDMF_DSM_CACHE_PAGE_SIZE, file->eof);
+    std::vector<char> fetched(fetchEnd - firstPage);
+    if (SUCCEED != XDMF_dsm_read_file(file, firstPage, fetched.size(), &fetched[0])) {
+      return FAIL;
+    }
+    for (haddr_t page = firstPage; page < fetchEnd; page += XDMF_DSM_CACHE_PAGE_SIZE) {
+      XdmfDSMCacheKey key(name, page);
+      std::map<XdmfDSMCacheKey, XdmfDSMCachePage>::iterator found = cachePages.find(key);
+      if (found != cachePages.end()) {
+        XDMF_dsm_cache_erase(found);
+      }
+      haddr_t pageEnd = std::min(page + XDMF_DSM_CACHE_PAGE_SIZE, fetchEnd);
+      XdmfDSMCachePage & newPage = cachePages[key];
+      newPage.data.assign(fetched.begin() + (page - firstPage),
+                          fetched.begin() + (pageEnd - firstPage));
+      cacheUse.push_front(key);
+      newPage.use = cacheUse.begin();
+      cacheUsed += newPage.data.size();
+    }
+  }
+
+  // Copy out of the cached pages, marking them as recently used
+  for (haddr_t page = firstPage; page <= lastPage; page += XDMF_DSM_CACHE_PAGE_SIZE) {
+    XdmfDSMCachePage & cachedPage = cachePages[XdmfDSMCacheKey(name, page)];
+    haddr_t copyStart = std::max(addr, page);
+    haddr_t copyEnd = std::min(addr + size, page + XDMF_DSM_CACHE_PAGE_SIZE);
+    memcpy((char *)buf + (copyStart - addr),
+           &cachedPage.data[copyStart - page],
+           copyEnd - copyStart);
+    cacheUse.splice(cacheUse.begin(), cacheUse, cachedPage.use);
+  }
+
+  XDMF_dsm_cache_evict();
+  return SUCCEED;
+}
+
 static herr_t
 XDMF_dsm_read(H5FD_t *_file, H5FD_mem_t UNUSED type, hid_t UNUSED dxpl_id,
     haddr_t addr, size_t size, void *buf /* out */)
@@ -926,30 +1065,33 @@ XDMF_dsm_read(H5FD_t *_file, H5FD_mem_t UNUSED type, hid_t UNUSED dxpl_id,
     nbytes = MIN(size,(size_t)temp_nbytes);
 
 
-    if (((XdmfDSMBuffer *)xdmf_dsm_get_manager())->GetDsmType() == XDMF_DSM_TYPE_BLOCK_CYCLIC ||
-        ((XdmfDSMBuffer *)xdmf_dsm_get_manager())->GetDsmType() == XDMF_DSM_TYPE_BLOCK_RANDOM)
+    int dsmType = ((XdmfDSMBuffer *)xdmf_dsm_get_manager())->GetDsmType();
+    if (dsmType != XDMF_DSM_TYPE_BLOCK_CYCLIC &&
+        dsmType != XDMF_DSM_TYPE_BLOCK_RANDOM &&
+        dsmType != XDMF_DSM_TYPE_UNIFORM &&
+        dsmType != XDMF_DSM_TYPE_UNIFORM_RANGE)
     {
-      xdmf_dsm_read_pages(&(filePages[file->name][0]), file->numPages, addr, nbytes, buf);
+      HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "invalid DSM type")
+    }
+
+    ++statReads;
+    statBytesRead += nbytes;
+
+    /* Read from DSM to BUF, small reads such as metadata go through the cache */
+    herr_t read_code;
+    if (file->read_only && cacheSize > 0 && nbytes <= XDMF_DSM_CACHE_MAX_READ) {
+      read_code = XDMF_dsm_cache_read(file, addr, nbytes, buf);
+    }
+    else {
+      read_code = XDMF_dsm_read_file(file, addr, nbytes, buf);
+    }
+    if (SUCCEED != read_code) {
+      HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "cannot read from DSM")
+    } else {
       size -= nbytes;
       addr += nbytes;
       buf = (char*) buf + nbytes;
     }
-    else if (((XdmfDSMBuffer *)xdmf_dsm_get_manager())->GetDsmType() == XDMF_DSM_TYPE_UNIFORM ||
-             ((XdmfDSMBuffer *)xdmf_dsm_get_manager())->GetDsmType() == XDMF_DSM_TYPE_UNIFORM_RANGE)
-    {
-      /* Read from DSM to BUF */
-      if (SUCCEED != xdmf_dsm_read(file->start + addr, nbytes, buf)) {
-        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "cannot read from DSM")
-      } else {
-        size -= nbytes;
-        addr += nbytes;
-        buf = (char*) buf + nbytes;
-      }
-    }
-    else
-    {
-      HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "invalid DSM type")
-    }
   }
   /* Read zeros for the part which is after the EOF markers */
   if (size > 0) HDmemset(buf, 0, size);
@@ -992,6 +1134,9 @@ XDMF_dsm_write(H5FD_t *_file, H5FD_mem_t type, hid_t UNUSED dxpl_id,
   if (addr + size > file->eof)
     HGOTO_ERROR(H5E_IO, H5E_NOSPACE, FAIL, "not enough space in DSM")
 
+  ++statWrites;
+  statBytesWritten += size;
+
   if (((XdmfDSMBuffer *)xdmf_dsm_get_manager())->GetDsmType() == XDMF_DSM_TYPE_BLOCK_CYCLIC ||
       ((XdmfDSMBuffer *)xdmf_dsm_get_manager())->GetDsmType() == XDMF_DSM_TYPE_BLOCK_RANDOM)
   {
@@ -1225,7 +1370,8 @@ xdmf_dsm_lock(char * filename)
     }
   }
 
-  return(SUCCEED);
+  // Others may have written to the file before the lock was acquired
+  return xdmf_dsm_invalidate_cache(filename);
 }
 
 herr_t
@@ -1243,6 +1389,69 @@ xdmf_dsm_unlock(char * filename, unsigned long flag)
   return(SUCCEED);
 }
 
+herr_t
+xdmf_dsm_set_cache_size(size_t size)
+{
+  cacheSize = size;
+  XDMF_dsm_cache_evict();
+  return(SUCCEED);
+}
+
+size_t
+xdmf_dsm_get_cache_size()
+{
+  return cacheSize;
+}
+
+herr_t
+xdmf_dsm_invalidate_cache(const char * filename)
+{
+  if (filename == NULL) {
+    cachePages.clear();
+    cacheUse.clear();
+    cacheUsed = 0;
+    return(SUCCEED);
+  }
+  const std::string name(filename);
+  std::map<XdmfDSMCacheKey, XdmfDSMCachePage>::iterator page =
+    cachePages.lower_bound(XdmfDSMCacheKey(name, 0));
+  while (page != cachePages.end() && page->first.first == name) {
+    std::map<XdmfDSMCacheKey, XdmfDSMCachePage>::iterator next = page;
+    ++next;
+    XDMF_dsm_cache_erase(page);
+    page = next;
+  }
+  return(SUCCEED);
+}
+
+herr_t
+xdmf_dsm_get_statistics(unsigned long * reads,
+                        unsigned long * bytes_read,
+                        unsigned long * writes,
+                        unsigned long * bytes_written,
+                        unsigned long * cache_hits,
+                        unsigned long * cache_misses)
+{
+  if (reads) *reads = statReads;
+  if (bytes_read) *bytes_read = statBytesRead;
+  if (writes) *writes = statWrites;
+  if (bytes_written) *bytes_written = statBytesWritten;
+  if (cache_hits) *cache_hits = statCacheHits;
+  if (cache_misses) *cache_misses = statCacheMisses;
+  return(SUCCEED);
+}
+
+herr_t
+xdmf_dsm_reset_statistics()
+{
+  statReads = 0;
+  statBytesRead = 0;
+  statWrites = 0;
+  statBytesWritten = 0;
+  statCacheHits = 0;
+  statCacheMisses = 0;
+  return(SUCCEED);
+}
 
 // When writing and reading, we want to provide a list of pages that the file contains.
 // The appropriate subsections can be retrieved from the pages this way.
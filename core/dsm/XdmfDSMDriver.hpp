@@ -138,6 +138,24 @@ extern "C" {
   XDMFDSM_EXPORT herr_t  xdmf_dsm_lock(char * filename);
   XDMFDSM_EXPORT herr_t  xdmf_dsm_unlock(char * filename, unsigned long flag);
 
+  // Pages read from files opened read-only are cached on each client
+  // until the file is written, or is found to have been registered
+  // again by any core when it is next opened.
+  // A size of 0 (the default) disables the cache.
+  XDMFDSM_EXPORT herr_t  xdmf_dsm_set_cache_size(size_t size);
+  XDMFDSM_EXPORT size_t  xdmf_dsm_get_cache_size();
+  // Drops the cached pages of a file, or of every file if NULL
+  XDMFDSM_EXPORT herr_t  xdmf_dsm_invalidate_cache(const char * filename);
+
+  // Counts of the reads and writes HDF5 made through the driver on
+  // this core and of the cached reads, any argument may be NULL.
+  // The transfers below the driver are counted by the buffer.
+  XDMFDSM_EXPORT herr_t  xdmf_dsm_get_statistics(unsigned long * reads,
+      unsigned long * bytes_read, unsigned long * writes,
+      unsigned long * bytes_written, unsigned long * cache_hits,
+      unsigned long * cache_misses);
+  XDMFDSM_EXPORT herr_t  xdmf_dsm_reset_statistics();
+
   XDMFDSM_EXPORT herr_t  xdmf_dsm_read(haddr_t addr, size_t len, void *buf_ptr);
   XDMFDSM_EXPORT herr_t  xdmf_dsm_read_pages(unsigned int * pages, unsigned int numPages, haddr_t addr, size_t len, void *buf_ptr);
   XDMFDSM_EXPORT herr_t  xdmf_dsm_write(haddr_t addr, size_t len, const void *buf_ptr);
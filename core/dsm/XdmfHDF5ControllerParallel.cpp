@@ -0,0 +1,367 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfHDF5ControllerParallel.cpp                                      */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <hdf5.h>
+#include <functional>
+#include <numeric>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfError.hpp"
+#include "XdmfHDF5ControllerParallel.hpp"
+
+namespace {
+
+  hid_t
+  getDatatype(const shared_ptr<const XdmfArrayType> type)
+  {
+    if(type == XdmfArrayType::Int8()) {
+      return H5T_NATIVE_CHAR;
+    }
+    else if(type == XdmfArrayType::Int16()) {
+      return H5T_NATIVE_SHORT;
+    }
+    else if(type == XdmfArrayType::Int32()) {
+      return H5T_NATIVE_INT;
+    }
+    else if(type == XdmfArrayType::Int64()) {
+      return H5T_NATIVE_LONG;
+    }
+    else if(type == XdmfArrayType::Float32()) {
+      return H5T_NATIVE_FLOAT;
+    }
+    else if(type == XdmfArrayType::Float64()) {
+      return H5T_NATIVE_DOUBLE;
+    }
+    else if(type == XdmfArrayType::UInt8()) {
+      return H5T_NATIVE_UCHAR;
+    }
+    else if(type == XdmfArrayType::UInt16()) {
+      return H5T_NATIVE_USHORT;
+    }
+    else if(type == XdmfArrayType::UInt32()) {
+      return H5T_NATIVE_UINT;
+    }
+    return -1;
+  }
+
+}
+
+shared_ptr<XdmfHDF5ControllerParallel>
+XdmfHDF5ControllerParallel::New(const std::string & hdf5FilePath,
+                                const std::string & dataSetPath,
+                                const shared_ptr<const XdmfArrayType> & type,
+                                const std::vector<unsigned int> & start,
+                                const std::vector<unsigned int> & stride,
+                                const std::vector<unsigned int> & dimensions,
+                                const std::vector<unsigned int> & dataspaceDimensions,
+                                MPI_Comm comm)
+{
+  shared_ptr<XdmfHDF5ControllerParallel>
+    p(new XdmfHDF5ControllerParallel(hdf5FilePath,
+                                     dataSetPath,
+                                     type,
+                                     start,
+                                     stride,
+                                     dimensions,
+                                     dataspaceDimensions,
+                                     comm));
+  return p;
+}
+
+shared_ptr<XdmfHDF5ControllerParallel>
+XdmfHDF5ControllerParallel::New(const shared_ptr<XdmfHDF5Controller> & controller,
+                                MPI_Comm comm)
+{
+  shared_ptr<XdmfHDF5ControllerParallel>
+    p(new XdmfHDF5ControllerParallel(controller->getFilePath(),
+                                     controller->getDataSetPath(),
+                                     controller->getType(),
+                                     controller->getStart(),
+                                     controller->getStride(),
+                                     controller->getDimensions(),
+                                     controller->getDataspaceDimensions(),
+                                     comm));
+  p->setArrayOffset(controller->getArrayOffset());
+  return p;
+}
+
+XdmfHDF5ControllerParallel::XdmfHDF5ControllerParallel(const std::string & hdf5FilePath,
+                                                       const std::string & dataSetPath,
+                                                       const shared_ptr<const XdmfArrayType> & type,
+                                                       const std::vector<unsigned int> & start,
+                                                       const std::vector<unsigned int> & stride,
+                                                       const std::vector<unsigned int> & dimensions,
+                                                       const std::vector<unsigned int> & dataspaceDimensions,
+                                                       MPI_Comm comm) :
+  XdmfHDF5Controller(hdf5FilePath,
+                     dataSetPath,
+                     type,
+                     start,
+                     stride,
+                     dimensions,
+                     dataspaceDimensions),
+  mComm(comm)
+{
+}
+
+XdmfHDF5ControllerParallel::XdmfHDF5ControllerParallel(const XdmfHDF5ControllerParallel & refController):
+  XdmfHDF5Controller(refController),
+  mComm(refController.getComm())
+{
+}
+
+XdmfHDF5ControllerParallel::~XdmfHDF5ControllerParallel()
+{
+}
+
+MPI_Comm
+XdmfHDF5ControllerParallel::getComm() const
+{
+  return mComm;
+}
+
+std::vector<unsigned int>
+XdmfHDF5ControllerParallel::getLocalDimensions() const
+{
+  std::vector<unsigned int> localDimensions = mDimensions;
+  if(localDimensions.size() > 0) {
+    int rank;
+    int numberCores;
+    MPI_Comm_rank(mComm, &rank);
+    MPI_Comm_size(mComm, &numberCores);
+    localDimensions[0] = mDimensions[0] / numberCores;
+    if((unsigned int)rank < mDimensions[0] % numberCores) {
+      ++localDimensions[0];
+    }
+  }
+  return localDimensions;
+}
+
+std::vector<unsigned int>
+XdmfHDF5ControllerParallel::getLocalStart() const
+{
+  std::vector<unsigned int> localStart(mDimensions.size(), 0);
+  if(localStart.size() > 0) {
+    int rank;
+    int numberCores;
+    MPI_Comm_rank(mComm, &rank);
+    MPI_Comm_size(mComm, &numberCores);
+    // Lower ranks hold one more when the shares are uneven
+    localStart[0] = rank * (mDimensions[0] / numberCores) +
+      std::min((unsigned int)rank, mDimensions[0] % numberCores);
+  }
+  return localStart;
+}
+
+std::vector<unsigned int>
+XdmfHDF5ControllerParallel::getReadDimensions() const
+{
+  return this->getLocalDimensions();
+}
+
+void
+XdmfHDF5ControllerParallel::read(XdmfArray * const array)
+{
+  const hid_t datatype = getDatatype(mType);
+  if(datatype == -1) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Array of unsupported type in "
+                       "XdmfHDF5ControllerParallel::read");
+  }
+
+  herr_t status;
+
+  // Every core opens the file together
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+#ifdef H5_HAVE_PARALLEL
+  status = H5Pset_fapl_mpio(fapl, mComm, MPI_INFO_NULL);
+#else
+  status = H5Pclose(fapl);
+  XdmfError::message(XdmfError::FATAL,
+                     "hdf5 was built without parallel IO support in "
+                     "XdmfHDF5ControllerParallel::read");
+#endif
+  hid_t hdf5Handle = H5Fopen(mFilePath.c_str(), H5F_ACC_RDONLY, fapl);
+  status = H5Pclose(fapl);
+
+  if(hdf5Handle < 0) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Could not open " + mFilePath + " in "
+                       "XdmfHDF5ControllerParallel::read");
+  }
+
+  const hid_t dataset = H5Dopen(hdf5Handle,
+                                this->getDataSetPath().c_str(),
+                                H5P_DEFAULT);
+  if(dataset < 0) {
+    status = H5Fclose(hdf5Handle);
+    XdmfError::message(XdmfError::FATAL,
+                       "Could not open dataset " + this->getDataSetPath() +
+                       " in XdmfHDF5ControllerParallel::read");
+  }
+
+  const hid_t dataspace = H5Dget_space(dataset);
+
+  if((unsigned int)H5Sget_simple_extent_ndims(dataspace) != mDimensions.size()) {
+    status = H5Sclose(dataspace);
+    status = H5Dclose(dataset);
+    status = H5Fclose(hdf5Handle);
+    XdmfError::message(XdmfError::FATAL,
+                       "Number of dimensions in light data description in "
+                       "Xdmf does not match number of dimensions in hdf5 "
+                       "file in XdmfHDF5ControllerParallel::read");
+  }
+
+  // Select the share of this core from the first dimension
+  const std::vector<unsigned int> localStart = this->getLocalStart();
+  const std::vector<unsigned int> localDimensions = this->getLocalDimensions();
+  const unsigned int numberValues =
+    std::accumulate(localDimensions.begin(),
+                    localDimensions.end(),
+                    1,
+                    std::multiplies<unsigned int>());
+
+  array->initialize(mType, localDimensions);
+
+  hid_t memspace;
+  if(numberValues > 0) {
+    std::vector<hsize_t> start(mStart.begin(), mStart.end());
+    const std::vector<hsize_t> stride(mStride.begin(), mStride.end());
+    const std::vector<hsize_t> count(localDimensions.begin(),
+                                     localDimensions.end());
+    start[0] += (hsize_t)localStart[0] * stride[0];
+    status = H5Sselect_hyperslab(dataspace,
+                                 H5S_SELECT_SET,
+                                 &start[0],
+                                 &stride[0],
+                                 &count[0],
+                                 NULL);
+    memspace = H5Screate_simple(count.size(), &count[0], NULL);
+  }
+  else {
+    status = H5Sselect_none(dataspace);
+    memspace = H5Screate(H5S_SCALAR);
+    status = H5Sselect_none(memspace);
+  }
+
+  char noValues;
+  hid_t transfer = H5Pcreate(H5P_DATASET_XFER);
+#ifdef H5_HAVE_PARALLEL
+  status = H5Pset_dxpl_mpio(transfer, H5FD_MPIO_COLLECTIVE);
+#endif
+  herr_t readStatus = H5Dread(dataset,
+                              datatype,
+                              memspace,
+                              dataspace,
+                              transfer,
+                              numberValues > 0 ?
+                                array->getValuesInternal() : &noValues);
+
+  status = H5Pclose(transfer);
+  status = H5Sclose(memspace);
+  status = H5Sclose(dataspace);
+  status = H5Dclose(dataset);
+  status = H5Fclose(hdf5Handle);
+
+  if(readStatus < 0) {
+    XdmfError::message(XdmfError::FATAL,
+                       "H5Dread returned failure in "
+                       "XdmfHDF5ControllerParallel::read");
+  }
+}
+
+// C Wrappers
+
+XDMFHDF5CONTROLLERPARALLEL * XdmfHDF5ControllerParallelNew(char * hdf5FilePath,
+                                                           char * dataSetPath,
+                                                           int type,
+                                                           unsigned int * start,
+                                                           unsigned int * stride,
+                                                           unsigned int * dimensions,
+                                                           unsigned int * dataspaceDimensions,
+                                                           unsigned int numDims,
+                                                           MPI_Comm comm,
+                                                           int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  std::vector<unsigned int> startVector(start, start + numDims);
+  std::vector<unsigned int> strideVector(stride, stride + numDims);
+  std::vector<unsigned int> dimVector(dimensions, dimensions + numDims);
+  std::vector<unsigned int> dataspaceVector(dataspaceDimensions, dataspaceDimensions + numDims);
+  shared_ptr<const XdmfArrayType> buildType = shared_ptr<XdmfArrayType>();
+  switch (type) {
+    case XDMF_ARRAY_TYPE_UINT8:
+      buildType = XdmfArrayType::UInt8();
+      break;
+    case XDMF_ARRAY_TYPE_UINT16:
+      buildType = XdmfArrayType::UInt16();
+      break;
+    case XDMF_ARRAY_TYPE_UINT32:
+      buildType = XdmfArrayType::UInt32();
+      break;
+    case XDMF_ARRAY_TYPE_INT8:
+      buildType = XdmfArrayType::Int8();
+      break;
+    case XDMF_ARRAY_TYPE_INT16:
+      buildType = XdmfArrayType::Int16();
+      break;
+    case XDMF_ARRAY_TYPE_INT32:
+      buildType = XdmfArrayType::Int32();
+      break;
+    case XDMF_ARRAY_TYPE_INT64:
+      buildType = XdmfArrayType::Int64();
+      break;
+    case XDMF_ARRAY_TYPE_FLOAT32:
+      buildType = XdmfArrayType::Float32();
+      break;
+    case XDMF_ARRAY_TYPE_FLOAT64:
+      buildType = XdmfArrayType::Float64();
+      break;
+    default:
+      XdmfError::message(XdmfError::FATAL,
+                         "Error: Invalid ArrayType.");
+      break;
+  }
+  shared_ptr<XdmfHDF5ControllerParallel> generatedController =
+    XdmfHDF5ControllerParallel::New(std::string(hdf5FilePath),
+                                    std::string(dataSetPath),
+                                    buildType,
+                                    startVector,
+                                    strideVector,
+                                    dimVector,
+                                    dataspaceVector,
+                                    comm);
+  return (XDMFHDF5CONTROLLERPARALLEL *)((void *)(new XdmfHDF5ControllerParallel(*generatedController.get())));
+  XDMF_ERROR_WRAP_END(status)
+  return NULL;
+}
+
+MPI_Comm XdmfHDF5ControllerParallelGetComm(XDMFHDF5CONTROLLERPARALLEL * controller)
+{
+  return ((XdmfHDF5ControllerParallel *) controller)->getComm();
+}
+
+// C Wrappers for parent classes are generated by macros
+
+XDMF_HEAVYCONTROLLER_C_CHILD_WRAPPER(XdmfHDF5ControllerParallel, XDMFHDF5CONTROLLERPARALLEL)
+XDMF_HDF5CONTROLLER_C_CHILD_WRAPPER(XdmfHDF5ControllerParallel, XDMFHDF5CONTROLLERPARALLEL)
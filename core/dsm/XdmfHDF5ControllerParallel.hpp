@@ -0,0 +1,286 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfHDF5ControllerParallel.hpp                                      */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef XDMFHDF5CONTROLLERPARALLEL_HPP_
+#define XDMFHDF5CONTROLLERPARALLEL_HPP_
+
+// C Compatible Includes
+#include "XdmfDSM.hpp"
+#include "XdmfHDF5Controller.hpp"
+#include <mpi.h>
+
+#ifdef __cplusplus
+
+/**
+ * @brief Couples an XdmfArray with a share of HDF5 data read
+ * collectively by all cores of a communicator.
+ *
+ * Every core of the communicator opens the hdf5 file with the MPI-IO
+ * driver and reads a share of the selection with a collective
+ * H5Dread. The first dimension of the selection is divided between
+ * the cores in rank order, as evenly as possible, with lower ranks
+ * taking one more when it does not divide evenly. The other
+ * dimensions are read whole. After reading, each array holds only the
+ * share of its core and has the dimensions returned by
+ * getLocalDimensions(), which getReadDimensions() reports to the array.
+ *
+ * Reading is collective. Every core of the communicator must read
+ * the same selection at the same time, cores with an empty share
+ * included. String datasets can not be read. Requires an hdf5 library
+ * built with parallel IO support.
+ */
+class XDMFDSM_EXPORT XdmfHDF5ControllerParallel : public XdmfHDF5Controller {
+
+public:
+
+  virtual ~XdmfHDF5ControllerParallel();
+
+  /**
+   * Create a new controller for an hdf5 data set read collectively.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5ControllerParallel.cpp
+   * @skipline //#initMPI
+   * @until //#initMPI
+   * @skipline //#initialization
+   * @until //#initialization
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5ControllerParallel.py
+   * @skipline #//initMPI
+   * @until #//initMPI
+   * @skipline #//initialization
+   * @until #//initialization
+   *
+   * @param     hdf5FilePath            The path to the hdf5 file that the
+   *                                    controller will be accessing
+   * @param     dataSetPath             The location of the dataset within
+   *                                    the hdf5 file
+   * @param     type                    The data type of the dataset to read
+   * @param     start                   The offset of the starting element
+   *                                    in each dimension in the hdf5 data set
+   * @param     stride                  The number of elements to move in
+   *                                    each dimension from the hdf5 data set
+   * @param     dimensions              The number of elements to select in
+   *                                    each dimension from the hdf5 data
+   *                                    set, shared between the cores
+   * @param     dataspaceDimensions     The number of elements in the
+   *                                    entire hdf5 data set
+   * @param     comm                    The communicator of the cores
+   *                                    reading the data set
+   * @return                            New HDF5 Controller.
+   */
+  static shared_ptr<XdmfHDF5ControllerParallel>
+  New(const std::string & hdf5FilePath,
+      const std::string & dataSetPath,
+      const shared_ptr<const XdmfArrayType> & type,
+      const std::vector<unsigned int> & start,
+      const std::vector<unsigned int> & stride,
+      const std::vector<unsigned int> & dimensions,
+      const std::vector<unsigned int> & dataspaceDimensions,
+      MPI_Comm comm);
+
+  /**
+   * Create a new controller reading the selection of an existing
+   * controller collectively, such as one attached by XdmfReader.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5ControllerParallel.cpp
+   * @skipline //#initMPI
+   * @until //#initMPI
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#initializationcontroller
+   * @until //#initializationcontroller
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5ControllerParallel.py
+   * @skipline #//initMPI
+   * @until #//initMPI
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//initializationcontroller
+   * @until #//initializationcontroller
+   *
+   * @param     controller      The controller whose selection is read
+   * @param     comm            The communicator of the cores reading the
+   *                            data set
+   * @return                    New HDF5 Controller.
+   */
+  static shared_ptr<XdmfHDF5ControllerParallel>
+  New(const shared_ptr<XdmfHDF5Controller> & controller,
+      MPI_Comm comm);
+
+  /**
+   * Gets the communicator of the cores reading the data set.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5ControllerParallel.cpp
+   * @skipline //#initMPI
+   * @until //#initMPI
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#getComm
+   * @until //#getComm
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5ControllerParallel.py
+   * @skipline #//initMPI
+   * @until #//initMPI
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//getComm
+   * @until #//getComm
+   *
+   * @return    The communicator of the reading cores.
+   */
+  MPI_Comm getComm() const;
+
+  /**
+   * Gets the number of elements in each dimension of the share read by
+   * this core.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5ControllerParallel.cpp
+   * @skipline //#initMPI
+   * @until //#initMPI
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#getLocalDimensions
+   * @until //#getLocalDimensions
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5ControllerParallel.py
+   * @skipline #//initMPI
+   * @until #//initMPI
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//getLocalDimensions
+   * @until #//getLocalDimensions
+   *
+   * @return    The dimensions of the share of this core.
+   */
+  std::vector<unsigned int> getLocalDimensions() const;
+
+  /**
+   * Gets the offset in each dimension of the share read by this core,
+   * counted in elements of the selection.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5ControllerParallel.cpp
+   * @skipline //#initMPI
+   * @until //#initMPI
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#getLocalStart
+   * @until //#getLocalStart
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5ControllerParallel.py
+   * @skipline #//initMPI
+   * @until #//initMPI
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//getLocalStart
+   * @until #//getLocalStart
+   *
+   * @return    The offset of the share of this core.
+   */
+  std::vector<unsigned int> getLocalStart() const;
+
+  std::vector<unsigned int> getReadDimensions() const;
+
+  virtual void read(XdmfArray * const array);
+
+  XdmfHDF5ControllerParallel(const XdmfHDF5ControllerParallel &);
+
+protected:
+
+  XdmfHDF5ControllerParallel(const std::string & hdf5FilePath,
+                             const std::string & dataSetPath,
+                             const shared_ptr<const XdmfArrayType> & type,
+                             const std::vector<unsigned int> & start,
+                             const std::vector<unsigned int> & stride,
+                             const std::vector<unsigned int> & dimensions,
+                             const std::vector<unsigned int> & dataspaceDimensions,
+                             MPI_Comm comm);
+
+private:
+
+  void operator=(const XdmfHDF5ControllerParallel &);  // Not implemented.
+
+  MPI_Comm mComm;
+};
+
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C wrappers go here
+
+struct XDMFHDF5CONTROLLERPARALLEL; // Simply as a typedef to ensure correct typing
+typedef struct XDMFHDF5CONTROLLERPARALLEL XDMFHDF5CONTROLLERPARALLEL;
+
+XDMFDSM_EXPORT XDMFHDF5CONTROLLERPARALLEL * XdmfHDF5ControllerParallelNew(char * hdf5FilePath,
+                                                                          char * dataSetPath,
+                                                                          int type,
+                                                                          unsigned int * start,
+                                                                          unsigned int * stride,
+                                                                          unsigned int * dimensions,
+                                                                          unsigned int * dataspaceDimensions,
+                                                                          unsigned int numDims,
+                                                                          MPI_Comm comm,
+                                                                          int * status);
+
+XDMFDSM_EXPORT MPI_Comm XdmfHDF5ControllerParallelGetComm(XDMFHDF5CONTROLLERPARALLEL * controller);
+
+XDMF_HEAVYCONTROLLER_C_CHILD_DECLARE(XdmfHDF5ControllerParallel, XDMFHDF5CONTROLLERPARALLEL, XDMFDSM)
+XDMF_HDF5CONTROLLER_C_CHILD_DECLARE(XdmfHDF5ControllerParallel, XDMFHDF5CONTROLLERPARALLEL, XDMFDSM)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XDMFHDF5CONTROLLERPARALLEL_HPP_ */
@@ -1109,7 +1109,10 @@ XdmfHDF5WriterDSM::waitRelease(std::string fileName, std::string datasetName, in
 int
 XdmfHDF5WriterDSM::waitOn(std::string fileName, std::string datasetName)
 {
-  return mDSMServerBuffer->WaitOn(fileName, datasetName);
+  int returnCode = mDSMServerBuffer->WaitOn(fileName, datasetName);
+  // The notification means the file was changed by someone else
+  xdmf_dsm_invalidate_cache(fileName.c_str());
+  return returnCode;
 }
 
 // C Wrappers
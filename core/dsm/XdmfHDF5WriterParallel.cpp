@@ -0,0 +1,442 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfHDF5WriterParallel.cpp                                          */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <hdf5.h>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <sstream>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfError.hpp"
+#include "XdmfHDF5Controller.hpp"
+#include "XdmfHDF5WriterParallel.hpp"
+
+namespace {
+
+  // Types that can be written, in an order the cores agree on
+  std::vector<shared_ptr<const XdmfArrayType> >
+  getWritableTypes()
+  {
+    std::vector<shared_ptr<const XdmfArrayType> > types;
+    types.push_back(XdmfArrayType::Int8());
+    types.push_back(XdmfArrayType::Int16());
+    types.push_back(XdmfArrayType::Int32());
+    types.push_back(XdmfArrayType::Int64());
+    types.push_back(XdmfArrayType::Float32());
+    types.push_back(XdmfArrayType::Float64());
+    types.push_back(XdmfArrayType::UInt8());
+    types.push_back(XdmfArrayType::UInt16());
+    types.push_back(XdmfArrayType::UInt32());
+    return types;
+  }
+
+  hid_t
+  getDatatype(const shared_ptr<const XdmfArrayType> type)
+  {
+    if(type == XdmfArrayType::Int8()) {
+      return H5T_NATIVE_CHAR;
+    }
+    else if(type == XdmfArrayType::Int16()) {
+      return H5T_NATIVE_SHORT;
+    }
+    else if(type == XdmfArrayType::Int32()) {
+      return H5T_NATIVE_INT;
+    }
+    else if(type == XdmfArrayType::Int64()) {
+      return H5T_NATIVE_LONG;
+    }
+    else if(type == XdmfArrayType::Float32()) {
+      return H5T_NATIVE_FLOAT;
+    }
+    else if(type == XdmfArrayType::Float64()) {
+      return H5T_NATIVE_DOUBLE;
+    }
+    else if(type == XdmfArrayType::UInt8()) {
+      return H5T_NATIVE_UCHAR;
+    }
+    else if(type == XdmfArrayType::UInt16()) {
+      return H5T_NATIVE_USHORT;
+    }
+    else if(type == XdmfArrayType::UInt32()) {
+      return H5T_NATIVE_UINT;
+    }
+    return -1;
+  }
+
+}
+
+XdmfHDF5WriterParallel::XdmfHDF5WriterParallelImpl::XdmfHDF5WriterParallelImpl(MPI_Comm comm):
+  XdmfHDF5WriterImpl(),
+  mComm(comm)
+{
+};
+
+XdmfHDF5WriterParallel::XdmfHDF5WriterParallelImpl::~XdmfHDF5WriterParallelImpl()
+{
+  closeFile();
+};
+
+int
+XdmfHDF5WriterParallel::XdmfHDF5WriterParallelImpl::openFile(const std::string & filePath,
+                                                             const int mDataSetId)
+{
+  if(mHDF5Handle >= 0) {
+    closeFile();
+  }
+  // Save old error handler and turn off error handling for now
+  H5E_auto_t old_func;
+  void * old_client_data;
+  H5Eget_auto(0, &old_func, &old_client_data);
+  H5Eset_auto2(0, NULL, NULL);
+
+  int toReturn = 0;
+
+  mOpenFile.assign(filePath);
+
+  // Every core has to either open or create the file
+  int rank;
+  MPI_Comm_rank(mComm, &rank);
+  int fileExists = 0;
+  if(rank == 0) {
+    fileExists = H5Fis_hdf5(filePath.c_str()) > 0;
+  }
+  MPI_Bcast(&fileExists, 1, MPI_INT, 0, mComm);
+
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+#ifdef H5_HAVE_PARALLEL
+  H5Pset_fapl_mpio(fapl, mComm, MPI_INFO_NULL);
+#else
+  H5Pclose(fapl);
+  H5Eset_auto2(0, old_func, old_client_data);
+  XdmfError::message(XdmfError::FATAL,
+                     "hdf5 was built without parallel IO support in "
+                     "XdmfHDF5WriterParallel::openFile");
+#endif
+
+  if(fileExists) {
+    mHDF5Handle = H5Fopen(filePath.c_str(),
+                          H5F_ACC_RDWR,
+                          fapl);
+    if(mDataSetId == 0) {
+      hsize_t numObjects;
+      /*herr_t status = */H5Gget_num_objs(mHDF5Handle,
+                                          &numObjects);
+      toReturn = numObjects;
+    }
+    else {
+      toReturn = mDataSetId;
+    }
+  }
+  else {
+    mHDF5Handle = H5Fcreate(filePath.c_str(),
+                            H5F_ACC_TRUNC,
+                            H5P_DEFAULT,
+                            fapl);
+  }
+
+  H5Pclose(fapl);
+
+  // Restore previous error handler
+  H5Eset_auto2(0, old_func, old_client_data);
+
+  return toReturn;
+}
+
+shared_ptr<XdmfHDF5WriterParallel>
+XdmfHDF5WriterParallel::New(const std::string & filePath,
+                            MPI_Comm comm,
+                            const bool clobberFile)
+{
+  if(clobberFile) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if(rank == 0) {
+      std::remove(filePath.c_str());
+    }
+    MPI_Barrier(comm);
+  }
+  shared_ptr<XdmfHDF5WriterParallel> p(new XdmfHDF5WriterParallel(filePath,
+                                                                  comm));
+  return p;
+}
+
+XdmfHDF5WriterParallel::XdmfHDF5WriterParallel(const std::string & filePath,
+                                               MPI_Comm comm) :
+  XdmfHDF5Writer(filePath),
+  mComm(comm)
+{
+  delete mImpl;
+  mImpl = new XdmfHDF5WriterParallelImpl(mComm);
+}
+
+XdmfHDF5WriterParallel::XdmfHDF5WriterParallel(XdmfHDF5WriterParallel & refWriter) :
+  XdmfHDF5Writer(refWriter),
+  mComm(refWriter.getComm())
+{
+  delete mImpl;
+  mImpl = new XdmfHDF5WriterParallelImpl(mComm);
+}
+
+XdmfHDF5WriterParallel::~XdmfHDF5WriterParallel()
+{
+}
+
+MPI_Comm
+XdmfHDF5WriterParallel::getComm() const
+{
+  return mComm;
+}
+
+void
+XdmfHDF5WriterParallel::visit(XdmfArray & array,
+                              const shared_ptr<XdmfBaseVisitor> visitor)
+{
+  mImpl->mDepth++;
+  std::set<const XdmfItem *>::iterator checkWritten = mImpl->mWrittenItems.find(&array);
+  if (checkWritten == mImpl->mWrittenItems.end()) {
+    array.traverse(visitor);
+    // Cores without values still take part in the collective write
+    this->write(array);
+    mImpl->mWrittenItems.insert(&array);
+  }
+  mImpl->mDepth--;
+  if(mImpl->mDepth <= 0) {
+    mImpl->mWrittenItems.clear();
+  }
+}
+
+void
+XdmfHDF5WriterParallel::write(XdmfArray & array)
+{
+  if(mMode != Default) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Only the Default mode is supported in "
+                       "XdmfHDF5WriterParallel::write");
+  }
+
+  const std::vector<shared_ptr<const XdmfArrayType> > types =
+    getWritableTypes();
+
+  // Cores without values take the type from the others, the maximum of
+  // the negated index is the minimum index
+  unsigned long long localSize = 0;
+  int localType[2] = {-1, -(int)types.size() - 1};
+  if(array.isInitialized() && array.getSize() > 0) {
+    localSize = array.getSize();
+    localType[0] = std::find(types.begin(),
+                             types.end(),
+                             array.getArrayType()) - types.begin();
+    localType[1] = -localType[0];
+  }
+  int type[2];
+  MPI_Allreduce(localType, type, 2, MPI_INT, MPI_MAX, mComm);
+
+  if(type[0] < 0) {
+    // No core has values to write
+    return;
+  }
+  if(type[0] != -type[1]) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Array has a different type on each core in "
+                       "XdmfHDF5WriterParallel::write");
+  }
+  if(type[0] >= (int)types.size()) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Array of unsupported type in "
+                       "XdmfHDF5WriterParallel::write");
+  }
+  const shared_ptr<const XdmfArrayType> arrayType = types[type[0]];
+  const hid_t datatype = getDatatype(arrayType);
+
+  // Values are ordered by rank in the dataset
+  int rank;
+  int numberCores;
+  MPI_Comm_rank(mComm, &rank);
+  MPI_Comm_size(mComm, &numberCores);
+  std::vector<unsigned long long> sizes(numberCores);
+  MPI_Allgather(&localSize,
+                1,
+                MPI_UNSIGNED_LONG_LONG,
+                &sizes[0],
+                1,
+                MPI_UNSIGNED_LONG_LONG,
+                mComm);
+  hsize_t offset = 0;
+  hsize_t totalSize = 0;
+  for(int i = 0; i < numberCores; ++i) {
+    if(i < rank) {
+      offset += sizes[i];
+    }
+    totalSize += sizes[i];
+  }
+
+  // Controllers hold their extents as unsigned int
+  if(totalSize > UINT_MAX) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Dataset too large for an XdmfHDF5Controller in "
+                       "XdmfHDF5WriterParallel::write");
+  }
+
+  bool closeFile = false;
+  if(mImpl->mOpenFile.compare(mFilePath) != 0) {
+    if(mImpl->mHDF5Handle < 0) {
+      closeFile = true;
+    }
+    mImpl->openFile(mFilePath,
+                    mDataSetId);
+  }
+
+  if(mImpl->mHDF5Handle < 0) {
+    XdmfError::message(XdmfError::FATAL,
+                       "Could not open " + mFilePath + " in "
+                       "XdmfHDF5WriterParallel::write");
+  }
+
+  // Find an unused dataset name
+  std::stringstream dataSetPath;
+  dataSetPath << "Data" << mDataSetId;
+  while(H5Lexists(mImpl->mHDF5Handle,
+                  dataSetPath.str().c_str(),
+                  H5P_DEFAULT) > 0) {
+    dataSetPath.str(std::string());
+    dataSetPath << "Data" << ++mDataSetId;
+  }
+
+  herr_t status;
+  hid_t dataspace = H5Screate_simple(1, &totalSize, NULL);
+  hid_t property = H5Pcreate(H5P_DATASET_CREATE);
+  if(mUseDeflate) {
+    // Filtered datasets must be chunked
+    hsize_t chunkSize = std::min((hsize_t)mImpl->mChunkSize, totalSize);
+    if(chunkSize == 0) {
+      chunkSize = 1;
+    }
+    status = H5Pset_chunk(property, 1, &chunkSize);
+    status = H5Pset_deflate(property, mDeflateFactor);
+  }
+  hid_t dataset = H5Dcreate(mImpl->mHDF5Handle,
+                            dataSetPath.str().c_str(),
+                            datatype,
+                            dataspace,
+                            H5P_DEFAULT,
+                            property,
+                            H5P_DEFAULT);
+  status = H5Pclose(property);
+
+  if(dataset < 0) {
+    H5Sclose(dataspace);
+    if(closeFile) {
+      mImpl->closeFile();
+    }
+    XdmfError::message(XdmfError::FATAL,
+                       "H5Dcreate returned failure in "
+                       "XdmfHDF5WriterParallel::write");
+  }
+
+  // Each core writes its values as a hyperslab of the dataset
+  hid_t memspace;
+  void * values;
+  char noValues;
+  if(localSize > 0) {
+    hsize_t count = localSize;
+    status = H5Sselect_hyperslab(dataspace,
+                                 H5S_SELECT_SET,
+                                 &offset,
+                                 NULL,
+                                 &count,
+                                 NULL);
+    memspace = H5Screate_simple(1, &count, NULL);
+    values = array.getValuesInternal();
+  }
+  else {
+    status = H5Sselect_none(dataspace);
+    memspace = H5Screate(H5S_SCALAR);
+    status = H5Sselect_none(memspace);
+    values = &noValues;
+  }
+
+  hid_t transfer = H5Pcreate(H5P_DATASET_XFER);
+#ifdef H5_HAVE_PARALLEL
+  status = H5Pset_dxpl_mpio(transfer, H5FD_MPIO_COLLECTIVE);
+#endif
+  herr_t writeStatus = H5Dwrite(dataset,
+                                datatype,
+                                memspace,
+                                dataspace,
+                                transfer,
+                                values);
+  status = H5Pclose(transfer);
+  status = H5Sclose(memspace);
+  status = H5Sclose(dataspace);
+  status = H5Dclose(dataset);
+
+  if(closeFile) {
+    mImpl->closeFile();
+  }
+
+  if(writeStatus < 0) {
+    XdmfError::message(XdmfError::FATAL,
+                       "H5Dwrite returned failure in "
+                       "XdmfHDF5WriterParallel::write");
+  }
+
+  // Every core describes the whole dataset, so the light data written
+  // from any core refers to the complete field rather than one share
+  while(array.getNumberHeavyDataControllers() != 0) {
+    array.removeHeavyDataController(array.getNumberHeavyDataControllers() - 1);
+  }
+  array.insert(this->createController(mFilePath,
+                                      dataSetPath.str(),
+                                      arrayType,
+                                      std::vector<unsigned int>(1, 0),
+                                      std::vector<unsigned int>(1, 1),
+                                      std::vector<unsigned int>(1, (unsigned int)totalSize),
+                                      std::vector<unsigned int>(1, (unsigned int)totalSize)));
+  // The local values are only a share of what the controller describes
+  array.release();
+
+  ++mDataSetId;
+}
+
+// C Wrappers
+
+XDMFHDF5WRITERPARALLEL * XdmfHDF5WriterParallelNew(char * filePath,
+                                                   MPI_Comm comm,
+                                                   int clobberFile,
+                                                   int * status)
+{
+  XDMF_ERROR_WRAP_START(status)
+  shared_ptr<XdmfHDF5WriterParallel> createdWriter = XdmfHDF5WriterParallel::New(std::string(filePath), comm, clobberFile);
+  return (XDMFHDF5WRITERPARALLEL *)((void *)(new XdmfHDF5WriterParallel(*createdWriter.get())));
+  XDMF_ERROR_WRAP_END(status)
+  return NULL;
+}
+
+MPI_Comm XdmfHDF5WriterParallelGetComm(XDMFHDF5WRITERPARALLEL * writer)
+{
+  return ((XdmfHDF5WriterParallel *) writer)->getComm();
+}
+
+XDMF_HDF5WRITER_C_CHILD_WRAPPER(XdmfHDF5WriterParallel, XDMFHDF5WRITERPARALLEL)
+XDMF_HEAVYWRITER_C_CHILD_WRAPPER(XdmfHDF5WriterParallel, XDMFHDF5WRITERPARALLEL)
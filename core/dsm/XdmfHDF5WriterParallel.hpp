@@ -0,0 +1,201 @@
+/*****************************************************************************/
+/*                                    XDMF                                   */
+/*                       eXtensible Data Model and Format                    */
+/*                                                                           */
+/*  Id : XdmfHDF5WriterParallel.hpp                                          */
+/*                                                                           */
+/*  Author:                                                                  */
+/*     Andrew Burns                                                          */
+/*     andrew.j.burns2@arl.army.mil                                          */
+/*     US Army Research Laboratory                                           */
+/*     Aberdeen Proving Ground, MD                                           */
+/*                                                                           */
+/*     Copyright @ 2015 US Army Research Laboratory                          */
+/*     All Rights Reserved                                                   */
+/*     See Copyright.txt for details                                         */
+/*                                                                           */
+/*     This software is distributed WITHOUT ANY WARRANTY; without            */
+/*     even the implied warranty of MERCHANTABILITY or FITNESS               */
+/*     FOR A PARTICULAR PURPOSE.  See the above copyright notice             */
+/*     for more information.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef XDMFHDF5WRITERPARALLEL_HPP_
+#define XDMFHDF5WRITERPARALLEL_HPP_
+
+// C Compatible Includes
+#include <XdmfDSM.hpp>
+#include <XdmfHDF5Writer.hpp>
+#include <mpi.h>
+
+#ifdef __cplusplus
+
+/**
+ * @brief Traverse the Xdmf graph and write heavy data stored in
+ * XdmfArrays to a single hdf5 file shared by all cores of a
+ * communicator.
+ *
+ * XdmfHDF5WriterParallel opens one hdf5 file with the MPI-IO driver
+ * on every core of a communicator. Each array written becomes one
+ * dataset in that file holding the values of the array on every core,
+ * ordered by rank. The cores write their own values collectively as
+ * a hyperslab of the dataset.
+ *
+ * After writing, the array on every core holds one XdmfHDF5Controller
+ * describing the complete dataset and its local values are released.
+ * Light data written from any core therefore refers to the whole
+ * field. A core reads its own share back with
+ * XdmfHDF5ControllerParallel.
+ *
+ * Writing is collective. Every core of the communicator must accept
+ * the writer on the same items in the same order, cores without
+ * values for an array included. Arrays may have different sizes on
+ * each core.
+ *
+ * Only the Default heavy data writing mode is supported, and string
+ * arrays can not be written. File size limits, deduplication and the
+ * release data setting are ignored. A dataset may hold at most
+ * UINT_MAX values in total. Only built against an hdf5 library with
+ * parallel IO support.
+ */
+class XDMFDSM_EXPORT XdmfHDF5WriterParallel : public XdmfHDF5Writer {
+
+public:
+
+  /**
+   * Construct XdmfHDF5WriterParallel.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5WriterParallel.cpp
+   * @skipline //#initMPI
+   * @until //#initMPI
+   * @skipline //#initialization
+   * @until //#initialization
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5WriterParallel.py
+   * @skipline #//initMPI
+   * @until #//initMPI
+   * @skipline #//initialization
+   * @until #//initialization
+   *
+   * @param     filePath        The location of the hdf5 file to output to
+   *                            on disk.
+   * @param     comm            The communicator of the cores writing to
+   *                            the file.
+   * @param     clobberFile     Whether to overwrite the previous file if it
+   *                            exists.
+   *
+   * @return                    New XdmfHDF5WriterParallel.
+   */
+  static shared_ptr<XdmfHDF5WriterParallel>
+  New(const std::string & filePath,
+      MPI_Comm comm,
+      const bool clobberFile = false);
+
+  virtual ~XdmfHDF5WriterParallel();
+
+  /**
+   * Gets the communicator of the cores writing to the file.
+   *
+   * Example of use:
+   *
+   * C++
+   *
+   * @dontinclude ExampleXdmfHDF5WriterParallel.cpp
+   * @skipline //#initMPI
+   * @until //#initMPI
+   * @skipline //#initialization
+   * @until //#initialization
+   * @skipline //#getComm
+   * @until //#getComm
+   *
+   * Python
+   *
+   * @dontinclude XdmfExampleHDF5WriterParallel.py
+   * @skipline #//initMPI
+   * @until #//initMPI
+   * @skipline #//initialization
+   * @until #//initialization
+   * @skipline #//getComm
+   * @until #//getComm
+   *
+   * @return    The communicator of the writing cores.
+   */
+  MPI_Comm getComm() const;
+
+  using XdmfHeavyDataWriter::visit;
+  void visit(XdmfArray & array,
+             const shared_ptr<XdmfBaseVisitor> visitor);
+
+  XdmfHDF5WriterParallel(XdmfHDF5WriterParallel &);
+
+protected:
+
+  XdmfHDF5WriterParallel(const std::string & filePath,
+                         MPI_Comm comm);
+
+  /**
+   * Write the values of the XdmfArray on every core to one dataset.
+   *
+   * @param     array   An XdmfArray to write to hdf5.
+   */
+  virtual void write(XdmfArray & array);
+
+  /**
+   * PIMPL
+   */
+  class XdmfHDF5WriterParallelImpl : public XdmfHDF5WriterImpl
+  {
+  public:
+
+    XdmfHDF5WriterParallelImpl(MPI_Comm comm);
+
+    virtual ~XdmfHDF5WriterParallelImpl();
+
+    virtual int
+    openFile(const std::string & filePath,
+             const int mDataSetId);
+
+    MPI_Comm mComm;
+  };
+
+private:
+
+  XdmfHDF5WriterParallel(const XdmfHDF5WriterParallel &);  // Not implemented.
+  void operator=(const XdmfHDF5WriterParallel &);  // Not implemented.
+
+  MPI_Comm mComm;
+};
+
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C wrappers go here
+
+struct XDMFHDF5WRITERPARALLEL; // Simply as a typedef to ensure correct typing
+typedef struct XDMFHDF5WRITERPARALLEL XDMFHDF5WRITERPARALLEL;
+
+XDMFDSM_EXPORT XDMFHDF5WRITERPARALLEL * XdmfHDF5WriterParallelNew(char * filePath,
+                                                                  MPI_Comm comm,
+                                                                  int clobberFile,
+                                                                  int * status);
+
+XDMFDSM_EXPORT MPI_Comm XdmfHDF5WriterParallelGetComm(XDMFHDF5WRITERPARALLEL * writer);
+
+XDMF_HDF5WRITER_C_CHILD_DECLARE(XdmfHDF5WriterParallel, XDMFHDF5WRITERPARALLEL, XDMFDSM)
+XDMF_HEAVYWRITER_C_CHILD_DECLARE(XdmfHDF5WriterParallel, XDMFHDF5WRITERPARALLEL, XDMFDSM)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XDMFHDF5WRITERPARALLEL_HPP_ */
@@ -0,0 +1,208 @@
+#include <mpi.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include <algorithm>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfHDF5WriterDSM.hpp"
+#include "XdmfHDF5ControllerDSM.hpp"
+#include "XdmfDSMBuffer.hpp"
+#include "XdmfDSMDriver.hpp"
+
+// Reads the same dataset repeatedly with the client page cache enabled,
+// then rewrites it and checks that the new values are read instead of
+// stale cached pages, both by the cores that wrote it and by cores that
+// only read. Reports the time of uncached and cached reads.
+
+double readRepeatedly(shared_ptr<XdmfArray> readArray,
+                      MPI_Comm workerComm,
+                      unsigned int iterations)
+{
+        MPI_Barrier(workerComm);
+        double startTime = MPI_Wtime();
+        for (unsigned int i = 0; i < iterations; ++i)
+        {
+                readArray->read();
+        }
+        MPI_Barrier(workerComm);
+        return MPI_Wtime() - startTime;
+}
+
+int main(int argc, char *argv[])
+{
+        int size, id, dsmSize;
+        dsmSize = 64;//The total size of the DSM being created
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init(&argc, &argv);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        std::string newPath = "dsm";
+        std::string newSetPath = "dataspace";
+
+        // Change this to determine the number of cores used as servers
+        unsigned int numServersCores = 2;
+        // Change this to determine the size of the arrays generated when initializing
+        unsigned int writeArraySize = 256;
+        // Change this to determine the number of times the data is read
+        unsigned int iterations = 20;
+
+        MPI_Comm workerComm;
+
+        MPI_Group workers, dsmgroup;
+
+        MPI_Comm_group(comm, &dsmgroup);
+        int * ServerIds = (int *)calloc((numServersCores), sizeof(int));
+        unsigned int index = 0;
+        for(int i=size-numServersCores ; i <= size-1 ; ++i)
+        {
+                ServerIds[index++] = i;
+        }
+
+        MPI_Group_excl(dsmgroup, index, ServerIds, &workers);
+        int testval = MPI_Comm_create(comm, workers, &workerComm);
+        free(ServerIds);
+
+        shared_ptr<XdmfHDF5WriterDSM> exampleWriter = XdmfHDF5WriterDSM::New(newPath, comm, dsmSize/numServersCores, size-numServersCores, size-1);
+
+        exampleWriter->setMode(XdmfHeavyDataWriter::Hyperslab);
+
+        // Server cores will not progress to this point until after the servers are done running
+
+        if (id < size - (int)numServersCores)
+        {
+                int workerSize;
+                MPI_Comm_size(workerComm, &workerSize);
+                unsigned int totalSize = writeArraySize * workerSize;
+
+                shared_ptr<XdmfArray> testArray = XdmfArray::New();
+                testArray->initialize<int>(0);
+                for (unsigned int i = 0; i < writeArraySize; ++i)
+                {
+                        testArray->pushBack((int)(id * writeArraySize + i));
+                }
+
+                std::vector<unsigned int> writeStartVector(1, id * writeArraySize);
+                std::vector<unsigned int> strideVector(1, 1);
+                std::vector<unsigned int> writeCountVector(1, writeArraySize);
+                std::vector<unsigned int> dataSizeVector(1, totalSize);
+
+                testArray->insert(XdmfHDF5ControllerDSM::New(
+                        newPath,
+                        newSetPath,
+                        XdmfArrayType::Int32(),
+                        writeStartVector,
+                        strideVector,
+                        writeCountVector,
+                        dataSizeVector,
+                        exampleWriter->getServerBuffer()));
+
+                testArray->accept(exampleWriter);
+                MPI_Barrier(workerComm);
+
+                // Every core reads the whole dataset
+                shared_ptr<XdmfArray> readArray = XdmfArray::New();
+                readArray->insert(XdmfHDF5ControllerDSM::New(
+                        newPath,
+                        newSetPath,
+                        XdmfArrayType::Int32(),
+                        std::vector<unsigned int>(1, 0),
+                        strideVector,
+                        dataSizeVector,
+                        dataSizeVector,
+                        exampleWriter->getServerBuffer()));
+
+                assert(xdmf_dsm_get_cache_size() == 0);
+                double uncachedTime = readRepeatedly(readArray, workerComm, iterations);
+
+                xdmf_dsm_set_cache_size(1024 * 1024);
+                assert(xdmf_dsm_get_cache_size() == 1024 * 1024);
+                double cachedTime = readRepeatedly(readArray, workerComm, iterations);
+
+                for (unsigned int i = 0; i < totalSize; ++i)
+                {
+                        assert(readArray->getValue<int>(i) == (int)i);
+                }
+
+                // Writing the file again must invalidate the cached pages
+                for (unsigned int i = 0; i < writeArraySize; ++i)
+                {
+                        testArray->insert(i, -(int)(id * writeArraySize + i));
+                }
+                testArray->accept(exampleWriter);
+                MPI_Barrier(workerComm);
+
+                readArray->read();
+                for (unsigned int i = 0; i < totalSize; ++i)
+                {
+                        assert(readArray->getValue<int>(i) == -(int)i);
+                }
+
+                // The first core changes the file the way another
+                // application would, without the others opening it for
+                // writing, so every other core only reads it
+                if (id == 0)
+                {
+                        XdmfDSMBuffer * buffer = exampleWriter->getServerBuffer();
+                        std::vector<char> fileName(newPath.begin(), newPath.end());
+                        fileName.push_back(0);
+                        std::vector<unsigned int> pages;
+                        unsigned int numPages = 0;
+                        haddr_t start = 0;
+                        haddr_t end = 0;
+                        int found = buffer->RequestFileDescription(&fileName[0], pages, numPages, start, end);
+                        assert(found == XDMF_DSM_SUCCESS);
+
+                        std::vector<char> image(end - start);
+                        buffer->Get(start, image.size(), &image[0]);
+
+                        // The dataset fits in one chunk, so its values are contiguous
+                        std::vector<int> oldValues(totalSize);
+                        std::vector<int> newValues(totalSize);
+                        for (unsigned int i = 0; i < totalSize; ++i)
+                        {
+                                oldValues[i] = -(int)i;
+                                newValues[i] = 2 * (int)i;
+                        }
+                        const char * oldBytes = (const char *)&oldValues[0];
+                        std::vector<char>::iterator values =
+                                std::search(image.begin(), image.end(), oldBytes, oldBytes + totalSize * sizeof(int));
+                        assert(values != image.end());
+                        long offset = values - image.begin();
+
+                        buffer->Put(start + offset, totalSize * sizeof(int), &newValues[0]);
+                        buffer->RegisterFile(&fileName[0], numPages > 0 ? &pages[0] : NULL, numPages, start, end);
+                }
+                MPI_Barrier(workerComm);
+
+                readArray->read();
+                for (unsigned int i = 0; i < totalSize; ++i)
+                {
+                        assert(readArray->getValue<int>(i) == 2 * (int)i);
+                }
+
+                xdmf_dsm_set_cache_size(0);
+
+                if (id == 0)
+                {
+                        std::cout << "uncached reads: " << uncachedTime / iterations << " s" << std::endl;
+                        std::cout << "cached reads: " << cachedTime / iterations << " s" << std::endl;
+                }
+        }
+
+        if (id == 0)
+        {
+                exampleWriter->stopDSM();
+        }
+
+        MPI_Barrier(comm);
+
+        MPI_Finalize();
+
+        return 0;
+}
@@ -0,0 +1,150 @@
+#include <mpi.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include "XdmfDSMBuffer.hpp"
+#include "XdmfError.hpp"
+#include "XdmfHDF5WriterDSM.hpp"
+
+// Moves smooth floating point data through the DSM with each compression
+// type, checking the contents and reporting the bytes saved and the time
+// spent compressing.
+
+int main(int argc, char *argv[])
+{
+        int size, id, dsmSize;
+        dsmSize = 64;//The total size of the DSM being created
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init(&argc, &argv);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        std::string newPath = "dsm";
+
+        // Change this to determine the number of cores used as servers
+        unsigned int numServersCores = 2;
+        // Change this to determine the number of times the data is moved
+        unsigned int iterations = 10;
+
+        MPI_Comm workerComm;
+
+        MPI_Group workers, dsmgroup;
+
+        MPI_Comm_group(comm, &dsmgroup);
+        int * ServerIds = (int *)calloc((numServersCores), sizeof(int));
+        unsigned int index = 0;
+        for(int i=size-numServersCores ; i <= size-1 ; ++i)
+        {
+                ServerIds[index++] = i;
+        }
+
+        MPI_Group_excl(dsmgroup, index, ServerIds, &workers);
+        int testval = MPI_Comm_create(comm, workers, &workerComm);
+        free(ServerIds);
+
+        shared_ptr<XdmfHDF5WriterDSM> exampleWriter = XdmfHDF5WriterDSM::New(newPath, comm, dsmSize/numServersCores, size-numServersCores, size-1);
+
+        // Server cores will not progress to this point until after the servers are done running
+
+        if (id < size - (int)numServersCores)
+        {
+                XdmfDSMBuffer * buffer = exampleWriter->getServerBuffer();
+
+                int workerSize;
+                MPI_Comm_size(workerComm, &workerSize);
+
+                // Each core writes a block spanning the boundary between
+                // server buffers and reads back the block of the next core.
+                long numValues = buffer->GetTotalLength() / (2 * workerSize * sizeof(float));
+                long blockLength = numValues * sizeof(float);
+                long writeAddress = (buffer->GetTotalLength() / 2) - (workerSize * blockLength) / 2 + id * blockLength;
+                long readAddress = (buffer->GetTotalLength() / 2) - (workerSize * blockLength) / 2 + ((id + 1) % workerSize) * blockLength;
+
+                std::vector<float> writeData(numValues);
+                std::vector<float> readData(numValues);
+
+                buffer->SetCompressionElementSize(sizeof(float));
+                assert(buffer->GetCompressionElementSize() == sizeof(float));
+
+                for (int compression = XDMF_DSM_COMPRESSION_NONE; compression <= XDMF_DSM_COMPRESSION_ZLIB; ++compression)
+                {
+                        try
+                        {
+                                buffer->SetCompressionType(compression);
+                        }
+                        catch (XdmfError & e)
+                        {
+                                // Not every build has every codec
+                                continue;
+                        }
+                        assert(buffer->GetCompressionType() == compression);
+
+                        for (long i = 0; i < numValues; ++i)
+                        {
+                                writeData[i] = (float)((i / 64) + id + compression);
+                        }
+
+                        long uncompressedBytes = buffer->GetUncompressedBytes();
+                        long compressedBytes = buffer->GetCompressedBytes();
+                        double compressionTime = buffer->GetCompressionTime();
+
+                        MPI_Barrier(workerComm);
+                        double startTime = MPI_Wtime();
+                        for (unsigned int i = 0; i < iterations; ++i)
+                        {
+                                buffer->Put(writeAddress, blockLength, &writeData[0]);
+                                MPI_Barrier(workerComm);
+                                buffer->Get(readAddress, blockLength, &readData[0]);
+                                MPI_Barrier(workerComm);
+                        }
+                        double elapsed = MPI_Wtime() - startTime;
+
+                        int readId = (id + 1) % workerSize;
+                        for (long i = 0; i < numValues; ++i)
+                        {
+                                assert(readData[i] == (float)((i / 64) + readId + compression));
+                        }
+
+                        uncompressedBytes = buffer->GetUncompressedBytes() - uncompressedBytes;
+                        compressedBytes = buffer->GetCompressedBytes() - compressedBytes;
+                        compressionTime = buffer->GetCompressionTime() - compressionTime;
+
+                        if (compression == XDMF_DSM_COMPRESSION_NONE)
+                        {
+                                assert(uncompressedBytes == 0);
+                        }
+                        else
+                        {
+                                // Half of each block is on a remote server
+                                assert(uncompressedBytes > 0);
+                                assert(compressedBytes < uncompressedBytes);
+                        }
+
+                        double megaBytes = (2.0 * iterations * blockLength * workerSize) / (1024 * 1024);
+                        if (id == 0)
+                        {
+                                std::cout << "compression " << compression << ": "
+                                          << megaBytes / elapsed << " MB/s, "
+                                          << uncompressedBytes - compressedBytes << " bytes saved, "
+                                          << compressionTime << " s compressing" << std::endl;
+                        }
+                }
+
+                buffer->SetCompressionType(XDMF_DSM_COMPRESSION_NONE);
+        }
+
+        if (id == 0)
+        {
+                exampleWriter->stopDSM();
+        }
+
+        MPI_Barrier(comm);
+
+        MPI_Finalize();
+
+        return 0;
+}
@@ -0,0 +1,195 @@
+#include <mpi.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include <algorithm>
+#include "XdmfDSMBuffer.hpp"
+#include "XdmfDSMCommMPI.hpp"
+
+// Writes one large region from every worker core into the DSM with
+// the distribution given on the command line (uniform, cyclic or random),
+// then reports how the data was spread over the server cores and the
+// aggregate bandwidth of the writes.
+
+int main(int argc, char *argv[])
+{
+        int size, id, dsmSize;
+        dsmSize = 64;//The total size of the DSM being created
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init(&argc, &argv);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        std::string distribution = "uniform";
+        if (argc > 1)
+        {
+                distribution = argv[1];
+        }
+
+        // Change this to determine the number of cores used as servers
+        unsigned int numServersCores = size / 2;
+        // Change this to determine the size of the pages
+        unsigned int blockSize = 4096;
+        // Change this to determine the number of times the data is written
+        unsigned int iterations = 10;
+
+        int startCoreIndex = size - numServersCores;
+        int endCoreIndex = size - 1;
+
+        MPI_Comm workerComm, serverComm;
+
+        MPI_Group workers, dsmgroup, servergroup;
+
+        MPI_Comm_group(comm, &dsmgroup);
+        int * ServerIds = (int *)calloc((numServersCores), sizeof(int));
+        unsigned int index = 0;
+        for(int i=startCoreIndex ; i <= endCoreIndex ; ++i)
+        {
+                ServerIds[index++] = i;
+        }
+
+        MPI_Group_incl(dsmgroup, index, ServerIds, &servergroup);
+        MPI_Comm_create(comm, servergroup, &serverComm);
+        MPI_Group_excl(dsmgroup, index, ServerIds, &workers);
+        MPI_Comm_create(comm, workers, &workerComm);
+        free(ServerIds);
+
+        XdmfDSMBuffer * buffer = new XdmfDSMBuffer();
+        buffer->SetLocalBufferSizeMBytes(dsmSize/numServersCores);
+        buffer->SetInterCommType(XDMF_DSM_COMM_MPI);
+        if (distribution == "cyclic")
+        {
+                buffer->SetBlockLength(blockSize);
+                buffer->SetDsmType(XDMF_DSM_TYPE_BLOCK_CYCLIC);
+        }
+        else if (distribution == "random")
+        {
+                buffer->SetBlockLength(blockSize);
+                buffer->SetDsmType(XDMF_DSM_TYPE_BLOCK_RANDOM);
+        }
+        else
+        {
+                buffer->SetDsmType(XDMF_DSM_TYPE_UNIFORM);
+        }
+
+        MPI_Barrier(comm);
+
+        if (id >= startCoreIndex)
+        {
+                buffer->Create(serverComm);
+        }
+        else
+        {
+                buffer->Create(workerComm, startCoreIndex, endCoreIndex);
+                buffer->SetIsServer(false);
+        }
+
+        buffer->GetComm()->DupInterComm(comm);
+        buffer->SetIsConnected(true);
+
+        if (id >= startCoreIndex)
+        {
+                buffer->ReceiveInfo();
+        }
+        else
+        {
+                buffer->SendInfo();
+        }
+
+        MPI_Barrier(comm);
+
+        double elapsed = 0;
+        long bytesWritten = 0;
+
+        if (id >= startCoreIndex)
+        {
+                int returnOpCode;
+                buffer->BufferServiceLoop(&returnOpCode);
+        }
+        else
+        {
+                int workerSize;
+                MPI_Comm_size(workerComm, &workerSize);
+
+                // All cores write into the first quarter of the DSM,
+                // a single large dataset as far as the servers can tell.
+                long regionLength = buffer->GetTotalLength() / (4 * workerSize);
+                long writeAddress = id * regionLength;
+
+                std::vector<char> writeData(regionLength, (char)(id + 1));
+                std::vector<char> readData(regionLength);
+
+                MPI_Barrier(workerComm);
+                double startTime = MPI_Wtime();
+                for (unsigned int i = 0; i < iterations; ++i)
+                {
+                        buffer->Put(writeAddress, regionLength, &writeData[0]);
+                }
+                MPI_Barrier(workerComm);
+                elapsed = MPI_Wtime() - startTime;
+                bytesWritten = iterations * regionLength;
+
+                buffer->Get(writeAddress, regionLength, &readData[0]);
+                assert(memcmp(&writeData[0], &readData[0], regionLength) == 0);
+
+                MPI_Barrier(workerComm);
+
+                if (id == 0)
+                {
+                        buffer->SendDone();
+                }
+        }
+
+        // Each server counts the bytes that were written to it
+        long localBytes = 0;
+        if (id >= startCoreIndex)
+        {
+                char * data = buffer->GetDataPointer();
+                for (long i = 0; i < buffer->GetLength(); ++i)
+                {
+                        if (data[i] != 0)
+                        {
+                                ++localBytes;
+                        }
+                }
+        }
+
+        std::vector<long> serverBytes(size);
+        MPI_Gather(&localBytes, 1, MPI_LONG, &serverBytes[0], 1, MPI_LONG, 0, comm);
+
+        long totalBytes = 0;
+        double maxElapsed = 0;
+        MPI_Reduce(&bytesWritten, &totalBytes, 1, MPI_LONG, MPI_SUM, 0, comm);
+        MPI_Reduce(&elapsed, &maxElapsed, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+
+        if (id == 0)
+        {
+                long minBytes = serverBytes[startCoreIndex];
+                long maxBytes = serverBytes[startCoreIndex];
+                for (int i = startCoreIndex; i <= endCoreIndex; ++i)
+                {
+                        std::cout << distribution << " server " << i << ": " << serverBytes[i] << " bytes" << std::endl;
+                        minBytes = std::min(minBytes, serverBytes[i]);
+                        maxBytes = std::max(maxBytes, serverBytes[i]);
+                }
+                std::cout << distribution << " aggregate bandwidth: "
+                          << (totalBytes / (1024.0 * 1024.0)) / maxElapsed << " MB/s" << std::endl;
+                if (distribution != "uniform")
+                {
+                        // Paged distributions spread the region over every server
+                        assert(minBytes > 0);
+                        assert(maxBytes - minBytes <= (long)blockSize);
+                }
+        }
+
+        MPI_Barrier(comm);
+
+        MPI_Finalize();
+
+        return 0;
+}
@@ -0,0 +1,3 @@
+$MPIEXEC -n 6 ./DSMDistributionTest uniform
+$MPIEXEC -n 6 ./DSMDistributionTest cyclic
+$MPIEXEC -n 6 ./DSMDistributionTest random
@@ -0,0 +1,151 @@
+#include <mpi.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include "XdmfDSMBuffer.hpp"
+#include "XdmfDSMCommMPI.hpp"
+
+// Grows a file in a paged DSM until the servers have to resize their
+// buffers several times, checking after every step that the data
+// written before is still there and that the servers never moved
+// the memory they started with.
+
+int main(int argc, char *argv[])
+{
+        int size, id;
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init(&argc, &argv);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        // Change this to determine the number of cores used as servers
+        unsigned int numServersCores = 2;
+        // Change this to determine the size of the pages
+        unsigned int blockSize = 4096;
+        // Change this to determine the number of times the file grows
+        unsigned int steps = 6;
+
+        int startCoreIndex = size - numServersCores;
+        int endCoreIndex = size - 1;
+
+        MPI_Comm workerComm, serverComm;
+
+        MPI_Group workers, dsmgroup, servergroup;
+
+        MPI_Comm_group(comm, &dsmgroup);
+        int * ServerIds = (int *)calloc((numServersCores), sizeof(int));
+        unsigned int index = 0;
+        for(int i=startCoreIndex ; i <= endCoreIndex ; ++i)
+        {
+                ServerIds[index++] = i;
+        }
+
+        MPI_Group_incl(dsmgroup, index, ServerIds, &servergroup);
+        MPI_Comm_create(comm, servergroup, &serverComm);
+        MPI_Group_excl(dsmgroup, index, ServerIds, &workers);
+        MPI_Comm_create(comm, workers, &workerComm);
+        free(ServerIds);
+
+        XdmfDSMBuffer * buffer = new XdmfDSMBuffer();
+        buffer->SetLocalBufferSizeMBytes(1);
+        buffer->SetInterCommType(XDMF_DSM_COMM_MPI);
+        buffer->SetBlockLength(blockSize);
+        buffer->SetDsmType(XDMF_DSM_TYPE_BLOCK_CYCLIC);
+        buffer->SetResizeFactor(0.5);
+
+        MPI_Barrier(comm);
+
+        if (id >= startCoreIndex)
+        {
+                buffer->Create(serverComm);
+        }
+        else
+        {
+                buffer->Create(workerComm, startCoreIndex, endCoreIndex);
+                buffer->SetIsServer(false);
+        }
+
+        buffer->GetComm()->DupInterComm(comm);
+        buffer->SetIsConnected(true);
+
+        if (id >= startCoreIndex)
+        {
+                buffer->ReceiveInfo();
+        }
+        else
+        {
+                buffer->SendInfo();
+        }
+
+        MPI_Barrier(comm);
+
+        if (id >= startCoreIndex)
+        {
+                char * initialPointer = buffer->GetDataPointer();
+                long initialLength = buffer->GetLength();
+
+                int returnOpCode;
+                buffer->BufferServiceLoop(&returnOpCode);
+
+                // The buffer grew around the memory it started with
+                assert(buffer->GetDataPointer() == initialPointer);
+                assert(buffer->GetLength() > initialLength);
+        }
+        else
+        {
+                if (id == 0)
+                {
+                        long initialTotal = buffer->GetTotalLength();
+                        // Each step adds more than half of the original DSM
+                        long stepLength = (initialTotal * 3) / 5 + 100;
+                        std::vector<char> fileData;
+                        std::vector<unsigned int> pages;
+                        unsigned int numPages = 0;
+                        haddr_t start = 0;
+                        haddr_t end = 0;
+                        char fileName[] = "resize.h5";
+
+                        buffer->RegisterFile(fileName, NULL, 0, 0, 0);
+
+                        for (unsigned int step = 0; step < steps; ++step)
+                        {
+                                buffer->RequestPages(fileName, stepLength, pages, numPages, start, end);
+                                assert(numPages * blockSize >= fileData.size() + stepLength);
+
+                                long writeStart = fileData.size();
+                                fileData.resize(writeStart + stepLength);
+                                for (long i = writeStart; i < (long)fileData.size(); ++i)
+                                {
+                                        fileData[i] = (char)((i * 7 + step) % 127);
+                                }
+                                buffer->Put(&pages[0], numPages, writeStart, stepLength, &fileData[writeStart]);
+
+                                // Everything written so far survives the resize
+                                std::vector<char> readData(fileData.size());
+                                buffer->Get(&pages[0], numPages, 0, readData.size(), &readData[0]);
+                                assert(readData == fileData);
+                        }
+
+                        assert(buffer->GetTotalLength() > initialTotal);
+                        std::cout << "DSM grew from " << initialTotal << " to "
+                                  << buffer->GetTotalLength() << " bytes" << std::endl;
+                }
+
+                MPI_Barrier(workerComm);
+
+                if (id == 0)
+                {
+                        buffer->SendDone();
+                }
+        }
+
+        MPI_Barrier(comm);
+
+        MPI_Finalize();
+
+        return 0;
+}
@@ -0,0 +1,187 @@
+#include <mpi.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include <algorithm>
+#include "XdmfDSMBuffer.hpp"
+#include "XdmfDSMCommMPI.hpp"
+
+// Measures the latency of small reads while another core writes large
+// blocks to the same server core, with the number of service threads
+// given on the command line (0 serves every request in the loop itself).
+
+int main(int argc, char *argv[])
+{
+        int size, id, dsmSize, provided;
+        dsmSize = 64;//The total size of the DSM being created
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        int serviceThreads = 0;
+        if (argc > 1)
+        {
+                serviceThreads = atoi(argv[1]);
+        }
+        if (serviceThreads > 0 && provided != MPI_THREAD_MULTIPLE)
+        {
+                if (id == 0)
+                {
+                        std::cout << "# MPI_THREAD_MULTIPLE not available, skipping" << std::endl;
+                }
+                MPI_Finalize();
+                return 0;
+        }
+
+        // Change this to determine the number of cores used as servers
+        unsigned int numServersCores = 2;
+        // Change this to determine the size of the large writes
+        long writeLength = 8 * 1024 * 1024;
+        // Change this to determine the size of the small reads
+        long readLength = 4096;
+        // Change this to determine the number of times the data is written
+        unsigned int iterations = 20;
+
+        int startCoreIndex = size - numServersCores;
+        int endCoreIndex = size - 1;
+
+        MPI_Comm workerComm, serverComm;
+
+        MPI_Group workers, dsmgroup, servergroup;
+
+        MPI_Comm_group(comm, &dsmgroup);
+        int * ServerIds = (int *)calloc((numServersCores), sizeof(int));
+        unsigned int index = 0;
+        for(int i=startCoreIndex ; i <= endCoreIndex ; ++i)
+        {
+                ServerIds[index++] = i;
+        }
+
+        MPI_Group_incl(dsmgroup, index, ServerIds, &servergroup);
+        MPI_Comm_create(comm, servergroup, &serverComm);
+        MPI_Group_excl(dsmgroup, index, ServerIds, &workers);
+        MPI_Comm_create(comm, workers, &workerComm);
+        free(ServerIds);
+
+        XdmfDSMBuffer * buffer = new XdmfDSMBuffer();
+        buffer->SetLocalBufferSizeMBytes(dsmSize/numServersCores);
+        buffer->SetInterCommType(XDMF_DSM_COMM_MPI);
+        buffer->SetDsmType(XDMF_DSM_TYPE_UNIFORM);
+        buffer->SetServiceThreads(serviceThreads);
+        assert(buffer->GetServiceThreads() == serviceThreads);
+
+        MPI_Barrier(comm);
+
+        if (id >= startCoreIndex)
+        {
+                buffer->Create(serverComm);
+        }
+        else
+        {
+                buffer->Create(workerComm, startCoreIndex, endCoreIndex);
+                buffer->SetIsServer(false);
+        }
+
+        buffer->GetComm()->DupInterComm(comm);
+        buffer->SetIsConnected(true);
+
+        if (id >= startCoreIndex)
+        {
+                buffer->ReceiveInfo();
+        }
+        else
+        {
+                buffer->SendInfo();
+        }
+
+        MPI_Barrier(comm);
+
+        double latency = 0;
+        double maxLatency = 0;
+        long numReads = 0;
+
+        if (id >= startCoreIndex)
+        {
+                int returnOpCode;
+                buffer->BufferServiceLoop(&returnOpCode);
+        }
+        else
+        {
+                // Everything goes to the first server core, the writer
+                // at the start of its buffer and the readers after it.
+                long readAddress = writeLength + id * readLength;
+                std::vector<char> writeData(writeLength, (char)1);
+                std::vector<char> readData(readLength, (char)(id + 1));
+                buffer->Put(readAddress, readLength, &readData[0]);
+
+                MPI_Barrier(workerComm);
+
+                if (id == 0)
+                {
+                        for (unsigned int i = 0; i < iterations; ++i)
+                        {
+                                buffer->Put(0, writeLength, &writeData[0]);
+                        }
+                        // Tell the readers to stop
+                        char done = 1;
+                        for (int i = 1; i < startCoreIndex; ++i)
+                        {
+                                MPI_Send(&done, 1, MPI_CHAR, i, 0, workerComm);
+                        }
+                }
+                else
+                {
+                        int stop = 0;
+                        MPI_Request stopRequest;
+                        char done;
+                        MPI_Irecv(&done, 1, MPI_CHAR, 0, 0, workerComm, &stopRequest);
+                        while (!stop)
+                        {
+                                double startTime = MPI_Wtime();
+                                buffer->Get(readAddress, readLength, &readData[0]);
+                                double elapsed = MPI_Wtime() - startTime;
+                                assert(readData[0] == (char)(id + 1));
+                                assert(readData[readLength - 1] == (char)(id + 1));
+                                latency += elapsed;
+                                maxLatency = std::max(maxLatency, elapsed);
+                                ++numReads;
+                                MPI_Test(&stopRequest, &stop, MPI_STATUS_IGNORE);
+                        }
+                }
+
+                MPI_Barrier(workerComm);
+
+                if (id == 0)
+                {
+                        buffer->SendDone();
+                }
+        }
+
+        double totalLatency = 0;
+        double worstLatency = 0;
+        long totalReads = 0;
+        MPI_Reduce(&latency, &totalLatency, 1, MPI_DOUBLE, MPI_SUM, 0, comm);
+        MPI_Reduce(&maxLatency, &worstLatency, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+        MPI_Reduce(&numReads, &totalReads, 1, MPI_LONG, MPI_SUM, 0, comm);
+
+        if (id == 0)
+        {
+                std::cout << serviceThreads << " service threads: " << totalReads
+                          << " reads, mean latency " << (totalReads > 0 ? totalLatency / totalReads : 0)
+                          << " s, max latency " << worstLatency << " s" << std::endl;
+        }
+
+        MPI_Barrier(comm);
+
+        delete buffer;
+
+        MPI_Finalize();
+
+        return 0;
+}
@@ -0,0 +1,2 @@
+$MPIEXEC -n 5 ./DSMServiceThreadTest 0
+$MPIEXEC -n 5 ./DSMServiceThreadTest 2
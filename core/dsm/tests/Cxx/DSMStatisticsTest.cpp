@@ -0,0 +1,199 @@
+#include <mpi.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <map>
+#include "XdmfDSMBuffer.hpp"
+#include "XdmfDSMCommMPI.hpp"
+
+// Writes and reads back a region of a paged DSM, then checks that the
+// bytes counted per peer agree between the workers and the servers
+// and that the statistics files of the servers are written when
+// their service loop ends.
+
+long sumPeers(const std::map<int, long> & bytes)
+{
+        long total = 0;
+        for (std::map<int, long>::const_iterator iter = bytes.begin(); iter != bytes.end(); ++iter)
+        {
+                total += iter->second;
+        }
+        return total;
+}
+
+int main(int argc, char *argv[])
+{
+        int size, id, dsmSize;
+        dsmSize = 64;//The total size of the DSM being created
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init(&argc, &argv);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        // Change this to determine the number of cores used as servers
+        unsigned int numServersCores = 2;
+        // Change this to determine the size of the pages
+        unsigned int blockSize = 4096;
+
+        int startCoreIndex = size - numServersCores;
+        int endCoreIndex = size - 1;
+
+        MPI_Comm workerComm, serverComm;
+
+        MPI_Group workers, dsmgroup, servergroup;
+
+        MPI_Comm_group(comm, &dsmgroup);
+        int * ServerIds = (int *)calloc((numServersCores), sizeof(int));
+        unsigned int index = 0;
+        for(int i=startCoreIndex ; i <= endCoreIndex ; ++i)
+        {
+                ServerIds[index++] = i;
+        }
+
+        MPI_Group_incl(dsmgroup, index, ServerIds, &servergroup);
+        MPI_Comm_create(comm, servergroup, &serverComm);
+        MPI_Group_excl(dsmgroup, index, ServerIds, &workers);
+        MPI_Comm_create(comm, workers, &workerComm);
+        free(ServerIds);
+
+        XdmfDSMBuffer * buffer = new XdmfDSMBuffer();
+        buffer->SetLocalBufferSizeMBytes(dsmSize/numServersCores);
+        buffer->SetInterCommType(XDMF_DSM_COMM_MPI);
+        buffer->SetBlockLength(blockSize);
+        buffer->SetDsmType(XDMF_DSM_TYPE_BLOCK_CYCLIC);
+        buffer->SetStatisticsFileName("dsmstatistics.json");
+        assert(buffer->GetStatisticsFileName() == "dsmstatistics.json");
+
+        MPI_Barrier(comm);
+
+        if (id >= startCoreIndex)
+        {
+                buffer->Create(serverComm);
+        }
+        else
+        {
+                buffer->Create(workerComm, startCoreIndex, endCoreIndex);
+                buffer->SetIsServer(false);
+        }
+
+        buffer->GetComm()->DupInterComm(comm);
+        buffer->SetIsConnected(true);
+
+        if (id >= startCoreIndex)
+        {
+                buffer->ReceiveInfo();
+        }
+        else
+        {
+                buffer->SendInfo();
+        }
+
+        // Only the transfers below are checked
+        buffer->ResetStatistics();
+        assert(buffer->GetComm()->GetMessagesSent() == 0);
+
+        MPI_Barrier(comm);
+
+        long bytesPut = 0;
+        long bytesGot = 0;
+
+        if (id >= startCoreIndex)
+        {
+                int returnOpCode;
+                buffer->BufferServiceLoop(&returnOpCode);
+                bytesPut = sumPeers(buffer->GetBytesPut());
+                bytesGot = sumPeers(buffer->GetBytesGot());
+                assert(buffer->GetServiceBusyTime() > 0);
+                assert(buffer->GetServiceIdleTime() > 0);
+        }
+        else
+        {
+                int workerSize;
+                MPI_Comm_size(workerComm, &workerSize);
+
+                // Spans several pages so that every server is written
+                long regionLength = 10 * blockSize + 100;
+                long writeAddress = id * regionLength;
+
+                std::vector<char> writeData(regionLength, (char)(id + 1));
+                std::vector<char> readData(regionLength);
+
+                buffer->Put(writeAddress, regionLength, &writeData[0]);
+                MPI_Barrier(workerComm);
+                buffer->Get(writeAddress, regionLength, &readData[0]);
+                assert(readData == writeData);
+
+                assert(sumPeers(buffer->GetBytesPut()) == regionLength);
+                assert(sumPeers(buffer->GetBytesGot()) == regionLength);
+                assert((int)buffer->GetBytesPut().size() == (int)numServersCores);
+                assert(buffer->GetPageLookups() > 0);
+                assert(buffer->GetComm()->GetMessagesSent() > 0);
+                assert(buffer->GetComm()->GetBytesSent() >= regionLength);
+                assert(buffer->GetComm()->GetBytesReceived() >= regionLength);
+
+                bytesPut = sumPeers(buffer->GetBytesPut());
+                bytesGot = sumPeers(buffer->GetBytesGot());
+
+                MPI_Barrier(workerComm);
+
+                if (id == 0)
+                {
+                        buffer->SendDone();
+                }
+
+                std::stringstream fileName;
+                fileName << "dsmstatistics.client" << id << ".csv";
+                buffer->WriteStatistics(fileName.str());
+        }
+
+        // What the workers sent is what the servers received
+        long isServer = id >= startCoreIndex;
+        long workerBytes[2] = {isServer ? 0 : bytesPut, isServer ? 0 : bytesGot};
+        long serverBytes[2] = {isServer ? bytesPut : 0, isServer ? bytesGot : 0};
+        long workerTotal[2], serverTotal[2];
+        MPI_Allreduce(workerBytes, workerTotal, 2, MPI_LONG, MPI_SUM, comm);
+        MPI_Allreduce(serverBytes, serverTotal, 2, MPI_LONG, MPI_SUM, comm);
+        assert(workerTotal[0] == serverTotal[0]);
+        assert(workerTotal[1] == serverTotal[1]);
+
+        if (id >= startCoreIndex)
+        {
+                std::stringstream fileName;
+                fileName << "dsmstatistics.server" << buffer->GetComm()->GetId() << ".json";
+                std::ifstream statistics(fileName.str().c_str());
+                assert(statistics.good());
+                std::string firstLine;
+                std::getline(statistics, firstLine);
+                assert(firstLine == "{");
+                statistics.close();
+                remove(fileName.str().c_str());
+        }
+        else
+        {
+                std::stringstream fileName;
+                fileName << "dsmstatistics.client" << id << ".csv";
+                std::ifstream statistics(fileName.str().c_str());
+                assert(statistics.good());
+                std::string firstLine;
+                std::getline(statistics, firstLine);
+                assert(firstLine == "statistic,peer,value");
+                statistics.close();
+                remove(fileName.str().c_str());
+        }
+
+        MPI_Barrier(comm);
+
+        if (id == 0)
+        {
+                std::cout << "bytes put: " << workerTotal[0] << " bytes got: " << workerTotal[1] << std::endl;
+        }
+
+        MPI_Finalize();
+
+        return 0;
+}
@@ -0,0 +1,173 @@
+#include <mpi.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include "XdmfDSMBuffer.hpp"
+#include "XdmfHDF5WriterDSM.hpp"
+
+// Moves the same data through the DSM with each transport type,
+// checking the contents and reporting the throughput of both. Run
+// on a single node so that the workers share the servers' memory.
+
+double transfer(XdmfDSMBuffer * buffer,
+                MPI_Comm workerComm,
+                std::vector<char> & writeData,
+                std::vector<char> & readData,
+                long writeAddress,
+                long readAddress,
+                unsigned int iterations)
+{
+        MPI_Barrier(workerComm);
+        double startTime = MPI_Wtime();
+        for (unsigned int i = 0; i < iterations; ++i)
+        {
+                buffer->Put(writeAddress, writeData.size(), &writeData[0]);
+                MPI_Barrier(workerComm);
+                buffer->Get(readAddress, readData.size(), &readData[0]);
+                MPI_Barrier(workerComm);
+        }
+        return MPI_Wtime() - startTime;
+}
+
+// Co-located cores write and read back the same block at once, each
+// writing its own value, so an access that is not made under the window
+// lock shows up as a block mixing values.
+void contend(XdmfDSMBuffer * buffer,
+             MPI_Comm workerComm,
+             int id,
+             long blockLength,
+             unsigned int iterations)
+{
+        std::vector<char> writeData(blockLength, (char)(id + 1));
+        std::vector<char> readData(blockLength);
+        MPI_Barrier(workerComm);
+        for (unsigned int i = 0; i < iterations; ++i)
+        {
+                buffer->Put(0, blockLength, &writeData[0]);
+                buffer->Get(0, blockLength, &readData[0]);
+                for (long j = 1; j < blockLength; ++j)
+                {
+                        assert(readData[j] == readData[0]);
+                }
+        }
+        MPI_Barrier(workerComm);
+}
+
+int main(int argc, char *argv[])
+{
+        int size, id, dsmSize;
+        dsmSize = 64;//The total size of the DSM being created
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init(&argc, &argv);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        std::string newPath = "dsm";
+
+        // Change this to determine the number of cores used as servers
+        unsigned int numServersCores = 2;
+        // Change this to determine the number of times the data is moved
+        unsigned int iterations = 10;
+
+        MPI_Comm workerComm;
+
+        MPI_Group workers, dsmgroup;
+
+        MPI_Comm_group(comm, &dsmgroup);
+        int * ServerIds = (int *)calloc((numServersCores), sizeof(int));
+        unsigned int index = 0;
+        for(int i=size-numServersCores ; i <= size-1 ; ++i)
+        {
+                ServerIds[index++] = i;
+        }
+
+        MPI_Group_excl(dsmgroup, index, ServerIds, &workers);
+        int testval = MPI_Comm_create(comm, workers, &workerComm);
+        free(ServerIds);
+
+        shared_ptr<XdmfHDF5WriterDSM> exampleWriter = XdmfHDF5WriterDSM::New(newPath, comm, dsmSize/numServersCores, size-numServersCores, size-1);
+
+        // Server cores will not progress to this point until after the servers are done running
+
+        if (id < size - (int)numServersCores)
+        {
+                XdmfDSMBuffer * buffer = exampleWriter->getServerBuffer();
+
+                int workerSize;
+                MPI_Comm_size(workerComm, &workerSize);
+
+                // Each core writes a block spanning the boundary between
+                // server buffers and reads back the block of the next core.
+                long blockLength = buffer->GetTotalLength() / (2 * workerSize);
+                long writeAddress = (buffer->GetTotalLength() / 2) - (workerSize * blockLength) / 2 + id * blockLength;
+                long readAddress = (buffer->GetTotalLength() / 2) - (workerSize * blockLength) / 2 + ((id + 1) % workerSize) * blockLength;
+
+                std::vector<char> writeData(blockLength);
+                std::vector<char> readData(blockLength);
+
+                double messageTime = 0;
+                double rmaTime = 0;
+                double sharedTime = 0;
+
+                for (int transport = XDMF_DSM_TRANSPORT_MESSAGE; transport <= XDMF_DSM_TRANSPORT_SHARED; ++transport)
+                {
+                        buffer->SetTransportType(transport);
+                        assert(buffer->GetTransportType() == transport);
+
+                        for (long i = 0; i < blockLength; ++i)
+                        {
+                                writeData[i] = (char)((i + id + transport) % 127);
+                        }
+
+                        double elapsed = transfer(buffer, workerComm, writeData, readData, writeAddress, readAddress, iterations);
+
+                        int readId = (id + 1) % workerSize;
+                        for (long i = 0; i < blockLength; ++i)
+                        {
+                                assert(readData[i] == (char)((i + readId + transport) % 127));
+                        }
+
+                        // Within the buffer of the first server
+                        contend(buffer, workerComm, id, buffer->GetTotalLength() / 4, iterations);
+
+                        if (transport == XDMF_DSM_TRANSPORT_MESSAGE)
+                        {
+                                messageTime = elapsed;
+                        }
+                        else if (transport == XDMF_DSM_TRANSPORT_RMA)
+                        {
+                                rmaTime = elapsed;
+                        }
+                        else
+                        {
+                                sharedTime = elapsed;
+                        }
+                }
+
+                // Release the window before shutting down the servers
+                buffer->SetTransportType(XDMF_DSM_TRANSPORT_MESSAGE);
+
+                double megaBytes = (2.0 * iterations * blockLength * workerSize) / (1024 * 1024);
+                if (id == 0)
+                {
+                        std::cout << "message transport: " << megaBytes / messageTime << " MB/s" << std::endl;
+                        std::cout << "rma transport: " << megaBytes / rmaTime << " MB/s" << std::endl;
+                        std::cout << "shared transport: " << megaBytes / sharedTime << " MB/s" << std::endl;
+                }
+        }
+
+        if (id == 0)
+        {
+                exampleWriter->stopDSM();
+        }
+
+        MPI_Barrier(comm);
+
+        MPI_Finalize();
+
+        return 0;
+}
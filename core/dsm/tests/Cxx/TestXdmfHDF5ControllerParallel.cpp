@@ -0,0 +1,159 @@
+#include <mpi.h>
+#include <iostream>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfHDF5Controller.hpp"
+#include "XdmfHDF5ControllerParallel.hpp"
+#include "XdmfHDF5Writer.hpp"
+
+int main(int argc, char *argv[])
+{
+  int size, id;
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm_rank(comm, &id);
+  MPI_Comm_size(comm, &size);
+
+  // Rows do not divide evenly between the cores
+  const unsigned int rows = size + 2;
+  const unsigned int columns = 3;
+
+  std::vector<unsigned int> dimensions;
+  dimensions.push_back(rows);
+  dimensions.push_back(columns);
+
+  // One core writes the whole data set serially
+  if (id == 0) {
+    shared_ptr<XdmfArray> values = XdmfArray::New();
+    values->initialize<int>(dimensions);
+    for (unsigned int i = 0; i < rows * columns; ++i) {
+      values->insert(i, (int)i);
+    }
+    shared_ptr<XdmfHDF5Writer> writer =
+      XdmfHDF5Writer::New("TestXdmfHDF5ControllerParallel.h5", true);
+    values->accept(writer);
+  }
+
+  MPI_Barrier(comm);
+
+  shared_ptr<XdmfHDF5ControllerParallel> controller =
+    XdmfHDF5ControllerParallel::New("TestXdmfHDF5ControllerParallel.h5",
+                                    "Data0",
+                                    XdmfArrayType::Int32(),
+                                    std::vector<unsigned int>(2, 0),
+                                    std::vector<unsigned int>(2, 1),
+                                    dimensions,
+                                    dimensions,
+                                    comm);
+
+  assert(controller->getComm() == comm);
+
+  std::vector<unsigned int> localStart = controller->getLocalStart();
+  std::vector<unsigned int> localDimensions = controller->getLocalDimensions();
+
+  assert(localStart.size() == 2);
+  assert(localDimensions.size() == 2);
+  assert(localStart[1] == 0);
+  assert(localDimensions[1] == columns);
+
+  // The shares cover every row once, in rank order
+  unsigned int totalRows = 0;
+  MPI_Allreduce(&localDimensions[0], &totalRows, 1, MPI_UNSIGNED, MPI_SUM, comm);
+  assert(totalRows == rows);
+  unsigned int expectedStart = 0;
+  MPI_Exscan(&localDimensions[0], &expectedStart, 1, MPI_UNSIGNED, MPI_SUM, comm);
+  if (id == 0) {
+    expectedStart = 0;
+  }
+  assert(localStart[0] == expectedStart);
+
+  shared_ptr<XdmfArray> readArray = XdmfArray::New();
+  readArray->insert(controller);
+  readArray->read();
+
+  std::cout << id << ": " << readArray->getValuesString() << std::endl;
+
+  assert(readArray->getSize() == localDimensions[0] * columns);
+  assert(readArray->getDimensions() == localDimensions);
+  for (unsigned int i = 0; i < readArray->getSize(); ++i) {
+    assert(readArray->getValue<int>(i) ==
+           (int)(localStart[0] * columns + i));
+  }
+
+  // With several controllers each share is placed at its array offset
+  const unsigned int shareSize = localDimensions[0] * columns;
+  shared_ptr<XdmfHDF5ControllerParallel> secondController =
+    XdmfHDF5ControllerParallel::New("TestXdmfHDF5ControllerParallel.h5",
+                                    "Data0",
+                                    XdmfArrayType::Int32(),
+                                    std::vector<unsigned int>(2, 0),
+                                    std::vector<unsigned int>(2, 1),
+                                    dimensions,
+                                    dimensions,
+                                    comm);
+  secondController->setArrayOffset(shareSize);
+
+  shared_ptr<XdmfArray> joinedArray = XdmfArray::New();
+  joinedArray->insert(controller);
+  joinedArray->insert(secondController);
+  joinedArray->read();
+
+  std::vector<unsigned int> joinedDimensions;
+  joinedDimensions.push_back(localDimensions[0]);
+  joinedDimensions.push_back(localDimensions[0] > 0 ? 2 * columns : 0);
+  assert(joinedArray->getSize() == 2 * shareSize);
+  assert(joinedArray->getDimensions() == joinedDimensions);
+  for (unsigned int i = 0; i < joinedArray->getSize(); ++i) {
+    assert(joinedArray->getValue<int>(i) ==
+           (int)(localStart[0] * columns + i % shareSize));
+  }
+
+  // Wrapping a serial controller reads the same share of a strided selection
+  std::vector<unsigned int> stride;
+  stride.push_back(2);
+  stride.push_back(1);
+  std::vector<unsigned int> stridedDimensions;
+  stridedDimensions.push_back((rows + 1) / 2);
+  stridedDimensions.push_back(columns);
+
+  shared_ptr<XdmfHDF5Controller> serialController =
+    XdmfHDF5Controller::New("TestXdmfHDF5ControllerParallel.h5",
+                            "Data0",
+                            XdmfArrayType::Int32(),
+                            std::vector<unsigned int>(2, 0),
+                            stride,
+                            stridedDimensions,
+                            dimensions);
+
+  shared_ptr<XdmfHDF5ControllerParallel> wrappedController =
+    XdmfHDF5ControllerParallel::New(serialController, comm);
+
+  assert(wrappedController->getFilePath() == serialController->getFilePath());
+  assert(wrappedController->getDataSetPath() == serialController->getDataSetPath());
+  assert(wrappedController->getStride() == stride);
+
+  localStart = wrappedController->getLocalStart();
+  localDimensions = wrappedController->getLocalDimensions();
+
+  // Some cores have no rows of the strided selection and read nothing
+  shared_ptr<XdmfArray> stridedArray = XdmfArray::New();
+  stridedArray->insert(wrappedController);
+  stridedArray->read();
+
+  assert(stridedArray->getSize() == localDimensions[0] * columns);
+  assert(stridedArray->getDimensions() == localDimensions);
+  for (unsigned int i = 0; i < localDimensions[0]; ++i) {
+    for (unsigned int j = 0; j < columns; ++j) {
+      assert(stridedArray->getValue<int>(i * columns + j) ==
+             (int)((localStart[0] + i) * 2 * columns + j));
+    }
+  }
+
+  MPI_Barrier(comm);
+
+  MPI_Finalize();
+
+  return 0;
+}
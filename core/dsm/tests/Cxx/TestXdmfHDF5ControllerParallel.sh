@@ -0,0 +1 @@
+$MPIEXEC -n 4 ./TestXdmfHDF5ControllerParallel
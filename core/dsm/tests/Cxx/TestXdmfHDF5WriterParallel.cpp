@@ -0,0 +1,86 @@
+#include <mpi.h>
+#include <iostream>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfHDF5Controller.hpp"
+#include "XdmfHDF5WriterParallel.hpp"
+
+int main(int argc, char *argv[])
+{
+  int size, id;
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm_rank(comm, &id);
+  MPI_Comm_size(comm, &size);
+
+  // Each core holds a different number of values, the last none
+  shared_ptr<XdmfArray> values = XdmfArray::New();
+  shared_ptr<XdmfArray> moreValues = XdmfArray::New();
+  if (id < size - 1 || size == 1) {
+    for (int i = 0; i <= id; ++i) {
+      values->pushBack(id * 10 + i);
+      moreValues->pushBack(id + i / 2.0);
+    }
+  }
+
+  shared_ptr<XdmfHDF5WriterParallel> writer =
+    XdmfHDF5WriterParallel::New("TestXdmfHDF5WriterParallel.h5", comm, true);
+
+  values->accept(writer);
+  moreValues->accept(writer);
+
+  unsigned int totalSize = 0;
+  for (int i = 0; i < size; ++i) {
+    if (i < size - 1 || size == 1) {
+      totalSize += i + 1;
+    }
+  }
+
+  // Every core, the one without values included, describes the whole
+  // dataset so the light data of any core refers to the complete field
+  assert(values->getNumberHeavyDataControllers() == 1);
+  assert(!values->isInitialized());
+  shared_ptr<XdmfHDF5Controller> controller =
+    shared_dynamic_cast<XdmfHDF5Controller>(values->getHeavyDataController(0));
+  assert(controller);
+  assert(controller->getStart()[0] == 0);
+  assert(controller->getDimensions()[0] == totalSize);
+  assert(controller->getDataspaceDimensions()[0] == totalSize);
+  assert(values->getDimensions()[0] == totalSize);
+
+  // Both arrays share one file, each in its own dataset
+  assert(moreValues->getNumberHeavyDataControllers() == 1);
+  shared_ptr<XdmfHDF5Controller> moreController =
+    shared_dynamic_cast<XdmfHDF5Controller>(moreValues->getHeavyDataController(0));
+  assert(moreController->getFilePath() == controller->getFilePath());
+  assert(moreController->getDataSetPath() != controller->getDataSetPath());
+
+  writer->closeFile();
+
+  MPI_Barrier(comm);
+
+  // Every core reads back the values written by all of them
+  values->read();
+
+  if (id == 0) {
+    std::cout << values->getValuesString() << std::endl;
+  }
+
+  assert(values->getSize() == totalSize);
+  unsigned int index = 0;
+  for (int i = 0; i < size; ++i) {
+    if (i < size - 1 || size == 1) {
+      for (int j = 0; j <= i; ++j) {
+        assert(values->getValue<int>(index++) == i * 10 + j);
+      }
+    }
+  }
+
+  MPI_Barrier(comm);
+
+  MPI_Finalize();
+
+  return 0;
+}
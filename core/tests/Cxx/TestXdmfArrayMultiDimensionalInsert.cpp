@@ -48,5 +48,41 @@ int main(int, char **)
 
 	assert(readArray->getValuesString().compare("1 0 3 0 5 0 0 0 0 0 0 0 11 0 13 0 15 0 0 0 0 0 0 0") == 0);
 
+	// Rows of different lengths, converting to another type
+
+	shared_ptr<XdmfArray> convertedArray = XdmfArray::New();
+	std::vector<unsigned int> convertedDimensionVector;
+	convertedDimensionVector.push_back(2);
+	convertedDimensionVector.push_back(3);
+	convertedArray->initialize<double>(convertedDimensionVector);
+
+	std::vector<unsigned int> convertedStarts(2, 0);
+	std::vector<unsigned int> convertedStrides(2, 1);
+	std::vector<unsigned int> convertedDim;
+	convertedDim.push_back(2);
+	convertedDim.push_back(3);
+
+	convertedArray->insert(convertedStarts, writtenArray, writeStarts, writeDim, convertedDim, convertedStrides, writeStrides);
+
+	std::cout << convertedArray->getValuesString() << " ?= " << "1 3 5 11 13 15" << std::endl;
+
+	assert(convertedArray->getArrayType() == XdmfArrayType::Float64());
+	assert(convertedArray->getValuesString().compare("1 3 5 11 13 15") == 0);
+
+	// Inserting an array into itself
+
+	std::vector<unsigned int> selfStarts;
+	selfStarts.push_back(1);
+	selfStarts.push_back(0);
+	std::vector<unsigned int> selfDim;
+	selfDim.push_back(4);
+	selfDim.push_back(4);
+
+	writtenArray->insert(selfStarts, writtenArray, writeStarts, selfDim, selfDim, convertedStrides, convertedStrides);
+
+	std::cout << writtenArray->getValuesString() << " ?= " << "1 1 2 3 4 6 6 7 8 9 11 11 12 13 14 16 16 17 18 19" << std::endl;
+
+	assert(writtenArray->getValuesString().compare("1 1 2 3 4 6 6 7 8 9 11 11 12 13 14 16 16 17 18 19") == 0);
+
 	return 0;
 }
@@ -0,0 +1,151 @@
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfHDF5Controller.hpp"
+#include "XdmfHDF5Writer.hpp"
+#include <hdf5.h>
+#include <iostream>
+
+std::string
+getDataSetPath(const shared_ptr<XdmfArray> array)
+{
+  return shared_dynamic_cast<XdmfHDF5Controller>
+    (array->getHeavyDataController())->getDataSetPath();
+}
+
+shared_ptr<XdmfArray>
+createArray(const int offset)
+{
+  shared_ptr<XdmfArray> array = XdmfArray::New();
+  array->initialize<int>(100);
+  for(int i = 0; i < 100; ++i) {
+    array->insert(i, i + offset);
+  }
+  return array;
+}
+
+int main(int, char **)
+{
+  shared_ptr<XdmfHDF5Writer> writer =
+    XdmfHDF5Writer::New("hdf5WriterDeduplicate.h5", true);
+  assert(!writer->getDeduplicate());
+  writer->setDeduplicate(true);
+  assert(writer->getDeduplicate());
+
+  shared_ptr<XdmfArray> first = createArray(0);
+  shared_ptr<XdmfArray> second = createArray(0);
+  shared_ptr<XdmfArray> different = createArray(1);
+  shared_ptr<XdmfArray> reshaped = createArray(0);
+  std::vector<unsigned int> dimensions(2, 10);
+  reshaped->resize(dimensions, 0);
+  shared_ptr<XdmfArray> retyped = XdmfArray::New();
+  retyped->initialize<unsigned int>(100);
+  retyped->insert(0, &(first->getValuesInternal<int>()->operator[](0)), 100);
+
+  first->accept(writer);
+  second->accept(writer);
+  different->accept(writer);
+  reshaped->accept(writer);
+  retyped->accept(writer);
+
+  std::cout << getDataSetPath(first) << " ?= " << getDataSetPath(second)
+            << std::endl;
+
+  // Identical contents share a dataset
+  assert(getDataSetPath(first) == getDataSetPath(second));
+  // Different values, dimensions, or types do not
+  assert(getDataSetPath(first) != getDataSetPath(different));
+  assert(getDataSetPath(first) != getDataSetPath(reshaped));
+  assert(getDataSetPath(first) != getDataSetPath(retyped));
+  assert(getDataSetPath(reshaped) != getDataSetPath(retyped));
+
+  second->release();
+  second->read();
+  assert(second->getSize() == 100);
+  assert(second->getValue<int>(99) == 99);
+
+  reshaped->release();
+  reshaped->read();
+  assert(reshaped->getDimensions() == dimensions);
+
+  //
+  // Hashes persist in the file for later writers
+  //
+
+  shared_ptr<XdmfHDF5Writer> appendWriter =
+    XdmfHDF5Writer::New("hdf5WriterDeduplicate.h5", false);
+  appendWriter->setDeduplicate(true);
+  appendWriter->setMode(XdmfHDF5Writer::Append);
+
+  shared_ptr<XdmfArray> later = createArray(0);
+  later->accept(appendWriter);
+
+  std::cout << getDataSetPath(first) << " ?= " << getDataSetPath(later)
+            << std::endl;
+
+  assert(getDataSetPath(first) == getDataSetPath(later));
+
+  // Appending to a dataset changes its contents, so it is no longer
+  // matched
+  different->accept(appendWriter);
+  assert(different->getHeavyDataController()->getSize() == 200);
+
+  shared_ptr<XdmfArray> differentAgain = createArray(1);
+  differentAgain->accept(appendWriter);
+
+  assert(getDataSetPath(different) != getDataSetPath(differentAgain));
+
+  //
+  // Overwriting a dataset also removes its hash
+  //
+
+  writer->setMode(XdmfHDF5Writer::Overwrite);
+  first->insert(0, 50);
+  first->accept(writer);
+
+  writer->setMode(XdmfHDF5Writer::Default);
+  shared_ptr<XdmfArray> afterOverwrite = createArray(0);
+  afterOverwrite->accept(writer);
+
+  assert(getDataSetPath(first) != getDataSetPath(afterOverwrite));
+
+  //
+  // A matching hash is not trusted without comparing the values
+  //
+
+  shared_ptr<XdmfArray> collided = createArray(2);
+  collided->accept(writer);
+  writer->closeFile();
+
+  // Change the values behind the writer, keeping the hash
+  hid_t file = H5Fopen("hdf5WriterDeduplicate.h5", H5F_ACC_RDWR, H5P_DEFAULT);
+  hid_t dataset = H5Dopen(file, getDataSetPath(collided).c_str(), H5P_DEFAULT);
+  std::vector<int> changed(100, -1);
+  H5Dwrite(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+           &changed[0]);
+  H5Dclose(dataset);
+  H5Fclose(file);
+
+  shared_ptr<XdmfHDF5Writer> laterWriter =
+    XdmfHDF5Writer::New("hdf5WriterDeduplicate.h5", false);
+  laterWriter->setDeduplicate(true);
+  shared_ptr<XdmfArray> collidedAgain = createArray(2);
+  collidedAgain->accept(laterWriter);
+
+  assert(getDataSetPath(collided) != getDataSetPath(collidedAgain));
+
+  collidedAgain->release();
+  collidedAgain->read();
+  assert(collidedAgain->getValue<int>(0) == 2);
+
+  //
+  // Without deduplication every write creates a dataset
+  //
+
+  writer->setDeduplicate(false);
+  shared_ptr<XdmfArray> copy = createArray(0);
+  copy->accept(writer);
+
+  assert(getDataSetPath(copy) != getDataSetPath(afterOverwrite));
+
+  return 0;
+}
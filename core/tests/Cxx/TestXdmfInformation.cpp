@@ -1,5 +1,6 @@
 #include "XdmfInformation.hpp"
 #include <iostream>
+#include <sstream>
 
 int main(int, char **)
 {
@@ -67,5 +68,86 @@ int main(int, char **)
 
   assert(information->getNumberInformations() == 0);
 
+  // Enough children to be looked up through the index
+  std::vector<shared_ptr<XdmfInformation> > children;
+  for(unsigned int i = 0; i < 100; ++i) {
+    std::stringstream key;
+    key << "Key" << i % 50;
+    children.push_back(XdmfInformation::New(key.str(), "Value"));
+    information->insert(children.back());
+  }
+
+  // Duplicate keys find the first child with that key
+  std::cout << information->getInformation("Key7") << " ?= " << children[7]
+            << std::endl;
+
+  assert(information->getInformation("Key7") == children[7]);
+  assert(information->getInformation("Key49") == children[49]);
+  assert(information->getInformation("foo") == NULL);
+
+  // Renamed children are found under their new key
+  children[3]->setKey("Renamed");
+  children[60]->setKey("Key3");
+
+  std::cout << information->getInformation("Renamed") << " ?= "
+            << children[3] << std::endl;
+  std::cout << information->getInformation("Key3") << " ?= "
+            << children[53] << std::endl;
+
+  assert(information->getInformation("Renamed") == children[3]);
+  assert(information->getInformation("Key3") == children[53]);
+  assert(information->getInformation("Key10") == children[10]);
+
+  information->removeInformation(7);
+  assert(information->getInformation("Key7") == children[57]);
+  information->removeInformation("Key8");
+  assert(information->getInformation("Key8") == children[58]);
+  assert(information->getInformation(7) == children[9]);
+
+  std::cout << information->getNumberInformations() << " ?= " << 98
+            << std::endl;
+
+  assert(information->getNumberInformations() == 98);
+
+  // An earlier child renamed to the key of a later one is found first
+  shared_ptr<XdmfInformation> renamedParent = XdmfInformation::New();
+  std::vector<shared_ptr<XdmfInformation> > named;
+  for(unsigned int i = 0; i < 20; ++i) {
+    std::stringstream key;
+    key << "k" << i;
+    named.push_back(XdmfInformation::New(key.str(), "Value"));
+    renamedParent->insert(named.back());
+  }
+  assert(renamedParent->getInformation("k10") == named[10]);
+
+  renamedParent->getInformation(3)->setKey("k10");
+
+  std::cout << renamedParent->getInformation("k10") << " ?= " << named[3]
+            << std::endl;
+
+  assert(renamedParent->getInformation("k10") == named[3]);
+
+  // Const lookups find it before the index is rebuilt
+  named[5]->setKey("k12");
+  const XdmfInformation & constParent = *renamedParent;
+  assert(constParent.getInformation("k12") == named[5]);
+
+  renamedParent->removeInformation("k10");
+  assert(renamedParent->getInformation(3) == named[4]);
+  assert(renamedParent->getInformation("k10") == named[10]);
+
+  // Removals keep the positions of the children after them
+  renamedParent->removeInformation("k12");
+  renamedParent->removeInformation("k0");
+  assert(renamedParent->getInformation("k12") == named[12]);
+  assert(renamedParent->getInformation("k19") == named[19]);
+  assert(renamedParent->getInformation("k1") == named[1]);
+  assert(renamedParent->getInformation(0) == named[1]);
+
+  std::cout << renamedParent->getNumberInformations() << " ?= " << 17
+            << std::endl;
+
+  assert(renamedParent->getNumberInformations() == 17);
+
   return 0;
 }
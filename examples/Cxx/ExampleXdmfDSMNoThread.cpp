@@ -317,13 +317,13 @@ int main(int argc, char *argv[])
 
                 //#GetStartAddress begin
 
-                int exampleBufferStart = exampleBuffer->GetStartAddress();
+                long exampleBufferStart = exampleBuffer->GetStartAddress();
 
                 //#GetStartAddress end
 
                 //#GetEndAddress begin
 
-                int exampleBufferEnd = exampleBuffer->GetEndAddress();
+                long exampleBufferEnd = exampleBuffer->GetEndAddress();
 
                 //#GetEndAddress end
 
@@ -405,8 +405,8 @@ int main(int argc, char *argv[])
                         {
                                 std::cout << "IntraComm" << std::endl;
                         }
-                        int length;
-                        int address;
+                        long length;
+                        long address;
                         int opcode;
                         int source;
                         exampleBuffer->ReceiveCommandHeader(&opcode, &source, &length, &address, XDMF_DSM_INTRA_COMM, 0);
@@ -485,8 +485,8 @@ int main(int argc, char *argv[])
 
                 //#GetAddressRangeForId begin
 
-                int core0StartAddress = 0;
-                int core0EndAddress = 0;
+                long core0StartAddress = 0;
+                long core0EndAddress = 0;
                 exampleBuffer->GetAddressRangeForId(0, &core0StartAddress, &core0EndAddress);
 
                 //#GetAddressRangeForId end
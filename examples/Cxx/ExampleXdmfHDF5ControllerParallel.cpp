@@ -0,0 +1,103 @@
+#include <mpi.h>
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfHDF5Controller.hpp"
+#include "XdmfHDF5ControllerParallel.hpp"
+
+int main(int argc, char *argv[])
+{
+        //#initMPI begin
+
+        int size, id;
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init(&argc, &argv);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        //#initMPI end
+
+        //#initialization begin
+
+        std::string newPath = "File path to hdf5 file goes here";
+        std::string newSetPath = "path to the set goes here";
+        shared_ptr<const XdmfArrayType> readType = XdmfArrayType::Int32();
+        std::vector<unsigned int> readStarts;
+        //Three dimensions, all starting at index 0
+        readStarts.push_back(0);
+        readStarts.push_back(0);
+        readStarts.push_back(0);
+        std::vector<unsigned int> readStrides;
+        //Three dimensions, no skipping between reads
+        readStrides.push_back(1);
+        readStrides.push_back(1);
+        readStrides.push_back(1);
+        std::vector<unsigned int> readCounts;
+        //Three dimensions, reading 10 values from each
+        readCounts.push_back(10);
+        readCounts.push_back(10);
+        readCounts.push_back(10);
+        std::vector<unsigned int> readDataSize;
+        //Three dimensions, each with a maximum of 20 values
+        readDataSize.push_back(20);
+        readDataSize.push_back(20);
+        readDataSize.push_back(20);
+        shared_ptr<XdmfHDF5ControllerParallel> exampleController =
+          XdmfHDF5ControllerParallel::New(newPath,
+                                          newSetPath,
+                                          readType,
+                                          readStarts,
+                                          readStrides,
+                                          readCounts,
+                                          readDataSize,
+                                          comm);
+
+        // Every core reads its share of the first dimension
+        shared_ptr<XdmfArray> exampleArray = XdmfArray::New();
+        exampleArray->insert(exampleController);
+        exampleArray->read();
+
+        //#initialization end
+
+        //#initializationcontroller begin
+
+        shared_ptr<XdmfHDF5Controller> serialController =
+          XdmfHDF5Controller::New(newPath,
+                                  newSetPath,
+                                  readType,
+                                  readStarts,
+                                  readStrides,
+                                  readCounts,
+                                  readDataSize);
+        shared_ptr<XdmfHDF5ControllerParallel> wrappedController =
+          XdmfHDF5ControllerParallel::New(serialController, comm);
+
+        //#initializationcontroller end
+
+        //#getComm begin
+
+        MPI_Comm exampleComm = exampleController->getComm();
+
+        //#getComm end
+
+        //#getLocalDimensions begin
+
+        std::vector<unsigned int> exampleDimensions = exampleController->getLocalDimensions();
+
+        //#getLocalDimensions end
+
+        //#getLocalStart begin
+
+        std::vector<unsigned int> exampleStart = exampleController->getLocalStart();
+
+        //#getLocalStart end
+
+        //#finalizeMPI begin
+
+        MPI_Finalize();
+
+        //#finalizeMPI end
+
+        return 0;
+}
@@ -53,5 +53,23 @@ int main(int, char **)
 
         //#getDeflateFactor
 
+        //#setDeduplicate
+
+        exampleWriter->setDeduplicate(true);
+
+        //#setDeduplicate
+
+        //#getDeduplicate
+
+        bool isDeduplicating = exampleWriter->getDeduplicate();
+
+        //#getDeduplicate
+
+        //#getFileIsOpen
+
+        bool isOpen = exampleWriter->getFileIsOpen();
+
+        //#getFileIsOpen
+
         return 0;
 }
@@ -0,0 +1,49 @@
+#include <mpi.h>
+#include "XdmfArray.hpp"
+#include "XdmfHDF5WriterParallel.hpp"
+
+int main(int argc, char *argv[])
+{
+        //#initMPI begin
+
+        int size, id;
+        MPI_Comm comm = MPI_COMM_WORLD;
+
+        MPI_Init(&argc, &argv);
+
+        MPI_Comm_rank(comm, &id);
+        MPI_Comm_size(comm, &size);
+
+        //#initMPI end
+
+        //#initialization begin
+
+        std::string newPath = "File path to hdf5 file goes here";
+        bool replaceFile = true;
+        shared_ptr<XdmfHDF5WriterParallel> exampleWriter =
+          XdmfHDF5WriterParallel::New(newPath, comm, replaceFile);
+
+        // Every core writes its own values to the same dataset
+        shared_ptr<XdmfArray> exampleArray = XdmfArray::New();
+        for (int i = 0; i < 10; ++i)
+        {
+                exampleArray->pushBack(id * 10 + i);
+        }
+        exampleArray->accept(exampleWriter);
+
+        //#initialization end
+
+        //#getComm begin
+
+        MPI_Comm exampleComm = exampleWriter->getComm();
+
+        //#getComm end
+
+        //#finalizeMPI begin
+
+        MPI_Finalize();
+
+        //#finalizeMPI end
+
+        return 0;
+}
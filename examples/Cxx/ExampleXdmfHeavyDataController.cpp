@@ -66,6 +66,12 @@ int main(int, char **)
 
         //#getName end
 
+        //#getReadDimensions begin
+
+        std::vector<unsigned int> exampleReadDimensions = exampleController->getReadDimensions();
+
+        //#getReadDimensions end
+
         //#getSize begin
 
         unsigned int exampleSize = exampleController->getSize();
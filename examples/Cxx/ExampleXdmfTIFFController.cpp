@@ -52,5 +52,17 @@ int main(int, char **)
 
         //#initializationsimplified end
 
+        //#setNumberThreads begin
+
+        exampleController->setNumberThreads(4);
+
+        //#setNumberThreads end
+
+        //#getNumberThreads begin
+
+        unsigned int exampleThreads = exampleController->getNumberThreads();
+
+        //#getNumberThreads end
+
         return 0;
 }
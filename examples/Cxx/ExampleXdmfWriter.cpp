@@ -91,6 +91,30 @@ int main(int, char **)
 
         //#setRebuildXML end
 
+        //#getStreamXML begin
+
+        bool exampleStreamStatus = exampleWriter->getStreamXML();
+
+        //#getStreamXML end
+
+        //#setStreamXML begin
+
+        exampleWriter->setStreamXML(true);
+
+        //#setStreamXML end
+
+        //#getWriteImplicit begin
+
+        bool exampleImplicitStatus = exampleWriter->getWriteImplicit();
+
+        //#getWriteImplicit end
+
+        //#setWriteImplicit begin
+
+        exampleWriter->setWriteImplicit(true);
+
+        //#setWriteImplicit end
+
         //#getXPathParse begin
 
         bool exampleXPathParse = exampleWriter->getXPathParse();
@@ -0,0 +1,86 @@
+from Xdmf import *
+from mpi4py.MPI import *
+
+if __name__ == "__main__":
+        #//initMPI begin
+
+        comm = COMM_WORLD
+
+        id = comm.Get_rank()
+        size = comm.Get_size()
+
+        #//initMPI end
+
+        #//initialization begin
+
+        newPath = "File path to hdf5 file goes here"
+        newSetPath = "path to the set goes here"
+        readType = XdmfArrayType.Int32()
+        readStarts = UInt32Vector()
+        #Three dimensions, all starting at index 0
+        readStarts.push_back(0)
+        readStarts.push_back(0)
+        readStarts.push_back(0)
+        readStrides = UInt32Vector()
+        #Three dimensions, no skipping between reads
+        readStrides.push_back(1)
+        readStrides.push_back(1)
+        readStrides.push_back(1)
+        readCounts = UInt32Vector()
+        #Three dimensions, reading 10 values from each
+        readCounts.push_back(10)
+        readCounts.push_back(10)
+        readCounts.push_back(10)
+        readDataSize = UInt32Vector()
+        #Three dimensions, each with a maximum of 20 values
+        readDataSize.push_back(20)
+        readDataSize.push_back(20)
+        readDataSize.push_back(20)
+        exampleController = XdmfHDF5ControllerParallel.New(
+                newPath,
+                newSetPath,
+                readType,
+                readStarts,
+                readStrides,
+                readCounts,
+                readDataSize,
+                comm)
+
+        # Every core reads its share of the first dimension
+        exampleArray = XdmfArray.New()
+        exampleArray.insert(exampleController)
+        exampleArray.read()
+
+        #//initialization end
+
+        #//initializationcontroller begin
+
+        serialController = XdmfHDF5Controller.New(
+                newPath,
+                newSetPath,
+                readType,
+                readStarts,
+                readStrides,
+                readCounts,
+                readDataSize)
+        wrappedController = XdmfHDF5ControllerParallel.New(serialController, comm)
+
+        #//initializationcontroller end
+
+        #//getComm begin
+
+        exampleComm = exampleController.getComm()
+
+        #//getComm end
+
+        #//getLocalDimensions begin
+
+        exampleDimensions = exampleController.getLocalDimensions()
+
+        #//getLocalDimensions end
+
+        #//getLocalStart begin
+
+        exampleStart = exampleController.getLocalStart()
+
+        #//getLocalStart end
@@ -51,3 +51,21 @@ if __name__ == "__main__":
         currentDeflateFactor = exampleWriter.getDeflateFactor()
 
         #//getDeflateFactor
+
+        #//setDeduplicate
+
+        exampleWriter.setDeduplicate(True)
+
+        #//setDeduplicate
+
+        #//getDeduplicate
+
+        isDeduplicating = exampleWriter.getDeduplicate()
+
+        #//getDeduplicate
+
+        #//getFileIsOpen
+
+        isOpen = exampleWriter.getFileIsOpen()
+
+        #//getFileIsOpen
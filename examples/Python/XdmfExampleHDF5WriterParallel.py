@@ -0,0 +1,32 @@
+from Xdmf import *
+from mpi4py.MPI import *
+
+if __name__ == "__main__":
+        #//initMPI begin
+
+        comm = COMM_WORLD
+
+        id = comm.Get_rank()
+        size = comm.Get_size()
+
+        #//initMPI end
+
+        #//initialization begin
+
+        newPath = "File path to hdf5 file goes here"
+        replaceFile = True
+        exampleWriter = XdmfHDF5WriterParallel.New(newPath, comm, replaceFile)
+
+        # Every core writes its own values to the same dataset
+        exampleArray = XdmfArray.New()
+        for i in range(10):
+                exampleArray.pushBackAsInt32(id * 10 + i)
+        exampleArray.accept(exampleWriter)
+
+        #//initialization end
+
+        #//getComm begin
+
+        exampleComm = exampleWriter.getComm()
+
+        #//getComm end
@@ -63,6 +63,12 @@ if __name__ == "__main__":
 
         #//getName end
 
+        #//getReadDimensions begin
+
+        exampleReadDimensions = exampleController.getReadDimensions()
+
+        #//getReadDimensions end
+
         #//getSize begin
 
         exampleSize = exampleController.getSize()
@@ -50,3 +50,15 @@ if __name__ == "__main__":
                 readCounts)
 
         #//initializationsimplified end
+
+        #//setNumberThreads begin
+
+        exampleController.setNumberThreads(4)
+
+        #//setNumberThreads end
+
+        #//getNumberThreads begin
+
+        exampleThreads = exampleController.getNumberThreads()
+
+        #//getNumberThreads end
@@ -64,6 +64,30 @@ if __name__ == "__main__":
 
         #//setRebuildXML end
 
+        #//getStreamXML begin
+
+        exampleStreamStatus = exampleWriter.getStreamXML()
+
+        #//getStreamXML end
+
+        #//setStreamXML begin
+
+        exampleWriter.setStreamXML(True)
+
+        #//setStreamXML end
+
+        #//getWriteImplicit begin
+
+        exampleImplicitStatus = exampleWriter.getWriteImplicit()
+
+        #//getWriteImplicit end
+
+        #//setWriteImplicit begin
+
+        exampleWriter.setWriteImplicit(True)
+
+        #//setWriteImplicit end
+
         #//getWriteXPaths begin
 
         exampleTestPaths = exampleWriter.getWriteXPaths()
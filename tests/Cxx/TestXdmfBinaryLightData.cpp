@@ -0,0 +1,133 @@
+#include "XdmfAttribute.hpp"
+#include "XdmfAttributeCenter.hpp"
+#include "XdmfAttributeType.hpp"
+#include "XdmfBinaryLightData.hpp"
+#include "XdmfBinaryLightDataWriter.hpp"
+#include "XdmfDomain.hpp"
+#include "XdmfGridCollection.hpp"
+#include "XdmfGridCollectionType.hpp"
+#include "XdmfInformation.hpp"
+#include "XdmfReader.hpp"
+#include "XdmfWriter.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "XdmfTestDataGenerator.hpp"
+
+std::string
+readFile(const std::string & filePath)
+{
+  std::ifstream fileStream(filePath.c_str());
+  std::stringstream contents;
+  contents << fileStream.rdbuf();
+  return contents.str();
+}
+
+int main(int, char **)
+{
+  shared_ptr<XdmfDomain> domain = XdmfDomain::New();
+  domain->insert(XdmfInformation::New("Key", "Value & <Escaped>"));
+
+  shared_ptr<XdmfGridCollection> collection = XdmfGridCollection::New();
+  collection->setType(XdmfGridCollectionType::Temporal());
+  domain->insert(collection);
+
+  for (unsigned int step = 0; step < 3; ++step) {
+    shared_ptr<XdmfUnstructuredGrid> grid =
+      XdmfTestDataGenerator::createHexahedron();
+    grid->getTime()->setValue(step);
+    collection->insert(grid);
+  }
+
+  shared_ptr<XdmfAttribute> names = XdmfAttribute::New();
+  names->setName("Names");
+  names->setCenter(XdmfAttributeCenter::Grid());
+  names->setType(XdmfAttributeType::Scalar());
+  names->pushBack(std::string("First"));
+  names->pushBack(std::string("Second"));
+  collection->getUnstructuredGrid(0)->insert(names);
+
+  // Written again as an xpath
+  domain->insert(collection->getUnstructuredGrid(1));
+
+  shared_ptr<XdmfWriter> writer =
+    XdmfWriter::New("TestXdmfBinaryLightData1.xmf");
+  domain->accept(writer);
+
+  shared_ptr<XdmfBinaryLightDataWriter> binaryWriter =
+    XdmfBinaryLightDataWriter::New("TestXdmfBinaryLightData2.xmfb");
+  domain->accept(binaryWriter);
+
+  assert(!XdmfBinaryLightData::isBinary("TestXdmfBinaryLightData1.xmf"));
+  assert(XdmfBinaryLightData::isBinary("TestXdmfBinaryLightData2.xmfb"));
+
+  const std::string written = readFile("TestXdmfBinaryLightData1.xmf");
+
+  std::cout << "XML size: " << written.size() << " binary size: "
+            << readFile("TestXdmfBinaryLightData2.xmfb").size() << std::endl;
+
+  assert(readFile("TestXdmfBinaryLightData2.xmfb").size() < written.size());
+
+  // Converted to the same XML as written by XdmfWriter
+
+  XdmfBinaryLightData::toXML("TestXdmfBinaryLightData2.xmfb",
+                             "TestXdmfBinaryLightData3.xmf");
+
+  assert(readFile("TestXdmfBinaryLightData3.xmf") == written);
+
+  XdmfBinaryLightData::toBinary("TestXdmfBinaryLightData1.xmf",
+                                "TestXdmfBinaryLightData4.xmfb");
+  XdmfBinaryLightData::toXML("TestXdmfBinaryLightData4.xmfb",
+                             "TestXdmfBinaryLightData3.xmf");
+
+  assert(readFile("TestXdmfBinaryLightData3.xmf") == written);
+
+  // Read the same as XML
+
+  shared_ptr<XdmfReader> reader = XdmfReader::New();
+  shared_ptr<XdmfDomain> readDomain =
+    shared_dynamic_cast<XdmfDomain>(reader->read("TestXdmfBinaryLightData2.xmfb"));
+
+  assert(readDomain);
+
+  readDomain->accept(writer);
+
+  assert(readFile("TestXdmfBinaryLightData1.xmf") == written);
+
+  shared_ptr<XdmfGridCollection> readCollection =
+    readDomain->getGridCollection(0);
+
+  assert(readDomain->getInformation(0)->getValue().compare("Value & <Escaped>") == 0);
+  assert(readCollection->getNumberUnstructuredGrids() == 3);
+  assert(readDomain->getUnstructuredGrid(0) ==
+         readCollection->getUnstructuredGrid(1));
+
+  shared_ptr<XdmfUnstructuredGrid> readGrid =
+    readCollection->getUnstructuredGrid(0);
+  shared_ptr<XdmfUnstructuredGrid> grid =
+    collection->getUnstructuredGrid(0);
+
+  assert(readGrid->getGeometry()->getValuesString() ==
+         grid->getGeometry()->getValuesString());
+  assert(readGrid->getTopology()->getValuesString() ==
+         grid->getTopology()->getValuesString());
+  assert(readGrid->getAttribute("Names")->getValue<std::string>(1) ==
+         "Second");
+
+  // Heavy data is referenced the same as from XML
+
+  binaryWriter->setLightDataLimit(2);
+  domain->accept(binaryWriter);
+
+  readDomain =
+    shared_dynamic_cast<XdmfDomain>(reader->read("TestXdmfBinaryLightData2.xmfb"));
+  readGrid = readDomain->getGridCollection(0)->getUnstructuredGrid(0);
+
+  assert(!readGrid->getGeometry()->isInitialized());
+  readGrid->getGeometry()->read();
+  assert(readGrid->getGeometry()->getValuesString() ==
+         grid->getGeometry()->getValuesString());
+
+  return 0;
+}
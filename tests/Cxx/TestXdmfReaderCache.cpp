@@ -0,0 +1,98 @@
+#include <XdmfDomain.hpp>
+#include <XdmfGridController.hpp>
+#include <XdmfInformation.hpp>
+#include <XdmfReader.hpp>
+#include <XdmfUnstructuredGrid.hpp>
+#include <XdmfWriter.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+void writeGrids(const std::string & prefix)
+{
+  shared_ptr<XdmfDomain> domain = XdmfDomain::New();
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    shared_ptr<XdmfUnstructuredGrid> grid = XdmfUnstructuredGrid::New();
+    std::stringstream name;
+    name << prefix << i;
+    grid->setName(name.str());
+    domain->insert(grid);
+  }
+  shared_ptr<XdmfWriter> writer = XdmfWriter::New("cacheGrids.xmf");
+  domain->accept(writer);
+}
+
+void writeInformation(const std::string & value)
+{
+  std::ofstream innerFile("cacheInner.xmf");
+  innerFile << "<?xml version=\"1.0\" ?><Xdmf Version=\"2.1\"><Domain><Information Name=\"foo\" Value=\"" << value << "\"/></Domain></Xdmf>";
+  innerFile.close();
+}
+
+int main(int, char **)
+{
+  assert(XdmfReader::getDocumentCacheSize() > 0);
+
+  writeGrids("first");
+
+  // Every controller reads from the same file
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    std::stringstream path;
+    path << "/Xdmf/Domain/Grid[" << i + 1 << "]";
+    shared_ptr<XdmfGridController> controller =
+      XdmfGridController::New("cacheGrids.xmf", path.str());
+    std::stringstream name;
+    name << "first" << i;
+    std::cout << controller->read()->getName() << " ?= " << name.str() << std::endl;
+    assert(controller->read()->getName() == name.str());
+  }
+
+  // Rewriting the file replaces the cached document
+  writeGrids("second");
+
+  shared_ptr<XdmfGridController> controller =
+    XdmfGridController::New("cacheGrids.xmf", "/Xdmf/Domain/Grid[3]");
+  std::cout << controller->read()->getName() << " ?= second2" << std::endl;
+  assert(controller->read()->getName() == "second2");
+
+  // XIncludes are resolved through the same cache
+  std::ofstream outerFile("cacheOuter.xmf");
+  outerFile << "<?xml version=\"1.0\" ?><Xdmf Version=\"2.1\" xmlns:xi=\"http://www.w3.org/2001/XInclude\"><Domain><xi:include href=\"cacheInner.xmf\" xpointer=\"element(/1/1/1)\"/></Domain></Xdmf>";
+  outerFile.close();
+
+  writeInformation("bar");
+
+  shared_ptr<XdmfReader> reader = XdmfReader::New();
+
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    shared_ptr<XdmfDomain> outerDomain =
+      shared_dynamic_cast<XdmfDomain>(reader->read("cacheOuter.xmf"));
+    std::cout << outerDomain->getInformation(0)->getValue() << " ?= bar" << std::endl;
+    assert(outerDomain->getInformation(0)->getValue() == "bar");
+  }
+
+  writeInformation("bazz");
+
+  shared_ptr<XdmfDomain> changedDomain =
+    shared_dynamic_cast<XdmfDomain>(reader->read("cacheOuter.xmf"));
+  std::cout << changedDomain->getInformation(0)->getValue() << " ?= bazz" << std::endl;
+  assert(changedDomain->getInformation(0)->getValue() == "bazz");
+
+  // Reading still works with the cache cleared or disabled
+  XdmfReader::clearDocumentCache();
+  XdmfReader::setDocumentCacheSize(0);
+  assert(XdmfReader::getDocumentCacheSize() == 0);
+
+  std::cout << controller->read()->getName() << " ?= second2" << std::endl;
+  assert(controller->read()->getName() == "second2");
+
+  shared_ptr<XdmfDomain> uncachedDomain =
+    shared_dynamic_cast<XdmfDomain>(reader->read("cacheOuter.xmf"));
+  assert(uncachedDomain->getInformation(0)->getValue() == "bazz");
+
+  return 0;
+}
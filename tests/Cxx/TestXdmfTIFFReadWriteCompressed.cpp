@@ -355,5 +355,173 @@ int main(int, char **)
     }
   }
 
+  // Tiled images are decoded a tile at a time
+
+  tif = TIFFOpen("compressedtiles.tif", "w");
+
+  if (tif) {
+    unsigned int w, h, tileSize;
+    w = 100;
+    h = 70;
+    tileSize = 16;
+
+    for (unsigned int dirID = 0; dirID < 4; ++dirID)
+    {
+      TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
+      TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
+      TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 1);
+      TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 16);
+      TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_UINT);
+      TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+      TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
+      TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+      TIFFSetField(tif, TIFFTAG_TILEWIDTH, tileSize);
+      TIFFSetField(tif, TIFFTAG_TILELENGTH, tileSize);
+
+      std::vector<unsigned short> tile(tileSize * tileSize);
+      unsigned int tileIndex = 0;
+      for (unsigned int tileRow = 0; tileRow < h; tileRow += tileSize)
+      {
+        for (unsigned int tileColumn = 0; tileColumn < w; tileColumn += tileSize)
+        {
+          for (unsigned int i = 0; i < tileSize; ++i)
+          {
+            for (unsigned int j = 0; j < tileSize; ++j)
+            {
+              tile[i * tileSize + j] =
+                dirID * 10000 + (tileRow + i) * 100 + tileColumn + j;
+            }
+          }
+          TIFFWriteEncodedTile(tif,
+                               tileIndex++,
+                               &tile[0],
+                               tile.size() * sizeof(unsigned short));
+        }
+      }
+      TIFFWriteDirectory(tif);
+    }
+  }
+
+  TIFFClose(tif);
+
+  std::vector<unsigned int> tilestarts;
+  tilestarts.push_back(3);
+  tilestarts.push_back(5);
+  tilestarts.push_back(1);
+  std::vector<unsigned int> tilestrides;
+  tilestrides.push_back(7);
+  tilestrides.push_back(3);
+  tilestrides.push_back(2);
+  std::vector<unsigned int> tiledims;
+  tiledims.push_back(14);
+  tiledims.push_back(22);
+  tiledims.push_back(2);
+  std::vector<unsigned int> tiledataspace;
+  tiledataspace.push_back(100);
+  tiledataspace.push_back(70);
+  tiledataspace.push_back(4);
+
+  for (unsigned int numberThreads = 1; numberThreads <= 4; numberThreads *= 4)
+  {
+    shared_ptr<XdmfTIFFController> tilecontroller =
+      XdmfTIFFController::New("compressedtiles.tif",
+                              XdmfArrayType::UInt16(),
+                              tilestarts,
+                              tilestrides,
+                              tiledims,
+                              tiledataspace);
+    tilecontroller->setNumberThreads(numberThreads);
+
+    assert(tilecontroller->getNumberThreads() == numberThreads);
+
+    shared_ptr<XdmfArray> tileArray = XdmfArray::New();
+
+    tileArray->insert(tilecontroller);
+
+    tileArray->read();
+
+    assert(tileArray->getSize() == 14 * 22 * 2);
+
+    for (unsigned int k = 0; k < 2; ++k)
+    {
+      for (unsigned int i = 0; i < 22; ++i)
+      {
+        for (unsigned int j = 0; j < 14; ++j)
+        {
+          assert(tileArray->getValue<unsigned int>((k * 22 + i) * 14 + j) ==
+                 (1 + 2 * k) * 10000 + (5 + 3 * i) * 100 + 3 + 7 * j);
+        }
+      }
+    }
+  }
+
+  // Stripped images of a single directory read as two dimensions
+
+  tif = TIFFOpen("compressedstrips.tif", "w");
+
+  if (tif) {
+    unsigned int w, h;
+    w = 50;
+    h = 40;
+
+    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
+    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
+    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 1);
+    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 32);
+    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
+    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
+    TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, 3);
+
+    std::vector<float> scanline(w);
+    for (unsigned int i = 0; i < h; ++i)
+    {
+      for (unsigned int j = 0; j < w; ++j)
+      {
+        scanline[j] = i + j / 100.0f;
+      }
+      TIFFWriteScanline(tif, &scanline[0], i, 0);
+    }
+  }
+
+  TIFFClose(tif);
+
+  std::vector<unsigned int> stripstarts;
+  stripstarts.push_back(1);
+  stripstarts.push_back(2);
+  std::vector<unsigned int> stripstrides;
+  stripstrides.push_back(4);
+  stripstrides.push_back(5);
+  std::vector<unsigned int> stripdims;
+  stripdims.push_back(12);
+  stripdims.push_back(8);
+  std::vector<unsigned int> stripdataspace;
+  stripdataspace.push_back(50);
+  stripdataspace.push_back(40);
+
+  shared_ptr<XdmfTIFFController> stripcontroller =
+    XdmfTIFFController::New("compressedstrips.tif",
+                            XdmfArrayType::Float32(),
+                            stripstarts,
+                            stripstrides,
+                            stripdims,
+                            stripdataspace);
+
+  shared_ptr<XdmfArray> stripArray = XdmfArray::New();
+
+  stripArray->insert(stripcontroller);
+
+  stripArray->read();
+
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    for (unsigned int j = 0; j < 12; ++j)
+    {
+      assert(stripArray->getValue<float>(i * 12 + j) ==
+             (2 + 5 * i) + (1 + 4 * j) / 100.0f);
+    }
+  }
+
   return 0;
 }
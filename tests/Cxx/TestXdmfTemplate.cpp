@@ -351,6 +351,9 @@ int main(int, char **)
 
   heavyWriter3->setMode(XdmfHeavyDataWriter::Append);
 
+  shared_ptr<XdmfHDF5Writer> appendWriter3 =
+    shared_dynamic_cast<XdmfHDF5Writer>(heavyWriter3);
+
   appendtemp->setHeavyDataWriter(heavyWriter3);
 
   appendtemp->setBase(appendungrid);
@@ -364,8 +367,21 @@ int main(int, char **)
       appendattr3->insert<double>(i, 3.0 * iteration);
     }
 
+    // A file the caller opened stays open across the step
+    if (iteration == 1)
+    {
+      heavyWriter3->openFile();
+    }
+
     appendtemp->addStep();
 
+    assert(appendWriter3->getFileIsOpen() == (iteration == 1));
+
+    if (iteration == 1)
+    {
+      heavyWriter3->closeFile();
+    }
+
     appendtemp->clearStep();
   }
 
@@ -415,6 +431,36 @@ int main(int, char **)
     appendreadTemp->clearStep();
   }
 
+  // Reading ahead, out of order
+
+  appendreadTemp->setPrefetch(2);
+
+  assert(appendreadTemp->getPrefetch() == 2);
+
+  unsigned int stepOrder[] = {3, 0, 1, 4, 2, 2, 1};
+
+  for (unsigned int j = 0; j < 7; ++j)
+  {
+    unsigned int iteration = stepOrder[j];
+
+    appendreadTemp->setStep(iteration);
+
+    std::cout << appendreadAttr->getValuesString() << std::endl;
+
+    assert(appendreadAttr->getSize() == arraySize);
+
+    for (unsigned int i = 0; i < arraySize; ++i)
+    {
+      assert(appendreadAttr->getValue<double>(i) ==  1.0 * (1 + iteration));
+      assert(appendreadAttr2->getValue<double>(i) == 2.0 * (1 + iteration));
+      assert(appendreadAttr3->getValue<double>(i) == 3.0 * (1 + iteration));
+    }
+
+    appendreadTemp->clearStep();
+  }
+
+  appendreadTemp->setPrefetch(0);
+
   // Overwrite
 
   shared_ptr<XdmfTemplate> overwritetemp = XdmfTemplate::New();
@@ -563,7 +609,219 @@ int main(int, char **)
 
     overwritereadTemp->clearStep();
   }
-    
+
+  // Preallocating more values than a single dataset can address
+
+  shared_ptr<XdmfTemplate> largetemp = XdmfTemplate::New();
+
+  shared_ptr<XdmfUnstructuredGrid> largeungrid = XdmfUnstructuredGrid::New();
+
+  largeungrid->getTopology()->initialize(XdmfArrayType::Float64(), 12);
+
+  largeungrid->getGeometry()->initialize(XdmfArrayType::Float64(), 36);
+
+  shared_ptr<XdmfAttribute> largeattr = XdmfAttribute::New();
+
+  largeattr->initialize(XdmfArrayType::Float64(), 12);
+
+  largeattr->release();
+
+  largeungrid->insert(largeattr);
+
+  shared_ptr<XdmfWriter> writer5 = XdmfWriter::New("template5.xmf");
+
+  shared_ptr<XdmfHeavyDataWriter> heavyWriter5 = writer5->getHeavyDataWriter();
+
+  largetemp->setHeavyDataWriter(heavyWriter5);
+
+  largetemp->setBase(largeungrid);
+
+  for (unsigned int i = 0; i < arraySize; ++i)
+  {
+    largeattr->insert<double>(i, 0.0);
+  }
+
+  largetemp->preallocateSteps(200000000);
+
+  for (unsigned int iteration = 1; iteration <= numSteps; ++iteration)
+  {
+    for (unsigned int i = 0; i < arraySize; ++i)
+    {
+      largeattr->insert<double>(i, 1.0 * iteration);
+    }
+
+    largetemp->addStep();
+
+    largetemp->clearStep();
+  }
+
+  assert(largetemp->getNumberSteps() == numSteps);
+
+  for (unsigned int iteration = 0; iteration < numSteps; ++iteration)
+  {
+    largetemp->setStep(iteration);
+
+    largeattr->read();
+
+    std::cout << largeattr->getValuesString() << std::endl;
+
+    for (unsigned int i = 0; i < arraySize; ++i)
+    {
+      assert(largeattr->getValue<double>(i) ==  1.0 * (1 + iteration));
+    }
+
+    largetemp->clearStep();
+  }
+
+
+  // Storing steps relative to keyframes
+
+  std::cout << "Keyframes" << std::endl;
+
+  unsigned int numKeyframeSteps = 7;
+
+  shared_ptr<XdmfTemplate> keytemp = XdmfTemplate::New();
+
+  shared_ptr<XdmfUnstructuredGrid> keyungrid = XdmfUnstructuredGrid::New();
+
+  keyungrid->getTopology()->initialize(XdmfArrayType::Float64(), 12);
+
+  keyungrid->getGeometry()->initialize(XdmfArrayType::Float64(), 36);
+
+  shared_ptr<XdmfAttribute> constattr = XdmfAttribute::New();
+
+  constattr->initialize(XdmfArrayType::Float64(), 12);
+
+  constattr->release();
+
+  shared_ptr<XdmfAttribute> slowattr = XdmfAttribute::New();
+
+  slowattr->initialize(XdmfArrayType::Float64(), 12);
+
+  slowattr->release();
+
+  keyungrid->insert(constattr);
+  keyungrid->insert(slowattr);
+
+  shared_ptr<XdmfWriter> writer6 = XdmfWriter::New("template6.xmf");
+
+  keytemp->setHeavyDataWriter(writer6->getHeavyDataWriter());
+
+  keytemp->setKeyframeInterval(3);
+
+  assert(keytemp->getKeyframeInterval() == 3);
+
+  keytemp->setBase(keyungrid);
+
+  for (unsigned int iteration = 0; iteration < numKeyframeSteps; ++iteration)
+  {
+    for (unsigned int i = 0; i < arraySize; ++i)
+    {
+      constattr->insert<double>(i, 5.0);
+      slowattr->insert<double>(i, 1.0 * i + (i < 2 ? 0.5 * iteration : 0.0));
+    }
+
+    keytemp->addStep();
+
+    // Values are unchanged by the encoding
+    for (unsigned int i = 0; i < arraySize; ++i)
+    {
+      assert(slowattr->getValue<double>(i) == 1.0 * i + (i < 2 ? 0.5 * iteration : 0.0));
+    }
+
+    keytemp->clearStep();
+  }
+
+  assert(keytemp->getNumberSteps() == numKeyframeSteps);
+
+  for (int iteration = numKeyframeSteps - 1; iteration >= 0; --iteration)
+  {
+    keytemp->setStep(iteration);
+
+    constattr->read();
+    slowattr->read();
+
+    std::cout << slowattr->getValuesString() << std::endl;
+
+    for (unsigned int i = 0; i < arraySize; ++i)
+    {
+      assert(constattr->getValue<double>(i) == 5.0);
+      assert(slowattr->getValue<double>(i) == 1.0 * i + (i < 2 ? 0.5 * iteration : 0.0));
+    }
+
+    keytemp->clearStep();
+  }
+
+  keytemp->accept(writer6);
+
+  shared_ptr<XdmfTemplate> readKeyTemp =
+    shared_dynamic_cast<XdmfTemplate>(reader->read("template6.xmf"));
+
+  shared_ptr<XdmfUnstructuredGrid> readkeyungrid =
+    shared_dynamic_cast<XdmfUnstructuredGrid>(readKeyTemp->getBase());
+
+  assert(readKeyTemp->getNumberSteps() == numKeyframeSteps);
+
+  for (unsigned int iteration = 0; iteration < numKeyframeSteps; ++iteration)
+  {
+    readKeyTemp->setStep(iteration);
+
+    readkeyungrid->getAttribute(0)->read();
+    readkeyungrid->getAttribute(1)->read();
+
+    for (unsigned int i = 0; i < arraySize; ++i)
+    {
+      assert(readkeyungrid->getAttribute(0)->getValue<double>(i) == 5.0);
+      assert(readkeyungrid->getAttribute(1)->getValue<double>(i) ==
+             1.0 * i + (i < 2 ? 0.5 * iteration : 0.0));
+    }
+
+    readKeyTemp->clearStep();
+  }
+
+  // Removing the first step, the keyframe of the steps after it, leaves
+  // the base describing the values of the new first step
+
+  keytemp->removeStep(0);
+
+  assert(keytemp->getNumberSteps() == numKeyframeSteps - 1);
+
+  // Referring to the heavy data of the steps
+  shared_ptr<XdmfWriter> writer7 =
+    XdmfWriter::New("template7.xmf", writer6->getHeavyDataWriter());
+
+  writer7->setLightDataLimit(0);
+
+  keytemp->accept(writer7);
+
+  shared_ptr<XdmfTemplate> removedKeyTemp =
+    shared_dynamic_cast<XdmfTemplate>(reader->read("template7.xmf"));
+
+  shared_ptr<XdmfUnstructuredGrid> removedkeyungrid =
+    shared_dynamic_cast<XdmfUnstructuredGrid>(removedKeyTemp->getBase());
+
+  removedkeyungrid->getAttribute(1)->read();
+
+  for (unsigned int i = 0; i < arraySize; ++i)
+  {
+    assert(removedkeyungrid->getAttribute(1)->getValue<double>(i) ==
+           1.0 * i + (i < 2 ? 0.5 : 0.0));
+  }
+
+  for (unsigned int iteration = 0; iteration < numKeyframeSteps - 1; ++iteration)
+  {
+    removedKeyTemp->setStep(iteration);
+
+    removedkeyungrid->getAttribute(1)->read();
+
+    for (unsigned int i = 0; i < arraySize; ++i)
+    {
+      assert(removedkeyungrid->getAttribute(1)->getValue<double>(i) ==
+             1.0 * i + (i < 2 ? 0.5 * (iteration + 1) : 0.0));
+    }
+
+    removedKeyTemp->clearStep();
+  }
 
   return 0;
 }
@@ -0,0 +1,184 @@
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
+#include "XdmfAttribute.hpp"
+#include "XdmfAttributeCenter.hpp"
+#include "XdmfDomain.hpp"
+#include "XdmfGridCollection.hpp"
+#include "XdmfGridCollectionType.hpp"
+#include "XdmfGridTemplate.hpp"
+#include "XdmfHDF5Writer.hpp"
+#include "XdmfReader.hpp"
+#include "XdmfTime.hpp"
+#include "XdmfUnstructuredGrid.hpp"
+#include "XdmfWriter.hpp"
+#include <cmath>
+#include <iostream>
+
+bool
+isClose(double value, double expected)
+{
+  return std::fabs(value - expected) < 1e-12;
+}
+
+int main(int, char **)
+{
+  unsigned int arraySize = 12;
+
+  // Steps at times 0, 1 and 3, inserted out of order
+
+  shared_ptr<XdmfGridCollection> collection = XdmfGridCollection::New();
+  collection->setType(XdmfGridCollectionType::Temporal());
+
+  const double times[3] = {3.0, 0.0, 1.0};
+  for (unsigned int step = 0; step < 3; ++step) {
+    shared_ptr<XdmfUnstructuredGrid> grid = XdmfUnstructuredGrid::New();
+    grid->setTime(XdmfTime::New(times[step]));
+    shared_ptr<XdmfAttribute> pressure = XdmfAttribute::New();
+    pressure->setName("Pressure");
+    pressure->setCenter(XdmfAttributeCenter::Node());
+    for (unsigned int i = 0; i < arraySize; ++i) {
+      pressure->insert<double>(i, 10.0 * times[step] + i);
+    }
+    grid->insert(pressure);
+    collection->insert(grid);
+  }
+
+  shared_ptr<XdmfAttribute> interpolated = collection->getInterpolated(0.5, "Pressure");
+
+  std::cout << interpolated->getValuesString() << std::endl;
+
+  assert(interpolated->getName().compare("Pressure") == 0);
+  assert(interpolated->getCenter() == XdmfAttributeCenter::Node());
+  assert(interpolated->getSize() == arraySize);
+
+  for (unsigned int i = 0; i < arraySize; ++i) {
+    assert(isClose(interpolated->getValue<double>(i), 5.0 + i));
+  }
+
+  // Sequential queries and times outside the steps
+  const double queries[5] = {-1.0, 1.0, 1.5, 2.5, 4.0};
+  const double expected[5] = {0.0, 10.0, 15.0, 25.0, 30.0};
+  for (unsigned int query = 0; query < 5; ++query) {
+    interpolated = collection->getInterpolated(queries[query], "Pressure");
+    for (unsigned int i = 0; i < arraySize; ++i) {
+      assert(isClose(interpolated->getValue<double>(i), expected[query] + i));
+    }
+  }
+
+  // Steps edited after a query
+
+  shared_ptr<XdmfGridCollection> edited = XdmfGridCollection::New();
+  edited->setType(XdmfGridCollectionType::Temporal());
+
+  for (unsigned int step = 0; step < 2; ++step) {
+    shared_ptr<XdmfUnstructuredGrid> grid = XdmfUnstructuredGrid::New();
+    grid->setTime(XdmfTime::New(1.0 * step));
+    shared_ptr<XdmfAttribute> f = XdmfAttribute::New();
+    f->setName("f");
+    f->insert<double>(0, 10.0 * step);
+    grid->insert(f);
+    edited->insert(grid);
+  }
+
+  assert(isClose(edited->getInterpolated(0.5, "f")->getValue<double>(0), 5.0));
+
+  edited->getUnstructuredGrid(1)->getAttribute("f")->insert<double>(0, 100.0);
+  edited->getUnstructuredGrid(1)->getTime()->setValue(2.0);
+
+  assert(isClose(edited->getInterpolated(0.5, "f")->getValue<double>(0), 25.0));
+
+  edited->getUnstructuredGrid(0)->getAttribute("f")->insert<double>(0, 20.0);
+
+  assert(isClose(edited->getInterpolated(0.5, "f")->getValue<double>(0), 40.0));
+
+  // Through heavy data controllers
+
+  shared_ptr<XdmfDomain> domain = XdmfDomain::New();
+  domain->insert(collection);
+
+  shared_ptr<XdmfWriter> writer = XdmfWriter::New("TestXdmfTimeInterpolation.xmf");
+  writer->setLightDataLimit(1);
+  domain->accept(writer);
+
+  shared_ptr<XdmfReader> reader = XdmfReader::New();
+  shared_ptr<XdmfDomain> readDomain =
+    shared_dynamic_cast<XdmfDomain>(reader->read("TestXdmfTimeInterpolation.xmf"));
+  shared_ptr<XdmfGridCollection> readCollection = readDomain->getGridCollection(0);
+
+  assert(!readCollection->getUnstructuredGrid(0)->getAttribute("Pressure")->isInitialized());
+
+  interpolated = readCollection->getInterpolated(2.0, "Pressure");
+
+  for (unsigned int i = 0; i < arraySize; ++i) {
+    assert(isClose(interpolated->getValue<double>(i), 20.0 + i));
+  }
+
+  // Steps are read without being loaded into the collection
+  assert(!readCollection->getUnstructuredGrid(0)->getAttribute("Pressure")->isInitialized());
+
+  // Steps loaded and edited after a query
+  shared_ptr<XdmfAttribute> readPressure =
+    readCollection->getUnstructuredGrid(2)->getAttribute("Pressure");
+  readPressure->read();
+  for (unsigned int i = 0; i < arraySize; ++i) {
+    readPressure->insert<double>(i, 50.0 + i);
+  }
+
+  interpolated = readCollection->getInterpolated(2.0, "Pressure");
+
+  for (unsigned int i = 0; i < arraySize; ++i) {
+    assert(isClose(interpolated->getValue<double>(i), 40.0 + i));
+  }
+
+  // Templates
+
+  shared_ptr<XdmfGridTemplate> temp = XdmfGridTemplate::New();
+
+  shared_ptr<XdmfUnstructuredGrid> ungrid = XdmfUnstructuredGrid::New();
+  ungrid->getTopology()->initialize(XdmfArrayType::Float64(), 12);
+  ungrid->getGeometry()->initialize(XdmfArrayType::Float64(), 36);
+
+  shared_ptr<XdmfAttribute> velocity = XdmfAttribute::New();
+  velocity->setName("Velocity");
+  velocity->initialize(XdmfArrayType::Float64(), arraySize);
+  velocity->release();
+  ungrid->insert(velocity);
+
+  shared_ptr<XdmfTime> time = XdmfTime::New(0.0);
+  ungrid->setTime(time);
+
+  shared_ptr<XdmfWriter> templateWriter = XdmfWriter::New("TestXdmfTimeInterpolation2.xmf");
+  temp->setHeavyDataWriter(templateWriter->getHeavyDataWriter());
+  temp->setBase(ungrid);
+
+  for (unsigned int step = 1; step <= 3; ++step) {
+    time->setValue(10.0 * step);
+    for (unsigned int i = 0; i < arraySize; ++i) {
+      velocity->insert<double>(i, 1.0 * step * i);
+    }
+    temp->addStep();
+    temp->clearStep();
+  }
+
+  interpolated = temp->getInterpolated(25.0, "Velocity");
+
+  std::cout << interpolated->getValuesString() << std::endl;
+
+  for (unsigned int i = 0; i < arraySize; ++i) {
+    assert(isClose(interpolated->getValue<double>(i), 2.5 * i));
+  }
+
+  temp->accept(templateWriter);
+
+  shared_ptr<XdmfGridTemplate> readTemp =
+    shared_dynamic_cast<XdmfGridTemplate>(reader->read("TestXdmfTimeInterpolation2.xmf"));
+
+  for (unsigned int query = 0; query < 4; ++query) {
+    interpolated = readTemp->getInterpolated(12.5 + 5.0 * query, "Velocity");
+    for (unsigned int i = 0; i < arraySize; ++i) {
+      assert(isClose(interpolated->getValue<double>(i), (1.25 + 0.5 * query) * i));
+    }
+  }
+
+  return 0;
+}
@@ -1,8 +1,19 @@
+#include "XdmfArray.hpp"
+#include "XdmfArrayType.hpp"
 #include "XdmfAttribute.hpp"
+#include "XdmfDomain.hpp"
+#include "XdmfGeometry.hpp"
+#include "XdmfImplicitGeometryController.hpp"
+#include "XdmfImplicitTopologyController.hpp"
+#include "XdmfRectilinearGrid.hpp"
+#include "XdmfRegularGrid.hpp"
+#include "XdmfTopology.hpp"
 #include "XdmfUnstructuredGrid.hpp"
 #include "XdmfInformation.hpp"
+#include "XdmfReader.hpp"
 #include "XdmfSet.hpp"
 #include "XdmfTime.hpp"
+#include "XdmfWriter.hpp"
 
 #include <iostream>
 
@@ -94,5 +105,179 @@ int main(int, char **)
     XdmfInformation::New("key", "value");
   grid->insert(information);
 
+  // Structured grids convert without storing points or connectivity
+  shared_ptr<XdmfRegularGrid> regularGrid =
+    XdmfRegularGrid::New(5, 5, 5, 5, 0, 0);
+  shared_ptr<XdmfUnstructuredGrid> regularConverted =
+    XdmfUnstructuredGrid::New(regularGrid);
+  assert(!regularConverted->getGeometry()->isInitialized());
+  assert(!regularConverted->getTopology()->isInitialized());
+  std::cout << regularConverted->getGeometry()->getNumberPoints() << " ?= " << 25 << std::endl;
+  std::cout << regularConverted->getTopology()->getNumberElements() << " ?= " << 16 << std::endl;
+  assert(regularConverted->getGeometry()->getNumberPoints() == 25);
+  assert(regularConverted->getTopology()->getNumberElements() == 16);
+  regularConverted->getGeometry()->read();
+  regularConverted->getTopology()->read();
+  std::cout << regularConverted->getGeometry()->getValuesString() << std::endl;
+  std::cout << regularConverted->getTopology()->getValuesString() << std::endl;
+  assert(regularConverted->getGeometry()->getValuesString().compare("0 0 5 0 10 0 15 0 20 0 0 5 5 5 10 5 15 5 20 5 0 10 5 10 10 10 15 10 20 10 0 15 5 15 10 15 15 15 20 15 0 20 5 20 10 20 15 20 20 20") == 0);
+  assert(regularConverted->getTopology()->getValuesString().compare("0 1 6 5 1 2 7 6 2 3 8 7 3 4 9 8 5 6 11 10 6 7 12 11 7 8 13 12 8 9 14 13 10 11 16 15 11 12 17 16 12 13 18 17 13 14 19 18 15 16 21 20 16 17 22 21 17 18 23 22 18 19 24 23") == 0);
+
+  shared_ptr<XdmfArray> xCoordinates = XdmfArray::New();
+  shared_ptr<XdmfArray> yCoordinates = XdmfArray::New();
+  shared_ptr<XdmfArray> zCoordinates = XdmfArray::New();
+  xCoordinates->pushBack(0.0);
+  xCoordinates->pushBack(1.0);
+  xCoordinates->pushBack(3.0);
+  yCoordinates->pushBack(0.0);
+  yCoordinates->pushBack(2.0);
+  zCoordinates->pushBack(0.0);
+  zCoordinates->pushBack(4.0);
+  shared_ptr<XdmfRectilinearGrid> rectilinearGrid =
+    XdmfRectilinearGrid::New(xCoordinates, yCoordinates, zCoordinates);
+  shared_ptr<XdmfUnstructuredGrid> rectilinearConverted =
+    XdmfUnstructuredGrid::New(rectilinearGrid);
+  std::cout << rectilinearConverted->getGeometry()->getNumberPoints() << " ?= " << 12 << std::endl;
+  std::cout << rectilinearConverted->getTopology()->getNumberElements() << " ?= " << 2 << std::endl;
+  assert(rectilinearConverted->getGeometry()->getNumberPoints() == 12);
+  assert(rectilinearConverted->getTopology()->getNumberElements() == 2);
+  rectilinearConverted->getTopology()->read();
+  std::cout << rectilinearConverted->getTopology()->getValuesString() << std::endl;
+  assert(rectilinearConverted->getTopology()->getValuesString().compare("0 1 4 3 6 7 10 9 1 2 5 4 7 8 11 10") == 0);
+
+  // Read a single block: the y and z coordinates of points 4 through 6
+  shared_ptr<XdmfImplicitGeometryController> geometryController =
+    XdmfImplicitGeometryController::New(rectilinearGrid);
+  std::vector<unsigned int> starts;
+  starts.push_back(4);
+  starts.push_back(1);
+  std::vector<unsigned int> strides(2, 1);
+  std::vector<unsigned int> dimensions;
+  dimensions.push_back(3);
+  dimensions.push_back(2);
+  shared_ptr<XdmfArray> block = XdmfArray::New();
+  XdmfImplicitGeometryController::New(geometryController->getAxesCoordinates(),
+                                      starts,
+                                      strides,
+                                      dimensions)->read(block.get());
+  std::cout << block->getValuesString() << " ?= " << "2 0 2 0 0 4" << std::endl;
+  assert(block->getValuesString().compare("2 0 2 0 0 4") == 0);
+
+  // Every other element of a 3D regular grid
+  std::vector<unsigned int> pointDimensions(3, 3);
+  starts = std::vector<unsigned int>(2, 0);
+  strides[0] = 2;
+  dimensions[0] = 4;
+  dimensions[1] = 8;
+  XdmfImplicitTopologyController::New(pointDimensions,
+                                      starts,
+                                      strides,
+                                      dimensions)->read(block.get());
+  shared_ptr<XdmfArray> fullTopology = XdmfArray::New();
+  XdmfImplicitTopologyController::New(pointDimensions)->read(fullTopology.get());
+  for(unsigned int i=0; i<block->getSize(); ++i) {
+    assert(block->getValue<unsigned int>(i) ==
+           fullTopology->getValue<unsigned int>((i / 8) * 16 + i % 8));
+  }
+
+  // Grids with more values than an unsigned int addresses are selected
+  // per axis: the last cell of a 2048^3 cell grid
+  shared_ptr<XdmfUnstructuredGrid> largeGrid =
+    XdmfUnstructuredGrid::New(XdmfRegularGrid::New(1, 1, 1,
+                                                   2049, 2049, 2049,
+                                                   0, 0, 0));
+  shared_ptr<XdmfImplicitGeometryController> largeGeometry =
+    shared_dynamic_cast<XdmfImplicitGeometryController>(
+      largeGrid->getGeometry()->getHeavyDataController(0));
+  assert(largeGeometry->getDataspaceDimensions().size() == 4);
+  std::vector<unsigned int> largeStarts(4, 2048);
+  largeStarts[3] = 0;
+  std::vector<unsigned int> largeStrides(4, 1);
+  std::vector<unsigned int> largeDimensions(4, 1);
+  largeDimensions[3] = 3;
+  XdmfImplicitGeometryController::New(largeGeometry->getAxesCoordinates(),
+                                      largeStarts,
+                                      largeStrides,
+                                      largeDimensions)->read(block.get());
+  std::cout << block->getValuesString() << " ?= " << "2048 2048 2048" << std::endl;
+  assert(block->getValuesString().compare("2048 2048 2048") == 0);
+  largeStarts = std::vector<unsigned int>(4, 2047);
+  largeStarts[3] = 0;
+  largeDimensions[3] = 8;
+  XdmfImplicitTopologyController::New(std::vector<unsigned int>(3, 2049),
+                                      largeStarts,
+                                      largeStrides,
+                                      largeDimensions)->read(block.get());
+  assert(block->getArrayType() == XdmfArrayType::Int64());
+  const long lastPoint = 2049L * 2049L * 2049L - 1;
+  std::cout << block->getValue<long>(6) << " ?= " << lastPoint << std::endl;
+  assert(block->getValue<long>(6) == lastPoint);
+
+  // Generated grids are written as their description when requested
+  // and read back without storing any values
+  shared_ptr<XdmfUnstructuredGrid> implicitGrid =
+    XdmfUnstructuredGrid::New(XdmfRegularGrid::New(0.1, 0.25, 0.5,
+                                                   4, 3, 2,
+                                                   -1, 0, 1));
+  implicitGrid->setName("Implicit");
+  shared_ptr<XdmfUnstructuredGrid> implicitRectilinear =
+    XdmfUnstructuredGrid::New(rectilinearGrid);
+  implicitRectilinear->setName("ImplicitRectilinear");
+  shared_ptr<XdmfWriter> writer =
+    XdmfWriter::New("TestXdmfUnstructuredGridImplicit.xmf");
+  writer->setLightDataLimit(0);
+  writer->setWriteImplicit(true);
+  shared_ptr<XdmfDomain> domain = XdmfDomain::New();
+  domain->insert(implicitGrid);
+  domain->insert(implicitRectilinear);
+  domain->accept(writer);
+  assert(!implicitGrid->getGeometry()->isInitialized());
+  assert(!implicitGrid->getTopology()->isInitialized());
+
+  shared_ptr<XdmfReader> reader = XdmfReader::New();
+  shared_ptr<XdmfDomain> readDomain =
+    shared_dynamic_cast<XdmfDomain>(reader->read("TestXdmfUnstructuredGridImplicit.xmf"));
+  for(unsigned int i=0; i<domain->getNumberUnstructuredGrids(); ++i) {
+    shared_ptr<XdmfUnstructuredGrid> writtenGrid =
+      domain->getUnstructuredGrid(i);
+    shared_ptr<XdmfUnstructuredGrid> readGrid =
+      readDomain->getUnstructuredGrid(i);
+    assert(shared_dynamic_cast<XdmfImplicitGeometryController>(
+             readGrid->getGeometry()->getHeavyDataController(0)));
+    assert(shared_dynamic_cast<XdmfImplicitTopologyController>(
+             readGrid->getTopology()->getHeavyDataController(0)));
+    readGrid->getGeometry()->read();
+    readGrid->getTopology()->read();
+    writtenGrid->getGeometry()->read();
+    writtenGrid->getTopology()->read();
+    std::cout << readGrid->getGeometry()->getValuesString() << " ?= " << writtenGrid->getGeometry()->getValuesString() << std::endl;
+    assert(readGrid->getGeometry()->getValuesString().compare(writtenGrid->getGeometry()->getValuesString()) == 0);
+    assert(readGrid->getTopology()->getValuesString().compare(writtenGrid->getTopology()->getValuesString()) == 0);
+    for(unsigned int j=0; j<readGrid->getGeometry()->getSize(); ++j) {
+      assert(readGrid->getGeometry()->getValue<double>(j) ==
+             writtenGrid->getGeometry()->getValue<double>(j));
+    }
+  }
+
+  // By default generated grids are written as heavy data
+  shared_ptr<XdmfWriter> heavyWriter =
+    XdmfWriter::New("TestXdmfUnstructuredGridGenerated.xmf");
+  heavyWriter->setLightDataLimit(0);
+  domain->accept(heavyWriter);
+  shared_ptr<XdmfDomain> heavyDomain =
+    shared_dynamic_cast<XdmfDomain>(reader->read("TestXdmfUnstructuredGridGenerated.xmf"));
+  for(unsigned int i=0; i<domain->getNumberUnstructuredGrids(); ++i) {
+    shared_ptr<XdmfUnstructuredGrid> readGrid =
+      heavyDomain->getUnstructuredGrid(i);
+    assert(!shared_dynamic_cast<XdmfImplicitGeometryController>(
+             readGrid->getGeometry()->getHeavyDataController(0)));
+    assert(!shared_dynamic_cast<XdmfImplicitTopologyController>(
+             readGrid->getTopology()->getHeavyDataController(0)));
+    readGrid->getGeometry()->read();
+    readGrid->getTopology()->read();
+    assert(readGrid->getGeometry()->getValuesString().compare(domain->getUnstructuredGrid(i)->getGeometry()->getValuesString()) == 0);
+    assert(readGrid->getTopology()->getValuesString().compare(domain->getUnstructuredGrid(i)->getTopology()->getValuesString()) == 0);
+  }
+
   return 0;
 }
@@ -0,0 +1,112 @@
+#include "XdmfDomain.hpp"
+#include "XdmfGridCollection.hpp"
+#include "XdmfGridCollectionType.hpp"
+#include "XdmfWriter.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "XdmfTestDataGenerator.hpp"
+
+std::string
+readFile(const std::string & filePath)
+{
+  std::ifstream fileStream(filePath.c_str());
+  std::stringstream contents;
+  contents << fileStream.rdbuf();
+  return contents.str();
+}
+
+void
+writeFile(const std::string & filePath, const std::string & contents)
+{
+  std::ofstream fileStream(filePath.c_str());
+  fileStream << contents;
+}
+
+// Writes the domain in full and compares it to the file written without
+// rebuilding the XML
+bool
+matchesFullWrite(shared_ptr<XdmfDomain> domain)
+{
+  shared_ptr<XdmfWriter> fullWriter =
+    XdmfWriter::New("TestXdmfWriterRebuildXML2.xmf");
+  domain->accept(fullWriter);
+  return readFile("TestXdmfWriterRebuildXML1.xmf") ==
+    readFile("TestXdmfWriterRebuildXML2.xmf");
+}
+
+int main(int, char **)
+{
+  shared_ptr<XdmfDomain> domain = XdmfDomain::New();
+  shared_ptr<XdmfGridCollection> collection = XdmfGridCollection::New();
+  collection->setType(XdmfGridCollectionType::Temporal());
+  domain->insert(collection);
+
+  shared_ptr<XdmfWriter> writer =
+    XdmfWriter::New("TestXdmfWriterRebuildXML1.xmf");
+  writer->setRebuildXML(false);
+
+  assert(writer->getRebuildXML() == false);
+
+  for (unsigned int step = 0; step < 4; ++step) {
+    shared_ptr<XdmfUnstructuredGrid> grid =
+      XdmfTestDataGenerator::createHexahedron();
+    grid->getTime()->setValue(step);
+    collection->insert(grid);
+
+    domain->accept(writer);
+
+    if (step == 2) {
+      // Grids added later are written in place of the closing tags,
+      // keeping what was written before
+      std::string contents = readFile("TestXdmfWriterRebuildXML1.xmf");
+      const size_t index = contents.find(" <Domain >");
+      assert(index != std::string::npos);
+      contents.replace(index, 10, "  <Domain>");
+      writeFile("TestXdmfWriterRebuildXML1.xmf", contents);
+    }
+
+    assert(matchesFullWrite(domain));
+
+    if (step == 1) {
+      // Rewritten without changing the size of the file
+      std::string contents = readFile("TestXdmfWriterRebuildXML1.xmf");
+      const size_t index = contents.find("  <Domain>");
+      contents.replace(index, 10, " <Domain >");
+      writeFile("TestXdmfWriterRebuildXML1.xmf", contents);
+    }
+  }
+
+  // Nothing changed
+  const std::string written = readFile("TestXdmfWriterRebuildXML1.xmf");
+  domain->accept(writer);
+  assert(readFile("TestXdmfWriterRebuildXML1.xmf") == written);
+
+  // Changing an array within a grid written earlier rewrites that grid
+  collection->getUnstructuredGrid(1)->getAttribute(0)->insert(0, 150);
+
+  domain->accept(writer);
+
+  assert(matchesFullWrite(domain));
+
+  collection->insert(XdmfTestDataGenerator::createHexahedron());
+
+  domain->accept(writer);
+
+  assert(matchesFullWrite(domain));
+
+  // A grid destroyed after being written may be replaced by one at the
+  // same address, which must not reuse the destroyed grid's XML
+  collection->removeUnstructuredGrid(0);
+  shared_ptr<XdmfUnstructuredGrid> replacement =
+    XdmfTestDataGenerator::createHexahedron();
+  replacement->getTime()->setValue(10);
+  collection->insert(replacement);
+
+  domain->accept(writer);
+
+  assert(matchesFullWrite(domain));
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include "XdmfDomain.hpp"
+#include "XdmfGridCollection.hpp"
+#include "XdmfGridCollectionType.hpp"
+#include "XdmfHDF5Writer.hpp"
+#include "XdmfInformation.hpp"
+#include "XdmfWriter.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "XdmfTestDataGenerator.hpp"
+
+std::string
+readFile(const std::string & filePath)
+{
+  std::ifstream fileStream(filePath.c_str());
+  std::stringstream contents;
+  contents << fileStream.rdbuf();
+  return contents.str();
+}
+
+int main(int, char **)
+{
+  shared_ptr<XdmfDomain> domain = XdmfDomain::New();
+  domain->insert(XdmfInformation::New("Key", "Value"));
+
+  shared_ptr<XdmfGridCollection> collection = XdmfGridCollection::New();
+  collection->setType(XdmfGridCollectionType::Temporal());
+  collection->insert(XdmfInformation::New("Collection", "Information"));
+  domain->insert(collection);
+
+  shared_ptr<XdmfGridCollection> spatial = XdmfGridCollection::New();
+  spatial->setType(XdmfGridCollectionType::Spatial());
+
+  for (unsigned int step = 0; step < 4; ++step) {
+    shared_ptr<XdmfUnstructuredGrid> grid =
+      XdmfTestDataGenerator::createHexahedron();
+    grid->getTime()->setValue(step);
+    collection->insert(grid);
+    if (step % 2 == 0) {
+      spatial->insert(grid);
+    }
+  }
+  collection->insert(spatial);
+
+  // Grids written before are written again as xpaths
+  domain->insert(collection->getUnstructuredGrid(1));
+  domain->insert(XdmfInformation::New("Last", "Information"));
+
+  shared_ptr<XdmfWriter> writer =
+    XdmfWriter::New("TestXdmfWriterStreamXML1.xmf");
+  domain->accept(writer);
+
+  shared_ptr<XdmfWriter> streamWriter =
+    XdmfWriter::New("TestXdmfWriterStreamXML2.xmf");
+
+  assert(streamWriter->getStreamXML() == false);
+
+  streamWriter->setStreamXML(true);
+
+  assert(streamWriter->getStreamXML() == true);
+
+  domain->accept(streamWriter);
+
+  const std::string written = readFile("TestXdmfWriterStreamXML1.xmf");
+
+  std::cout << readFile("TestXdmfWriterStreamXML2.xmf") << std::endl;
+
+  assert(readFile("TestXdmfWriterStreamXML2.xmf") == written);
+
+  // Writing again with the same writer
+  domain->accept(streamWriter);
+
+  assert(readFile("TestXdmfWriterStreamXML2.xmf") == written);
+
+  // Streaming to an output stream
+  std::stringstream stream;
+  shared_ptr<XdmfWriter> outputWriter =
+    XdmfWriter::New(stream,
+                    XdmfHDF5Writer::New("TestXdmfWriterStreamXML1.h5"));
+  outputWriter->setStreamXML(true);
+  domain->accept(outputWriter);
+
+  assert(stream.str() == written);
+
+  // Nothing to stream without grids
+  shared_ptr<XdmfDomain> emptyDomain = XdmfDomain::New();
+  emptyDomain->insert(XdmfInformation::New("Key", "Value"));
+  emptyDomain->accept(writer);
+  emptyDomain->accept(streamWriter);
+
+  assert(readFile("TestXdmfWriterStreamXML1.xmf") ==
+         readFile("TestXdmfWriterStreamXML2.xmf"));
+
+  return 0;
+}
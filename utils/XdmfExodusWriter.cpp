@@ -33,6 +33,7 @@
 #include "XdmfGeometryType.hpp"
 #include "XdmfGridCollection.hpp"
 #include "XdmfGridCollectionType.hpp"
+#include "XdmfImplicitGeometryController.hpp"
 #include "XdmfPartitioner.hpp"
 #include "XdmfSet.hpp"
 #include "XdmfSetType.hpp"
@@ -514,22 +515,50 @@ XdmfExodusWriter::write(const std::string & filePath,
    
   // get geometry
   shared_ptr<XdmfGeometry> geometry = unstructuredGrid->getGeometry();
-  bool releaseGeometry = false;
-  if(!geometry->isInitialized()) {
-    geometry->read();
-    releaseGeometry = true;
-  }
-  
-  // read nodal positions
-  geometry->getValues(0, x, num_nodes, num_dim);
-  geometry->getValues(1, y, num_nodes, num_dim);
-  if(num_dim == 3) {
-    geometry->getValues(2, z, num_nodes, num_dim);
+
+  shared_ptr<XdmfImplicitGeometryController> implicitController;
+  if(!geometry->isInitialized() &&
+     geometry->getNumberHeavyDataControllers() == 1) {
+    implicitController = shared_dynamic_cast<XdmfImplicitGeometryController>
+      (geometry->getHeavyDataController(0));
+  }
+
+  if(implicitController) {
+    // structured source, generate one coordinate at a time instead of
+    // reading the interleaved points
+    double * coordinates[3] = {x, y, z};
+    std::vector<unsigned int> starts(2, 0);
+    std::vector<unsigned int> strides(2, 1);
+    std::vector<unsigned int> dimensions(2, 1);
+    dimensions[0] = num_nodes;
+    for(int i=0; i<num_dim; ++i) {
+      starts[1] = i;
+      shared_ptr<XdmfArray> axisValues = XdmfArray::New();
+      XdmfImplicitGeometryController::New(implicitController->getAxesCoordinates(),
+                                          starts,
+                                          strides,
+                                          dimensions)->read(axisValues.get());
+      axisValues->getValues(0, coordinates[i], num_nodes);
+    }
   }
-    
-  // release data
-  if(releaseGeometry) {
-    geometry->release();
+  else {
+    bool releaseGeometry = false;
+    if(!geometry->isInitialized()) {
+      geometry->read();
+      releaseGeometry = true;
+    }
+
+    // read nodal positions
+    geometry->getValues(0, x, num_nodes, num_dim);
+    geometry->getValues(1, y, num_nodes, num_dim);
+    if(num_dim == 3) {
+      geometry->getValues(2, z, num_nodes, num_dim);
+    }
+
+    // release data
+    if(releaseGeometry) {
+      geometry->release();
+    }
   }
 
   error = ex_put_coord(exodusHandle, x ,y ,z);
@@ -40,6 +40,7 @@ extern "C"
 #include "XdmfGridCollection.hpp"
 #include "XdmfGridCollectionType.hpp"
 #include "XdmfHeavyDataWriter.hpp"
+#include "XdmfImplicitGeometryController.hpp"
 #include "XdmfMap.hpp"
 #include "XdmfPartitioner.hpp"
 #include "XdmfSet.hpp"
@@ -449,15 +450,40 @@ XdmfPartitioner::partition(const shared_ptr<XdmfUnstructuredGrid> gridToPartitio
                               localElementCount * nodesPerElement);
   }
   
+  // Points of structured grids are generated from their axes, pick
+  // the coordinates of each node there instead of generating them all
+  shared_ptr<XdmfImplicitGeometryController> implicitController;
+  if(!geometry->isInitialized() &&
+     geometry->getNumberHeavyDataControllers() == 1) {
+    implicitController = shared_dynamic_cast<XdmfImplicitGeometryController>
+      (geometry->getHeavyDataController(0));
+    if(implicitController &&
+       (implicitController->getAxesCoordinates().size() != geometryDimensions ||
+        implicitController->getSize() !=
+        implicitController->getDataspaceSize())) {
+      implicitController = shared_ptr<XdmfImplicitGeometryController>();
+    }
+  }
+
   bool releaseGeometry = false;
-  if(!geometry->isInitialized()) {
+  if(!geometry->isInitialized() && !implicitController) {
     geometry->read();
     releaseGeometry = true;
   }
 
   // fill geometry for each partition
+  std::vector<double> point(geometryDimensions);
   for(int i=0; i<numNodes; ++i) {
     const std::map<unsigned int, unsigned int> & localNodeIds = nodeIdMap[i];
+    if(implicitController && localNodeIds.size() > 0) {
+      const std::vector<std::vector<double> > & axesCoordinates =
+        implicitController->getAxesCoordinates();
+      unsigned int pointIndex = i;
+      for(unsigned int j=0; j<geometryDimensions; ++j) {
+        point[j] = axesCoordinates[j][pointIndex % axesCoordinates[j].size()];
+        pointIndex /= axesCoordinates[j].size();
+      }
+    }
     for(std::map<unsigned int, unsigned int>::const_iterator iter = 
           localNodeIds.begin(); iter != localNodeIds.end(); ++iter) {
       const unsigned int partitionId = iter->first;
@@ -465,10 +491,17 @@ XdmfPartitioner::partition(const shared_ptr<XdmfUnstructuredGrid> gridToPartitio
       const shared_ptr<XdmfUnstructuredGrid> grid = 
         partitionedGrid->getUnstructuredGrid(partitionId);
       const shared_ptr<XdmfGeometry> localGeometry = grid->getGeometry();
-      localGeometry->insert(localNodeId * geometryDimensions,
-                            geometry,
-                            i * geometryDimensions,
-                            geometryDimensions);
+      if(implicitController) {
+        localGeometry->insert(localNodeId * geometryDimensions,
+                              &point[0],
+                              geometryDimensions);
+      }
+      else {
+        localGeometry->insert(localNodeId * geometryDimensions,
+                              geometry,
+                              i * geometryDimensions,
+                              geometryDimensions);
+      }
     }
   }
 
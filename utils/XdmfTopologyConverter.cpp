@@ -31,6 +31,8 @@
 #include "XdmfGeometry.hpp"
 #include "XdmfGeometryType.hpp"
 #include "XdmfHeavyDataWriter.hpp"
+#include "XdmfImplicitGeometryController.hpp"
+#include "XdmfImplicitTopologyController.hpp"
 #include "XdmfSet.hpp"
 #include "XdmfSetType.hpp"
 #include "XdmfTopology.hpp"
@@ -510,6 +512,151 @@ namespace {
       
     }
 
+    // Returns true if the controller generates the whole of its dataspace
+    bool
+    isWholeDataspace(const shared_ptr<XdmfHeavyDataController> controller) const
+    {
+      const std::vector<unsigned int> start = controller->getStart();
+      const std::vector<unsigned int> stride = controller->getStride();
+      const std::vector<unsigned int> dimensions =
+        controller->getDimensions();
+      const std::vector<unsigned int> dataspace =
+        controller->getDataspaceDimensions();
+      for(unsigned int i=0; i<dimensions.size(); ++i) {
+        if(start[i] != 0 || stride[i] != 1 || dimensions[i] != dataspace[i]) {
+          return false;
+        }
+      }
+      return dimensions.size() == 2;
+    }
+
+    // Structured hexahedral grids whose points and connectivity are
+    // generated refine into another structured lattice. The new points
+    // are generated along refined axes and the connectivity is built
+    // directly from lattice indices, without reading the original grid
+    // or hashing shared faces and edges. Returns a null pointer when
+    // the grid is not generated.
+    shared_ptr<XdmfUnstructuredGrid>
+    convertStructured(const shared_ptr<XdmfUnstructuredGrid> gridToConvert,
+                      const shared_ptr<const XdmfTopologyType> topologyType,
+                      const shared_ptr<XdmfHeavyDataWriter> heavyDataWriter) const
+    {
+      shared_ptr<XdmfGeometry> geometry = gridToConvert->getGeometry();
+      shared_ptr<XdmfTopology> topology = gridToConvert->getTopology();
+      if(geometry->isInitialized() ||
+         topology->isInitialized() ||
+         geometry->getNumberHeavyDataControllers() != 1 ||
+         topology->getNumberHeavyDataControllers() != 1) {
+        return shared_ptr<XdmfUnstructuredGrid>();
+      }
+
+      shared_ptr<XdmfImplicitGeometryController> geometryController =
+        shared_dynamic_cast<XdmfImplicitGeometryController>(geometry->getHeavyDataController(0));
+      shared_ptr<XdmfImplicitTopologyController> topologyController =
+        shared_dynamic_cast<XdmfImplicitTopologyController>(topology->getHeavyDataController(0));
+      if(!geometryController || !topologyController ||
+         !isWholeDataspace(geometryController) ||
+         !isWholeDataspace(topologyController)) {
+        return shared_ptr<XdmfUnstructuredGrid>();
+      }
+
+      const std::vector<std::vector<double> > & axesCoordinates =
+        geometryController->getAxesCoordinates();
+      const std::vector<unsigned int> pointDimensions =
+        topologyController->getPointDimensions();
+      if(axesCoordinates.size() != 3 || pointDimensions.size() != 3) {
+        return shared_ptr<XdmfUnstructuredGrid>();
+      }
+      for(unsigned int i=0; i<3; ++i) {
+        if(axesCoordinates[i].size() != pointDimensions[i] ||
+           pointDimensions[i] < 2) {
+          return shared_ptr<XdmfUnstructuredGrid>();
+        }
+      }
+
+      // Each cell interval is split at the same fractions used to
+      // place points inside an element
+      std::vector<std::vector<double> > refinedCoordinates(3);
+      std::vector<unsigned int> refinedDimensions(3);
+      for(unsigned int i=0; i<3; ++i) {
+        const std::vector<double> & axis = axesCoordinates[i];
+        refinedDimensions[i] = (pointDimensions[i] - 1) * ORDER + 1;
+        refinedCoordinates[i].reserve(refinedDimensions[i]);
+        for(unsigned int j=0; j<pointDimensions[i] - 1; ++j) {
+          for(unsigned int k=0; k<ORDER; ++k) {
+            refinedCoordinates[i].push_back(axis[j] +
+                                            points[k] * (axis[j+1] - axis[j]));
+          }
+        }
+        refinedCoordinates[i].push_back(axis[pointDimensions[i] - 1]);
+      }
+
+      shared_ptr<XdmfUnstructuredGrid> toReturn = XdmfUnstructuredGrid::New();
+      toReturn->setName(gridToConvert->getName());
+
+      shared_ptr<XdmfGeometry> toReturnGeometry = toReturn->getGeometry();
+      toReturnGeometry->setType(geometry->getType());
+      toReturnGeometry->setHeavyDataController(
+        XdmfImplicitGeometryController::New(refinedCoordinates));
+
+      const unsigned int numberElements = topology->getNumberElements();
+      shared_ptr<XdmfTopology> toReturnTopology = toReturn->getTopology();
+      toReturnTopology->setType(topologyType);
+      toReturnTopology->initialize(XdmfArrayType::UInt32(),
+                                   numberElements * mNumberPoints);
+
+      // Local node (i, j, k) of an element steps along x, y and z
+      const unsigned int nx = refinedDimensions[0];
+      const unsigned int nxy = refinedDimensions[0] * refinedDimensions[1];
+      unsigned int elementIds[mNumberPoints];
+      unsigned int offset = 0;
+      for(unsigned int z=0; z<pointDimensions[2] - 1; ++z) {
+        for(unsigned int y=0; y<pointDimensions[1] - 1; ++y) {
+          for(unsigned int x=0; x<pointDimensions[0] - 1; ++x) {
+            const unsigned int firstId =
+              x * ORDER + nx * y * ORDER + nxy * z * ORDER;
+            unsigned int pointIndex = 0;
+            for(unsigned int i=0; i<mNodesPerEdge; ++i) {
+              for(unsigned int j=0; j<mNodesPerEdge; ++j) {
+                for(unsigned int k=0; k<mNodesPerEdge; ++k) {
+                  elementIds[pointIndex++] = firstId + i + nx * j + nxy * k;
+                }
+              }
+            }
+            toReturnTopology->insert(offset, elementIds, mNumberPoints);
+            offset += mNumberPoints;
+          }
+        }
+      }
+
+      remapTopology<ORDER>(toReturnTopology);
+
+      if(heavyDataWriter) {
+        toReturnTopology->accept(heavyDataWriter);
+        toReturnTopology->release();
+      }
+
+      std::vector<int> oldIdToNewId;
+      if(gridToConvert->getNumberSets() > 0) {
+        oldIdToNewId.resize(pointDimensions[0] * pointDimensions[1] *
+                            pointDimensions[2]);
+        unsigned int oldId = 0;
+        for(unsigned int z=0; z<pointDimensions[2]; ++z) {
+          for(unsigned int y=0; y<pointDimensions[1]; ++y) {
+            for(unsigned int x=0; x<pointDimensions[0]; ++x) {
+              oldIdToNewId[oldId++] =
+                x * ORDER + nx * y * ORDER + nxy * z * ORDER;
+            }
+          }
+        }
+      }
+      handleSetConversion(gridToConvert,
+                          toReturn,
+                          oldIdToNewId,
+                          heavyDataWriter);
+      return toReturn;
+    }
+
     void
     calculateIntermediatePoint(double result[3],
                                const double point1[3],
@@ -528,6 +675,12 @@ namespace {
             const shared_ptr<XdmfHeavyDataWriter> heavyDataWriter) const
     {
 
+      shared_ptr<XdmfUnstructuredGrid> structuredGrid =
+        convertStructured(gridToConvert, topologyType, heavyDataWriter);
+      if(structuredGrid) {
+        return structuredGrid;
+      }
+
       shared_ptr<XdmfUnstructuredGrid> toReturn = XdmfUnstructuredGrid::New();
       toReturn->setName(gridToConvert->getName());
 
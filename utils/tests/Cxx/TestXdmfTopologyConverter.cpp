@@ -4,6 +4,10 @@
 #include "XdmfArrayType.hpp"
 #include "XdmfGeometry.hpp"
 #include "XdmfGeometryType.hpp"
+#include "XdmfImplicitGeometryController.hpp"
+#include "XdmfRegularGrid.hpp"
+#include "XdmfSet.hpp"
+#include "XdmfSetType.hpp"
 #include "XdmfTopology.hpp"
 #include "XdmfTopologyConverter.hpp"
 #include "XdmfTopologyType.hpp"
@@ -70,6 +74,78 @@ int main(int, char **)
   assert(newHexGrid->getTopology()->getNumberElements() == 27);
 
 
+  /*
+   * Structured Hexahedron to Hexahedron_27 and Hexahedron_64, the
+   * generated grid must match converting the same grid explicitly
+   */
+  shared_ptr<XdmfUnstructuredGrid> structuredGrid =
+    XdmfUnstructuredGrid::New(XdmfRegularGrid::New(0.5, 1, 2,
+                                                   3, 2, 4,
+                                                   1, -1, 0));
+  shared_ptr<XdmfSet> nodeSet = XdmfSet::New();
+  nodeSet->setType(XdmfSetType::Node());
+  nodeSet->pushBack<unsigned int>(0);
+  nodeSet->pushBack<unsigned int>(7);
+  nodeSet->pushBack<unsigned int>(23);
+  structuredGrid->insert(nodeSet);
+
+  shared_ptr<XdmfUnstructuredGrid> explicitGrid = XdmfUnstructuredGrid::New();
+  explicitGrid->getGeometry()->setType(XdmfGeometryType::XYZ());
+  explicitGrid->getGeometry()->setHeavyDataController(
+    structuredGrid->getGeometry()->getHeavyDataController(0));
+  explicitGrid->getGeometry()->read();
+  explicitGrid->getTopology()->setType(XdmfTopologyType::Hexahedron());
+  explicitGrid->getTopology()->setHeavyDataController(
+    structuredGrid->getTopology()->getHeavyDataController(0));
+  explicitGrid->getTopology()->read();
+  explicitGrid->insert(nodeSet);
+
+  std::vector<shared_ptr<const XdmfTopologyType> > structuredTypes;
+  structuredTypes.push_back(XdmfTopologyType::Hexahedron_27());
+  structuredTypes.push_back(XdmfTopologyType::Hexahedron_64());
+  for(unsigned int type=0; type<structuredTypes.size(); ++type) {
+    shared_ptr<XdmfUnstructuredGrid> generatedHighOrder =
+      converter->convert(structuredGrid, structuredTypes[type]);
+    shared_ptr<XdmfUnstructuredGrid> explicitHighOrder =
+      converter->convert(explicitGrid, structuredTypes[type]);
+
+    assert(!structuredGrid->getGeometry()->isInitialized());
+    assert(!structuredGrid->getTopology()->isInitialized());
+    assert(!generatedHighOrder->getGeometry()->isInitialized());
+    assert(shared_dynamic_cast<XdmfImplicitGeometryController>(
+             generatedHighOrder->getGeometry()->getHeavyDataController(0)));
+    assert(generatedHighOrder->getGeometry()->getNumberPoints() ==
+           explicitHighOrder->getGeometry()->getNumberPoints());
+    assert(generatedHighOrder->getTopology()->getSize() ==
+           explicitHighOrder->getTopology()->getSize());
+
+    generatedHighOrder->getGeometry()->read();
+    shared_ptr<XdmfTopology> generatedTopology =
+      generatedHighOrder->getTopology();
+    shared_ptr<XdmfTopology> explicitTopology =
+      explicitHighOrder->getTopology();
+    for(unsigned int i=0; i<generatedTopology->getSize(); ++i) {
+      const unsigned int generatedId =
+        generatedTopology->getValue<unsigned int>(i);
+      const unsigned int explicitId =
+        explicitTopology->getValue<unsigned int>(i);
+      for(unsigned int j=0; j<3; ++j) {
+        assert(fabs(generatedHighOrder->getGeometry()->getValue<double>(generatedId * 3 + j) -
+                    explicitHighOrder->getGeometry()->getValue<double>(explicitId * 3 + j)) < 1e-12);
+      }
+    }
+
+    shared_ptr<XdmfSet> generatedSet = generatedHighOrder->getSet(0);
+    shared_ptr<XdmfSet> explicitSet = explicitHighOrder->getSet(0);
+    assert(generatedSet->getSize() == 3);
+    for(unsigned int i=0; i<generatedSet->getSize(); ++i) {
+      for(unsigned int j=0; j<3; ++j) {
+        assert(fabs(generatedHighOrder->getGeometry()->getValue<double>(generatedSet->getValue<unsigned int>(i) * 3 + j) -
+                    explicitHighOrder->getGeometry()->getValue<double>(explicitSet->getValue<unsigned int>(i) * 3 + j)) < 1e-12);
+      }
+    }
+  }
+
   shared_ptr<XdmfTopology> faceTopology;
 
   /**